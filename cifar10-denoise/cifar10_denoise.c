@@ -87,7 +87,7 @@ cifar10_denoise_addNoise(cifar10_denoise_t* self,
 static cifar10_denoise_t*
 cifar10_denoise_parse(nn_engine_t* engine, uint32_t xh,
                       uint32_t xw, uint32_t xd,
-                      cc_jsmnVal_t* val)
+                      int inference, cc_jsmnVal_t* val)
 {
 	ASSERT(engine);
 	ASSERT(val);
@@ -190,6 +190,12 @@ cifar10_denoise_parse(nn_engine_t* engine, uint32_t xh,
 		return NULL;
 	}
 
+	// skip the optimizer and gradient state
+	if(inference)
+	{
+		nn_arch_inferenceOnly(&self->base);
+	}
+
 	self->bs    = strtol(val_bs->data, NULL, 0);
 	self->fc    = strtol(val_fc->data, NULL, 0);
 	self->mu    = strtod(val_mu->data, NULL);
@@ -584,7 +590,7 @@ void cifar10_denoise_delete(cifar10_denoise_t** _self)
 cifar10_denoise_t*
 cifar10_denoise_import(nn_engine_t* engine,
                        uint32_t xh, uint32_t xw,
-                       uint32_t xd,
+                       uint32_t xd, int inference,
                        const char* fname)
 {
 	ASSERT(engine);
@@ -597,7 +603,8 @@ cifar10_denoise_import(nn_engine_t* engine,
 	}
 
 	cifar10_denoise_t* self;
-	self = cifar10_denoise_parse(engine, xh, xw, xd, val);
+	self = cifar10_denoise_parse(engine, xh, xw, xd,
+	                             inference, val);
 	if(self == NULL)
 	{
 		goto fail_parse;
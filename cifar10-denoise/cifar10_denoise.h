@@ -69,6 +69,7 @@ cifar10_denoise_t* cifar10_denoise_import(nn_engine_t* engine,
                                           uint32_t xh,
                                           uint32_t xw,
                                           uint32_t xd,
+                                          int inference,
                                           const char* fname);
 int                cifar10_denoise_export(cifar10_denoise_t* self,
                                           const char* fname);
@@ -75,7 +75,7 @@ cifar10_disc_onMain(vkk_engine_t* ve, int argc,
 	cifar10_denoise_t* dn;
 	dn = cifar10_denoise_import(engine, dimXt->height,
 	                            dimXt->width, dimXt->depth,
-	                            "data/dn.json");
+	                            1, "data/dn.json");
 	if(dn == NULL)
 	{
 		goto fail_dn;
@@ -242,7 +242,7 @@ cnn_test_onMain(vkk_engine_t* ve, int argc, char** argv)
 	};
 
 	nn_convLayer_t* conv;
-	conv = nn_convLayer_new(arch, dim, &dimW, 1,
+	conv = nn_convLayer_new(arch, dim, &dimW, 1, 1,
 	                        NN_CONV_LAYER_FLAG_XAVIER);
 	if(conv == NULL)
 	{
@@ -293,7 +293,6 @@ cnn_test_onMain(vkk_engine_t* ve, int argc, char** argv)
 	uint32_t idx;
 	uint32_t m;
 	uint32_t count = 1000;
-	nn_tensor_t* Y;
 	nn_tensor_t* dL_dY;
 	for(idx = 0; idx < count; ++idx)
 	{
@@ -306,19 +305,7 @@ cnn_test_onMain(vkk_engine_t* ve, int argc, char** argv)
 			}
 		}
 
-		Y = nn_arch_forwardPass(arch, 0, bs, X);
-		if(Y == NULL)
-		{
-			goto fail_train;
-		}
-
-		dL_dY = nn_loss_pass(loss, 0, bs, Y, Yt);
-		if(dL_dY == NULL)
-		{
-			goto fail_train;
-		}
-
-		dL_dY = nn_arch_backprop(arch, 0, bs, dL_dY);
+		dL_dY = nn_arch_step(arch, loss, 0, 0, bs, X, Yt);
 		if(dL_dY == NULL)
 		{
 			goto fail_train;
@@ -85,7 +85,7 @@ mnist_denoise_addNoise(mnist_denoise_t* self,
 static mnist_denoise_t*
 mnist_denoise_parse(nn_engine_t* engine,
                     uint32_t xh, uint32_t xw,
-                    cc_jsmnVal_t* val)
+                    int inference, cc_jsmnVal_t* val)
 {
 	ASSERT(engine);
 	ASSERT(val);
@@ -206,6 +206,12 @@ mnist_denoise_parse(nn_engine_t* engine,
 		return NULL;
 	}
 
+	// skip the optimizer and gradient state
+	if(inference)
+	{
+		nn_arch_inferenceOnly(&self->base);
+	}
+
 	self->bs    = strtol(val_bs->data, NULL, 0);
 	self->fc    = strtol(val_fc->data, NULL, 0);
 	self->mu    = strtod(val_mu->data, NULL);
@@ -517,7 +523,7 @@ mnist_denoise_new(nn_engine_t* engine,
 		.depth  = dim->depth,
 	};
 
-	self->convO = nn_convLayer_new(&self->base, dim, &dimWO, 1,
+	self->convO = nn_convLayer_new(&self->base, dim, &dimWO, 1, 1,
 	                               NN_CONV_LAYER_FLAG_XAVIER);
 	if(self->convO == NULL)
 	{
@@ -638,7 +644,7 @@ void mnist_denoise_delete(mnist_denoise_t** _self)
 mnist_denoise_t*
 mnist_denoise_import(nn_engine_t* engine,
                      uint32_t xh, uint32_t xw,
-                     const char* fname)
+                     int inference, const char* fname)
 {
 	ASSERT(engine);
 	ASSERT(fname);
@@ -650,7 +656,7 @@ mnist_denoise_import(nn_engine_t* engine,
 	}
 
 	mnist_denoise_t* self;
-	self = mnist_denoise_parse(engine, xh, xw, val);
+	self = mnist_denoise_parse(engine, xh, xw, inference, val);
 	if(self == NULL)
 	{
 		goto fail_parse;
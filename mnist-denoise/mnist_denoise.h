@@ -69,6 +69,7 @@ void             mnist_denoise_delete(mnist_denoise_t** _self);
 mnist_denoise_t* mnist_denoise_import(nn_engine_t* engine,
                                       uint32_t xh,
                                       uint32_t xw,
+                                      int inference,
                                       const char* fname);
 int              mnist_denoise_export(mnist_denoise_t* self,
                                       const char* fname);
@@ -72,7 +72,7 @@ mnist_disc_onMain(vkk_engine_t* ve, int argc,
 
 	mnist_denoise_t* dn;
 	dn = mnist_denoise_import(engine, dimXt->height,
-	                          dimXt->width, "data/dn.json");
+	                          dimXt->width, 1, "data/dn.json");
 	if(dn == NULL)
 	{
 		goto fail_dn;
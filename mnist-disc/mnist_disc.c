@@ -470,7 +470,7 @@ mnist_disc_new(nn_engine_t* engine, uint32_t bs,
 		.depth  = dim->depth,
 	};
 
-	self->convO = nn_convLayer_new(&self->base, dim, &dimWO, 1,
+	self->convO = nn_convLayer_new(&self->base, dim, &dimWO, 1, 1,
 	                               NN_CONV_LAYER_FLAG_XAVIER);
 	if(self->convO == NULL)
 	{
@@ -28,17 +28,17 @@
 
 typedef struct nn_arch_s               nn_arch_t;
 typedef struct nn_batchNormLayer_s     nn_batchNormLayer_t;
-typedef struct nn_batchNormUs2Data_s   nn_batchNormUs2Data_t;
-typedef struct nn_batchNormUs2Key_s    nn_batchNormUs2Key_t;
 typedef struct nn_convLayer_s          nn_convLayer_t;
 typedef struct nn_convUs2Data_s        nn_convUs2Data_t;
 typedef struct nn_convUs2Key_s         nn_convUs2Key_t;
 typedef struct nn_coderLayerInfo_s     nn_coderLayerInfo_t;
 typedef struct nn_coderLayer_s         nn_coderLayer_t;
+typedef struct nn_cpu_s                nn_cpu_t;
 typedef struct nn_dim_s                nn_dim_t;
 typedef struct nn_encdecLayer_s        nn_encdecLayer_t;
 typedef struct nn_engine_s             nn_engine_t;
 typedef struct nn_factLayer_s          nn_factLayer_t;
+typedef struct nn_groupNormLayer_s     nn_groupNormLayer_t;
 typedef struct nn_lanczosLayer_s       nn_lanczosLayer_t;
 typedef struct nn_lanczosParam_s       nn_lanczosParam_t;
 typedef struct nn_lanczosResampler_s   nn_lanczosResampler_t;
@@ -48,8 +48,10 @@ typedef struct nn_loss_s               nn_loss_t;
 typedef struct nn_resLayer_s           nn_resLayer_t;
 typedef struct nn_reshapeLayer_s       nn_reshapeLayer_t;
 typedef struct nn_skipLayer_s          nn_skipLayer_t;
+typedef struct nn_tensorGemm_s         nn_tensorGemm_t;
 typedef struct nn_tensorOpUs0Idx_s     nn_tensorOpUs0Idx_t;
 typedef struct nn_tensorOpUs0Data_s    nn_tensorOpUs0Data_t;
+typedef struct nn_tensorQ8_s           nn_tensorQ8_t;
 typedef struct nn_tensorStats_s        nn_tensorStats_t;
 typedef struct nn_tensor_s             nn_tensor_t;
 typedef struct nn_urrdbBlockLayer_s    nn_urrdbBlockLayer_t;
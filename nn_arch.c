@@ -35,6 +35,18 @@
 #include "nn_loss.h"
 #include "nn_tensor.h"
 
+// memory planner buffer
+// host is the index of the buffer which is aliased or -1
+// and tail is the last epoch of the most recent activation
+// stored in the buffer
+typedef struct
+{
+	size_t   size;
+	uint32_t tail;
+	int      host;
+	int      done;
+} nn_archPlan_t;
+
 /***********************************************************
 * private                                                  *
 ***********************************************************/
@@ -90,6 +102,18 @@ nn_arch_t* nn_arch_new(nn_engine_t* engine,
 		goto fail_layers;
 	}
 
+	self->step_cmds = cc_list_new();
+	if(self->step_cmds == NULL)
+	{
+		goto fail_step_cmds;
+	}
+
+	// the CPU backend reads the state directly
+	if(engine->cpu)
+	{
+		return self;
+	}
+
 	vkk_updateMode_e um;
 	um = vkk_compute_updateMode(engine->compute);
 	self->sb100_bs = vkk_buffer_new(engine->engine, um,
@@ -117,6 +141,8 @@ nn_arch_t* nn_arch_new(nn_engine_t* engine,
 	fail_sb101_state:
 		vkk_buffer_delete(&self->sb100_bs);
 	fail_sb100_bs:
+		cc_list_delete(&self->step_cmds);
+	fail_step_cmds:
 		cc_list_delete(&self->layers);
 	fail_layers:
 		FREE(self);
@@ -130,6 +156,8 @@ void nn_arch_delete(nn_arch_t** _self)
 	nn_arch_t* self = *_self;
 	if(self)
 	{
+		nn_arch_stepReset(self);
+		cc_list_delete(&self->step_cmds);
 		vkk_buffer_delete(&self->sb101_state);
 		vkk_buffer_delete(&self->sb100_bs);
 		cc_list_discard(self->layers);
@@ -168,6 +196,8 @@ int nn_arch_attachLayer(nn_arch_t* self,
 		return 0;
 	}
 
+	nn_arch_stepReset(self);
+
 	return 1;
 }
 
@@ -333,11 +363,21 @@ nn_arch_forwardPass(nn_arch_t* self,
 		return NULL;
 	}
 
+	// aliased activations require the planned inference pass
+	if(self->plan && ((flags & NN_ARCH_FLAG_FP_BN_RUNNING) == 0))
+	{
+		LOGE("invalid flags=0x%X", flags);
+		return NULL;
+	}
+
 	nn_archState_t* state = &self->state;
-	vkk_buffer_writeStorage(self->sb100_bs, 0,
-	                        sizeof(uint32_t), &bs);
-	vkk_buffer_writeStorage(self->sb101_state, 0,
-	                        sizeof(nn_archState_t), state);
+	if(self->engine->cpu == NULL)
+	{
+		vkk_buffer_writeStorage(self->sb100_bs, 0,
+		                        sizeof(uint32_t), &bs);
+		vkk_buffer_writeStorage(self->sb101_state, 0,
+		                        sizeof(nn_archState_t), state);
+	}
 
 	if(nn_engine_computeBegin(self->engine) == 0)
 	{
@@ -345,12 +385,14 @@ nn_arch_forwardPass(nn_arch_t* self,
 	}
 
 	// perform forward pass
+	int            idx  = 0;
 	cc_listIter_t* iter = cc_list_head(self->layers);
 	while(iter)
 	{
 		nn_layer_t* layer;
 		layer = (nn_layer_t*) cc_list_peekIter(iter);
 
+		nn_engine_profileLayer(self->engine, idx++);
 		X = nn_layer_computeFp(layer, flags, bs, X);
 		if(X == NULL)
 		{
@@ -359,8 +401,10 @@ nn_arch_forwardPass(nn_arch_t* self,
 
 		iter = cc_list_next(iter);
 	}
+	nn_engine_profileLayer(self->engine, -1);
 
 	nn_engine_computeEnd(self->engine);
+	nn_engine_profileReport(self->engine, "forwardPass");
 	nn_arch_post(self, flags, bs);
 
 	// success
@@ -368,6 +412,7 @@ nn_arch_forwardPass(nn_arch_t* self,
 
 	// failure
 	fail_forwardPass:
+		nn_engine_profileLayer(self->engine, -1);
 		nn_engine_computeEnd(self->engine);
 	return NULL;
 }
@@ -386,16 +431,27 @@ nn_arch_backprop(nn_arch_t* self,
 		return NULL;
 	}
 
+	// backprop requires the activations which were aliased
+	// and the state which is skipped by inference-only
+	if(self->plan || self->inference)
+	{
+		LOGE("invalid");
+		return NULL;
+	}
+
 	nn_archState_t* state = &self->state;
 	if((flags & NN_ARCH_FLAG_BP_NOP) == 0)
 	{
 		state->adam_beta1t *= state->adam_beta1;
 		state->adam_beta2t *= state->adam_beta2;
 	}
-	vkk_buffer_writeStorage(self->sb100_bs, 0,
-	                        sizeof(uint32_t), &bs);
-	vkk_buffer_writeStorage(self->sb101_state, 0,
-	                        sizeof(nn_archState_t), state);
+	if(self->engine->cpu == NULL)
+	{
+		vkk_buffer_writeStorage(self->sb100_bs, 0,
+		                        sizeof(uint32_t), &bs);
+		vkk_buffer_writeStorage(self->sb101_state, 0,
+		                        sizeof(nn_archState_t), state);
+	}
 
 	if(nn_engine_computeBegin(self->engine) == 0)
 	{
@@ -403,12 +459,14 @@ nn_arch_backprop(nn_arch_t* self,
 	}
 
 	// perform backprop
+	int            idx  = cc_list_size(self->layers);
 	cc_listIter_t* iter = cc_list_tail(self->layers);
 	while(iter)
 	{
 		nn_layer_t* layer;
 		layer = (nn_layer_t*) cc_list_peekIter(iter);
 
+		nn_engine_profileLayer(self->engine, --idx);
 		dL_dY = nn_layer_computeBp(layer, flags, bs, dL_dY);
 		if(dL_dY == NULL)
 		{
@@ -417,8 +475,10 @@ nn_arch_backprop(nn_arch_t* self,
 
 		iter = cc_list_prev(iter);
 	}
+	nn_engine_profileLayer(self->engine, -1);
 
 	nn_engine_computeEnd(self->engine);
+	nn_engine_profileReport(self->engine, "backprop");
 	nn_arch_post(self, flags, bs);
 
 	// success
@@ -426,6 +486,542 @@ nn_arch_backprop(nn_arch_t* self,
 
 	// failure
 	fail_backprop:
+		nn_engine_profileLayer(self->engine, -1);
 		nn_engine_computeEnd(self->engine);
 	return NULL;
 }
+
+nn_tensor_t*
+nn_arch_step(nn_arch_t* self, nn_loss_t* loss,
+             int flags, int loss_flags, uint32_t bs,
+             nn_tensor_t* X, nn_tensor_t* Yt)
+{
+	ASSERT(self);
+	ASSERT(loss);
+	ASSERT(X);
+	ASSERT(Yt);
+
+	nn_engine_t* engine = self->engine;
+
+	nn_tensor_t* Y;
+	nn_tensor_t* dL_dY;
+	nn_tensor_t* dL_dX;
+
+	if(self->plan || self->inference)
+	{
+		LOGE("invalid");
+		return NULL;
+	}
+
+	// the CPU backend and stats do not support capture
+	if(engine->cpu ||
+	   (flags & (NN_ARCH_FLAG_FP_STATS | NN_ARCH_FLAG_BP_STATS)) ||
+	   (loss_flags & NN_LOSS_FLAG_STATS))
+	{
+		Y = nn_arch_forwardPass(self, flags, bs, X);
+		if(Y == NULL)
+		{
+			return NULL;
+		}
+
+		dL_dY = nn_loss_pass(loss, loss_flags, bs, Y, Yt);
+		if(dL_dY == NULL)
+		{
+			return NULL;
+		}
+
+		return nn_arch_backprop(self, flags, bs, dL_dY);
+	}
+
+	if(self->step_captured &&
+	   ((self->step_loss       != loss)       ||
+	    (self->step_flags      != flags)      ||
+	    (self->step_loss_flags != loss_flags) ||
+	    (self->step_bs         != bs)         ||
+	    (self->step_X          != X)          ||
+	    (self->step_Yt         != Yt)))
+	{
+		nn_arch_stepReset(self);
+	}
+
+	// capture the step
+	if(self->step_captured == 0)
+	{
+		nn_engine_captureBegin(engine, self->step_cmds);
+
+		Y = nn_arch_forwardPass(self, flags, bs, X);
+		if(Y == NULL)
+		{
+			goto fail_capture;
+		}
+
+		dL_dY = nn_loss_pass(loss, loss_flags, bs, Y, Yt);
+		if(dL_dY == NULL)
+		{
+			goto fail_capture;
+		}
+
+		dL_dX = nn_arch_backprop(self, flags, bs, dL_dY);
+		if(dL_dX == NULL)
+		{
+			goto fail_capture;
+		}
+
+		if(nn_engine_captureEnd(engine) == 0)
+		{
+			// the step was performed but it is not replayable
+			nn_arch_stepReset(self);
+			return dL_dX;
+		}
+
+		self->step_captured   = 1;
+		self->step_loss       = loss;
+		self->step_flags      = flags;
+		self->step_loss_flags = loss_flags;
+		self->step_bs         = bs;
+		self->step_X          = X;
+		self->step_Yt         = Yt;
+		self->step_dL_dX      = dL_dX;
+
+		return dL_dX;
+	}
+
+	// replay the step
+	// forwardPass only depends on bn_momentum so the state
+	// is updated once for backprop
+	nn_archState_t* state = &self->state;
+	if((flags & NN_ARCH_FLAG_BP_NOP) == 0)
+	{
+		state->adam_beta1t *= state->adam_beta1;
+		state->adam_beta2t *= state->adam_beta2;
+	}
+	vkk_buffer_writeStorage(self->sb100_bs, 0,
+	                        sizeof(uint32_t), &bs);
+	vkk_buffer_writeStorage(self->sb101_state, 0,
+	                        sizeof(nn_archState_t), state);
+
+	if(nn_engine_computeBegin(engine) == 0)
+	{
+		return NULL;
+	}
+
+	if(nn_engine_captureReplay(engine, self->step_cmds) == 0)
+	{
+		goto fail_replay;
+	}
+
+	nn_engine_computeEnd(engine);
+	nn_engine_profileReport(engine, "step");
+	nn_arch_post(self, flags, bs);
+	nn_loss_post(loss, loss_flags, bs);
+
+	// success
+	return self->step_dL_dX;
+
+	// failure
+	fail_replay:
+		nn_engine_computeEnd(engine);
+	return NULL;
+
+	// failure
+	fail_capture:
+		nn_engine_captureEnd(engine);
+		nn_arch_stepReset(self);
+	return NULL;
+}
+
+void nn_arch_stepReset(nn_arch_t* self)
+{
+	ASSERT(self);
+
+	if(self->engine->cpu == NULL)
+	{
+		nn_engine_captureDiscard(self->engine, self->step_cmds);
+	}
+
+	self->step_captured   = 0;
+	self->step_loss       = NULL;
+	self->step_flags      = 0;
+	self->step_loss_flags = 0;
+	self->step_bs         = 0;
+	self->step_X          = NULL;
+	self->step_Yt         = NULL;
+	self->step_dL_dX      = NULL;
+}
+
+int nn_arch_plan(nn_arch_t* self, uint32_t bs,
+                 nn_tensor_t* X)
+{
+	ASSERT(self);
+	ASSERT(X);
+
+	nn_engine_t* engine = self->engine;
+
+	// the CPU backend is not supported
+	if(engine->cpu)
+	{
+		return 1;
+	}
+
+	if(self->plan)
+	{
+		LOGE("invalid");
+		return 0;
+	}
+
+	cc_list_t* cmds = cc_list_new();
+	if(cmds == NULL)
+	{
+		return 0;
+	}
+
+	self->plan_Y = cc_list_new();
+	if(self->plan_Y == NULL)
+	{
+		goto fail_plan_Y;
+	}
+
+	// capture the inference pass
+	nn_arch_stepReset(self);
+	nn_engine_captureBegin(engine, cmds);
+
+	nn_tensor_t* Y;
+	Y = nn_arch_forwardPass(self, NN_ARCH_FLAG_FP_BN_RUNNING,
+	                        bs, X);
+	if((nn_engine_captureEnd(engine) == 0) || (Y == NULL))
+	{
+		goto fail_capture;
+	}
+
+	// collect the activation buffers
+	// the input/output are not aliased and references (e.g.
+	// skip fork or reshape) share the buffer of another
+	// activation
+	uint32_t count = 0;
+	vkk_buffer_t** buffers;
+	buffers = (vkk_buffer_t**)
+	          CALLOC(cc_list_size(self->plan_Y) + 1,
+	                 sizeof(vkk_buffer_t*));
+	if(buffers == NULL)
+	{
+		LOGE("CALLOC failed");
+		goto fail_buffers;
+	}
+
+	uint32_t       i;
+	uint32_t       j;
+	nn_tensor_t*   T;
+	cc_listIter_t* iter = cc_list_head(self->plan_Y);
+	while(iter)
+	{
+		T = (nn_tensor_t*) cc_list_peekIter(iter);
+		iter = cc_list_next(iter);
+
+		if((T->sb_data == NULL)        ||
+		   (T->sb_data == X->sb_data) ||
+		   (T->sb_data == Y->sb_data))
+		{
+			continue;
+		}
+
+		for(i = 0; i < count; ++i)
+		{
+			if(buffers[i] == T->sb_data)
+			{
+				break;
+			}
+		}
+
+		if(i == count)
+		{
+			buffers[count++] = T->sb_data;
+		}
+	}
+
+	uint32_t* first;
+	first = (uint32_t*) CALLOC(count + 1, sizeof(uint32_t));
+	if(first == NULL)
+	{
+		LOGE("CALLOC failed");
+		goto fail_first;
+	}
+
+	uint32_t* last;
+	last = (uint32_t*) CALLOC(count + 1, sizeof(uint32_t));
+	if(last == NULL)
+	{
+		LOGE("CALLOC failed");
+		goto fail_last;
+	}
+
+	nn_archPlan_t* plan;
+	plan = (nn_archPlan_t*)
+	       CALLOC(count + 1, sizeof(nn_archPlan_t));
+	if(plan == NULL)
+	{
+		LOGE("CALLOC failed");
+		goto fail_plan;
+	}
+
+	if(nn_engine_captureLiveness(engine, cmds, count, buffers,
+	                             first, last) == 0)
+	{
+		goto fail_liveness;
+	}
+
+	// assign the activations to buffers in order of first
+	// use where each activation is stored in the smallest
+	// buffer which is dead before the activation is written
+	int c;
+	int best;
+	for(i = 0; i < count; ++i)
+	{
+		plan[i].size = vkk_buffer_size(buffers[i]);
+		plan[i].host = -1;
+
+		// unreferenced buffers are not aliased
+		if(first[i] > last[i])
+		{
+			plan[i].done = 1;
+		}
+	}
+
+	while(1)
+	{
+		c = -1;
+		for(i = 0; i < count; ++i)
+		{
+			if(plan[i].done)
+			{
+				continue;
+			}
+
+			if((c == -1) || (first[i] < first[c]))
+			{
+				c = (int) i;
+			}
+		}
+
+		if(c == -1)
+		{
+			break;
+		}
+
+		best = -1;
+		for(j = 0; j < count; ++j)
+		{
+			if((plan[j].done == 0) || (plan[j].host != -1) ||
+			   (first[j] > last[j])                       ||
+			   (plan[j].tail >= first[c])                 ||
+			   (plan[j].size < plan[c].size))
+			{
+				continue;
+			}
+
+			if((best == -1) || (plan[j].size < plan[best].size))
+			{
+				best = (int) j;
+			}
+		}
+
+		if(best == -1)
+		{
+			plan[c].tail = last[c];
+		}
+		else
+		{
+			plan[c].host    = best;
+			plan[best].tail = last[c];
+		}
+		plan[c].done = 1;
+	}
+
+	// alias the buffers
+	vkk_buffer_t* src;
+	vkk_buffer_t* dst;
+	for(i = 0; i < count; ++i)
+	{
+		if(plan[i].host == -1)
+		{
+			continue;
+		}
+
+		src = buffers[i];
+		dst = buffers[plan[i].host];
+		if(nn_engine_captureAlias(engine, cmds, src, dst) == 0)
+		{
+			goto fail_alias;
+		}
+
+		iter = cc_list_head(self->plan_Y);
+		while(iter)
+		{
+			T = (nn_tensor_t*) cc_list_peekIter(iter);
+			iter = cc_list_next(iter);
+
+			if(T->sb_data != src)
+			{
+				continue;
+			}
+
+			T->sb_data = dst;
+			T->alias   = 1;
+			if(T->us0)
+			{
+				// sb00: dimX
+				// sb01: X
+				vkk_uniformAttachment_t ua0_array[] =
+				{
+					{
+						.binding = 0,
+						.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
+						.buffer  = T->sb_dim,
+					},
+					{
+						.binding = 1,
+						.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
+						.buffer  = T->sb_data,
+					},
+				};
+
+				nn_engine_computeUpdateUniformSetRefs(engine,
+				                                      T->us0, 2,
+				                                      ua0_array);
+			}
+		}
+
+		nn_engine_flushTensorOpUs0(engine, src);
+		vkk_buffer_delete(&src);
+		self->plan_bytes += plan[i].size;
+		self->plan        = 1;
+	}
+
+	FREE(plan);
+	FREE(last);
+	FREE(first);
+	FREE(buffers);
+	nn_engine_captureDiscard(engine, cmds);
+	cc_list_discard(self->plan_Y);
+	cc_list_delete(&self->plan_Y);
+	cc_list_delete(&cmds);
+
+	// success
+	return 1;
+
+	// failure
+	fail_alias:
+	fail_liveness:
+		FREE(plan);
+	fail_plan:
+		FREE(last);
+	fail_last:
+		FREE(first);
+	fail_first:
+		FREE(buffers);
+	fail_buffers:
+	fail_capture:
+		nn_engine_captureDiscard(engine, cmds);
+		cc_list_discard(self->plan_Y);
+		cc_list_delete(&self->plan_Y);
+	fail_plan_Y:
+		cc_list_delete(&cmds);
+	return 0;
+}
+
+void nn_arch_inferenceOnly(nn_arch_t* self)
+{
+	ASSERT(self);
+
+	self->inference = 1;
+}
+
+void nn_arch_fp16(nn_arch_t* self)
+{
+	ASSERT(self);
+
+	self->fp16 = 1;
+}
+
+int nn_arch_freeze(nn_arch_t* self)
+{
+	ASSERT(self);
+
+	// the plan references the batch normalization outputs
+	if(self->plan)
+	{
+		LOGE("invalid");
+		return 0;
+	}
+
+	// the captured step references the removed layers
+	nn_arch_stepReset(self);
+
+	cc_listIter_t* iter = cc_list_head(self->layers);
+	while(iter)
+	{
+		nn_layer_t* layer;
+		layer = (nn_layer_t*) cc_list_peekIter(iter);
+		if(nn_layer_freeze(layer) == 0)
+		{
+			return 0;
+		}
+
+		iter = cc_list_next(iter);
+	}
+
+	// the folded parameters cannot be trained
+	self->inference = 1;
+
+	return 1;
+}
+
+int nn_arch_quantize(nn_arch_t* self)
+{
+	ASSERT(self);
+
+	// the captured step references the FP32 kernels
+	nn_arch_stepReset(self);
+
+	cc_listIter_t* iter = cc_list_head(self->layers);
+	while(iter)
+	{
+		nn_layer_t* layer;
+		layer = (nn_layer_t*) cc_list_peekIter(iter);
+		if(nn_layer_quantize(layer) == 0)
+		{
+			return 0;
+		}
+
+		iter = cc_list_next(iter);
+	}
+
+	// the int8 weights cannot be trained
+	self->inference = 1;
+
+	return 1;
+}
+
+nn_tensorMode_e nn_arch_trainMode(nn_arch_t* self)
+{
+	ASSERT(self);
+
+	if(self->inference)
+	{
+		return NN_TENSOR_MODE_NONE;
+	}
+
+	return NN_TENSOR_MODE_COMPUTE;
+}
+
+nn_tensorMode_e nn_arch_fp16Mode(nn_arch_t* self)
+{
+	ASSERT(self);
+
+	// the CPU backend stores FP32
+	if(self->fp16 && (self->engine->cpu == NULL))
+	{
+		return NN_TENSOR_MODE_COMPUTE_FP16;
+	}
+
+	return NN_TENSOR_MODE_COMPUTE;
+}
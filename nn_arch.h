@@ -28,6 +28,7 @@
 #include "../libcc/cc_list.h"
 #include "../libvkk/vkk.h"
 #include "nn.h"
+#include "nn_tensor.h"
 
 // Flag Usage
 //
@@ -43,15 +44,81 @@
 // which updates running average but uses mini-batch for
 // mean and variance.
 //
+// NN_ARCH_FLAG_FP_CALIBRATE (Forward Pass Calibration)
+// * Track the max(|X|) input range of the conv/weight
+//   layers for nn_arch_quantize
+//
 // NN_ARCH_FLAG_BP_NOP (Backprop No Parameter Update)
 // * Disable beta1t and beta2t Update
 // * Disable Parameter Update
 //
 // NN_ARCH_FLAG_BP_STATS (Backprop Statistics)
 // * Compute and log statistics during backprop
+//
+// Captured Step
+// nn_arch_step performs forwardPass, loss and backprop
+// (e.g. a training step). The commands are recorded on the
+// first step and replayed in a single compute pass on
+// subsequent steps where only the bs/state buffers are
+// updated. The contents of X and Yt may change between
+// steps however the tensors must not be reallocated
+// without calling nn_arch_stepReset. The STATS flags
+// bypass the capture.
+//
+// Memory Planner
+// nn_arch_plan captures an inference pass (e.g.
+// NN_ARCH_FLAG_FP_BN_RUNNING) to compute the lifetime of
+// the activations returned by each layer (including nested
+// layers and skip references) and aliases the buffers of
+// activations whose lifetimes do not overlap. The input X
+// and output Y are never aliased. A planned arch may only
+// perform inference passes with NN_ARCH_FLAG_FP_BN_RUNNING
+// since the activations required by backprop are
+// overwritten. The CPU backend is not affected.
+//
+// Inference Only
+// nn_arch_inferenceOnly must be called before the layers
+// are created or imported. The layers only allocate the
+// forward pass tensors and the optimizer/gradient state is
+// replaced by placeholders (see nn_arch_trainMode). An
+// inference-only arch cannot perform backprop or be
+// exported.
+//
+// Freeze
+// nn_arch_freeze folds the batch normalization layers into
+// the preceding conv/weight layers where the layer
+// ordering allows (e.g. nn_coderLayer without an add skip)
+// and removes them from the forward pass. The running
+// averages are folded so a frozen arch is inference-only
+// and must use NN_ARCH_FLAG_FP_BN_RUNNING. The freeze must
+// be performed before nn_arch_plan.
+//
+// FP16 Batch Norm Storage
+// nn_arch_fp16 must be called before the layers are created
+// or imported and selects FP16 storage for the batch
+// normalization Xhat and dL_dXhat tensors. The Y/dL_dX
+// tensors shared between layers, the parameters and the
+// Adam moments remain FP32 so the loss is not scaled. The
+// CPU backend stores FP32.
+//
+// Quantization
+// nn_arch_quantize performs post-training int8 quantization
+// of the conv/weight layers. The input range of each layer
+// is calibrated by running nn_arch_forwardPass on a
+// representative dataset with NN_ARCH_FLAG_FP_CALIBRATE
+// (typically after nn_arch_freeze). The weights use
+// per-channel scales and the inputs use a per-layer scale
+// where the int8 inputs are requantized from the FP32
+// activations once per layer into a packed buffer before
+// the int8 dot products are accumulated. A quantized arch is
+// inference-only and the layers export the int8 weights in
+// place of the FP32 weights and optimizer state which must
+// be imported into an inference-only arch (e.g.
+// NN_TENSOR_MODE_NONE). Transpose conv layers remain FP32.
 #define NN_ARCH_FLAG_FP_BN_RUNNING 0x0001
 #define NN_ARCH_FLAG_FP_BN_COMPUTE 0x0002
 #define NN_ARCH_FLAG_FP_STATS      0x0004
+#define NN_ARCH_FLAG_FP_CALIBRATE  0x0008
 #define NN_ARCH_FLAG_BP_NOP        0x0010
 #define NN_ARCH_FLAG_BP_STATS      0x0020
 
@@ -87,6 +154,29 @@ typedef struct nn_arch_s
 
 	vkk_buffer_t* sb100_bs;
 	vkk_buffer_t* sb101_state;
+
+	// captured step
+	// the step is recaptured when any of the key parameters
+	// (loss, flags, loss_flags, bs, X, Yt) are changed
+	int          step_captured;
+	nn_loss_t*   step_loss;
+	int          step_flags;
+	int          step_loss_flags;
+	uint32_t     step_bs;
+	nn_tensor_t* step_X;
+	nn_tensor_t* step_Yt;
+	nn_tensor_t* step_dL_dX;
+	cc_list_t*   step_cmds;
+
+	// memory planner
+	// plan_Y records the activations during the planning
+	// pass and plan_bytes is the memory saved by aliasing
+	int        plan;
+	size_t     plan_bytes;
+	cc_list_t* plan_Y;
+
+	int inference;
+	int fp16;
 } nn_arch_t;
 
 nn_arch_t*      nn_arch_new(nn_engine_t* engine,
@@ -111,5 +201,22 @@ nn_tensor_t*    nn_arch_backprop(nn_arch_t* self,
                                  int flags,
                                  uint32_t bs,
                                  nn_tensor_t* dL_dY);
+nn_tensor_t*    nn_arch_step(nn_arch_t* self,
+                             nn_loss_t* loss,
+                             int flags,
+                             int loss_flags,
+                             uint32_t bs,
+                             nn_tensor_t* X,
+                             nn_tensor_t* Yt);
+void            nn_arch_stepReset(nn_arch_t* self);
+int             nn_arch_plan(nn_arch_t* self,
+                             uint32_t bs,
+                             nn_tensor_t* X);
+void            nn_arch_inferenceOnly(nn_arch_t* self);
+void            nn_arch_fp16(nn_arch_t* self);
+int             nn_arch_freeze(nn_arch_t* self);
+int             nn_arch_quantize(nn_arch_t* self);
+nn_tensorMode_e nn_arch_trainMode(nn_arch_t* self);
+nn_tensorMode_e nn_arch_fp16Mode(nn_arch_t* self);
 
 #endif
@@ -30,6 +30,7 @@
 #include "../libcc/cc_log.h"
 #include "../libcc/cc_memory.h"
 #include "nn_arch.h"
+#include "nn_cpu.h"
 #include "nn_engine.h"
 #include "nn_batchNormLayer.h"
 #include "nn_layer.h"
@@ -104,121 +105,60 @@ nn_batchNormLayer_computeFpFn(nn_layer_t* base,
 			.buffer  = Xvar->sb_data,
 		},
 	};
-	vkk_compute_updateUniformSetRefs(engine->compute,
-	                                 self->us1_fp, 5,
-	                                 ua1_array);
+	nn_engine_computeUpdateUniformSetRefs(engine,
+	                                      self->us1_fp, 5,
+	                                      ua1_array);
 
 	vkk_uniformSet_t* us_array[] =
 	{
 		self->us0,
 		self->us1_fp,
-		NULL,
 	};
 
 	// optionally compute mean, variance and
 	// running averages
-	uint32_t k;
-	vkk_computePipeline_t* cp_mean = NULL;
-	vkk_computePipeline_t* cp_var  = NULL;
+	vkk_computePipeline_t* cp_stats = NULL;
 	if(((flags & NN_ARCH_FLAG_FP_BN_RUNNING) == 0) &&
 	   ((flags & NN_ARCH_FLAG_FP_BN_COMPUTE) == 0))
 	{
-		// nn_batchNormLayer_forwardPassXmeanTrain
-		cp_mean = engine->cp_batchNorm_forwardPassXmeanTrain;
-
-		// nn_batchNormLayer_forwardPassXvarTrain
-		cp_var = engine->cp_batchNorm_forwardPassXvarTrain;
+		// nn_batchNormLayer_forwardPassXstatsTrain
+		cp_stats = nn_engine_getPipeline(engine,
+		                                 &engine->cp_batchNorm_forwardPassXstatsTrain);
 	}
 	else if(flags & NN_ARCH_FLAG_FP_BN_COMPUTE)
 	{
-		// nn_batchNormLayer_forwardPassXmeanCompute
-		cp_mean = engine->cp_batchNorm_forwardPassXmeanCompute;
-
-		// nn_batchNormLayer_forwardPassXvarCompute
-		cp_var = engine->cp_batchNorm_forwardPassXvarCompute;
-	}
-
-	if(cp_mean)
-	{
-		// dispatch required for each k
-		// dispatch(RAW, 1, 1, 1, 8, 8, 1)
-		if(nn_engine_computeBind(engine, cp_mean) == 0)
-		{
-			return NULL;
-		}
-
-		for(k = 0; k < xd; ++k)
-		{
-			us_array[2] = nn_engine_getBatchNormUs2(engine, k);
-			if(us_array[2] == NULL)
-			{
-				return NULL;
-			}
-			vkk_compute_bindUniformSets(engine->compute, 3,
-			                            us_array);
-			if(k == 0)
-			{
-				nn_engine_computeDispatch(engine, VKK_HAZARD_RAW,
-				                          1, 1, 1, 8, 8, 1);
-			}
-			else
-			{
-				nn_engine_computeDispatch(engine, VKK_HAZARD_RAW,
-				                          1, 1, 1, 8, 8, 1);
-			}
-		}
+		// nn_batchNormLayer_forwardPassXstatsCompute
+		cp_stats = nn_engine_getPipeline(engine,
+		                                 &engine->cp_batchNorm_forwardPassXstatsCompute);
 	}
 
-	if(cp_var)
+	// the mean and variance of all channels are reduced
+	// in a single pass over X
+	// dispatch(RAW, 64, xd, 1, 64, 1, 1)
+	if(cp_stats)
 	{
-		// dispatch required for each k
-		// dispatch(RAW, 1, 1, 1, 8, 8, 1)
-		if(nn_engine_computeBind(engine, cp_var) == 0)
+		if(nn_engine_computeBind(engine, cp_stats) == 0)
 		{
 			return NULL;
 		}
-
-		for(k = 0; k < xd; ++k)
-		{
-			us_array[2] = nn_engine_getBatchNormUs2(engine, k);
-			if(us_array[2] == NULL)
-			{
-				return NULL;
-			}
-			vkk_compute_bindUniformSets(engine->compute, 3,
-			                            us_array);
-			if(k == 0)
-			{
-				nn_engine_computeDispatch(engine, VKK_HAZARD_RAW,
-				                          1, 1, 1, 8, 8, 1);
-			}
-			else
-			{
-				nn_engine_computeDispatch(engine, VKK_HAZARD_RAW,
-				                          1, 1, 1, 8, 8, 1);
-			}
-		}
+		nn_engine_computeBindUniformSets(engine, 2, us_array);
+		nn_engine_computeDispatch(engine, VKK_HAZARD_RAW,
+		                          64, xd, 1, 64, 1, 1);
 	}
 
-	// nn_batchNormLayer_forwardPassXhat
+	// nn_batchNormLayer_forwardPassXhat (includes Y)
 	// dispatch(RAW, bs, xh, xw, 1, 8, 8)
+	int fp16 = (nn_tensor_mode(self->Xhat) ==
+	            NN_TENSOR_MODE_COMPUTE_FP16);
 	vkk_computePipeline_t* cp;
-	cp = engine->cp_batchNorm_forwardPassXhat;
-	if(nn_engine_computeBind(engine, cp) == 0)
-	{
-		return NULL;
-	}
-	vkk_compute_bindUniformSets(engine->compute, 2, us_array);
-	nn_engine_computeDispatch(engine, VKK_HAZARD_RAW,
-	                          bs, xh, xw, 1, 8, 8);
-
-	// nn_batchNormLayer_forwardPassY
-	// dispatch(RAW, bs, xh, xw, 1, 8, 8)
-	cp = engine->cp_batchNorm_forwardPassY;
+	cp = nn_engine_getPipeline(engine, fp16 ?
+	                           &engine->cp_batchNorm_forwardPassXhatF16 :
+	                           &engine->cp_batchNorm_forwardPassXhat);
 	if(nn_engine_computeBind(engine, cp) == 0)
 	{
 		return NULL;
 	}
+	nn_engine_computeBindUniformSets(engine, 2, us_array);
 	nn_engine_computeDispatch(engine, VKK_HAZARD_RAW,
 	                          bs, xh, xw, 1, 8, 8);
 
@@ -263,76 +203,65 @@ nn_batchNormLayer_computeBpFn(nn_layer_t* base,
 			.buffer  = dL_dY->sb_data,
 		},
 	};
-	vkk_compute_updateUniformSetRefs(engine->compute,
-	                                 self->us1_bp, 3,
-	                                 ua1_array);
+	nn_engine_computeUpdateUniformSetRefs(engine,
+	                                      self->us1_bp, 3,
+	                                      ua1_array);
 
 	vkk_uniformSet_t* us_array[] =
 	{
 		self->us0,
 		self->us1_bp,
-		NULL,
 	};
 
 	// nn_batchNormLayer_backprop_dL_dXhat
 	// dispatch(RAW, bs, xh, xw, 1, 8, 8)
+	int fp16 = (nn_tensor_mode(self->Xhat) ==
+	            NN_TENSOR_MODE_COMPUTE_FP16);
 	vkk_computePipeline_t* cp;
-	cp = engine->cp_batchNorm_backprop_dL_dXhat;
+	cp = nn_engine_getPipeline(engine, fp16 ?
+	                           &engine->cp_batchNorm_backprop_dL_dXhatF16 :
+	                           &engine->cp_batchNorm_backprop_dL_dXhat);
 	if(nn_engine_computeBind(engine, cp) == 0)
 	{
 		return NULL;
 	}
-	vkk_compute_bindUniformSets(engine->compute, 2, us_array);
+	nn_engine_computeBindUniformSets(engine, 2, us_array);
 	nn_engine_computeDispatch(engine, VKK_HAZARD_RAW,
 	                          bs, xh, xw, 1, 8, 8);
 
 	// optionally skip parameter update
 	// nn_batchNormLayer_backpropSum or
 	// nn_batchNormLayer_backpropSumNOP
-	// dispatch required for each k
-	// dispatch(RAW, 1, 1, 1, 8, 8, 1)
-	uint32_t k;
+	// dispatch(RAW, 64, xd, 1, 64, 1, 1)
 	if(flags & NN_ARCH_FLAG_BP_NOP)
 	{
-		cp = engine->cp_batchNorm_backpropSumNOP;
+		cp = nn_engine_getPipeline(engine, fp16 ?
+		                           &engine->cp_batchNorm_backpropSumNOPF16 :
+		                           &engine->cp_batchNorm_backpropSumNOP);
 	}
 	else
 	{
-		cp = engine->cp_batchNorm_backpropSum;
+		cp = nn_engine_getPipeline(engine, fp16 ?
+		                           &engine->cp_batchNorm_backpropSumF16 :
+		                           &engine->cp_batchNorm_backpropSum);
 	}
 	if(nn_engine_computeBind(engine, cp) == 0)
 	{
 		return NULL;
 	}
-
-	for(k = 0; k < xd; ++k)
-	{
-		us_array[2] = nn_engine_getBatchNormUs2(engine, k);
-		if(us_array[2] == NULL)
-		{
-			return NULL;
-		}
-		vkk_compute_bindUniformSets(engine->compute, 3, us_array);
-		if(k == 0)
-		{
-			nn_engine_computeDispatch(engine, VKK_HAZARD_RAW,
-			                          1, 1, 1, 8, 8, 1);
-		}
-		else
-		{
-			nn_engine_computeDispatch(engine, VKK_HAZARD_RAW,
-			                          1, 1, 1, 8, 8, 1);
-		}
-	}
+	nn_engine_computeDispatch(engine, VKK_HAZARD_RAW,
+	                          64, xd, 1, 64, 1, 1);
 
 	// nn_batchNorm_backprop_dL_dX
 	// dispatch(RAW, bs, xh, xw, 1, 8, 8)
-	cp = engine->cp_batchNorm_backprop_dL_dX;
+	cp = nn_engine_getPipeline(engine, fp16 ?
+	                           &engine->cp_batchNorm_backprop_dL_dXF16 :
+	                           &engine->cp_batchNorm_backprop_dL_dX);
 	if(nn_engine_computeBind(engine, cp) == 0)
 	{
 		return NULL;
 	}
-	vkk_compute_bindUniformSets(engine->compute, 2, us_array);
+	nn_engine_computeBindUniformSets(engine, 2, us_array);
 	nn_engine_computeDispatch(engine, VKK_HAZARD_RAW,
 	                          bs, xh, xw, 1, 8, 8);
 
@@ -340,101 +269,324 @@ nn_batchNormLayer_computeBpFn(nn_layer_t* base,
 	return dL_dY;
 }
 
-static nn_dim_t*
-nn_batchNormLayer_dimXFn(nn_layer_t* base)
+typedef struct
 {
-	ASSERT(base);
+	nn_batchNormLayer_t* self;
+	nn_tensor_t*         X;
+	nn_tensor_t*         Xmean;
+	nn_tensor_t*         Xvar;
+	nn_tensor_t*         dL_dY;
+	uint32_t             bs;
+	int                  flags;
+} nn_batchNormLayerTask_t;
+
+static void
+nn_batchNormLayer_fpStatsCpuTask(void* priv, uint32_t idx)
+{
+	ASSERT(priv);
 
-	nn_batchNormLayer_t* self = (nn_batchNormLayer_t*) base;
+	nn_batchNormLayerTask_t* task = (nn_batchNormLayerTask_t*) priv;
+	nn_batchNormLayer_t*     self = task->self;
+	nn_archState_t*          state;
+	state = &self->base.arch->state;
 
-	return nn_tensor_dim(self->Xhat);
-}
+	nn_dim_t* dimX = nn_tensor_dim(self->Xhat);
+	uint32_t  n    = task->bs*dimX->height*dimX->width;
+	uint32_t  xd   = dimX->depth;
+	float*    X    = task->X->data;
+	float     M    = (float) n;
+
+	// dispatch(xd)
+	uint32_t k = idx;
+
+	// Welford's single pass mean and variance
+	uint32_t i;
+	float    x;
+	float    dx;
+	float    xmean_mb = 0.0f;
+	float    m2       = 0.0f;
+	for(i = 0; i < n; ++i)
+	{
+		x         = X[i*xd + k];
+		dx        = x - xmean_mb;
+		xmean_mb += dx/((float) (i + 1));
+		m2       += dx*(x - xmean_mb);
+	}
+	float xvar_mb = m2/M;
 
-static nn_dim_t*
-nn_batchNormLayer_dimYFn(nn_layer_t* base)
-{
-	ASSERT(base);
+	self->Xmean_mb->data[k] = xmean_mb;
+	self->Xvar_mb->data[k]  = xvar_mb;
 
-	nn_batchNormLayer_t* self = (nn_batchNormLayer_t*) base;
+	// update running averages
+	if((task->flags & NN_ARCH_FLAG_FP_BN_COMPUTE) == 0)
+	{
+		float momentum = state->bn_momentum;
 
-	return nn_tensor_dim(self->Y);
+		self->Xmean_ra->data[k] = momentum*self->Xmean_ra->data[k] +
+		                          (1.0f - momentum)*xmean_mb;
+		self->Xvar_ra->data[k]  = momentum*self->Xvar_ra->data[k] +
+		                          (1.0f - momentum)*xvar_mb;
+	}
 }
 
-/***********************************************************
-* public                                                   *
-***********************************************************/
+static void
+nn_batchNormLayer_fpCpuTask(void* priv, uint32_t idx)
+{
+	ASSERT(priv);
+
+	nn_batchNormLayerTask_t* task = (nn_batchNormLayerTask_t*) priv;
+	nn_batchNormLayer_t*     self = task->self;
+
+	nn_dim_t* dimX  = nn_tensor_dim(self->Xhat);
+	uint32_t  xw    = dimX->width;
+	uint32_t  xd    = dimX->depth;
+	uint32_t  n     = xw*xd;
+	float*    X     = &task->X->data[idx*n];
+	float*    Xhat  = &self->Xhat->data[idx*n];
+	float*    Y     = &self->Y->data[idx*n];
+	float*    Xmean = task->Xmean->data;
+	float*    Xvar  = task->Xvar->data;
+	float*    G     = self->G->data;
+	float*    B     = self->B->data;
+
+	// dispatch(bs*xh)
+	uint32_t j;
+	uint32_t k;
+	uint32_t i;
+	float    epsilon = 1.192092896e-07;
+	for(j = 0; j < xw; ++j)
+	{
+		for(k = 0; k < xd; ++k)
+		{
+			i       = j*xd + k;
+			Xhat[i] = (X[i] - Xmean[k])/(sqrtf(Xvar[k]) + epsilon);
+			Y[i]    = G[k]*Xhat[i] + B[k];
+		}
+	}
+}
 
-nn_batchNormUs2Data_t*
-nn_batchNormUs2Data_new(nn_engine_t* engine,
-                        nn_batchNormUs2Key_t* key)
+static void
+nn_batchNormLayer_bp_dL_dXhatCpuTask(void* priv, uint32_t idx)
 {
-	ASSERT(engine);
-	ASSERT(key);
+	ASSERT(priv);
 
-	nn_batchNormUs2Data_t* self;
-	self = (nn_batchNormUs2Data_t*)
-	       CALLOC(1, sizeof(nn_batchNormUs2Data_t));
-	if(self == NULL)
+	nn_batchNormLayerTask_t* task = (nn_batchNormLayerTask_t*) priv;
+	nn_batchNormLayer_t*     self = task->self;
+
+	nn_dim_t* dimX     = nn_tensor_dim(self->Xhat);
+	uint32_t  xw       = dimX->width;
+	uint32_t  xd       = dimX->depth;
+	uint32_t  n        = xw*xd;
+	float*    dL_dY    = &task->dL_dY->data[idx*n];
+	float*    dL_dXhat = &self->dL_dXhat->data[idx*n];
+	float*    G        = self->G->data;
+
+	// dispatch(bs*xh)
+	uint32_t j;
+	uint32_t k;
+	for(j = 0; j < xw; ++j)
 	{
-		LOGE("CALLOC failed");
-		return NULL;
+		for(k = 0; k < xd; ++k)
+		{
+			dL_dXhat[j*xd + k] = dL_dY[j*xd + k]*G[k];
+		}
 	}
+}
 
-	self->sb200 = vkk_buffer_new(engine->engine,
-	                             VKK_UPDATE_MODE_STATIC,
-	                             VKK_BUFFER_USAGE_STORAGE,
-	                             sizeof(nn_batchNormUs2Key_t),
-	                             key);
-	if(self->sb200 == NULL)
+static void
+nn_batchNormLayer_bpSumCpuTask(void* priv, uint32_t idx)
+{
+	ASSERT(priv);
+
+	nn_batchNormLayerTask_t* task = (nn_batchNormLayerTask_t*) priv;
+	nn_batchNormLayer_t*     self = task->self;
+
+	nn_dim_t* dimX     = nn_tensor_dim(self->Xhat);
+	uint32_t  n        = task->bs*dimX->height*dimX->width;
+	uint32_t  xd       = dimX->depth;
+	float*    dL_dY    = task->dL_dY->data;
+	float*    Xhat     = self->Xhat->data;
+	float*    dL_dXhat = self->dL_dXhat->data;
+
+	// dispatch(xd)
+	uint32_t k = idx;
+
+	uint32_t i;
+	float    dl_dg = 0.0f;
+	float    dl_db = 0.0f;
+	float    bsum  = 0.0f;
+	float    csum  = 0.0f;
+	for(i = 0; i < n; ++i)
 	{
-		goto fail_sb200;
+		dl_dg += dL_dY[i*xd + k]*Xhat[i*xd + k];
+		dl_db += dL_dY[i*xd + k];
+		bsum  += dL_dXhat[i*xd + k];
+		csum  += dL_dXhat[i*xd + k]*Xhat[i*xd + k];
 	}
+	self->Bsum->data[k] = bsum;
+	self->Csum->data[k] = csum;
 
-	self->us2 = vkk_uniformSet_new(engine->engine, 2, 0, NULL,
-	                               engine->usf2_batchNorm);
-	if(self->us2 == NULL)
+	// optionally skip parameter update
+	if(task->flags & NN_ARCH_FLAG_BP_NOP)
 	{
-		goto fail_us2;
+		return;
 	}
 
-	vkk_uniformAttachment_t ua2_array[] =
+	nn_archState_t* state = &self->base.arch->state;
+	nn_cpu_adam(state, &self->G->data[k],
+	            &self->MG->data[k], &self->VG->data[k],
+	            &dl_dg, 1);
+	nn_cpu_adam(state, &self->B->data[k],
+	            &self->MB->data[k], &self->VB->data[k],
+	            &dl_db, 1);
+}
+
+static void
+nn_batchNormLayer_bp_dL_dXCpuTask(void* priv, uint32_t idx)
+{
+	ASSERT(priv);
+
+	nn_batchNormLayerTask_t* task = (nn_batchNormLayerTask_t*) priv;
+	nn_batchNormLayer_t*     self = task->self;
+
+	nn_dim_t* dimX     = nn_tensor_dim(self->Xhat);
+	uint32_t  xw       = dimX->width;
+	uint32_t  xd       = dimX->depth;
+	uint32_t  n        = xw*xd;
+	float*    dL_dX    = &task->dL_dY->data[idx*n];
+	float*    Xhat     = &self->Xhat->data[idx*n];
+	float*    dL_dXhat = &self->dL_dXhat->data[idx*n];
+	float*    Xvar     = self->Xvar_mb->data;
+	float*    Bsum     = self->Bsum->data;
+	float*    Csum     = self->Csum->data;
+	float     M        = (float) (task->bs*dimX->height*xw);
+
+	// dispatch(bs*xh)
+	uint32_t j;
+	uint32_t k;
+	uint32_t i;
+	float    epsilon = 1.192092896e-07;
+	for(j = 0; j < xw; ++j)
 	{
+		for(k = 0; k < xd; ++k)
 		{
-			.binding = 0,
-			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
-			.buffer  = self->sb200,
-		},
+			i        = j*xd + k;
+			dL_dX[i] = (M*dL_dXhat[i] - Bsum[k] - Xhat[i]*Csum[k])/
+			           (M*sqrtf(Xvar[k] + epsilon));
+		}
+	}
+}
+
+static nn_tensor_t*
+nn_batchNormLayer_computeFpCpuFn(nn_layer_t* base,
+                                 int flags, uint32_t bs,
+                                 nn_tensor_t* X)
+{
+	ASSERT(base);
+	ASSERT(X);
+
+	nn_batchNormLayer_t* self   = (nn_batchNormLayer_t*) base;
+	nn_arch_t*           arch   = base->arch;
+	nn_engine_t*         engine = arch->engine;
+
+	nn_dim_t* dimX = nn_tensor_dim(self->Xhat);
+
+	// stats used by forward pass
+	nn_tensor_t* Xmean = self->Xmean_mb;
+	nn_tensor_t* Xvar  = self->Xvar_mb;
+	if((flags & NN_ARCH_FLAG_FP_BN_RUNNING) &&
+	   (flags & NN_ARCH_FLAG_FP_BN_COMPUTE))
+	{
+		LOGE("invalid flags=%i", flags);
+		return NULL;
+	}
+	else if(flags & NN_ARCH_FLAG_FP_BN_RUNNING)
+	{
+		Xmean = self->Xmean_ra;
+		Xvar  = self->Xvar_ra;
+	}
+
+	nn_batchNormLayerTask_t task =
+	{
+		.self  = self,
+		.X     = X,
+		.Xmean = Xmean,
+		.Xvar  = Xvar,
+		.bs    = bs,
+		.flags = flags,
 	};
 
-	vkk_compute_updateUniformSetRefs(engine->compute,
-	                                 self->us2, 1,
-	                                 ua2_array);
+	// optionally compute mean, variance and
+	// running averages
+	if((flags & NN_ARCH_FLAG_FP_BN_RUNNING) == 0)
+	{
+		nn_cpu_run(engine->cpu, nn_batchNormLayer_fpStatsCpuTask,
+		           &task, dimX->depth);
+	}
 
-	// success
-	return self;
+	nn_cpu_run(engine->cpu, nn_batchNormLayer_fpCpuTask,
+	           &task, bs*dimX->height);
 
-	// failure
-	fail_us2:
-		vkk_buffer_delete(&self->sb200);
-	fail_sb200:
-		FREE(self);
-	return NULL;
+	return self->Y;
 }
 
-void nn_batchNormUs2Data_delete(nn_batchNormUs2Data_t** _self)
+static nn_tensor_t*
+nn_batchNormLayer_computeBpCpuFn(nn_layer_t* base,
+                                 int flags, uint32_t bs,
+                                 nn_tensor_t* dL_dY)
 {
-	ASSERT(_self);
+	ASSERT(base);
+	ASSERT(dL_dY); // dim(bs,xh,xw,xd)
 
-	nn_batchNormUs2Data_t* self = *_self;
-	if(self)
+	nn_batchNormLayer_t* self   = (nn_batchNormLayer_t*) base;
+	nn_arch_t*           arch   = base->arch;
+	nn_engine_t*         engine = arch->engine;
+
+	nn_dim_t* dimX = nn_tensor_dim(self->Xhat);
+
+	nn_batchNormLayerTask_t task =
 	{
-		vkk_uniformSet_delete(&self->us2);
-		vkk_buffer_delete(&self->sb200);
-		FREE(self);
-		*_self = NULL;
-	}
+		.self  = self,
+		.dL_dY = dL_dY,
+		.bs    = bs,
+		.flags = flags,
+	};
+
+	nn_cpu_run(engine->cpu, nn_batchNormLayer_bp_dL_dXhatCpuTask,
+	           &task, bs*dimX->height);
+	nn_cpu_run(engine->cpu, nn_batchNormLayer_bpSumCpuTask,
+	           &task, dimX->depth);
+	nn_cpu_run(engine->cpu, nn_batchNormLayer_bp_dL_dXCpuTask,
+	           &task, bs*dimX->height);
+
+	// dL_dY replaced by dL_dX
+	return dL_dY;
+}
+
+static nn_dim_t*
+nn_batchNormLayer_dimXFn(nn_layer_t* base)
+{
+	ASSERT(base);
+
+	nn_batchNormLayer_t* self = (nn_batchNormLayer_t*) base;
+
+	return nn_tensor_dim(self->Xhat);
 }
 
+static nn_dim_t*
+nn_batchNormLayer_dimYFn(nn_layer_t* base)
+{
+	ASSERT(base);
+
+	nn_batchNormLayer_t* self = (nn_batchNormLayer_t*) base;
+
+	return nn_tensor_dim(self->Y);
+}
+
+/***********************************************************
+* public                                                   *
+***********************************************************/
+
 nn_batchNormLayer_t*
 nn_batchNormLayer_new(nn_arch_t* arch, nn_dim_t* dimX)
 {
@@ -462,6 +614,12 @@ nn_batchNormLayer_new(nn_arch_t* arch, nn_dim_t* dimX)
 		.dimY_fn       = nn_batchNormLayer_dimYFn,
 	};
 
+	if(engine->cpu)
+	{
+		info.compute_fp_fn = nn_batchNormLayer_computeFpCpuFn;
+		info.compute_bp_fn = nn_batchNormLayer_computeBpCpuFn;
+	}
+
 	nn_batchNormLayer_t* self;
 	self = (nn_batchNormLayer_t*)
 	       nn_layer_new(sizeof(nn_batchNormLayer_t), &info);
@@ -509,7 +667,7 @@ nn_batchNormLayer_new(nn_arch_t* arch, nn_dim_t* dimX)
 
 	self->Xhat = nn_tensor_new(engine, dimX,
 	                           NN_TENSOR_INIT_ZERO,
-	                           NN_TENSOR_MODE_COMPUTE);
+	                           nn_arch_fp16Mode(arch));
 	if(self->Xhat == NULL)
 	{
 		goto fail_Xhat;
@@ -523,9 +681,12 @@ nn_batchNormLayer_new(nn_arch_t* arch, nn_dim_t* dimX)
 		goto fail_Y;
 	}
 
+	// optimizer state
+	nn_tensorMode_e mode = nn_arch_trainMode(arch);
+
 	self->MG = nn_tensor_new(engine, &dim_111d,
 	                         NN_TENSOR_INIT_ZERO,
-	                         NN_TENSOR_MODE_COMPUTE);
+	                         mode);
 	if(self->MG == NULL)
 	{
 		goto fail_MG;
@@ -533,7 +694,7 @@ nn_batchNormLayer_new(nn_arch_t* arch, nn_dim_t* dimX)
 
 	self->VG = nn_tensor_new(engine, &dim_111d,
 	                         NN_TENSOR_INIT_ZERO,
-	                         NN_TENSOR_MODE_COMPUTE);
+	                         mode);
 	if(self->VG == NULL)
 	{
 		goto fail_VG;
@@ -541,7 +702,7 @@ nn_batchNormLayer_new(nn_arch_t* arch, nn_dim_t* dimX)
 
 	self->MB = nn_tensor_new(engine, &dim_111d,
 	                         NN_TENSOR_INIT_ZERO,
-	                         NN_TENSOR_MODE_COMPUTE);
+	                         mode);
 	if(self->MB == NULL)
 	{
 		goto fail_MB;
@@ -549,7 +710,7 @@ nn_batchNormLayer_new(nn_arch_t* arch, nn_dim_t* dimX)
 
 	self->VB = nn_tensor_new(engine, &dim_111d,
 	                         NN_TENSOR_INIT_ZERO,
-	                         NN_TENSOR_MODE_COMPUTE);
+	                         mode);
 	if(self->VB == NULL)
 	{
 		goto fail_VB;
@@ -587,9 +748,16 @@ nn_batchNormLayer_new(nn_arch_t* arch, nn_dim_t* dimX)
 		goto fail_Xvar_ra;
 	}
 
+	// dL_dXhat matches the Xhat storage when training
+	nn_tensorMode_e mode_dL_dXhat = mode;
+	if(mode != NN_TENSOR_MODE_NONE)
+	{
+		mode_dL_dXhat = nn_tensor_mode(self->Xhat);
+	}
+
 	self->dL_dXhat = nn_tensor_new(engine, dimX,
 	                               NN_TENSOR_INIT_ZERO,
-	                               NN_TENSOR_MODE_COMPUTE);
+	                               mode_dL_dXhat);
 	if(self->dL_dXhat == NULL)
 	{
 		goto fail_dL_dXhat;
@@ -597,7 +765,7 @@ nn_batchNormLayer_new(nn_arch_t* arch, nn_dim_t* dimX)
 
 	self->Bsum = nn_tensor_new(engine, &dim_111d,
 	                           NN_TENSOR_INIT_ZERO,
-	                           NN_TENSOR_MODE_COMPUTE);
+	                           mode);
 	if(self->Bsum == NULL)
 	{
 		goto fail_Bsum;
@@ -605,12 +773,19 @@ nn_batchNormLayer_new(nn_arch_t* arch, nn_dim_t* dimX)
 
 	self->Csum = nn_tensor_new(engine, &dim_111d,
 	                           NN_TENSOR_INIT_ZERO,
-	                           NN_TENSOR_MODE_COMPUTE);
+	                           mode);
 	if(self->Csum == NULL)
 	{
 		goto fail_Csum;
 	}
 
+	// the CPU backend does not require uniform sets
+	if(engine->cpu)
+	{
+		nn_tensor_delete(&tmpG);
+		return self;
+	}
+
 	self->us0 = vkk_uniformSet_new(engine->engine, 0, 0, NULL,
 	                               engine->usf0_batchNorm);
 	if(self->us0 == NULL)
@@ -731,9 +906,9 @@ nn_batchNormLayer_new(nn_arch_t* arch, nn_dim_t* dimX)
 			.buffer  = self->Csum->sb_data,
 		},
 	};
-	vkk_compute_updateUniformSetRefs(engine->compute,
-	                                 self->us0, 16,
-	                                 ua0_array);
+	nn_engine_computeUpdateUniformSetRefs(engine,
+	                                      self->us0, 16,
+	                                      ua0_array);
 
 	nn_tensor_delete(&tmpG);
 
@@ -964,3 +1139,124 @@ int nn_batchNormLayer_export(nn_batchNormLayer_t* self,
 
 	return ret;
 }
+
+int nn_batchNormLayer_fold(nn_batchNormLayer_t* self,
+                           nn_tensor_t* W, nn_tensor_t* B)
+{
+	ASSERT(self);
+	ASSERT(W);
+	ASSERT(B);
+
+	nn_arch_t*   arch   = self->base.arch;
+	nn_engine_t* engine = arch->engine;
+
+	nn_dim_t* dimG = nn_tensor_dim(self->G);
+	nn_dim_t* dimW = nn_tensor_dim(W);
+	nn_dim_t* dimB = nn_tensor_dim(B);
+	uint32_t  xd   = dimG->depth;
+	if((dimW->count != xd) || (dimB->count != xd))
+	{
+		LOGE("invalid count=%u:%u:%u",
+		     dimW->count, dimB->count, xd);
+		return 0;
+	}
+
+	// G, B, Xmean_ra and Xvar_ra
+	nn_dim_t dimP =
+	{
+		.count  = 4,
+		.height = 1,
+		.width  = 1,
+		.depth  = xd,
+	};
+
+	nn_tensor_t* P;
+	P = nn_tensor_new(engine, &dimP, NN_TENSOR_INIT_ZERO,
+	                  NN_TENSOR_MODE_IO);
+	if(P == NULL)
+	{
+		return 0;
+	}
+
+	nn_tensor_t* W_io;
+	W_io = nn_tensor_new(engine, dimW, NN_TENSOR_INIT_ZERO,
+	                     NN_TENSOR_MODE_IO);
+	if(W_io == NULL)
+	{
+		goto fail_W_io;
+	}
+
+	nn_tensor_t* B_io;
+	B_io = nn_tensor_new(engine, dimB, NN_TENSOR_INIT_ZERO,
+	                     NN_TENSOR_MODE_IO);
+	if(B_io == NULL)
+	{
+		goto fail_B_io;
+	}
+
+	if((nn_tensor_copy(self->G,        P, 0, 0, 1)  == 0) ||
+	   (nn_tensor_copy(self->B,        P, 0, 1, 1)  == 0) ||
+	   (nn_tensor_copy(self->Xmean_ra, P, 0, 2, 1)  == 0) ||
+	   (nn_tensor_copy(self->Xvar_ra,  P, 0, 3, 1)  == 0) ||
+	   (nn_tensor_copy(W, W_io, 0, 0, dimW->count) == 0) ||
+	   (nn_tensor_copy(B, B_io, 0, 0, dimB->count) == 0))
+	{
+		goto fail_copy;
+	}
+
+	// Y = gamma*(X - mean)/(sqrt(var) + epsilon) + beta
+	//   = s*(W*X + B) + beta - s*mean
+	// s = gamma/(sqrt(var) + epsilon)
+	float    epsilon = 1.192092896e-07;
+	float    s;
+	float    w;
+	float    b;
+	uint32_t n;
+	uint32_t i;
+	uint32_t j;
+	uint32_t k;
+	for(n = 0; n < xd; ++n)
+	{
+		s = nn_tensor_ioGet(P, 0, 0, 0, n)/
+		    (sqrtf(nn_tensor_ioGet(P, 3, 0, 0, n)) + epsilon);
+
+		for(i = 0; i < dimW->height; ++i)
+		{
+			for(j = 0; j < dimW->width; ++j)
+			{
+				for(k = 0; k < dimW->depth; ++k)
+				{
+					w = nn_tensor_ioGet(W_io, n, i, j, k);
+					nn_tensor_ioSet(W_io, n, i, j, k, s*w);
+				}
+			}
+		}
+
+		b = nn_tensor_ioGet(B_io, n, 0, 0, 0);
+		b = s*(b - nn_tensor_ioGet(P, 2, 0, 0, n)) +
+		    nn_tensor_ioGet(P, 1, 0, 0, n);
+		nn_tensor_ioSet(B_io, n, 0, 0, 0, b);
+	}
+
+	if((nn_tensor_copy(W_io, W, 0, 0, dimW->count) == 0) ||
+	   (nn_tensor_copy(B_io, B, 0, 0, dimB->count) == 0))
+	{
+		goto fail_copy;
+	}
+
+	nn_tensor_delete(&B_io);
+	nn_tensor_delete(&W_io);
+	nn_tensor_delete(&P);
+
+	// success
+	return 1;
+
+	// failure
+	fail_copy:
+		nn_tensor_delete(&B_io);
+	fail_B_io:
+		nn_tensor_delete(&W_io);
+	fail_W_io:
+		nn_tensor_delete(&P);
+	return 0;
+}
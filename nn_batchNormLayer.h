@@ -29,21 +29,6 @@
 #include "../libvkk/vkk.h"
 #include "nn_layer.h"
 
-typedef struct nn_batchNormUs2Key_s
-{
-	uint32_t k;
-} nn_batchNormUs2Key_t;
-
-typedef struct nn_batchNormUs2Data_s
-{
-	vkk_buffer_t*     sb200;
-	vkk_uniformSet_t* us2;
-} nn_batchNormUs2Data_t;
-
-nn_batchNormUs2Data_t* nn_batchNormUs2Data_new(nn_engine_t* engine,
-                                               nn_batchNormUs2Key_t* key);
-void                   nn_batchNormUs2Data_delete(nn_batchNormUs2Data_t** _self);
-
 typedef struct nn_batchNormLayer_s
 {
 	nn_layer_t base;
@@ -90,4 +75,11 @@ nn_batchNormLayer_t* nn_batchNormLayer_import(nn_arch_t* arch,
 int                  nn_batchNormLayer_export(nn_batchNormLayer_t* self,
                                               cc_jsmnStream_t* stream);
 
+// fold the running mean/variance and gamma/beta into the
+// weights and bias of a preceding layer where W is
+// dim(xd,fh,fw,c) and B is dim(xd,1,1,1)
+int                  nn_batchNormLayer_fold(nn_batchNormLayer_t* self,
+                                            nn_tensor_t* W,
+                                            nn_tensor_t* B);
+
 #endif
@@ -33,6 +33,7 @@
 #include "nn_convLayer.h"
 #include "nn_dim.h"
 #include "nn_factLayer.h"
+#include "nn_groupNormLayer.h"
 #include "nn_skipLayer.h"
 #include "nn_tensor.h"
 
@@ -81,8 +82,17 @@ nn_coderLayer_computeFpFn(nn_layer_t* base,
 			return NULL;
 		}
 	}
+	else if(self->gn)
+	{
+		X = nn_layer_computeFp(&self->gn->base,
+		                       flags, bs, X);
+		if(X == NULL)
+		{
+			return NULL;
+		}
+	}
 
-	if(self->fact)
+	if(self->fact && (self->fuse_fact == 0))
 	{
 		X = nn_layer_computeFp(&self->fact->base,
 		                       flags, bs, X);
@@ -129,7 +139,7 @@ nn_coderLayer_computeBpFn(nn_layer_t* base,
 		}
 	}
 
-	if(self->fact)
+	if(self->fact && (self->fuse_fact == 0))
 	{
 		dL_dY = nn_layer_computeBp(&self->fact->base,
 		                           flags, bs, dL_dY);
@@ -148,6 +158,15 @@ nn_coderLayer_computeBpFn(nn_layer_t* base,
 			return NULL;
 		}
 	}
+	else if(self->gn)
+	{
+		dL_dY = nn_layer_computeBp(&self->gn->base,
+		                           flags, bs, dL_dY);
+		if(dL_dY == NULL)
+		{
+			return NULL;
+		}
+	}
 
 	if(self->skip &&
 	   ((self->skip->skip_mode == NN_SKIP_MODE_FORK_ADD) ||
@@ -197,12 +216,104 @@ nn_coderLayer_postFn(nn_layer_t* base,
 		nn_layer_post(&self->bn->base, flags, bs);
 	}
 
+	if(self->gn)
+	{
+		nn_layer_post(&self->gn->base, flags, bs);
+	}
+
 	if(self->fact)
 	{
 		nn_layer_post(&self->fact->base, flags, bs);
 	}
 }
 
+static uint32_t
+nn_coderLayer_groups(nn_coderBatchNormMode_e bn_mode,
+                     uint32_t xd)
+{
+	if(bn_mode == NN_CODER_BATCH_NORM_MODE_LAYER)
+	{
+		return 1;
+	}
+	else if(bn_mode == NN_CODER_BATCH_NORM_MODE_INSTANCE)
+	{
+		return xd;
+	}
+
+	// the group count must divide xd
+	uint32_t groups = (xd < 32) ? xd : 32;
+	while(xd%groups)
+	{
+		--groups;
+	}
+	return groups;
+}
+
+static int
+nn_coderLayer_fuseFact(nn_coderLayer_t* self)
+{
+	ASSERT(self);
+
+	// the activation must directly follow the conv
+	if((self->conv == NULL) || (self->fact == NULL) ||
+	   self->bn || self->gn || self->fuse_fact ||
+	   (self->skip &&
+	    ((self->skip->skip_mode == NN_SKIP_MODE_FORK_ADD) ||
+	     (self->skip->skip_mode == NN_SKIP_MODE_ADD))))
+	{
+		return 1;
+	}
+
+	if(nn_convLayer_fuseFact(self->conv, self->fact->fn) == 0)
+	{
+		return 0;
+	}
+	self->fuse_fact = 1;
+
+	return 1;
+}
+
+static int
+nn_coderLayer_freezeFn(nn_layer_t* base)
+{
+	ASSERT(base);
+
+	nn_coderLayer_t* self = (nn_coderLayer_t*) base;
+
+	// the add skip consumes the conv output directly
+	if((self->conv == NULL) || (self->bn == NULL) ||
+	   (self->skip &&
+	    ((self->skip->skip_mode == NN_SKIP_MODE_FORK_ADD) ||
+	     (self->skip->skip_mode == NN_SKIP_MODE_ADD))))
+	{
+		return 1;
+	}
+
+	if(nn_convLayer_foldBatchNorm(self->conv, self->bn) == 0)
+	{
+		return 0;
+	}
+
+	nn_batchNormLayer_delete(&self->bn);
+
+	return nn_coderLayer_fuseFact(self);
+}
+
+static int
+nn_coderLayer_quantizeFn(nn_layer_t* base)
+{
+	ASSERT(base);
+
+	nn_coderLayer_t* self = (nn_coderLayer_t*) base;
+
+	if(self->conv == NULL)
+	{
+		return 1;
+	}
+
+	return nn_layer_quantize(&self->conv->base);
+}
+
 static nn_dim_t*
 nn_coderLayer_dimXFn(nn_layer_t* base)
 {
@@ -240,6 +351,8 @@ nn_coderLayer_new(nn_coderLayerInfo_t* info)
 		.post_fn       = nn_coderLayer_postFn,
 		.dimX_fn       = nn_coderLayer_dimXFn,
 		.dimY_fn       = nn_coderLayer_dimYFn,
+		.freeze_fn     = nn_coderLayer_freezeFn,
+		.quantize_fn   = nn_coderLayer_quantizeFn,
 	};
 
 	nn_coderLayer_t* self;
@@ -257,6 +370,10 @@ nn_coderLayer_new(nn_coderLayerInfo_t* info)
 	if(info->conv_size)
 	{
 		uint32_t xd = dim->depth;
+		if(info->conv_groups > 1)
+		{
+			xd /= info->conv_groups;
+		}
 
 		nn_dim_t dimW =
 		{
@@ -281,8 +398,15 @@ nn_coderLayer_new(nn_coderLayerInfo_t* info)
 		}
 		flags |= info->conv_flags;
 
+		uint32_t dilation = info->conv_dilation;
+		if(dilation == 0)
+		{
+			dilation = 1;
+		}
+
 		self->conv = nn_convLayer_new(info->arch, dim, &dimW,
-		                              info->conv_stride, flags);
+		                              info->conv_stride,
+		                              dilation, flags);
 		if(self->conv == NULL)
 		{
 			goto fail_conv;
@@ -316,12 +440,24 @@ nn_coderLayer_new(nn_coderLayerInfo_t* info)
 		dim = nn_layer_dimY(&self->skip->base);
 	}
 
-	if(info->bn_mode)
+	if(info->bn_mode == NN_CODER_BATCH_NORM_MODE_ENABLE)
 	{
 		self->bn = nn_batchNormLayer_new(info->arch, dim);
 		if(self->bn == NULL)
 		{
-			goto fail_bn;
+			goto fail_norm;
+		}
+	}
+	else if(info->bn_mode)
+	{
+		uint32_t groups;
+		groups   = nn_coderLayer_groups(info->bn_mode,
+		                                dim->depth);
+		self->gn = nn_groupNormLayer_new(info->arch, dim,
+		                                 groups);
+		if(self->gn == NULL)
+		{
+			goto fail_norm;
 		}
 	}
 
@@ -362,15 +498,22 @@ nn_coderLayer_new(nn_coderLayerInfo_t* info)
 
 	nn_dim_copy(dim, &self->dimY);
 
+	if(nn_coderLayer_fuseFact(self) == 0)
+	{
+		goto fail_fuse;
+	}
+
 	// success
 	return self;
 
 	// failure
+	fail_fuse:
 	fail_skip_cat:
 		nn_factLayer_delete(&self->fact);
 	fail_fact:
+		nn_groupNormLayer_delete(&self->gn);
 		nn_batchNormLayer_delete(&self->bn);
-	fail_bn:
+	fail_norm:
 		nn_skipLayer_delete(&self->skip);
 	fail_skip_add:
 		nn_convLayer_delete(&self->conv);
@@ -387,6 +530,7 @@ void nn_coderLayer_delete(nn_coderLayer_t** _self)
 	if(self)
 	{
 		nn_factLayer_delete(&self->fact);
+		nn_groupNormLayer_delete(&self->gn);
 		nn_batchNormLayer_delete(&self->bn);
 		nn_skipLayer_delete(&self->skip);
 		nn_convLayer_delete(&self->conv);
@@ -413,6 +557,7 @@ nn_coderLayer_import(nn_arch_t* arch, cc_jsmnVal_t* val,
 	cc_jsmnVal_t* val_conv = NULL;
 	cc_jsmnVal_t* val_skip = NULL;
 	cc_jsmnVal_t* val_bn   = NULL;
+	cc_jsmnVal_t* val_gn   = NULL;
 	cc_jsmnVal_t* val_fact = NULL;
 
 	cc_listIter_t* iter = cc_list_head(val->obj->list);
@@ -443,6 +588,10 @@ nn_coderLayer_import(nn_arch_t* arch, cc_jsmnVal_t* val,
 			{
 				val_bn = kv->val;
 			}
+			else if(strcmp(kv->key, "gn") == 0)
+			{
+				val_gn = kv->val;
+			}
 			else if(strcmp(kv->key, "fact") == 0)
 			{
 				val_fact = kv->val;
@@ -468,6 +617,8 @@ nn_coderLayer_import(nn_arch_t* arch, cc_jsmnVal_t* val,
 		.post_fn       = nn_coderLayer_postFn,
 		.dimX_fn       = nn_coderLayer_dimXFn,
 		.dimY_fn       = nn_coderLayer_dimYFn,
+		.freeze_fn     = nn_coderLayer_freezeFn,
+		.quantize_fn   = nn_coderLayer_quantizeFn,
 	};
 
 	nn_coderLayer_t*  self;
@@ -519,7 +670,15 @@ nn_coderLayer_import(nn_arch_t* arch, cc_jsmnVal_t* val,
 		self->bn = nn_batchNormLayer_import(arch, val_bn);
 		if(self->bn == NULL)
 		{
-			goto fail_bn;
+			goto fail_norm;
+		}
+	}
+	else if(val_gn)
+	{
+		self->gn = nn_groupNormLayer_import(arch, val_gn);
+		if(self->gn == NULL)
+		{
+			goto fail_norm;
 		}
 	}
 
@@ -532,13 +691,21 @@ nn_coderLayer_import(nn_arch_t* arch, cc_jsmnVal_t* val,
 		}
 	}
 
+	if(nn_coderLayer_fuseFact(self) == 0)
+	{
+		goto fail_fuse;
+	}
+
 	// success
 	return self;
 
 	// failure
+	fail_fuse:
+		nn_factLayer_delete(&self->fact);
 	fail_fact:
+		nn_groupNormLayer_delete(&self->gn);
 		nn_batchNormLayer_delete(&self->bn);
-	fail_bn:
+	fail_norm:
 		nn_skipLayer_delete(&self->skip);
 	fail_skip:
 		nn_convLayer_delete(&self->conv);
@@ -580,6 +747,12 @@ int nn_coderLayer_export(nn_coderLayer_t* self,
 		ret &= nn_batchNormLayer_export(self->bn, stream);
 	}
 
+	if(self->gn)
+	{
+		ret &= cc_jsmnStream_key(stream, "%s", "gn");
+		ret &= nn_groupNormLayer_export(self->gn, stream);
+	}
+
 	if(self->fact)
 	{
 		ret &= cc_jsmnStream_key(stream, "%s", "fact");
@@ -42,10 +42,19 @@ typedef enum
 
 #define NN_CODER_SKIP_MODE_COUNT 5
 
+// GROUP, LAYER and INSTANCE select a group normalization
+// layer which does not depend on the batch size (e.g. for
+// training or inference at batch size 1)
+// GROUP:    groups is the largest divisor of xd <= 32
+// LAYER:    groups is 1
+// INSTANCE: groups is xd
 typedef enum
 {
-	NN_CODER_BATCH_NORM_MODE_DISABLE = 0,
-	NN_CODER_BATCH_NORM_MODE_ENABLE  = 1,
+	NN_CODER_BATCH_NORM_MODE_DISABLE  = 0,
+	NN_CODER_BATCH_NORM_MODE_ENABLE   = 1,
+	NN_CODER_BATCH_NORM_MODE_GROUP    = 2,
+	NN_CODER_BATCH_NORM_MODE_LAYER    = 3,
+	NN_CODER_BATCH_NORM_MODE_INSTANCE = 4,
 } nn_coderBatchNormMode_e;
 
 typedef struct nn_coderLayerInfo_s
@@ -60,13 +69,21 @@ typedef struct nn_coderLayerInfo_s
 	uint32_t conv_size;
 	uint32_t conv_stride;
 
+	// dilated convolution (optional)
+	// 0 or 1 disables dilation
+	uint32_t conv_dilation;
+
+	// grouped convolution (optional)
+	// 0 or 1 is a dense conv and xd is a depthwise conv
+	uint32_t conv_groups;
+
 	// skip layer
 	// skip_coder must be set for add/cat modes
 	nn_coderSkipMode_e skip_mode;
 	nn_coderLayer_t*   skip_coder;
 	float              skip_beta;
 
-	// bn layer
+	// bn or gn layer
 	nn_coderBatchNormMode_e bn_mode;
 
 	// fact layer
@@ -116,7 +133,12 @@ typedef struct nn_coderLayer_s
 	nn_convLayer_t*      conv;
 	nn_skipLayer_t*      skip;
 	nn_batchNormLayer_t* bn;
+	nn_groupNormLayer_t* gn;
 	nn_factLayer_t*      fact;
+
+	// fact is fused with conv when it directly follows
+	// conv (see nn_convLayer_fuseFact)
+	int fuse_fact;
 } nn_coderLayer_t;
 
 nn_coderLayer_t* nn_coderLayer_new(nn_coderLayerInfo_t* info);
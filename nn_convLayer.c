@@ -30,9 +30,12 @@
 #include "../libcc/cc_memory.h"
 #include "../libvkk/vkk.h"
 #include "nn_arch.h"
+#include "nn_batchNormLayer.h"
 #include "nn_convLayer.h"
+#include "nn_cpu.h"
 #include "nn_engine.h"
 #include "nn_layer.h"
+#include "nn_tensorQ8.h"
 #include "nn_tensorStats.h"
 #include "nn_tensor.h"
 
@@ -44,174 +47,274 @@ typedef struct
 {
 	uint32_t disable_bias;
 	uint32_t stride;
+	uint32_t fact_fn;
+	uint32_t dilation;
 } nn_convLayerParam_t;
 
-static nn_tensor_t*
-nn_convLayer_computeFpFn(nn_layer_t* base,
-                         int flags, uint32_t bs,
-                         nn_tensor_t* X)
+// tiled forward pass limits
+// see nn_convLayer_forwardPassTile*.comp
+#define NN_CONV_LAYER_TILE_F  16
+#define NN_CONV_LAYER_TILE_FH 5
+#define NN_CONV_LAYER_TILE_FW 5
+#define NN_CONV_LAYER_TILE_S  2
+
+// im2col + GEMM selection
+// the col buffer is dim(bs*yh*yw, fh*fw*xd) so the GEMM is
+// only selected when the filters are large enough to
+// amortize the im2col pass and the buffer is bounded
+#define NN_CONV_LAYER_GEMM_MIN_FC 32
+#define NN_CONV_LAYER_GEMM_MIN_K  64
+#define NN_CONV_LAYER_GEMM_MAX    (64*1024*1024)
+
+static int
+nn_convLayer_useGemm(nn_dim_t* dimX, nn_dim_t* dimW,
+                     nn_dim_t* dimY, uint32_t stride,
+                     int flags)
 {
-	ASSERT(base);
-	ASSERT(X);
+	ASSERT(dimX);
+	ASSERT(dimW);
+	ASSERT(dimY);
+
+	uint32_t k = dimW->height*dimW->width*dimW->depth;
+	size_t   size;
+	size = ((size_t) dimY->count)*dimY->height*dimY->width*
+	       k*sizeof(float);
+	if((dimW->depth != dimX->depth) ||
+	   (dimW->count < NN_CONV_LAYER_GEMM_MIN_FC) ||
+	   (k < NN_CONV_LAYER_GEMM_MIN_K) ||
+	   (size > NN_CONV_LAYER_GEMM_MAX))
+	{
+		return 0;
+	}
 
-	nn_convLayer_t* self   = (nn_convLayer_t*) base;
-	nn_arch_t*      arch   = base->arch;
-	nn_engine_t*    engine = arch->engine;
+	// the transpose im2col matches the direct kernels when
+	// each output pixel maps to a unique input pixel per
+	// filter element
+	if((flags & NN_CONV_LAYER_FLAG_TRANSPOSE) &&
+	   ((stride != 2) || (dimW->height > 4) ||
+	    (dimW->width > 4)))
+	{
+		return 0;
+	}
 
-	nn_dim_t* dimY = nn_tensor_dim(self->Y);
+	return 1;
+}
 
-	// optionally perform Spectral Normalization
-	if(self->flags & NN_CONV_LAYER_FLAG_NORM_SN)
+// split-K dL_dW/dL_dB selection
+// the number of splits is bounded by the rows available
+// and by the size of the dL_dW partial sums
+#define NN_CONV_LAYER_SPLIT_MAX  64
+#define NN_CONV_LAYER_SPLIT_ROWS 4
+#define NN_CONV_LAYER_SPLIT_SIZE (16*1024*1024)
+
+// Winograd F(2x2,3x3) selection
+// the transforms are amortized over the channels so the
+// GEMM formulation is only selected for wide layers
+#define NN_CONV_LAYER_WINOGRAD_MIN_C 16
+#define NN_CONV_LAYER_WINOGRAD_MAX   (64*1024*1024)
+
+static int
+nn_convLayer_useWinograd(nn_dim_t* dimX, nn_dim_t* dimW,
+                         uint32_t stride, uint32_t dilation,
+                         int flags)
+{
+	ASSERT(dimX);
+	ASSERT(dimW);
+
+	if((flags & NN_CONV_LAYER_FLAG_TRANSPOSE) ||
+	   (dimW->height != 3) || (dimW->width != 3) ||
+	   (dimW->depth != dimX->depth) || (stride != 1) ||
+	   (dilation != 1))
 	{
-		if(nn_tensor_computeNormalize(self->W,
-		                              VKK_HAZARD_RAW,
-		                              NN_TENSOR_NORM_SN,
-		                              1.0f) == 0)
-		{
-			return NULL;
-		}
+		return 0;
 	}
-	else if(self->flags & NN_CONV_LAYER_FLAG_NORM_BSSN)
-	{
-		if(nn_tensor_computeNormalize(self->W,
-		                              VKK_HAZARD_RAW,
-		                              NN_TENSOR_NORM_BSSN,
-		                              1.2f) == 0)
-		{
-			return NULL;
-		}
+
+	uint32_t fc = dimW->count;
+	uint32_t xd = dimX->depth;
+	uint32_t c  = (fc > xd) ? fc : xd;
+	uint32_t th = (dimX->height + 1)/2;
+	uint32_t tw = (dimX->width + 1)/2;
+	size_t   size;
+	size = 16*((size_t) dimX->count)*th*tw*c*sizeof(float);
+	if((fc < NN_CONV_LAYER_WINOGRAD_MIN_C) ||
+	   (xd < NN_CONV_LAYER_WINOGRAD_MIN_C) ||
+	   (size > NN_CONV_LAYER_WINOGRAD_MAX))
+	{
+		return 0;
 	}
 
-	// sb100: bs
-	// sb101: state
-	// sb102: X
-	vkk_uniformAttachment_t ua1_array[] =
-	{
-		{
-			.binding = 0,
-			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
-			.buffer  = arch->sb100_bs,
-		},
-		{
-			.binding = 1,
-			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
-			.buffer  = arch->sb101_state,
-		},
-		{
-			.binding = 2,
-			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
-			.buffer  = X->sb_data,
-		},
-	};
+	return 1;
+}
+
+static int
+nn_convLayer_im2col(nn_convLayer_t* self, uint32_t bs,
+                    nn_tensor_t* X, int pad)
+{
+	ASSERT(self);
+	ASSERT(X);
 
-	vkk_compute_updateUniformSetRefs(engine->compute,
-	                                 self->us1_fp, 3,
-	                                 ua1_array);
+	nn_arch_t*   arch   = self->base.arch;
+	nn_engine_t* engine = arch->engine;
+	nn_dim_t*    dimY   = nn_tensor_dim(self->Y);
 
 	vkk_uniformSet_t* us_array[] =
 	{
 		self->us0,
 		self->us1_fp,
+		self->us2_col,
 	};
 
-	// nn_convLayer_forwardPass
+	// nn_convLayer_im2col
 	// dispatch(RAW, bs, yh, yw, 1, 8, 8)
 	vkk_computePipeline_t* cp;
-	cp = engine->cp_conv_forwardPassClamp;
-	if(self->flags & NN_CONV_LAYER_FLAG_MODE_PAD)
+	if(self->flags & NN_CONV_LAYER_FLAG_TRANSPOSE)
+	{
+		if(pad)
+		{
+			cp = nn_engine_getPipeline(engine,
+			                           &engine->cp_conv_im2colTPad);
+		}
+		else
+		{
+			cp = nn_engine_getPipeline(engine,
+			                           &engine->cp_conv_im2colTClamp);
+		}
+	}
+	else
 	{
-		cp = engine->cp_conv_forwardPassPad;
+		if(pad)
+		{
+			cp = nn_engine_getPipeline(engine,
+			                           &engine->cp_conv_im2colPad);
+		}
+		else
+		{
+			cp = nn_engine_getPipeline(engine,
+			                           &engine->cp_conv_im2colClamp);
+		}
 	}
 	if(nn_engine_computeBind(engine, cp) == 0)
 	{
-		return NULL;
+		return 0;
 	}
-	vkk_compute_bindUniformSets(engine->compute, 2, us_array);
+	nn_engine_computeBindUniformSets(engine, 3, us_array);
+	nn_engine_computeAccess(engine, 1, &X->sb_data,
+	                        1, &self->sb200_col);
 	nn_engine_computeDispatch(engine, VKK_HAZARD_RAW,
 	                          bs, dimY->height, dimY->width,
 	                          1, 8, 8);
 
-	// optionally compute stats
-	if(flags & NN_ARCH_FLAG_FP_STATS)
+	return 1;
+}
+
+static nn_tensor_t*
+nn_convLayer_computeFpGemm(nn_convLayer_t* self,
+                           uint32_t bs, nn_tensor_t* X)
+{
+	ASSERT(self);
+	ASSERT(X);
+
+	nn_arch_t* arch = self->base.arch;
+
+	int pad = (self->flags & NN_CONV_LAYER_FLAG_MODE_PAD) ? 1 : 0;
+	if(nn_convLayer_im2col(self, bs, X, pad) == 0)
 	{
-		if(nn_tensor_computeStats(self->Y, VKK_HAZARD_RAW, bs,
-		                          self->stats_Y) == 0)
-		{
-			return NULL;
-		}
+		return NULL;
 	}
 
-	// store reference
-	self->X = X;
+	// Y = col*W^T + B
+	vkk_buffer_t* sb_B = NULL;
+	if((self->flags & NN_CONV_LAYER_FLAG_DISABLE_BIAS) == 0)
+	{
+		sb_B = self->B->sb_data;
+	}
+
+	if(nn_tensorGemm_compute(self->gemm_Y, VKK_HAZARD_RAW, bs,
+	                         arch->sb100_bs, self->sb200_col,
+	                         self->W->sb_data, sb_B,
+	                         self->Y->sb_data) == 0)
+	{
+		return NULL;
+	}
 
 	return self->Y;
 }
 
-static nn_tensor_t*
-nn_convLayer_computeBpFn(nn_layer_t* base,
-                         int flags, uint32_t bs,
-                         nn_tensor_t* dL_dY)
+static int
+nn_convLayer_computeBpGemm(nn_convLayer_t* self,
+                           int flags, uint32_t bs,
+                           nn_tensor_t* dL_dY)
 {
-	ASSERT(base);
-	ASSERT(dL_dY); // dim(bs,yh,yw,fc)
-
-	nn_convLayer_t* self   = (nn_convLayer_t*) base;
-	nn_arch_t*      arch   = base->arch;
-	nn_engine_t*    engine = arch->engine;
+	ASSERT(self);
+	ASSERT(dL_dY);
 
-	nn_dim_t* dimW = nn_tensor_dim(self->W);
-	nn_dim_t* dimX = nn_tensor_dim(self->dL_dX);
-	uint32_t  fc   = dimW->count;
-	uint32_t  fh   = dimW->height;
-	uint32_t  fw   = dimW->width;
+	nn_arch_t*   arch   = self->base.arch;
+	nn_engine_t* engine = arch->engine;
+	nn_dim_t*    dimX   = nn_tensor_dim(self->dL_dX);
 
-	// sb100: bs
-	// sb101: state
-	// sb102: X
-	// sb103: dL_dY
-	vkk_uniformAttachment_t ua1_array[] =
+	// dL_dW is computed with zero padding in both modes to
+	// match the direct kernels so the clamped col computed
+	// by the forward pass must be replaced
+	if((self->flags & NN_CONV_LAYER_FLAG_MODE_PAD) == 0)
 	{
+		if(nn_convLayer_im2col(self, bs, self->X, 1) == 0)
 		{
-			.binding = 0,
-			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
-			.buffer  = arch->sb100_bs,
-		},
-		{
-			.binding = 1,
-			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
-			.buffer  = arch->sb101_state,
-		},
-		{
-			.binding = 2,
-			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
-			.buffer  = self->X->sb_data,
-		},
-		{
-			.binding = 3,
-			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
-			.buffer  = dL_dY->sb_data,
-		},
-	};
+			return 0;
+		}
+	}
+
+	// dL_dY is scaled by dY_dZ on load for the fused
+	// activation (see NN_TENSOR_GEMM_FLAG_DFACT_A)
+
+	// dL_dW = dL_dY^T*col
+	if(nn_tensorGemm_computeDfactA(self->gemm_dL_dW,
+	                               VKK_HAZARD_RAW, bs,
+	                               arch->sb100_bs, dL_dY->sb_data,
+	                               self->Y->sb_data,
+	                               self->sb200_col,
+	                               self->dL_dW->sb_data) == 0)
+	{
+		return 0;
+	}
 
-	vkk_compute_updateUniformSetRefs(engine->compute,
-	                                 self->us1_bp, 4,
-	                                 ua1_array);
+	// col = dL_dY*W
+	if(nn_tensorGemm_computeDfactA(self->gemm_dL_dX,
+	                               VKK_HAZARD_RAW, bs,
+	                               arch->sb100_bs, dL_dY->sb_data,
+	                               self->Y->sb_data,
+	                               self->W->sb_data,
+	                               self->sb200_col) == 0)
+	{
+		return 0;
+	}
 
 	vkk_uniformSet_t* us_array[] =
 	{
 		self->us0,
-		self->us1_bp,
+		self->us1_fp,
+		self->us2_col,
 	};
 
-	// nn_convLayer_backprop_dL_dX
+	// nn_convLayer_col2im
 	// dispatch(RAW, bs, xh, xw, 1, 8, 8)
 	vkk_computePipeline_t* cp;
-	cp = engine->cp_conv_backprop_dL_dX;
+	if(self->flags & NN_CONV_LAYER_FLAG_TRANSPOSE)
+	{
+		cp = nn_engine_getPipeline(engine,
+		                           &engine->cp_conv_col2imT);
+	}
+	else
+	{
+		cp = nn_engine_getPipeline(engine,
+		                           &engine->cp_conv_col2im);
+	}
 	if(nn_engine_computeBind(engine, cp) == 0)
 	{
-		return NULL;
+		return 0;
 	}
-	vkk_compute_bindUniformSets(engine->compute, 2, us_array);
+	nn_engine_computeBindUniformSets(engine, 3, us_array);
+	nn_engine_computeAccess(engine, 1, &self->sb200_col,
+	                        1, &self->dL_dX->sb_data);
 	nn_engine_computeDispatch(engine, VKK_HAZARD_RAW,
 	                          bs, dimX->height, dimX->width,
 	                          1, 8, 8);
@@ -222,239 +325,233 @@ nn_convLayer_computeBpFn(nn_layer_t* base,
 		if(nn_tensor_computeStats(self->dL_dX, VKK_HAZARD_RAW, bs,
 		                          self->stats_dL_dX) == 0)
 		{
-			return NULL;
+			return 0;
 		}
 	}
 
-	// nn_convLayer_backprop_dL_dW
+	return 1;
+}
+
+static int
+nn_convLayer_computeWinogradW(nn_convLayer_t* self)
+{
+	ASSERT(self);
+
+	nn_arch_t*   arch   = self->base.arch;
+	nn_engine_t* engine = arch->engine;
+	nn_dim_t*    dimW   = nn_tensor_dim(self->W);
+
+	vkk_uniformSet_t* us_array[] =
+	{
+		self->us0,
+		self->us1_fp,
+		self->us2_wg,
+	};
+
+	// nn_convLayer_winogradW
 	// dispatch(RAW, fc, xd, 1, 8, 8, 1)
-	cp = engine->cp_conv_backprop_dL_dW;
+	vkk_computePipeline_t* cp;
+	cp = nn_engine_getPipeline(engine,
+	                           &engine->cp_conv_winogradW);
 	if(nn_engine_computeBind(engine, cp) == 0)
 	{
-		return NULL;
+		return 0;
 	}
-	vkk_compute_bindUniformSets(engine->compute, 2, us_array);
+	nn_engine_computeBindUniformSets(engine, 3, us_array);
+	nn_engine_computeAccess(engine, 1, &self->W->sb_data,
+	                        1, &self->sb200_U);
 	nn_engine_computeDispatch(engine, VKK_HAZARD_RAW,
-	                          dimW->count, dimX->depth, 1,
+	                          dimW->count, dimW->depth, 1,
 	                          8, 8, 1);
 
-	// nn_convLayer_backprop_dL_dB
-	// dispatch(RAW, fc, 1, 1, 64, 1, 1)
-	if((self->flags & NN_CONV_LAYER_FLAG_DISABLE_BIAS) == 0)
+	// nn_convLayer_winogradWT
+	// dispatch(RAW, fc, xd, 1, 8, 8, 1)
+	if(self->sb201_UT)
 	{
-		cp = engine->cp_conv_backprop_dL_dB;
+		cp = nn_engine_getPipeline(engine,
+		                           &engine->cp_conv_winogradWT);
 		if(nn_engine_computeBind(engine, cp) == 0)
 		{
-			return NULL;
+			return 0;
 		}
-		vkk_compute_bindUniformSets(engine->compute, 2, us_array);
+		nn_engine_computeBindUniformSets(engine, 3, us_array);
+		nn_engine_computeAccess(engine, 1, &self->W->sb_data,
+		                        1, &self->sb201_UT);
 		nn_engine_computeDispatch(engine, VKK_HAZARD_RAW,
-		                          dimW->count, 1, 1,
-		                          64, 1, 1);
+		                          dimW->count, dimW->depth, 1,
+		                          8, 8, 1);
 	}
 
-	// optionally skip parameter update
-	if(flags & NN_ARCH_FLAG_BP_NOP)
-	{
-		return self->dL_dX;
-	}
+	self->wg_dirty = 0;
 
-	// nn_convLayer_backpropUpdateW
-	// dispatch(RAW, fc, fh, fw, 4, 4, 4)
-	cp = engine->cp_conv_backpropUpdateW;
-	if(nn_engine_computeBind(engine, cp) == 0)
-	{
-		return NULL;
-	}
-	vkk_compute_bindUniformSets(engine->compute, 2, us_array);
-	nn_engine_computeDispatch(engine, VKK_HAZARD_RAW,
-	                          fc, fh, fw, 4, 4, 4);
+	return 1;
+}
 
-	// nn_convLayer_backpropUpdateB
-	// dispatch(RAW, fc, 1, 1, 64, 1, 1)
-	if((self->flags & NN_CONV_LAYER_FLAG_DISABLE_BIAS) == 0)
+static int
+nn_convLayer_updateWinogradW(nn_convLayer_t* self)
+{
+	ASSERT(self);
+
+	// the transform is recorded with every update of W so
+	// that a replayed step (see nn_arch_step) never depends
+	// on the host wg_dirty flag
+	if(self->gemm_wg_Y == NULL)
 	{
-		cp = engine->cp_conv_backpropUpdateB;
-		if(nn_engine_computeBind(engine, cp) == 0)
-		{
-			return NULL;
-		}
-		nn_engine_computeDispatch(engine, VKK_HAZARD_RAW,
-		                          fc, 1, 1, 64, 1, 1);
+		return 1;
 	}
 
-	return self->dL_dX;
+	return nn_convLayer_computeWinogradW(self);
 }
 
 static nn_tensor_t*
-nn_convLayer_computeFpTFn(nn_layer_t* base,
-                          int flags, uint32_t bs,
-                          nn_tensor_t* X)
+nn_convLayer_computeFpWinograd(nn_convLayer_t* self,
+                               uint32_t bs, nn_tensor_t* X)
 {
-	ASSERT(base);
+	ASSERT(self);
 	ASSERT(X);
 
-	nn_convLayer_t* self   = (nn_convLayer_t*) base;
-	nn_arch_t*      arch   = base->arch;
-	nn_engine_t*    engine = arch->engine;
-
-	nn_dim_t* dimY = nn_tensor_dim(self->Y);
+	nn_arch_t*   arch   = self->base.arch;
+	nn_engine_t* engine = arch->engine;
+	nn_dim_t*    dimY   = nn_tensor_dim(self->Y);
+	uint32_t     th     = (dimY->height + 1)/2;
+	uint32_t     tw     = (dimY->width + 1)/2;
 
-	// optionally perform Spectral Normalization
-	if(self->flags & NN_CONV_LAYER_FLAG_NORM_SN)
+	// the transformed filters are recomputed here after
+	// W is changed by the host or normalized by the forward
+	// pass (the Adam update records its own transform)
+	if(self->wg_dirty)
 	{
-		if(nn_tensor_computeNormalize(self->W,
-		                              VKK_HAZARD_RAW,
-		                              NN_TENSOR_NORM_SN,
-		                              1.0f) == 0)
+		if(nn_convLayer_computeWinogradW(self) == 0)
 		{
 			return NULL;
 		}
 	}
-	else if(self->flags & NN_CONV_LAYER_FLAG_NORM_BSSN)
+
+	vkk_uniformSet_t* us_array[] =
 	{
-		if(nn_tensor_computeNormalize(self->W,
-		                              VKK_HAZARD_RAW,
-		                              NN_TENSOR_NORM_BSSN,
-		                              1.2f) == 0)
-		{
-			return NULL;
-		}
-	}
+		self->us0,
+		self->us1_fp,
+		self->us2_wg,
+	};
 
-	// sb100: bs
-	// sb101: state
-	// sb102: X
-	vkk_uniformAttachment_t ua1_array[] =
+	// nn_convLayer_winogradX
+	// dispatch(RAW, bs, th, tw, 1, 8, 8)
+	vkk_computePipeline_t* cp;
+	if(self->flags & NN_CONV_LAYER_FLAG_MODE_PAD)
 	{
-		{
-			.binding = 0,
-			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
-			.buffer  = arch->sb100_bs,
-		},
-		{
-			.binding = 1,
-			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
-			.buffer  = arch->sb101_state,
-		},
-		{
-			.binding = 2,
-			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
-			.buffer  = X->sb_data,
-		},
-	};
-
-	vkk_compute_updateUniformSetRefs(engine->compute,
-	                                 self->us1_fp, 3,
-	                                 ua1_array);
-
-	vkk_uniformSet_t* us_array[] =
-	{
-		self->us0,
-		self->us1_fp,
-	};
-
-	// nn_convLayer_forwardPassT
-	// dispatch(RAW, bs, yh, yw, 1, 8, 8)
-	vkk_computePipeline_t* cp;
-	cp = engine->cp_conv_forwardPassTClamp;
-	if(self->flags & NN_CONV_LAYER_FLAG_MODE_PAD)
+		cp = nn_engine_getPipeline(engine,
+		                           &engine->cp_conv_winogradXPad);
+	}
+	else
 	{
-		cp = engine->cp_conv_forwardPassTPad;
+		cp = nn_engine_getPipeline(engine,
+		                           &engine->cp_conv_winogradXClamp);
 	}
 	if(nn_engine_computeBind(engine, cp) == 0)
 	{
 		return NULL;
 	}
-	vkk_compute_bindUniformSets(engine->compute, 2, us_array);
+	nn_engine_computeBindUniformSets(engine, 3, us_array);
+	nn_engine_computeAccess(engine, 1, &X->sb_data,
+	                        1, &self->sb202_V);
 	nn_engine_computeDispatch(engine, VKK_HAZARD_RAW,
-	                          bs, dimY->height, dimY->width,
-	                          1, 8, 8);
+	                          bs, th, tw, 1, 8, 8);
 
-	// optionally compute stats
-	if(flags & NN_ARCH_FLAG_FP_STATS)
+	// M[e] = V[e]*U[e]^T
+	if(nn_tensorGemm_compute(self->gemm_wg_Y, VKK_HAZARD_RAW,
+	                         bs, arch->sb100_bs,
+	                         self->sb202_V, self->sb200_U,
+	                         NULL, self->sb203_M) == 0)
 	{
-		if(nn_tensor_computeStats(self->Y, VKK_HAZARD_RAW, bs,
-		                          self->stats_Y) == 0)
-		{
-			return NULL;
-		}
+		return NULL;
 	}
 
-	// store reference
-	self->X = X;
+	// nn_convLayer_winogradY
+	// dispatch(RAW, bs, th, tw, 1, 8, 8)
+	cp = nn_engine_getPipeline(engine,
+	                           &engine->cp_conv_winogradY);
+	if(nn_engine_computeBind(engine, cp) == 0)
+	{
+		return NULL;
+	}
+	nn_engine_computeBindUniformSets(engine, 3, us_array);
+	vkk_buffer_t* read_Y[] =
+	{
+		self->sb203_M,
+		self->B->sb_data,
+	};
+	nn_engine_computeAccess(engine, 2, read_Y,
+	                        1, &self->Y->sb_data);
+	nn_engine_computeDispatch(engine, VKK_HAZARD_RAW,
+	                          bs, th, tw, 1, 8, 8);
 
 	return self->Y;
 }
 
-static nn_tensor_t*
-nn_convLayer_computeBpTFn(nn_layer_t* base,
-                          int flags, uint32_t bs,
-                          nn_tensor_t* dL_dY)
+static int
+nn_convLayer_computeBpWinograd(nn_convLayer_t* self,
+                               int flags, uint32_t bs,
+                               nn_tensor_t* dL_dY)
 {
-	ASSERT(base);
-	ASSERT(dL_dY); // dim(bs,yh,yw,fc)
-
-	nn_convLayer_t* self   = (nn_convLayer_t*) base;
-	nn_arch_t*      arch   = base->arch;
-	nn_engine_t*    engine = arch->engine;
-
-	nn_dim_t* dimW = nn_tensor_dim(self->W);
-	nn_dim_t* dimX = nn_tensor_dim(self->dL_dX);
-	uint32_t  fc   = dimW->count;
-	uint32_t  fh   = dimW->height;
-	uint32_t  fw   = dimW->width;
-
-	// sb100: bs
-	// sb101: state
-	// sb102: X
-	// sb103: dL_dY
-	vkk_uniformAttachment_t ua1_array[] =
-	{
-		{
-			.binding = 0,
-			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
-			.buffer  = arch->sb100_bs,
-		},
-		{
-			.binding = 1,
-			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
-			.buffer  = arch->sb101_state,
-		},
-		{
-			.binding = 2,
-			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
-			.buffer  = self->X->sb_data,
-		},
-		{
-			.binding = 3,
-			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
-			.buffer  = dL_dY->sb_data,
-		},
-	};
+	ASSERT(self);
+	ASSERT(dL_dY);
 
-	vkk_compute_updateUniformSetRefs(engine->compute,
-	                                 self->us1_bp, 4,
-	                                 ua1_array);
+	nn_arch_t*   arch   = self->base.arch;
+	nn_engine_t* engine = arch->engine;
+	nn_dim_t*    dimX   = nn_tensor_dim(self->dL_dX);
+	uint32_t     th     = (dimX->height + 1)/2;
+	uint32_t     tw     = (dimX->width + 1)/2;
 
 	vkk_uniformSet_t* us_array[] =
 	{
 		self->us0,
 		self->us1_bp,
+		self->us2_wg,
 	};
 
-	// nn_convLayerT_backprop_dL_dX
-	// dispatch(RAW, bs, xh, xw, 1, 8, 8)
+	// nn_convLayer_winograd_dL_dY
+	// dispatch(RAW, bs, th, tw, 1, 8, 8)
 	vkk_computePipeline_t* cp;
-	cp = engine->cp_conv_backpropT_dL_dX;
+	cp = nn_engine_getPipeline(engine,
+	                           &engine->cp_conv_winograd_dL_dY);
 	if(nn_engine_computeBind(engine, cp) == 0)
 	{
-		return NULL;
+		return 0;
 	}
-	vkk_compute_bindUniformSets(engine->compute, 2, us_array);
+	nn_engine_computeBindUniformSets(engine, 3, us_array);
+	vkk_buffer_t* read_V[] =
+	{
+		dL_dY->sb_data,
+		self->Y->sb_data,
+	};
+	nn_engine_computeAccess(engine, 2, read_V,
+	                        1, &self->sb202_V);
 	nn_engine_computeDispatch(engine, VKK_HAZARD_RAW,
-	                          bs, dimX->height, dimX->width,
-	                          1, 8, 8);
+	                          bs, th, tw, 1, 8, 8);
+
+	// M[e] = V[e]*UT[e]^T
+	if(nn_tensorGemm_compute(self->gemm_wg_dL_dX,
+	                         VKK_HAZARD_RAW, bs,
+	                         arch->sb100_bs, self->sb202_V,
+	                         self->sb201_UT, NULL,
+	                         self->sb203_M) == 0)
+	{
+		return 0;
+	}
+
+	// nn_convLayer_winograd_dL_dX
+	// dispatch(RAW, bs, th, tw, 1, 8, 8)
+	cp = nn_engine_getPipeline(engine,
+	                           &engine->cp_conv_winograd_dL_dX);
+	if(nn_engine_computeBind(engine, cp) == 0)
+	{
+		return 0;
+	}
+	nn_engine_computeBindUniformSets(engine, 3, us_array);
+	nn_engine_computeAccess(engine, 1, &self->sb203_M,
+	                        1, &self->dL_dX->sb_data);
+	nn_engine_computeDispatch(engine, VKK_HAZARD_RAW,
+	                          bs, th, tw, 1, 8, 8);
 
 	// optionally compute stats
 	if(flags & NN_ARCH_FLAG_BP_STATS)
@@ -462,117 +559,2450 @@ nn_convLayer_computeBpTFn(nn_layer_t* base,
 		if(nn_tensor_computeStats(self->dL_dX, VKK_HAZARD_RAW, bs,
 		                          self->stats_dL_dX) == 0)
 		{
-			return NULL;
+			return 0;
 		}
 	}
 
+	return 1;
+}
+
+static int
+nn_convLayer_computeBp_dL_dW(nn_convLayer_t* self,
+                             nn_tensor_t* dL_dY)
+{
+	ASSERT(self);
+	ASSERT(dL_dY);
+
+	nn_arch_t*   arch   = self->base.arch;
+	nn_engine_t* engine = arch->engine;
+	nn_dim_t*    dimW   = nn_tensor_dim(self->W);
+
+	vkk_uniformSet_t* us_array[] =
+	{
+		self->us0,
+		self->us1_bp,
+		self->us2_split,
+	};
+
+	vkk_buffer_t* read_dL_dW[] =
+	{
+		dL_dY->sb_data,
+		self->Y->sb_data,
+		self->X->sb_data,
+	};
+
+	// nn_convLayer_backprop_dL_dW
 	// nn_convLayer_backpropT_dL_dW
 	// dispatch(RAW, fc, xd, 1, 8, 8, 1)
-	cp = engine->cp_conv_backpropT_dL_dW;
+	// the fused variants apply the Adam update to W
+	// rather than storing dL_dW
+	vkk_buffer_t* write_W[] =
+	{
+		self->W->sb_data,
+		self->MW->sb_data,
+		self->VW->sb_data,
+	};
+	vkk_buffer_t** write_dL_dW = &self->dL_dW->sb_data;
+	uint32_t       write_count = 1;
+	if(self->fused)
+	{
+		write_dL_dW = write_W;
+		write_count = 3;
+	}
+
+	vkk_computePipeline_t* cp;
+	if(self->sb200_P_dL_dW == NULL)
+	{
+		if(self->flags & NN_CONV_LAYER_FLAG_TRANSPOSE)
+		{
+			cp = nn_engine_getPipeline(engine,
+			                           self->fused ?
+			                           &engine->cp_conv_backpropT_dL_dWAdam :
+			                           &engine->cp_conv_backpropT_dL_dW);
+		}
+		else
+		{
+			cp = nn_engine_getPipeline(engine,
+			                           self->fused ?
+			                           &engine->cp_conv_backprop_dL_dWAdam :
+			                           &engine->cp_conv_backprop_dL_dW);
+		}
+		if(nn_engine_computeBind(engine, cp) == 0)
+		{
+			return 0;
+		}
+		nn_engine_computeBindUniformSets(engine, 2, us_array);
+		nn_engine_computeAccess(engine, 3, read_dL_dW,
+		                        write_count, write_dL_dW);
+		nn_engine_computeDispatch(engine, VKK_HAZARD_RAW,
+		                          dimW->count, dimW->depth, 1,
+		                          8, 8, 1);
+		return 1;
+	}
+
+	// nn_convLayer_backpropSplit_dL_dW
+	// nn_convLayer_backpropTSplit_dL_dW
+	// dispatch(RAW, fc, xd, split, 8, 8, 1)
+	if(self->flags & NN_CONV_LAYER_FLAG_TRANSPOSE)
+	{
+		cp = nn_engine_getPipeline(engine,
+		                           &engine->cp_conv_backpropTSplit_dL_dW);
+	}
+	else
+	{
+		cp = nn_engine_getPipeline(engine,
+		                           &engine->cp_conv_backpropSplit_dL_dW);
+	}
 	if(nn_engine_computeBind(engine, cp) == 0)
 	{
-		return NULL;
+		return 0;
 	}
-	vkk_compute_bindUniformSets(engine->compute, 2, us_array);
+	nn_engine_computeBindUniformSets(engine, 3, us_array);
+	nn_engine_computeAccess(engine, 3, read_dL_dW,
+	                        1, &self->sb200_P_dL_dW);
 	nn_engine_computeDispatch(engine, VKK_HAZARD_RAW,
-	                          dimW->count, dimX->depth, 1,
-	                          8, 8, 1);
+	                          dimW->count, dimW->depth,
+	                          self->split, 8, 8, 1);
+
+	// nn_convLayer_backpropReduce_dL_dW
+	// dispatch(RAW, fc*fh*fw*xd, 1, 1, 64, 1, 1)
+	cp = nn_engine_getPipeline(engine,
+	                           self->fused ?
+	                           &engine->cp_conv_backpropReduce_dL_dWAdam :
+	                           &engine->cp_conv_backpropReduce_dL_dW);
+	if(nn_engine_computeBind(engine, cp) == 0)
+	{
+		return 0;
+	}
+	nn_engine_computeBindUniformSets(engine, 3, us_array);
+	nn_engine_computeAccess(engine, 1, &self->sb200_P_dL_dW,
+	                        write_count, write_dL_dW);
+	nn_engine_computeDispatch(engine, VKK_HAZARD_RAW,
+	                          nn_dim_sizeElements(dimW), 1, 1,
+	                          64, 1, 1);
+
+	return 1;
+}
+
+static int
+nn_convLayer_computeBp_dL_dB(nn_convLayer_t* self,
+                             nn_tensor_t* dL_dY)
+{
+	ASSERT(self);
+	ASSERT(dL_dY);
+
+	nn_arch_t*   arch   = self->base.arch;
+	nn_engine_t* engine = arch->engine;
+	nn_dim_t*    dimW   = nn_tensor_dim(self->W);
+
+	vkk_uniformSet_t* us_array[] =
+	{
+		self->us0,
+		self->us1_bp,
+		self->us2_split,
+	};
+
+	vkk_buffer_t* write_B[] =
+	{
+		self->B->sb_data,
+		self->MB->sb_data,
+		self->VB->sb_data,
+	};
+	vkk_buffer_t** write_dL_dB = &self->dL_dB->sb_data;
+	uint32_t       write_count = 1;
+	if(self->fused)
+	{
+		write_dL_dB = write_B;
+		write_count = 3;
+	}
+
+	vkk_buffer_t* read_dL_dB[] =
+	{
+		dL_dY->sb_data,
+		self->Y->sb_data,
+	};
 
 	// nn_convLayer_backprop_dL_dB
 	// dispatch(RAW, fc, 1, 1, 64, 1, 1)
-	if((self->flags & NN_CONV_LAYER_FLAG_DISABLE_BIAS) == 0)
+	vkk_computePipeline_t* cp;
+	if(self->us2_split == NULL)
 	{
-		cp = engine->cp_conv_backprop_dL_dB;
+		cp = nn_engine_getPipeline(engine,
+		                           self->fused ?
+		                           &engine->cp_conv_backprop_dL_dBAdam :
+		                           &engine->cp_conv_backprop_dL_dB);
 		if(nn_engine_computeBind(engine, cp) == 0)
 		{
-			return NULL;
+			return 0;
 		}
-		vkk_compute_bindUniformSets(engine->compute, 2, us_array);
+		nn_engine_computeBindUniformSets(engine, 2, us_array);
+		nn_engine_computeAccess(engine, 2, read_dL_dB,
+		                        write_count, write_dL_dB);
 		nn_engine_computeDispatch(engine, VKK_HAZARD_RAW,
 		                          dimW->count, 1, 1,
 		                          64, 1, 1);
+		return 1;
 	}
 
-	// optionally skip parameter update
-	if(flags & NN_ARCH_FLAG_BP_NOP)
+	// nn_convLayer_backpropSplit_dL_dB
+	// dispatch(RAW, fc, split, 1, 64, 1, 1)
+	cp = nn_engine_getPipeline(engine,
+	                           &engine->cp_conv_backpropSplit_dL_dB);
+	if(nn_engine_computeBind(engine, cp) == 0)
 	{
-		return self->dL_dX;
+		return 0;
 	}
+	nn_engine_computeBindUniformSets(engine, 3, us_array);
+	nn_engine_computeAccess(engine, 2, read_dL_dB,
+	                        1, &self->sb201_P_dL_dB);
+	nn_engine_computeDispatch(engine, VKK_HAZARD_RAW,
+	                          dimW->count, self->split, 1,
+	                          64, 1, 1);
 
-	// nn_convLayer_backpropUpdateW
-	// dispatch(RAW, fc, fh, fw, 4, 4, 4)
-	cp = engine->cp_conv_backpropUpdateW;
+	// nn_convLayer_backpropReduce_dL_dB
+	// dispatch(RAW, fc, 1, 1, 64, 1, 1)
+	cp = nn_engine_getPipeline(engine,
+	                           self->fused ?
+	                           &engine->cp_conv_backpropReduce_dL_dBAdam :
+	                           &engine->cp_conv_backpropReduce_dL_dB);
+	if(nn_engine_computeBind(engine, cp) == 0)
+	{
+		return 0;
+	}
+	nn_engine_computeBindUniformSets(engine, 3, us_array);
+	nn_engine_computeAccess(engine, 1, &self->sb201_P_dL_dB,
+	                        write_count, write_dL_dB);
+	nn_engine_computeDispatch(engine, VKK_HAZARD_RAW,
+	                          dimW->count, 1, 1,
+	                          64, 1, 1);
+
+	return 1;
+}
+
+static int
+nn_convLayer_bakeNorm(nn_convLayer_t* self)
+{
+	ASSERT(self);
+
+	nn_arch_t*   arch   = self->base.arch;
+	nn_engine_t* engine = arch->engine;
+
+	// normalize the weights once and disable the per-pass
+	// normalization
+	nn_tensorNorm_e norm = NN_TENSOR_NORM_NONE;
+	float           c    = 1.0f;
+	if(self->flags & NN_CONV_LAYER_FLAG_NORM_SN)
+	{
+		norm = NN_TENSOR_NORM_SN;
+	}
+	else if(self->flags & NN_CONV_LAYER_FLAG_NORM_BSSN)
+	{
+		norm = NN_TENSOR_NORM_BSSN;
+		c    = 1.2f;
+	}
+
+	if(norm == NN_TENSOR_NORM_NONE)
+	{
+		return 1;
+	}
+
+	if(nn_engine_computeBegin(engine) == 0)
+	{
+		return 0;
+	}
+
+	if(nn_tensor_computeNormalize(self->W,
+	                              VKK_HAZARD_RAW,
+	                              norm, c) == 0)
+	{
+		nn_engine_computeEnd(engine);
+		return 0;
+	}
+	nn_engine_computeEnd(engine);
+
+	self->flags &= ~(NN_CONV_LAYER_FLAG_NORM_SN |
+	                 NN_CONV_LAYER_FLAG_NORM_BSSN);
+	self->wg_dirty = 1;
+
+	return 1;
+}
+
+static nn_tensor_t*
+nn_convLayer_computeFpQ8(nn_convLayer_t* self, uint32_t bs)
+{
+	ASSERT(self);
+
+	nn_arch_t*   arch   = self->base.arch;
+	nn_engine_t* engine = arch->engine;
+
+	nn_dim_t*      dimX = nn_tensor_dim(self->dL_dX);
+	nn_dim_t*      dimY = nn_tensor_dim(self->Y);
+	nn_tensorQ8_t* q8   = self->q8;
+
+	vkk_uniformSet_t* us_array[] =
+	{
+		self->us0,
+		self->us1_fp,
+		q8->us2,
+	};
+
+	// requantize X once for all filters
+	// nn_tensorQ8_quantizeX
+	// dispatch(RAW, bs*xh*xw, groups*depth/4, 1, 64, 1, 1)
+	vkk_computePipeline_t* cp;
+	cp = nn_engine_getPipeline(engine,
+	                           &engine->cp_conv_forwardPassQ8X);
 	if(nn_engine_computeBind(engine, cp) == 0)
 	{
 		return NULL;
 	}
-	vkk_compute_bindUniformSets(engine->compute, 2, us_array);
+	nn_engine_computeBindUniformSets(engine, 3, us_array);
 	nn_engine_computeDispatch(engine, VKK_HAZARD_RAW,
-	                          fc, fh, fw, 4, 4, 4);
+	                          bs*dimX->height*dimX->width,
+	                          q8->groups*q8->depth/4, 1,
+	                          64, 1, 1);
 
-	// nn_convLayer_backpropUpdateB
-	// dispatch(RAW, fc, 1, 1, 64, 1, 1)
-	if((self->flags & NN_CONV_LAYER_FLAG_DISABLE_BIAS) == 0)
+	// nn_convLayer_forwardPassQ8
+	// dispatch(RAW, bs, yh, yw, 1, 8, 8)
+	if(self->flags & NN_CONV_LAYER_FLAG_MODE_PAD)
 	{
-		cp = engine->cp_conv_backpropUpdateB;
-		if(nn_engine_computeBind(engine, cp) == 0)
+		cp = nn_engine_getPipeline(engine,
+		                           &engine->cp_conv_forwardPassQ8Pad);
+	}
+	else
+	{
+		cp = nn_engine_getPipeline(engine,
+		                           &engine->cp_conv_forwardPassQ8Clamp);
+	}
+	if(nn_engine_computeBind(engine, cp) == 0)
+	{
+		return NULL;
+	}
+	nn_engine_computeBindUniformSets(engine, 3, us_array);
+	nn_engine_computeDispatch(engine, VKK_HAZARD_RAW,
+	                          bs, dimY->height, dimY->width,
+	                          1, 8, 8);
+
+	return self->Y;
+}
+
+static nn_tensor_t*
+nn_convLayer_computeFpFn(nn_layer_t* base,
+                         int flags, uint32_t bs,
+                         nn_tensor_t* X)
+{
+	ASSERT(base);
+	ASSERT(X);
+
+	nn_convLayer_t* self   = (nn_convLayer_t*) base;
+	nn_arch_t*      arch   = base->arch;
+	nn_engine_t*    engine = arch->engine;
+
+	nn_dim_t* dimY = nn_tensor_dim(self->Y);
+
+	// optionally perform Spectral Normalization
+	if(self->flags & NN_CONV_LAYER_FLAG_NORM_SN)
+	{
+		if(nn_tensor_computeNormalize(self->W,
+		                              VKK_HAZARD_RAW,
+		                              NN_TENSOR_NORM_SN,
+		                              1.0f) == 0)
+		{
+			return NULL;
+		}
+		self->wg_dirty = 1;
+	}
+	else if(self->flags & NN_CONV_LAYER_FLAG_NORM_BSSN)
+	{
+		if(nn_tensor_computeNormalize(self->W,
+		                              VKK_HAZARD_RAW,
+		                              NN_TENSOR_NORM_BSSN,
+		                              1.2f) == 0)
+		{
+			return NULL;
+		}
+		self->wg_dirty = 1;
+	}
+
+	// sb100: bs
+	// sb101: state
+	// sb102: X
+	vkk_uniformAttachment_t ua1_array[] =
+	{
+		{
+			.binding = 0,
+			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
+			.buffer  = arch->sb100_bs,
+		},
+		{
+			.binding = 1,
+			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
+			.buffer  = arch->sb101_state,
+		},
+		{
+			.binding = 2,
+			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
+			.buffer  = X->sb_data,
+		},
+	};
+
+	nn_engine_computeUpdateUniformSetRefs(engine,
+	                                      self->us1_fp, 3,
+	                                      ua1_array);
+
+	vkk_uniformSet_t* us_array[] =
+	{
+		self->us0,
+		self->us1_fp,
+	};
+
+	if(self->q8)
+	{
+		if(nn_convLayer_computeFpQ8(self, bs) == NULL)
+		{
+			return NULL;
+		}
+	}
+	else if(self->gemm_wg_Y)
+	{
+		if(nn_convLayer_computeFpWinograd(self, bs, X) == NULL)
+		{
+			return NULL;
+		}
+	}
+	else if(self->gemm_Y)
+	{
+		if(nn_convLayer_computeFpGemm(self, bs, X) == NULL)
+		{
+			return NULL;
+		}
+	}
+	else
+	{
+		// the tiled kernels stage the input patch and a block of
+		// filters in shared memory which is sized for the
+		// filter/stride limits
+		nn_dim_t* dimW = nn_tensor_dim(self->W);
+		nn_dim_t* dimX = nn_tensor_dim(self->dL_dX);
+		int       tile = 0;
+		if((dimW->depth  == dimX->depth)           &&
+		   (dimW->height <= NN_CONV_LAYER_TILE_FH) &&
+		   (dimW->width  <= NN_CONV_LAYER_TILE_FW) &&
+		   (self->stride <= NN_CONV_LAYER_TILE_S)  &&
+		   (self->dilation == 1))
+		{
+			tile = 1;
+		}
+
+		// nn_convLayer_forwardPass
+		// dispatch(RAW, bs, yh, yw, 1, 8, 8)
+		// nn_convLayer_forwardPassTile
+		// dispatch(RAW, bs*fb, yh, yw, 1, 8, 8)
+		vkk_computePipeline_t* cp;
+		if(tile && (self->flags & NN_CONV_LAYER_FLAG_MODE_PAD))
+		{
+			cp = nn_engine_getPipeline(engine,
+			                           &engine->cp_conv_forwardPassTilePad);
+		}
+		else if(tile)
+		{
+			cp = nn_engine_getPipeline(engine,
+			                           &engine->cp_conv_forwardPassTileClamp);
+		}
+		else if(self->flags & NN_CONV_LAYER_FLAG_MODE_PAD)
+		{
+			cp = nn_engine_getPipeline(engine,
+			                           &engine->cp_conv_forwardPassPad);
+		}
+		else
+		{
+			cp = nn_engine_getPipeline(engine,
+			                           &engine->cp_conv_forwardPassClamp);
+		}
+		if(nn_engine_computeBind(engine, cp) == 0)
+		{
+			return NULL;
+		}
+		nn_engine_computeBindUniformSets(engine, 2, us_array);
+		if(tile)
+		{
+			uint32_t fb = (dimW->count + NN_CONV_LAYER_TILE_F - 1)/
+			              NN_CONV_LAYER_TILE_F;
+			nn_engine_computeDispatch(engine, VKK_HAZARD_RAW,
+			                          bs*fb, dimY->height,
+			                          dimY->width, 1, 8, 8);
+		}
+		else
+		{
+			nn_engine_computeDispatch(engine, VKK_HAZARD_RAW,
+			                          bs, dimY->height, dimY->width,
+			                          1, 8, 8);
+		}
+	}
+
+	// optionally calibrate the int8 input range
+	if(flags & NN_ARCH_FLAG_FP_CALIBRATE)
+	{
+		if(nn_tensor_computeStats(X, VKK_HAZARD_RAW, bs,
+		                          self->stats_X) == 0)
+		{
+			return NULL;
+		}
+	}
+
+	// optionally compute stats
+	if(flags & NN_ARCH_FLAG_FP_STATS)
+	{
+		if(nn_tensor_computeStats(self->Y, VKK_HAZARD_RAW, bs,
+		                          self->stats_Y) == 0)
+		{
+			return NULL;
+		}
+	}
+
+	// store reference
+	self->X = X;
+
+	return self->Y;
+}
+
+static nn_tensor_t*
+nn_convLayer_computeBpFn(nn_layer_t* base,
+                         int flags, uint32_t bs,
+                         nn_tensor_t* dL_dY)
+{
+	ASSERT(base);
+	ASSERT(dL_dY); // dim(bs,yh,yw,fc)
+
+	nn_convLayer_t* self   = (nn_convLayer_t*) base;
+	nn_arch_t*      arch   = base->arch;
+	nn_engine_t*    engine = arch->engine;
+
+	nn_dim_t* dimW = nn_tensor_dim(self->W);
+	nn_dim_t* dimX = nn_tensor_dim(self->dL_dX);
+	uint32_t  fc   = dimW->count;
+	uint32_t  fh   = dimW->height;
+	uint32_t  fw   = dimW->width;
+
+	// sb100: bs
+	// sb101: state
+	// sb102: X
+	// sb103: dL_dY
+	vkk_uniformAttachment_t ua1_array[] =
+	{
+		{
+			.binding = 0,
+			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
+			.buffer  = arch->sb100_bs,
+		},
+		{
+			.binding = 1,
+			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
+			.buffer  = arch->sb101_state,
+		},
+		{
+			.binding = 2,
+			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
+			.buffer  = self->X->sb_data,
+		},
+		{
+			.binding = 3,
+			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
+			.buffer  = dL_dY->sb_data,
+		},
+	};
+
+	nn_engine_computeUpdateUniformSetRefs(engine,
+	                                      self->us1_bp, 4,
+	                                      ua1_array);
+
+	vkk_uniformSet_t* us_array[] =
+	{
+		self->us0,
+		self->us1_bp,
+	};
+
+	// the fused kernels update W and B in place so they are
+	// skipped entirely when the update is skipped
+	int nop_fused = self->fused &&
+	                (flags & NN_ARCH_FLAG_BP_NOP);
+
+	vkk_computePipeline_t* cp;
+	if(self->gemm_Y)
+	{
+		if(nn_convLayer_computeBpGemm(self, flags, bs,
+		                              dL_dY) == 0)
+		{
+			return NULL;
+		}
+	}
+	else
+	{
+		if(self->gemm_wg_dL_dX)
+		{
+			if(nn_convLayer_computeBpWinograd(self, flags, bs,
+			                                  dL_dY) == 0)
+			{
+				return NULL;
+			}
+		}
+		else
+		{
+			// nn_convLayer_backprop_dL_dX
+			// dispatch(RAW, bs, xh, xw, 1, 8, 8)
+			cp = nn_engine_getPipeline(engine,
+			                           &engine->cp_conv_backprop_dL_dX);
+			if(nn_engine_computeBind(engine, cp) == 0)
+			{
+				return NULL;
+			}
+			nn_engine_computeBindUniformSets(engine, 2, us_array);
+			vkk_buffer_t* read_dL_dX[] =
+			{
+				dL_dY->sb_data,
+				self->Y->sb_data,
+				self->W->sb_data,
+			};
+			vkk_buffer_t* write_dL_dX[] =
+			{
+				self->dL_dX->sb_data,
+			};
+			nn_engine_computeAccess(engine, 3, read_dL_dX,
+			                        1, write_dL_dX);
+			nn_engine_computeDispatch(engine, VKK_HAZARD_RAW,
+			                          bs, dimX->height, dimX->width,
+			                          1, 8, 8);
+
+			// optionally compute stats
+			if(flags & NN_ARCH_FLAG_BP_STATS)
+			{
+				if(nn_tensor_computeStats(self->dL_dX, VKK_HAZARD_RAW, bs,
+				                          self->stats_dL_dX) == 0)
+				{
+					return NULL;
+				}
+			}
+		}
+
+		if((nop_fused == 0) &&
+		   (nn_convLayer_computeBp_dL_dW(self, dL_dY) == 0))
+		{
+			return NULL;
+		}
+	}
+
+	if((nop_fused == 0) &&
+	   ((self->flags & NN_CONV_LAYER_FLAG_DISABLE_BIAS) == 0))
+	{
+		if(nn_convLayer_computeBp_dL_dB(self, dL_dY) == 0)
+		{
+			return NULL;
+		}
+	}
+
+	// optionally skip parameter update
+	if(flags & NN_ARCH_FLAG_BP_NOP)
+	{
+		return self->dL_dX;
+	}
+	else if(self->fused)
+	{
+		// W and B were updated with dL_dW and dL_dB
+		if(nn_convLayer_updateWinogradW(self) == 0)
+		{
+			return NULL;
+		}
+		return self->dL_dX;
+	}
+
+	// nn_convLayer_backpropUpdateW
+	// dispatch(RAW, fc, fh, fw, 4, 4, 4)
+	cp = nn_engine_getPipeline(engine,
+	                           &engine->cp_conv_backpropUpdateW);
+	if(nn_engine_computeBind(engine, cp) == 0)
+	{
+		return NULL;
+	}
+	nn_engine_computeBindUniformSets(engine, 2, us_array);
+	vkk_buffer_t* read_W[] =
+	{
+		self->dL_dW->sb_data,
+	};
+	vkk_buffer_t* write_W[] =
+	{
+		self->W->sb_data,
+		self->MW->sb_data,
+		self->VW->sb_data,
+	};
+	nn_engine_computeAccess(engine, 1, read_W,
+	                        3, write_W);
+	nn_engine_computeDispatch(engine, VKK_HAZARD_RAW,
+	                          fc, fh, fw, 4, 4, 4);
+
+	// nn_convLayer_backpropUpdateB
+	// dispatch(RAW, fc, 1, 1, 64, 1, 1)
+	if((self->flags & NN_CONV_LAYER_FLAG_DISABLE_BIAS) == 0)
+	{
+		cp = nn_engine_getPipeline(engine,
+		                           &engine->cp_conv_backpropUpdateB);
+		if(nn_engine_computeBind(engine, cp) == 0)
+		{
+			return NULL;
+		}
+		vkk_buffer_t* read_B[] =
+		{
+			self->dL_dB->sb_data,
+		};
+		vkk_buffer_t* write_B[] =
+		{
+			self->B->sb_data,
+			self->MB->sb_data,
+			self->VB->sb_data,
+		};
+		nn_engine_computeAccess(engine, 1, read_B,
+		                        3, write_B);
+		nn_engine_computeDispatch(engine, VKK_HAZARD_RAW,
+		                          fc, 1, 1, 64, 1, 1);
+	}
+
+	if(nn_convLayer_updateWinogradW(self) == 0)
+	{
+		return NULL;
+	}
+
+	return self->dL_dX;
+}
+
+static nn_tensor_t*
+nn_convLayer_computeFpTFn(nn_layer_t* base,
+                          int flags, uint32_t bs,
+                          nn_tensor_t* X)
+{
+	ASSERT(base);
+	ASSERT(X);
+
+	nn_convLayer_t* self   = (nn_convLayer_t*) base;
+	nn_arch_t*      arch   = base->arch;
+	nn_engine_t*    engine = arch->engine;
+
+	nn_dim_t* dimY = nn_tensor_dim(self->Y);
+
+	// optionally perform Spectral Normalization
+	if(self->flags & NN_CONV_LAYER_FLAG_NORM_SN)
+	{
+		if(nn_tensor_computeNormalize(self->W,
+		                              VKK_HAZARD_RAW,
+		                              NN_TENSOR_NORM_SN,
+		                              1.0f) == 0)
+		{
+			return NULL;
+		}
+	}
+	else if(self->flags & NN_CONV_LAYER_FLAG_NORM_BSSN)
+	{
+		if(nn_tensor_computeNormalize(self->W,
+		                              VKK_HAZARD_RAW,
+		                              NN_TENSOR_NORM_BSSN,
+		                              1.2f) == 0)
+		{
+			return NULL;
+		}
+	}
+
+	// sb100: bs
+	// sb101: state
+	// sb102: X
+	vkk_uniformAttachment_t ua1_array[] =
+	{
+		{
+			.binding = 0,
+			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
+			.buffer  = arch->sb100_bs,
+		},
+		{
+			.binding = 1,
+			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
+			.buffer  = arch->sb101_state,
+		},
+		{
+			.binding = 2,
+			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
+			.buffer  = X->sb_data,
+		},
+	};
+
+	nn_engine_computeUpdateUniformSetRefs(engine,
+	                                      self->us1_fp, 3,
+	                                      ua1_array);
+
+	vkk_uniformSet_t* us_array[] =
+	{
+		self->us0,
+		self->us1_fp,
+	};
+
+	if(self->gemm_Y)
+	{
+		if(nn_convLayer_computeFpGemm(self, bs, X) == NULL)
+		{
+			return NULL;
+		}
+	}
+	else
+	{
+		// nn_convLayer_forwardPassT
+		// dispatch(RAW, bs, yh, yw, 1, 8, 8)
+		vkk_computePipeline_t* cp;
+		if(self->flags & NN_CONV_LAYER_FLAG_MODE_PAD)
+		{
+			cp = nn_engine_getPipeline(engine,
+			                           &engine->cp_conv_forwardPassTPad);
+		}
+		else
+		{
+			cp = nn_engine_getPipeline(engine,
+			                           &engine->cp_conv_forwardPassTClamp);
+		}
+		if(nn_engine_computeBind(engine, cp) == 0)
+		{
+			return NULL;
+		}
+		nn_engine_computeBindUniformSets(engine, 2, us_array);
+		nn_engine_computeDispatch(engine, VKK_HAZARD_RAW,
+		                          bs, dimY->height, dimY->width,
+		                          1, 8, 8);
+	}
+
+	// optionally compute stats
+	if(flags & NN_ARCH_FLAG_FP_STATS)
+	{
+		if(nn_tensor_computeStats(self->Y, VKK_HAZARD_RAW, bs,
+		                          self->stats_Y) == 0)
+		{
+			return NULL;
+		}
+	}
+
+	// store reference
+	self->X = X;
+
+	return self->Y;
+}
+
+static nn_tensor_t*
+nn_convLayer_computeBpTFn(nn_layer_t* base,
+                          int flags, uint32_t bs,
+                          nn_tensor_t* dL_dY)
+{
+	ASSERT(base);
+	ASSERT(dL_dY); // dim(bs,yh,yw,fc)
+
+	nn_convLayer_t* self   = (nn_convLayer_t*) base;
+	nn_arch_t*      arch   = base->arch;
+	nn_engine_t*    engine = arch->engine;
+
+	nn_dim_t* dimW = nn_tensor_dim(self->W);
+	nn_dim_t* dimX = nn_tensor_dim(self->dL_dX);
+	uint32_t  fc   = dimW->count;
+	uint32_t  fh   = dimW->height;
+	uint32_t  fw   = dimW->width;
+
+	// sb100: bs
+	// sb101: state
+	// sb102: X
+	// sb103: dL_dY
+	vkk_uniformAttachment_t ua1_array[] =
+	{
+		{
+			.binding = 0,
+			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
+			.buffer  = arch->sb100_bs,
+		},
+		{
+			.binding = 1,
+			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
+			.buffer  = arch->sb101_state,
+		},
+		{
+			.binding = 2,
+			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
+			.buffer  = self->X->sb_data,
+		},
+		{
+			.binding = 3,
+			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
+			.buffer  = dL_dY->sb_data,
+		},
+	};
+
+	nn_engine_computeUpdateUniformSetRefs(engine,
+	                                      self->us1_bp, 4,
+	                                      ua1_array);
+
+	vkk_uniformSet_t* us_array[] =
+	{
+		self->us0,
+		self->us1_bp,
+	};
+
+	// the fused kernels update W and B in place so they are
+	// skipped entirely when the update is skipped
+	int nop_fused = self->fused &&
+	                (flags & NN_ARCH_FLAG_BP_NOP);
+
+	vkk_computePipeline_t* cp;
+	if(self->gemm_Y)
+	{
+		if(nn_convLayer_computeBpGemm(self, flags, bs,
+		                              dL_dY) == 0)
+		{
+			return NULL;
+		}
+	}
+	else
+	{
+		// nn_convLayerT_backprop_dL_dX
+		// dispatch(RAW, bs, xh, xw, 1, 8, 8)
+		cp = nn_engine_getPipeline(engine,
+		                           &engine->cp_conv_backpropT_dL_dX);
+		if(nn_engine_computeBind(engine, cp) == 0)
+		{
+			return NULL;
+		}
+		nn_engine_computeBindUniformSets(engine, 2, us_array);
+		vkk_buffer_t* read_dL_dX[] =
+		{
+			dL_dY->sb_data,
+			self->Y->sb_data,
+			self->W->sb_data,
+		};
+		vkk_buffer_t* write_dL_dX[] =
+		{
+			self->dL_dX->sb_data,
+		};
+		nn_engine_computeAccess(engine, 3, read_dL_dX,
+		                        1, write_dL_dX);
+		nn_engine_computeDispatch(engine, VKK_HAZARD_RAW,
+		                          bs, dimX->height, dimX->width,
+		                          1, 8, 8);
+
+		// optionally compute stats
+		if(flags & NN_ARCH_FLAG_BP_STATS)
+		{
+			if(nn_tensor_computeStats(self->dL_dX, VKK_HAZARD_RAW, bs,
+			                          self->stats_dL_dX) == 0)
+			{
+				return NULL;
+			}
+		}
+
+		if((nop_fused == 0) &&
+		   (nn_convLayer_computeBp_dL_dW(self, dL_dY) == 0))
+		{
+			return NULL;
+		}
+	}
+
+	if((nop_fused == 0) &&
+	   ((self->flags & NN_CONV_LAYER_FLAG_DISABLE_BIAS) == 0))
+	{
+		if(nn_convLayer_computeBp_dL_dB(self, dL_dY) == 0)
+		{
+			return NULL;
+		}
+	}
+
+	// optionally skip parameter update
+	if(flags & NN_ARCH_FLAG_BP_NOP)
+	{
+		return self->dL_dX;
+	}
+	else if(self->fused)
+	{
+		// W and B were updated with dL_dW and dL_dB
+		return self->dL_dX;
+	}
+
+	// nn_convLayer_backpropUpdateW
+	// dispatch(RAW, fc, fh, fw, 4, 4, 4)
+	cp = nn_engine_getPipeline(engine,
+	                           &engine->cp_conv_backpropUpdateW);
+	if(nn_engine_computeBind(engine, cp) == 0)
+	{
+		return NULL;
+	}
+	nn_engine_computeBindUniformSets(engine, 2, us_array);
+	vkk_buffer_t* read_W[] =
+	{
+		self->dL_dW->sb_data,
+	};
+	vkk_buffer_t* write_W[] =
+	{
+		self->W->sb_data,
+		self->MW->sb_data,
+		self->VW->sb_data,
+	};
+	nn_engine_computeAccess(engine, 1, read_W,
+	                        3, write_W);
+	nn_engine_computeDispatch(engine, VKK_HAZARD_RAW,
+	                          fc, fh, fw, 4, 4, 4);
+
+	// nn_convLayer_backpropUpdateB
+	// dispatch(RAW, fc, 1, 1, 64, 1, 1)
+	if((self->flags & NN_CONV_LAYER_FLAG_DISABLE_BIAS) == 0)
+	{
+		cp = nn_engine_getPipeline(engine,
+		                           &engine->cp_conv_backpropUpdateB);
+		if(nn_engine_computeBind(engine, cp) == 0)
+		{
+			return NULL;
+		}
+		vkk_buffer_t* read_B[] =
+		{
+			self->dL_dB->sb_data,
+		};
+		vkk_buffer_t* write_B[] =
+		{
+			self->B->sb_data,
+			self->MB->sb_data,
+			self->VB->sb_data,
+		};
+		nn_engine_computeAccess(engine, 1, read_B,
+		                        3, write_B);
+		nn_engine_computeDispatch(engine, VKK_HAZARD_RAW,
+		                          fc, 1, 1, 64, 1, 1);
+	}
+
+	return self->dL_dX;
+}
+
+typedef struct
+{
+	nn_convLayer_t* self;
+	nn_tensor_t*    X;
+	nn_tensor_t*    dL_dY;
+	uint32_t        bs;
+} nn_convLayerTask_t;
+
+static void
+nn_convLayer_fpCpuTask(void* priv, uint32_t idx)
+{
+	ASSERT(priv);
+
+	nn_convLayerTask_t* task = (nn_convLayerTask_t*) priv;
+	nn_convLayer_t*     self = task->self;
+
+	nn_dim_t* dimX   = nn_tensor_dim(task->X);
+	nn_dim_t* dimW   = nn_tensor_dim(self->W);
+	nn_dim_t* dimY   = nn_tensor_dim(self->Y);
+	int       xh     = (int) dimX->height;
+	int       xw     = (int) dimX->width;
+	uint32_t  xd     = dimX->depth;
+	uint32_t  wd     = dimW->depth;
+	uint32_t  fc     = dimW->count;
+	uint32_t  fg     = fc/(xd/wd);
+	int       fh     = (int) dimW->height;
+	int       fw     = (int) dimW->width;
+	uint32_t  yh     = dimY->height;
+	uint32_t  yw     = dimY->width;
+	int       stride = (int) self->stride;
+	int       dil    = (int) self->dilation;
+	int       pad    = self->flags & NN_CONV_LAYER_FLAG_MODE_PAD;
+	float*    X      = task->X->data;
+	float*    W      = self->W->data;
+	float*    B      = self->B->data;
+	float*    Y      = self->Y->data;
+
+	// dispatch(bs*yh)
+	uint32_t m  = idx/yh;
+	int      yi = (int) (idx%yh);
+
+	int      xi;
+	int      xj;
+	int      fi;
+	int      fj;
+	int      yj;
+	uint32_t f;
+	uint32_t g;
+	float    y;
+	for(yj = 0; yj < (int) yw; ++yj)
+	{
+		for(f = 0; f < fc; ++f)
+		{
+			// filter group
+			g = f/fg;
+
+			y = 0.0f;
+			if((self->flags & NN_CONV_LAYER_FLAG_DISABLE_BIAS) == 0)
+			{
+				y = B[f];
+			}
+
+			for(fi = 0; fi < fh; ++fi)
+			{
+				xi = stride*yi + dil*(fi - fh/2);
+				if((xi < 0) || (xi >= xh))
+				{
+					if(pad)
+					{
+						continue;
+					}
+					xi = (xi < 0) ? 0 : xh - 1;
+				}
+
+				for(fj = 0; fj < fw; ++fj)
+				{
+					xj = stride*yj + dil*(fj - fw/2);
+					if((xj < 0) || (xj >= xw))
+					{
+						if(pad)
+						{
+							continue;
+						}
+						xj = (xj < 0) ? 0 : xw - 1;
+					}
+
+					y += nn_cpu_dot(&W[((f*fh + fi)*fw + fj)*wd],
+					                &X[((m*xh + xi)*xw + xj)*xd +
+					                   g*wd], wd);
+				}
+			}
+
+			Y[((m*yh + yi)*yw + yj)*fc + f] =
+				nn_factLayer_fact(self->fact_fn, y);
+		}
+	}
+}
+
+static void
+nn_convLayer_fpQ8CpuTask(void* priv, uint32_t idx)
+{
+	ASSERT(priv);
+
+	nn_convLayerTask_t* task = (nn_convLayerTask_t*) priv;
+	nn_convLayer_t*     self = task->self;
+	nn_tensorQ8_t*      q8   = self->q8;
+
+	nn_dim_t* dimX   = nn_tensor_dim(task->X);
+	nn_dim_t* dimW   = nn_tensor_dim(self->W);
+	nn_dim_t* dimY   = nn_tensor_dim(self->Y);
+	int       xh     = (int) dimX->height;
+	int       xw     = (int) dimX->width;
+	uint32_t  xd     = dimX->depth;
+	uint32_t  wd     = dimW->depth;
+	uint32_t  fc     = dimW->count;
+	uint32_t  fg     = fc/(xd/wd);
+	int       fh     = (int) dimW->height;
+	int       fw     = (int) dimW->width;
+	uint32_t  yh     = dimY->height;
+	uint32_t  yw     = dimY->width;
+	int       stride = (int) self->stride;
+	int       dil    = (int) self->dilation;
+	int       pad    = self->flags & NN_CONV_LAYER_FLAG_MODE_PAD;
+	int8_t*   Xq     = self->q8_X;
+	float*    B      = self->B->data;
+	float*    Y      = self->Y->data;
+
+	// dispatch(bs*yh)
+	uint32_t m  = idx/yh;
+	int      yi = (int) (idx%yh);
+
+	int      xi;
+	int      xj;
+	int      fi;
+	int      fj;
+	int      yj;
+	uint32_t f;
+	uint32_t g;
+	int8_t*  Wq;
+	int32_t  acc;
+	float    y;
+	for(yj = 0; yj < (int) yw; ++yj)
+	{
+		for(f = 0; f < fc; ++f)
+		{
+			// filter group
+			g   = f/fg;
+			Wq  = nn_tensorQ8_row(q8, f);
+			acc = 0;
+
+			for(fi = 0; fi < fh; ++fi)
+			{
+				xi = stride*yi + dil*(fi - fh/2);
+				if((xi < 0) || (xi >= xh))
+				{
+					if(pad)
+					{
+						continue;
+					}
+					xi = (xi < 0) ? 0 : xh - 1;
+				}
+
+				for(fj = 0; fj < fw; ++fj)
+				{
+					xj = stride*yj + dil*(fj - fw/2);
+					if((xj < 0) || (xj >= xw))
+					{
+						if(pad)
+						{
+							continue;
+						}
+						xj = (xj < 0) ? 0 : xw - 1;
+					}
+
+					acc += nn_cpu_dotQ8(&Wq[(fi*fw + fj)*q8->depth],
+					                    &Xq[((m*xh + xi)*xw + xj)*xd +
+					                        g*wd], wd);
+				}
+			}
+
+			// dequantize
+			y = ((float) acc)*q8->scale_x*q8->scale_w[f];
+			if((self->flags & NN_CONV_LAYER_FLAG_DISABLE_BIAS) == 0)
+			{
+				y += B[f];
+			}
+
+			Y[((m*yh + yi)*yw + yj)*fc + f] =
+				nn_factLayer_fact(self->fact_fn, y);
+		}
+	}
+}
+
+static void
+nn_convLayer_fpTCpuTask(void* priv, uint32_t idx)
+{
+	ASSERT(priv);
+
+	nn_convLayerTask_t* task = (nn_convLayerTask_t*) priv;
+	nn_convLayer_t*     self = task->self;
+
+	nn_dim_t* dimX   = nn_tensor_dim(task->X);
+	nn_dim_t* dimW   = nn_tensor_dim(self->W);
+	nn_dim_t* dimY   = nn_tensor_dim(self->Y);
+	int       xh     = (int) dimX->height;
+	int       xw     = (int) dimX->width;
+	uint32_t  xd     = dimX->depth;
+	uint32_t  fc     = dimW->count;
+	int       fh     = (int) dimW->height;
+	int       fw     = (int) dimW->width;
+	uint32_t  yh     = dimY->height;
+	uint32_t  yw     = dimY->width;
+	int       stride = (int) self->stride;
+	int       pad    = self->flags & NN_CONV_LAYER_FLAG_MODE_PAD;
+	float*    X      = task->X->data;
+	float*    W      = self->W->data;
+	float*    B      = self->B->data;
+	float*    Y      = self->Y->data;
+
+	// dispatch(bs*yh)
+	uint32_t m  = idx/yh;
+	int      yi = (int) (idx%yh);
+
+	int      start_xi = yi/stride;
+	int      start_xj;
+	int      xi;
+	int      xj;
+	int      ci;
+	int      cj;
+	int      fi;
+	int      fj;
+	int      yj;
+	uint32_t f;
+	float    y;
+	for(yj = 0; yj < (int) yw; ++yj)
+	{
+		start_xj = yj/stride;
+		for(f = 0; f < fc; ++f)
+		{
+			y = 0.0f;
+			if((self->flags & NN_CONV_LAYER_FLAG_DISABLE_BIAS) == 0)
+			{
+				y = B[f];
+			}
+
+			for(xi = start_xi; xi < start_xi + fh; ++xi)
+			{
+				fi = yi - xi*stride + fh/2;
+				if((fi < 0) || (fi >= fh))
+				{
+					continue;
+				}
+
+				ci = xi;
+				if((xi < 0) || (xi >= xh))
+				{
+					if(pad)
+					{
+						continue;
+					}
+					ci = (xi < 0) ? 0 : xh - 1;
+				}
+
+				for(xj = start_xj; xj < start_xj + fw; ++xj)
+				{
+					fj = yj - xj*stride + fw/2;
+					if((fj < 0) || (fj >= fw))
+					{
+						continue;
+					}
+
+					cj = xj;
+					if((xj < 0) || (xj >= xw))
+					{
+						if(pad)
+						{
+							continue;
+						}
+						cj = (xj < 0) ? 0 : xw - 1;
+					}
+
+					y += nn_cpu_dot(&W[((f*fh + fi)*fw + fj)*xd],
+					                &X[((m*xh + ci)*xw + cj)*xd],
+					                xd);
+				}
+			}
+
+			Y[((m*yh + yi)*yw + yj)*fc + f] =
+				nn_factLayer_fact(self->fact_fn, y);
+		}
+	}
+}
+
+static void
+nn_convLayer_bpFactCpuTask(void* priv, uint32_t idx)
+{
+	ASSERT(priv);
+
+	nn_convLayerTask_t* task = (nn_convLayerTask_t*) priv;
+	nn_convLayer_t*     self = task->self;
+
+	nn_dim_t* dimY  = nn_tensor_dim(self->Y);
+	uint32_t  n     = dimY->width*dimY->depth;
+	float*    Y     = &self->Y->data[idx*n];
+	float*    dL_dY = &task->dL_dY->data[idx*n];
+
+	// dispatch(bs*yh)
+	// dL_dY replaced by dL_dY*dY_dZ
+	uint32_t i;
+	for(i = 0; i < n; ++i)
+	{
+		dL_dY[i] *= nn_factLayer_dfactY(self->fact_fn, Y[i]);
+	}
+}
+
+static void
+nn_convLayer_bp_dL_dXCpuTask(void* priv, uint32_t idx)
+{
+	ASSERT(priv);
+
+	nn_convLayerTask_t* task = (nn_convLayerTask_t*) priv;
+	nn_convLayer_t*     self = task->self;
+
+	nn_dim_t* dimX   = nn_tensor_dim(self->dL_dX);
+	nn_dim_t* dimW   = nn_tensor_dim(self->W);
+	nn_dim_t* dimY   = nn_tensor_dim(self->Y);
+	uint32_t  xh     = dimX->height;
+	uint32_t  xw     = dimX->width;
+	uint32_t  xd     = dimX->depth;
+	uint32_t  wd     = dimW->depth;
+	uint32_t  fc     = dimW->count;
+	uint32_t  fg     = fc/(xd/wd);
+	int       fh     = (int) dimW->height;
+	int       fw     = (int) dimW->width;
+	int       yh     = (int) dimY->height;
+	int       yw     = (int) dimY->width;
+	int       stride = (int) self->stride;
+	int       dil    = (int) self->dilation;
+	float*    W      = self->W->data;
+	float*    dL_dY  = task->dL_dY->data;
+
+	// dispatch(bs*xh)
+	uint32_t m  = idx/xh;
+	int      xi = (int) (idx%xh);
+
+	float*   dL_dX;
+	int      xj;
+	int      yi;
+	int      yj;
+	int      fi;
+	int      fj;
+	uint32_t f;
+	float    dl_dy;
+	for(xj = 0; xj < (int) xw; ++xj)
+	{
+		dL_dX = &self->dL_dX->data[((m*xh + xi)*xw + xj)*xd];
+		memset(dL_dX, 0, xd*sizeof(float));
+
+		for(fi = 0; fi < fh; ++fi)
+		{
+			yi = (xi + dil*(fh/2 - fi))/stride;
+			if((yi < 0) || (yi >= yh))
+			{
+				continue;
+			}
+
+			for(fj = 0; fj < fw; ++fj)
+			{
+				yj = (xj + dil*(fw/2 - fj))/stride;
+				if((yj < 0) || (yj >= yw))
+				{
+					continue;
+				}
+
+				for(f = 0; f < fc; ++f)
+				{
+					dl_dy = dL_dY[((m*yh + yi)*yw + yj)*fc + f];
+					nn_cpu_axpy(dl_dy,
+					            &W[((f*fh + fi)*fw + fj)*wd],
+					            &dL_dX[(f/fg)*wd], wd);
+				}
+			}
+		}
+	}
+}
+
+static void
+nn_convLayer_bpT_dL_dXCpuTask(void* priv, uint32_t idx)
+{
+	ASSERT(priv);
+
+	nn_convLayerTask_t* task = (nn_convLayerTask_t*) priv;
+	nn_convLayer_t*     self = task->self;
+
+	nn_dim_t* dimX   = nn_tensor_dim(self->dL_dX);
+	nn_dim_t* dimW   = nn_tensor_dim(self->W);
+	nn_dim_t* dimY   = nn_tensor_dim(self->Y);
+	uint32_t  xh     = dimX->height;
+	uint32_t  xw     = dimX->width;
+	uint32_t  xd     = dimX->depth;
+	uint32_t  fc     = dimW->count;
+	int       fh     = (int) dimW->height;
+	int       fw     = (int) dimW->width;
+	int       yh     = (int) dimY->height;
+	int       yw     = (int) dimY->width;
+	int       stride = (int) self->stride;
+	float*    W      = self->W->data;
+	float*    dL_dY  = task->dL_dY->data;
+
+	// dispatch(bs*xh)
+	uint32_t m  = idx/xh;
+	int      xi = (int) (idx%xh);
+
+	float*   dL_dX;
+	int      xj;
+	int      yi;
+	int      yj;
+	int      fi;
+	int      fj;
+	uint32_t f;
+	float    dl_dy;
+	for(xj = 0; xj < (int) xw; ++xj)
+	{
+		dL_dX = &self->dL_dX->data[((m*xh + xi)*xw + xj)*xd];
+		memset(dL_dX, 0, xd*sizeof(float));
+
+		for(f = 0; f < fc; ++f)
+		{
+			for(fi = 0; fi < fh; ++fi)
+			{
+				yi = xi*stride + fi - fh/2;
+				if((yi < 0) || (yi >= yh))
+				{
+					continue;
+				}
+
+				for(fj = 0; fj < fw; ++fj)
+				{
+					yj = xj*stride + fj - fw/2;
+					if((yj < 0) || (yj >= yw))
+					{
+						continue;
+					}
+
+					dl_dy = dL_dY[((m*yh + yi)*yw + yj)*fc + f];
+					nn_cpu_axpy(dl_dy,
+					            &W[((f*fh + fi)*fw + fj)*xd],
+					            dL_dX, xd);
+				}
+			}
+		}
+	}
+}
+
+static void
+nn_convLayer_bp_dL_dWCpuTask(void* priv, uint32_t idx)
+{
+	ASSERT(priv);
+
+	nn_convLayerTask_t* task = (nn_convLayerTask_t*) priv;
+	nn_convLayer_t*     self = task->self;
+
+	nn_dim_t* dimX   = nn_tensor_dim(self->dL_dX);
+	nn_dim_t* dimW   = nn_tensor_dim(self->W);
+	nn_dim_t* dimY   = nn_tensor_dim(self->Y);
+	int       xh     = (int) dimX->height;
+	int       xw     = (int) dimX->width;
+	uint32_t  xd     = dimX->depth;
+	uint32_t  wd     = dimW->depth;
+	uint32_t  fc     = dimW->count;
+	uint32_t  fg     = fc/(xd/wd);
+	uint32_t  fh     = dimW->height;
+	uint32_t  fw     = dimW->width;
+	uint32_t  yh     = dimY->height;
+	uint32_t  yw     = dimY->width;
+	int       stride = (int) self->stride;
+	int       dil    = (int) self->dilation;
+	float*    X      = self->X->data;
+	float*    dL_dY  = task->dL_dY->data;
+
+	// dispatch(fc*fh)
+	uint32_t f  = idx/fh;
+	uint32_t fi = idx%fh;
+	uint32_t g  = f/fg;
+
+	float*   dL_dW;
+	uint32_t fj;
+	uint32_t m;
+	int      xi;
+	int      xj;
+	int      yi;
+	int      yj;
+	float    dl_dy;
+	for(fj = 0; fj < fw; ++fj)
+	{
+		dL_dW = &self->dL_dW->data[((f*fh + fi)*fw + fj)*wd];
+		memset(dL_dW, 0, wd*sizeof(float));
+
+		for(m = 0; m < task->bs; ++m)
+		{
+			for(yi = 0; yi < (int) yh; ++yi)
+			{
+				xi = stride*yi + dil*((int) fi - (int) (fh/2));
+				if((xi < 0) || (xi >= xh))
+				{
+					continue;
+				}
+
+				for(yj = 0; yj < (int) yw; ++yj)
+				{
+					xj = stride*yj + dil*((int) fj - (int) (fw/2));
+					if((xj < 0) || (xj >= xw))
+					{
+						continue;
+					}
+
+					dl_dy = dL_dY[((m*yh + yi)*yw + yj)*fc + f];
+					nn_cpu_axpy(dl_dy,
+					            &X[((m*xh + xi)*xw + xj)*xd +
+					               g*wd], dL_dW, wd);
+				}
+			}
+		}
+	}
+}
+
+static void
+nn_convLayer_bpT_dL_dWCpuTask(void* priv, uint32_t idx)
+{
+	ASSERT(priv);
+
+	nn_convLayerTask_t* task = (nn_convLayerTask_t*) priv;
+	nn_convLayer_t*     self = task->self;
+
+	nn_dim_t* dimX   = nn_tensor_dim(self->dL_dX);
+	nn_dim_t* dimW   = nn_tensor_dim(self->W);
+	nn_dim_t* dimY   = nn_tensor_dim(self->Y);
+	uint32_t  xh     = dimX->height;
+	uint32_t  xw     = dimX->width;
+	uint32_t  xd     = dimX->depth;
+	uint32_t  fc     = dimW->count;
+	uint32_t  fh     = dimW->height;
+	uint32_t  fw     = dimW->width;
+	int       yh     = (int) dimY->height;
+	int       yw     = (int) dimY->width;
+	int       stride = (int) self->stride;
+	float*    X      = self->X->data;
+	float*    dL_dY  = task->dL_dY->data;
+
+	// dispatch(fc*fh)
+	uint32_t f  = idx/fh;
+	uint32_t fi = idx%fh;
+
+	float*   dL_dW;
+	uint32_t fj;
+	uint32_t m;
+	int      xi;
+	int      xj;
+	int      yi;
+	int      yj;
+	float    dl_dy;
+	for(fj = 0; fj < fw; ++fj)
+	{
+		dL_dW = &self->dL_dW->data[((f*fh + fi)*fw + fj)*xd];
+		memset(dL_dW, 0, xd*sizeof(float));
+
+		for(m = 0; m < task->bs; ++m)
+		{
+			for(xi = 0; xi < (int) xh; ++xi)
+			{
+				yi = xi*stride + (int) fi - (int) (fh/2);
+				if((yi < 0) || (yi >= yh))
+				{
+					continue;
+				}
+
+				for(xj = 0; xj < (int) xw; ++xj)
+				{
+					yj = xj*stride + (int) fj - (int) (fw/2);
+					if((yj < 0) || (yj >= yw))
+					{
+						continue;
+					}
+
+					dl_dy = dL_dY[((m*yh + yi)*yw + yj)*fc + f];
+					nn_cpu_axpy(dl_dy,
+					            &X[((m*xh + xi)*xw + xj)*xd],
+					            dL_dW, xd);
+				}
+			}
+		}
+	}
+}
+
+static void
+nn_convLayer_bp_dL_dBCpuTask(void* priv, uint32_t idx)
+{
+	ASSERT(priv);
+
+	nn_convLayerTask_t* task = (nn_convLayerTask_t*) priv;
+	nn_convLayer_t*     self = task->self;
+
+	nn_dim_t* dimY  = nn_tensor_dim(self->Y);
+	uint32_t  n     = task->bs*dimY->height*dimY->width;
+	uint32_t  fc    = dimY->depth;
+	float*    dL_dY = task->dL_dY->data;
+
+	// dispatch(fc)
+	uint32_t f = idx;
+
+	float    dl_db = 0.0f;
+	uint32_t i;
+	for(i = 0; i < n; ++i)
+	{
+		dl_db += dL_dY[i*fc + f];
+	}
+	self->dL_dB->data[f] = dl_db;
+}
+
+static void
+nn_convLayer_bpUpdateCpuTask(void* priv, uint32_t idx)
+{
+	ASSERT(priv);
+
+	nn_convLayerTask_t* task = (nn_convLayerTask_t*) priv;
+	nn_convLayer_t*     self = task->self;
+	nn_archState_t*     state;
+	state = &self->base.arch->state;
+
+	nn_dim_t* dimW = nn_tensor_dim(self->W);
+	uint32_t  n    = dimW->height*dimW->width*dimW->depth;
+
+	// dispatch(fc)
+	uint32_t f = idx;
+
+	nn_cpu_adam(state, &self->W->data[f*n],
+	            &self->MW->data[f*n], &self->VW->data[f*n],
+	            &self->dL_dW->data[f*n], n);
+
+	if((self->flags & NN_CONV_LAYER_FLAG_DISABLE_BIAS) == 0)
+	{
+		nn_cpu_adam(state, &self->B->data[f],
+		            &self->MB->data[f], &self->VB->data[f],
+		            &self->dL_dB->data[f], 1);
+	}
+}
+
+static nn_tensor_t*
+nn_convLayer_computeFpCpu(nn_layer_t* base,
+                          int flags, uint32_t bs,
+                          nn_tensor_t* X,
+                          nn_cpuTask_fn fp_fn)
+{
+	ASSERT(base);
+	ASSERT(X);
+	ASSERT(fp_fn);
+
+	nn_convLayer_t* self   = (nn_convLayer_t*) base;
+	nn_arch_t*      arch   = base->arch;
+	nn_engine_t*    engine = arch->engine;
+
+	nn_dim_t* dimY = nn_tensor_dim(self->Y);
+
+	// optionally perform Spectral Normalization
+	if(self->flags & NN_CONV_LAYER_FLAG_NORM_SN)
+	{
+		if(nn_tensor_computeNormalize(self->W,
+		                              VKK_HAZARD_RAW,
+		                              NN_TENSOR_NORM_SN,
+		                              1.0f) == 0)
+		{
+			return NULL;
+		}
+	}
+	else if(self->flags & NN_CONV_LAYER_FLAG_NORM_BSSN)
+	{
+		if(nn_tensor_computeNormalize(self->W,
+		                              VKK_HAZARD_RAW,
+		                              NN_TENSOR_NORM_BSSN,
+		                              1.2f) == 0)
+		{
+			return NULL;
+		}
+	}
+
+	// requantize the input once for all filters
+	if(self->q8)
+	{
+		nn_cpu_quantize(self->q8->scale_x, X->data, self->q8_X,
+		                bs*nn_dim_strideElements(nn_tensor_dim(X)));
+		fp_fn = nn_convLayer_fpQ8CpuTask;
+	}
+
+	nn_convLayerTask_t task =
+	{
+		.self = self,
+		.X    = X,
+		.bs   = bs,
+	};
+	nn_cpu_run(engine->cpu, fp_fn, &task, bs*dimY->height);
+
+	// optionally calibrate the int8 input range
+	if(flags & NN_ARCH_FLAG_FP_CALIBRATE)
+	{
+		if(nn_tensor_computeStats(X, VKK_HAZARD_RAW, bs,
+		                          self->stats_X) == 0)
+		{
+			return NULL;
+		}
+	}
+
+	// optionally compute stats
+	if(flags & NN_ARCH_FLAG_FP_STATS)
+	{
+		if(nn_tensor_computeStats(self->Y, VKK_HAZARD_RAW, bs,
+		                          self->stats_Y) == 0)
+		{
+			return NULL;
+		}
+	}
+
+	// store reference
+	self->X = X;
+
+	return self->Y;
+}
+
+static nn_tensor_t*
+nn_convLayer_computeBpCpu(nn_layer_t* base,
+                          int flags, uint32_t bs,
+                          nn_tensor_t* dL_dY,
+                          nn_cpuTask_fn dL_dX_fn,
+                          nn_cpuTask_fn dL_dW_fn)
+{
+	ASSERT(base);
+	ASSERT(dL_dY); // dim(bs,yh,yw,fc)
+	ASSERT(dL_dX_fn);
+	ASSERT(dL_dW_fn);
+
+	nn_convLayer_t* self   = (nn_convLayer_t*) base;
+	nn_arch_t*      arch   = base->arch;
+	nn_engine_t*    engine = arch->engine;
+
+	nn_dim_t* dimW = nn_tensor_dim(self->W);
+	nn_dim_t* dimX = nn_tensor_dim(self->dL_dX);
+	uint32_t  fc   = dimW->count;
+	uint32_t  fh   = dimW->height;
+
+	nn_convLayerTask_t task =
+	{
+		.self  = self,
+		.X     = self->X,
+		.dL_dY = dL_dY,
+		.bs    = bs,
+	};
+
+	if(self->fact_fn != NN_FACT_LAYER_FN_LINEAR)
+	{
+		nn_dim_t* dimY = nn_tensor_dim(self->Y);
+		nn_cpu_run(engine->cpu, nn_convLayer_bpFactCpuTask,
+		           &task, bs*dimY->height);
+	}
+
+	nn_cpu_run(engine->cpu, dL_dX_fn, &task, bs*dimX->height);
+
+	// optionally compute stats
+	if(flags & NN_ARCH_FLAG_BP_STATS)
+	{
+		if(nn_tensor_computeStats(self->dL_dX, VKK_HAZARD_RAW, bs,
+		                          self->stats_dL_dX) == 0)
+		{
+			return NULL;
+		}
+	}
+
+	nn_cpu_run(engine->cpu, dL_dW_fn, &task, fc*fh);
+
+	if((self->flags & NN_CONV_LAYER_FLAG_DISABLE_BIAS) == 0)
+	{
+		nn_cpu_run(engine->cpu, nn_convLayer_bp_dL_dBCpuTask,
+		           &task, fc);
+	}
+
+	// optionally skip parameter update
+	if(flags & NN_ARCH_FLAG_BP_NOP)
+	{
+		return self->dL_dX;
+	}
+
+	nn_cpu_run(engine->cpu, nn_convLayer_bpUpdateCpuTask,
+	           &task, fc);
+
+	return self->dL_dX;
+}
+
+static nn_tensor_t*
+nn_convLayer_computeFpCpuFn(nn_layer_t* base,
+                            int flags, uint32_t bs,
+                            nn_tensor_t* X)
+{
+	return nn_convLayer_computeFpCpu(base, flags, bs, X,
+	                                 nn_convLayer_fpCpuTask);
+}
+
+static nn_tensor_t*
+nn_convLayer_computeBpCpuFn(nn_layer_t* base,
+                            int flags, uint32_t bs,
+                            nn_tensor_t* dL_dY)
+{
+	return nn_convLayer_computeBpCpu(base, flags, bs, dL_dY,
+	                                 nn_convLayer_bp_dL_dXCpuTask,
+	                                 nn_convLayer_bp_dL_dWCpuTask);
+}
+
+static nn_tensor_t*
+nn_convLayer_computeFpTCpuFn(nn_layer_t* base,
+                             int flags, uint32_t bs,
+                             nn_tensor_t* X)
+{
+	return nn_convLayer_computeFpCpu(base, flags, bs, X,
+	                                 nn_convLayer_fpTCpuTask);
+}
+
+static nn_tensor_t*
+nn_convLayer_computeBpTCpuFn(nn_layer_t* base,
+                             int flags, uint32_t bs,
+                             nn_tensor_t* dL_dY)
+{
+	return nn_convLayer_computeBpCpu(base, flags, bs, dL_dY,
+	                                 nn_convLayer_bpT_dL_dXCpuTask,
+	                                 nn_convLayer_bpT_dL_dWCpuTask);
+}
+
+static void
+nn_convLayer_postFn(nn_layer_t* base,
+                    int flags, uint32_t bs)
+{
+	ASSERT(base);
+
+	nn_convLayer_t* self = (nn_convLayer_t*) base;
+
+	if(flags & NN_ARCH_FLAG_FP_CALIBRATE)
+	{
+		float xmin = nn_tensorStats_min(self->stats_X);
+		float xmax = nn_tensorStats_max(self->stats_X);
+		self->q8_xmax = fmaxf(self->q8_xmax, fmaxf(-xmin, xmax));
+	}
+
+	if(flags & NN_ARCH_FLAG_FP_STATS)
+	{
+		LOGI("Y min=%f, max=%f, mean=%f, stddev=%f, norm=%f",
+		     nn_tensorStats_min(self->stats_Y),
+		     nn_tensorStats_max(self->stats_Y),
+		     nn_tensorStats_mean(self->stats_Y),
+		     nn_tensorStats_stddev(self->stats_Y),
+		     nn_tensorStats_norm(self->stats_Y));
+	}
+
+	if(flags & NN_ARCH_FLAG_BP_STATS)
+	{
+		LOGI("dL_dX min=%f, max=%f, mean=%f, stddev=%f, norm=%f",
+		     nn_tensorStats_min(self->stats_dL_dX),
+		     nn_tensorStats_max(self->stats_dL_dX),
+		     nn_tensorStats_mean(self->stats_dL_dX),
+		     nn_tensorStats_stddev(self->stats_dL_dX),
+		     nn_tensorStats_norm(self->stats_dL_dX));
+	}
+}
+
+static int
+nn_convLayer_setQ8(nn_convLayer_t* self, nn_tensorQ8_t* q8)
+{
+	ASSERT(self);
+	ASSERT(q8);
+
+	nn_arch_t*   arch   = self->base.arch;
+	nn_engine_t* engine = arch->engine;
+
+	// the CPU backend quantizes X prior to the dot products
+	if(engine->cpu)
+	{
+		nn_dim_t* dimX = nn_tensor_dim(self->dL_dX);
+		self->q8_X = (int8_t*)
+		             CALLOC(nn_dim_sizeElements(dimX),
+		                    sizeof(int8_t));
+		if(self->q8_X == NULL)
+		{
+			LOGE("CALLOC failed");
+			return 0;
+		}
+	}
+
+	self->q8 = q8;
+
+	return 1;
+}
+
+static int
+nn_convLayer_quantizeFn(nn_layer_t* base)
+{
+	ASSERT(base);
+
+	nn_convLayer_t* self   = (nn_convLayer_t*) base;
+	nn_arch_t*      arch   = base->arch;
+	nn_engine_t*    engine = arch->engine;
+
+	// transpose layers remain FP32
+	if(self->q8 ||
+	   (self->flags & NN_CONV_LAYER_FLAG_TRANSPOSE))
+	{
+		return 1;
+	}
+
+	if(nn_convLayer_bakeNorm(self) == 0)
+	{
+		return 0;
+	}
+
+	nn_tensorQ8_t* q8;
+	q8 = nn_tensorQ8_new(engine, nn_tensor_dim(self->dL_dX),
+	                     self->W, self->q8_xmax);
+	if(q8 == NULL)
+	{
+		return 0;
+	}
+
+	if(nn_convLayer_setQ8(self, q8) == 0)
+	{
+		nn_tensorQ8_delete(&q8);
+		return 0;
+	}
+
+	return 1;
+}
+
+static nn_dim_t*
+nn_convLayer_dimXFn(nn_layer_t* base)
+{
+	ASSERT(base);
+
+	nn_convLayer_t* self = (nn_convLayer_t*) base;
+
+	return nn_tensor_dim(self->dL_dX);
+}
+
+static nn_dim_t*
+nn_convLayer_dimYFn(nn_layer_t* base)
+{
+	ASSERT(base);
+
+	nn_convLayer_t* self = (nn_convLayer_t*) base;
+
+	return nn_tensor_dim(self->Y);
+}
+
+static int
+nn_convLayer_newSplit(nn_convLayer_t* self,
+                      nn_dim_t* dimX, nn_dim_t* dimY,
+                      int split_W)
+{
+	ASSERT(self);
+	ASSERT(dimX);
+	ASSERT(dimY);
+
+	nn_arch_t*   arch   = self->base.arch;
+	nn_engine_t* engine = arch->engine;
+	nn_dim_t*    dimW   = nn_tensor_dim(self->W);
+
+	// the dL_dW rows are bs*yh for the standard conv and
+	// bs*xh for the transpose conv
+	uint32_t rows = dimX->count*dimY->height;
+	if(dimX->height < dimY->height)
+	{
+		rows = dimX->count*dimX->height;
+	}
+
+	uint32_t split = rows/NN_CONV_LAYER_SPLIT_ROWS;
+	if(split > NN_CONV_LAYER_SPLIT_MAX)
+	{
+		split = NN_CONV_LAYER_SPLIT_MAX;
+	}
+
+	size_t size = nn_dim_sizeBytes(dimW);
+	if(split_W && (split*size > NN_CONV_LAYER_SPLIT_SIZE))
+	{
+		split = NN_CONV_LAYER_SPLIT_SIZE/size;
+	}
+
+	// the serial kernels are sufficient for small layers
+	if(split < 2)
+	{
+		return 1;
+	}
+
+	self->split = split;
+
+	vkk_updateMode_e um;
+	um = vkk_compute_updateMode(engine->compute);
+	vkk_buffer_t* sb200_P_dL_dW = engine->Null->sb_data;
+	if(split_W)
+	{
+		self->sb200_P_dL_dW = vkk_buffer_new(engine->engine, um,
+		                                     VKK_BUFFER_USAGE_STORAGE,
+		                                     split*size, NULL);
+		if(self->sb200_P_dL_dW == NULL)
+		{
+			goto fail_sb200_P_dL_dW;
+		}
+		sb200_P_dL_dW = self->sb200_P_dL_dW;
+	}
+
+	self->sb201_P_dL_dB = vkk_buffer_new(engine->engine, um,
+	                                     VKK_BUFFER_USAGE_STORAGE,
+	                                     split*dimW->count*sizeof(float),
+	                                     NULL);
+	if(self->sb201_P_dL_dB == NULL)
+	{
+		goto fail_sb201_P_dL_dB;
+	}
+
+	self->sb202_split = vkk_buffer_new(engine->engine,
+	                                   VKK_UPDATE_MODE_STATIC,
+	                                   VKK_BUFFER_USAGE_STORAGE,
+	                                   sizeof(uint32_t), &split);
+	if(self->sb202_split == NULL)
+	{
+		goto fail_sb202_split;
+	}
+
+	self->us2_split = vkk_uniformSet_new(engine->engine, 2, 0, NULL,
+	                                     engine->usf2_conv_split);
+	if(self->us2_split == NULL)
+	{
+		goto fail_us2_split;
+	}
+
+	// sb200: P_dL_dW
+	// sb201: P_dL_dB
+	// sb202: split
+	vkk_uniformAttachment_t ua2_array[] =
+	{
+		{
+			.binding = 0,
+			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
+			.buffer  = sb200_P_dL_dW,
+		},
+		{
+			.binding = 1,
+			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
+			.buffer  = self->sb201_P_dL_dB,
+		},
+		{
+			.binding = 2,
+			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
+			.buffer  = self->sb202_split,
+		},
+	};
+
+	nn_engine_computeUpdateUniformSetRefs(engine,
+	                                      self->us2_split, 3,
+	                                      ua2_array);
+
+	// success
+	return 1;
+
+	// failure
+	fail_us2_split:
+		vkk_buffer_delete(&self->sb202_split);
+	fail_sb202_split:
+		vkk_buffer_delete(&self->sb201_P_dL_dB);
+	fail_sb201_P_dL_dB:
+		vkk_buffer_delete(&self->sb200_P_dL_dW);
+	fail_sb200_P_dL_dW:
+		self->split = 0;
+	return 0;
+}
+
+static int
+nn_convLayer_newWinograd(nn_convLayer_t* self,
+                         nn_dim_t* dimX, nn_dim_t* dimW)
+{
+	ASSERT(self);
+	ASSERT(dimX);
+	ASSERT(dimW);
+
+	nn_arch_t*   arch   = self->base.arch;
+	nn_engine_t* engine = arch->engine;
+
+	uint32_t fc = dimW->count;
+	uint32_t xd = dimX->depth;
+	uint32_t c  = (fc > xd) ? fc : xd;
+	uint32_t th = (dimX->height + 1)/2;
+	uint32_t tw = (dimX->width + 1)/2;
+	uint32_t bs = dimX->count;
+
+	self->wg_dirty = 1;
+
+	vkk_updateMode_e um;
+	um = vkk_compute_updateMode(engine->compute);
+	self->sb200_U = vkk_buffer_new(engine->engine, um,
+	                               VKK_BUFFER_USAGE_STORAGE,
+	                               16*fc*xd*sizeof(float),
+	                               NULL);
+	if(self->sb200_U == NULL)
+	{
+		return 0;
+	}
+
+	// the backprop filters are not required for inference
+	vkk_buffer_t* sb201_UT = engine->Null->sb_data;
+	if(arch->inference == 0)
+	{
+		self->sb201_UT = vkk_buffer_new(engine->engine, um,
+		                                VKK_BUFFER_USAGE_STORAGE,
+		                                16*fc*xd*sizeof(float),
+		                                NULL);
+		if(self->sb201_UT == NULL)
+		{
+			goto fail_sb201_UT;
+		}
+		sb201_UT = self->sb201_UT;
+	}
+
+	self->sb202_V = vkk_buffer_new(engine->engine, um,
+	                               VKK_BUFFER_USAGE_STORAGE,
+	                               16*bs*th*tw*c*sizeof(float),
+	                               NULL);
+	if(self->sb202_V == NULL)
+	{
+		goto fail_sb202_V;
+	}
+
+	self->sb203_M = vkk_buffer_new(engine->engine, um,
+	                               VKK_BUFFER_USAGE_STORAGE,
+	                               16*bs*th*tw*c*sizeof(float),
+	                               NULL);
+	if(self->sb203_M == NULL)
+	{
+		goto fail_sb203_M;
+	}
+
+	self->us2_wg = vkk_uniformSet_new(engine->engine, 2, 0, NULL,
+	                                  engine->usf2_conv_wg);
+	if(self->us2_wg == NULL)
+	{
+		goto fail_us2_wg;
+	}
+
+	// sb200: U
+	// sb201: UT
+	// sb202: V
+	// sb203: M
+	vkk_uniformAttachment_t ua2_array[] =
+	{
+		{
+			.binding = 0,
+			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
+			.buffer  = self->sb200_U,
+		},
+		{
+			.binding = 1,
+			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
+			.buffer  = sb201_UT,
+		},
+		{
+			.binding = 2,
+			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
+			.buffer  = self->sb202_V,
+		},
+		{
+			.binding = 3,
+			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
+			.buffer  = self->sb203_M,
+		},
+	};
+
+	nn_engine_computeUpdateUniformSetRefs(engine,
+	                                      self->us2_wg, 4,
+	                                      ua2_array);
+
+	// the 16 element-wise products are a batch of GEMMs
+	// M[e] = V[e]*U[e]^T
+	self->gemm_wg_Y = nn_tensorGemm_new(engine, 16, th*tw,
+	                                    fc, xd,
+	                                    NN_TENSOR_GEMM_FLAG_TRANS_B |
+	                                    NN_TENSOR_GEMM_FLAG_BS_M);
+	if(self->gemm_wg_Y == NULL)
+	{
+		goto fail_gemm_wg_Y;
+	}
+
+	// M[e] = V[e]*UT[e]^T
+	if(arch->inference == 0)
+	{
+		self->gemm_wg_dL_dX = nn_tensorGemm_new(engine, 16,
+		                                        th*tw, xd, fc,
+		                                        NN_TENSOR_GEMM_FLAG_TRANS_B |
+		                                        NN_TENSOR_GEMM_FLAG_BS_M);
+		if(self->gemm_wg_dL_dX == NULL)
+		{
+			goto fail_gemm_wg_dL_dX;
+		}
+	}
+
+	// success
+	return 1;
+
+	// failure
+	fail_gemm_wg_dL_dX:
+		nn_tensorGemm_delete(&self->gemm_wg_Y);
+	fail_gemm_wg_Y:
+		vkk_uniformSet_delete(&self->us2_wg);
+	fail_us2_wg:
+		vkk_buffer_delete(&self->sb203_M);
+	fail_sb203_M:
+		vkk_buffer_delete(&self->sb202_V);
+	fail_sb202_V:
+		vkk_buffer_delete(&self->sb201_UT);
+	fail_sb201_UT:
+		vkk_buffer_delete(&self->sb200_U);
+	return 0;
+}
+
+static void
+nn_convLayer_updateUs0(nn_convLayer_t* self)
+{
+	ASSERT(self);
+
+	nn_engine_t* engine = self->base.arch->engine;
+
+	// sb000: dimX (xbs,xh,xw,xd)
+	// sb001: dimW (fc,fh,fw,xd)
+	// sb002: W
+	// sb003: B
+	// sb004: dimY
+	// sb005: Y
+	// sb006: MW
+	// sb007: VW
+	// sb008: MB
+	// sb019: VB
+	// sb010: dL_dW
+	// sb011: dL_dB
+	// sb012: dL_dX
+	// sb013: param (disable_bias,stride)
+	vkk_uniformAttachment_t ua0_array[] =
+	{
+		{
+			.binding = 0,
+			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
+			.buffer  = self->dL_dX->sb_dim,
+		},
+		{
+			.binding = 1,
+			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
+			.buffer  = self->W->sb_dim,
+		},
+		{
+			.binding = 2,
+			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
+			.buffer  = self->W->sb_data,
+		},
+		{
+			.binding = 3,
+			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
+			.buffer  = self->B->sb_data,
+		},
+		{
+			.binding = 4,
+			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
+			.buffer  = self->Y->sb_dim,
+		},
+		{
+			.binding = 5,
+			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
+			.buffer  = self->Y->sb_data,
+		},
+		{
+			.binding = 6,
+			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
+			.buffer  = self->MW->sb_data,
+		},
+		{
+			.binding = 7,
+			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
+			.buffer  = self->VW->sb_data,
+		},
+		{
+			.binding = 8,
+			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
+			.buffer  = self->MB->sb_data,
+		},
+		{
+			.binding = 9,
+			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
+			.buffer  = self->VB->sb_data,
+		},
+		{
+			.binding = 10,
+			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
+			.buffer  = self->dL_dW->sb_data,
+		},
 		{
-			return NULL;
-		}
-		nn_engine_computeDispatch(engine, VKK_HAZARD_RAW,
-		                          fc, 1, 1, 64, 1, 1);
-	}
+			.binding = 11,
+			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
+			.buffer  = self->dL_dB->sb_data,
+		},
+		{
+			.binding = 12,
+			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
+			.buffer  = self->dL_dX->sb_data,
+		},
+		{
+			.binding = 13,
+			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
+			.buffer  = self->sb013_param,
+		},
+	};
 
-	return self->dL_dX;
+	nn_engine_computeUpdateUniformSetRefs(engine,
+	                                      self->us0, 14,
+	                                      ua0_array);
 }
 
-static void
-nn_convLayer_postFn(nn_layer_t* base,
-                    int flags, uint32_t bs)
+static int
+nn_convLayer_updateParam(nn_convLayer_t* self)
 {
-	ASSERT(base);
+	ASSERT(self);
 
-	nn_convLayer_t* self = (nn_convLayer_t*) base;
+	nn_engine_t* engine = self->base.arch->engine;
 
-	if(flags & NN_ARCH_FLAG_FP_STATS)
+	// the CPU backend does not require uniform sets
+	if(engine->cpu)
 	{
-		LOGI("Y min=%f, max=%f, mean=%f, stddev=%f, norm=%f",
-		     nn_tensorStats_min(self->stats_Y),
-		     nn_tensorStats_max(self->stats_Y),
-		     nn_tensorStats_mean(self->stats_Y),
-		     nn_tensorStats_stddev(self->stats_Y),
-		     nn_tensorStats_norm(self->stats_Y));
+		return 1;
 	}
 
-	if(flags & NN_ARCH_FLAG_BP_STATS)
+	nn_convLayerParam_t param =
 	{
-		LOGI("dL_dX min=%f, max=%f, mean=%f, stddev=%f, norm=%f",
-		     nn_tensorStats_min(self->stats_dL_dX),
-		     nn_tensorStats_max(self->stats_dL_dX),
-		     nn_tensorStats_mean(self->stats_dL_dX),
-		     nn_tensorStats_stddev(self->stats_dL_dX),
-		     nn_tensorStats_norm(self->stats_dL_dX));
+		.disable_bias = (self->flags & NN_CONV_LAYER_FLAG_DISABLE_BIAS) ? 1 : 0,
+		.stride       = self->stride,
+		.fact_fn      = (uint32_t) self->fact_fn,
+		.dilation     = self->dilation,
+	};
+	vkk_buffer_t* sb013_param;
+	sb013_param = vkk_buffer_new(engine->engine,
+	                             VKK_UPDATE_MODE_STATIC,
+	                             VKK_BUFFER_USAGE_STORAGE,
+	                             sizeof(nn_convLayerParam_t),
+	                             &param);
+	if(sb013_param == NULL)
+	{
+		return 0;
 	}
-}
 
-static nn_dim_t*
-nn_convLayer_dimXFn(nn_layer_t* base)
-{
-	ASSERT(base);
+	if(self->gemm_Y)
+	{
+		nn_dim_t* dimW = nn_tensor_dim(self->W);
+		nn_dim_t* dimY = nn_tensor_dim(self->Y);
 
-	nn_convLayer_t* self = (nn_convLayer_t*) base;
+		int flags_Y = NN_TENSOR_GEMM_FLAG_TRANS_B |
+		              NN_TENSOR_GEMM_FLAG_BS_M    |
+		              NN_TENSOR_GEMM_FLAG_FACT(self->fact_fn);
+		if((self->flags & NN_CONV_LAYER_FLAG_DISABLE_BIAS) == 0)
+		{
+			flags_Y |= NN_TENSOR_GEMM_FLAG_BIAS;
+		}
 
-	return nn_tensor_dim(self->dL_dX);
-}
+		nn_tensorGemm_t* gemm_Y;
+		gemm_Y = nn_tensorGemm_new(engine, 1,
+		                           dimY->height*dimY->width,
+		                           dimW->count,
+		                           dimW->height*dimW->width*
+		                           dimW->depth, flags_Y);
+		if(gemm_Y == NULL)
+		{
+			vkk_buffer_delete(&sb013_param);
+			return 0;
+		}
 
-static nn_dim_t*
-nn_convLayer_dimYFn(nn_layer_t* base)
-{
-	ASSERT(base);
+		nn_tensorGemm_delete(&self->gemm_Y);
+		self->gemm_Y = gemm_Y;
+	}
 
-	nn_convLayer_t* self = (nn_convLayer_t*) base;
+	// the backprop GEMMs scale dL_dY by dY_dZ on load
+	if(self->gemm_dL_dW)
+	{
+		nn_dim_t* dimW = nn_tensor_dim(self->W);
+		nn_dim_t* dimY = nn_tensor_dim(self->Y);
+		uint32_t  rows = dimY->height*dimY->width;
+		uint32_t  k    = dimW->height*dimW->width*dimW->depth;
+		int       fn   = NN_TENSOR_GEMM_FLAG_DFACT_A(self->fact_fn);
+
+		nn_tensorGemm_t* gemm_dL_dW;
+		gemm_dL_dW = nn_tensorGemm_new(engine, 1, dimW->count,
+		                               k, rows,
+		                               NN_TENSOR_GEMM_FLAG_TRANS_A |
+		                               NN_TENSOR_GEMM_FLAG_BS_K    |
+		                               fn);
+		if(gemm_dL_dW == NULL)
+		{
+			vkk_buffer_delete(&sb013_param);
+			return 0;
+		}
 
-	return nn_tensor_dim(self->Y);
+		nn_tensorGemm_t* gemm_dL_dX;
+		gemm_dL_dX = nn_tensorGemm_new(engine, 1, rows, k,
+		                               dimW->count,
+		                               NN_TENSOR_GEMM_FLAG_BS_M |
+		                               fn);
+		if(gemm_dL_dX == NULL)
+		{
+			nn_tensorGemm_delete(&gemm_dL_dW);
+			vkk_buffer_delete(&sb013_param);
+			return 0;
+		}
+
+		nn_tensorGemm_delete(&self->gemm_dL_dW);
+		nn_tensorGemm_delete(&self->gemm_dL_dX);
+		self->gemm_dL_dW = gemm_dL_dW;
+		self->gemm_dL_dX = gemm_dL_dX;
+	}
+
+	vkk_buffer_delete(&self->sb013_param);
+	self->sb013_param = sb013_param;
+	nn_convLayer_updateUs0(self);
+
+	return 1;
 }
 
 /***********************************************************
@@ -582,7 +3012,7 @@ nn_convLayer_dimYFn(nn_layer_t* base)
 nn_convLayer_t*
 nn_convLayer_new(nn_arch_t* arch, nn_dim_t* dimX,
                  nn_dim_t* dimW, uint32_t stride,
-                 int flags)
+                 uint32_t dilation, int flags)
 {
 	ASSERT(arch);
 	ASSERT(dimX);
@@ -597,10 +3027,25 @@ nn_convLayer_new(nn_arch_t* arch, nn_dim_t* dimX,
 	uint32_t xh = dimX->height;
 	uint32_t xw = dimX->width;
 
-	if(dimX->depth != dimW->depth)
+	// grouped convolution
+	// groups = xd/wd where each group of fc/groups filters
+	// is applied to a contiguous wd slice of the channels
+	// (e.g. depthwise when wd is 1)
+	uint32_t wd     = dimW->depth;
+	uint32_t groups = (wd > 0) ? dimX->depth/wd : 0;
+	if((groups == 0) || (dimX->depth%wd) || (fc%groups) ||
+	   ((groups > 1) && (flags & NN_CONV_LAYER_FLAG_TRANSPOSE)))
+	{
+		LOGE("invalid depth=%u:%u, fc=%u, flags=0x%X",
+		     dimX->depth, wd, fc, flags);
+		return NULL;
+	}
+
+	// the transpose kernels do not support dilation
+	if((dilation < 1) ||
+	   ((dilation > 1) && (flags & NN_CONV_LAYER_FLAG_TRANSPOSE)))
 	{
-		LOGE("invalid depth=%u:%u",
-		     dimX->depth, dimW->depth);
+		LOGE("invalid dilation=%u, flags=0x%X", dilation, flags);
 		return NULL;
 	}
 
@@ -633,6 +3078,7 @@ nn_convLayer_new(nn_arch_t* arch, nn_dim_t* dimX,
 		.post_fn       = nn_convLayer_postFn,
 		.dimX_fn       = nn_convLayer_dimXFn,
 		.dimY_fn       = nn_convLayer_dimYFn,
+		.quantize_fn   = nn_convLayer_quantizeFn,
 	};
 
 	if(flags & NN_CONV_LAYER_FLAG_TRANSPOSE)
@@ -641,6 +3087,17 @@ nn_convLayer_new(nn_arch_t* arch, nn_dim_t* dimX,
 		info.compute_bp_fn = nn_convLayer_computeBpTFn;
 	}
 
+	if(engine->cpu)
+	{
+		info.compute_fp_fn = nn_convLayer_computeFpCpuFn;
+		info.compute_bp_fn = nn_convLayer_computeBpCpuFn;
+		if(flags & NN_CONV_LAYER_FLAG_TRANSPOSE)
+		{
+			info.compute_fp_fn = nn_convLayer_computeFpTCpuFn;
+			info.compute_bp_fn = nn_convLayer_computeBpTCpuFn;
+		}
+	}
+
 	nn_convLayer_t* self;
 	self = (nn_convLayer_t*)
 	       nn_layer_new(sizeof(nn_convLayer_t), &info);
@@ -650,7 +3107,8 @@ nn_convLayer_new(nn_arch_t* arch, nn_dim_t* dimX,
 	}
 
 	self->flags  = flags;
-	self->stride = stride;
+	self->stride   = stride;
+	self->dilation = dilation;
 
 	// XAVIER is default
 	if(flags & NN_CONV_LAYER_FLAG_HE)
@@ -716,9 +3174,12 @@ nn_convLayer_new(nn_arch_t* arch, nn_dim_t* dimX,
 		goto fail_Y;
 	}
 
+	// optimizer and gradient state
+	nn_tensorMode_e mode = nn_arch_trainMode(arch);
+
 	self->MW = nn_tensor_new(engine, dimW,
 	                         NN_TENSOR_INIT_ZERO,
-	                         NN_TENSOR_MODE_COMPUTE);
+	                         mode);
 	if(self->MW == NULL)
 	{
 		goto fail_MW;
@@ -726,7 +3187,7 @@ nn_convLayer_new(nn_arch_t* arch, nn_dim_t* dimX,
 
 	self->VW = nn_tensor_new(engine, dimW,
 	                         NN_TENSOR_INIT_ZERO,
-	                         NN_TENSOR_MODE_COMPUTE);
+	                         mode);
 	if(self->VW == NULL)
 	{
 		goto fail_VW;
@@ -734,7 +3195,7 @@ nn_convLayer_new(nn_arch_t* arch, nn_dim_t* dimX,
 
 	self->MB = nn_tensor_new(engine, &dimB,
 	                         NN_TENSOR_INIT_ZERO,
-	                         NN_TENSOR_MODE_COMPUTE);
+	                         mode);
 	if(self->MB == NULL)
 	{
 		goto fail_MB;
@@ -742,15 +3203,28 @@ nn_convLayer_new(nn_arch_t* arch, nn_dim_t* dimX,
 
 	self->VB = nn_tensor_new(engine, &dimB,
 	                         NN_TENSOR_INIT_ZERO,
-	                         NN_TENSOR_MODE_COMPUTE);
+	                         mode);
 	if(self->VB == NULL)
 	{
 		goto fail_VB;
 	}
 
+	// the GEMM path computes dL_dW directly so only the
+	// direct and split-K kernels fuse the Adam update
+	nn_tensorMode_e mode_dL_dW = mode;
+	if((engine->cpu == NULL) &&
+	   (nn_convLayer_useWinograd(dimX, dimW, stride,
+	                             dilation, flags) ||
+	    (nn_convLayer_useGemm(dimX, dimW, &dimY, stride,
+	                          flags) == 0)))
+	{
+		self->fused = 1;
+		mode_dL_dW  = NN_TENSOR_MODE_NONE;
+	}
+
 	self->dL_dW = nn_tensor_new(engine, dimW,
 	                            NN_TENSOR_INIT_ZERO,
-	                            NN_TENSOR_MODE_COMPUTE);
+	                            mode_dL_dW);
 	if(self->dL_dW == NULL)
 	{
 		goto fail_dL_dW;
@@ -758,7 +3232,7 @@ nn_convLayer_new(nn_arch_t* arch, nn_dim_t* dimX,
 
 	self->dL_dB = nn_tensor_new(engine, &dimB,
 	                            NN_TENSOR_INIT_ZERO,
-	                            NN_TENSOR_MODE_COMPUTE);
+	                            mode_dL_dW);
 	if(self->dL_dB == NULL)
 	{
 		goto fail_dL_dB;
@@ -766,12 +3240,18 @@ nn_convLayer_new(nn_arch_t* arch, nn_dim_t* dimX,
 
 	self->dL_dX = nn_tensor_new(engine, dimX,
 	                            NN_TENSOR_INIT_ZERO,
-	                            NN_TENSOR_MODE_COMPUTE);
+	                            mode);
 	if(self->dL_dX == NULL)
 	{
 		goto fail_dL_dX;
 	}
 
+	self->stats_X = nn_tensorStats_new(engine);
+	if(self->stats_X == NULL)
+	{
+		goto fail_stats_X;
+	}
+
 	self->stats_Y = nn_tensorStats_new(engine);
 	if(self->stats_Y == NULL)
 	{
@@ -784,10 +3264,18 @@ nn_convLayer_new(nn_arch_t* arch, nn_dim_t* dimX,
 		goto fail_stats_dL_dX;
 	}
 
+	// the CPU backend does not require uniform sets
+	if(engine->cpu)
+	{
+		return self;
+	}
+
 	nn_convLayerParam_t param =
 	{
 		.disable_bias = (self->flags & NN_CONV_LAYER_FLAG_DISABLE_BIAS) ? 1 : 0,
 		.stride       = self->stride,
+		.fact_fn      = (uint32_t) self->fact_fn,
+		.dilation     = self->dilation,
 	};
 	self->sb013_param = vkk_buffer_new(engine->engine,
 	                                   VKK_UPDATE_MODE_STATIC,
@@ -820,102 +3308,133 @@ nn_convLayer_new(nn_arch_t* arch, nn_dim_t* dimX,
 		goto fail_us1_bp;
 	}
 
-	// sb000: dimX (xbs,xh,xw,xd)
-	// sb001: dimW (fc,fh,fw,xd)
-	// sb002: W
-	// sb003: B
-	// sb004: dimY
-	// sb005: Y
-	// sb006: MW
-	// sb007: VW
-	// sb008: MB
-	// sb019: VB
-	// sb010: dL_dW
-	// sb011: dL_dB
-	// sb012: dL_dX
-	// sb013: param (disable_bias,stride)
-	vkk_uniformAttachment_t ua0_array[] =
+	nn_convLayer_updateUs0(self);
+
+	// optionally split the dL_dW/dL_dB reductions where
+	// the GEMM path computes dL_dW directly
+	if(arch->inference == 0)
 	{
+		// the split kernels do not support groups
+		int split_W = (groups == 1);
+		if((nn_convLayer_useWinograd(dimX, dimW, stride,
+		                             dilation, flags) == 0) &&
+		   nn_convLayer_useGemm(dimX, dimW, &dimY, stride,
+		                        flags))
 		{
-			.binding = 0,
-			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
-			.buffer  = self->dL_dX->sb_dim,
-		},
-		{
-			.binding = 1,
-			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
-			.buffer  = self->W->sb_dim,
-		},
-		{
-			.binding = 2,
-			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
-			.buffer  = self->W->sb_data,
-		},
-		{
-			.binding = 3,
-			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
-			.buffer  = self->B->sb_data,
-		},
-		{
-			.binding = 4,
-			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
-			.buffer  = self->Y->sb_dim,
-		},
-		{
-			.binding = 5,
-			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
-			.buffer  = self->Y->sb_data,
-		},
-		{
-			.binding = 6,
-			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
-			.buffer  = self->MW->sb_data,
-		},
-		{
-			.binding = 7,
-			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
-			.buffer  = self->VW->sb_data,
-		},
-		{
-			.binding = 8,
-			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
-			.buffer  = self->MB->sb_data,
-		},
-		{
-			.binding = 9,
-			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
-			.buffer  = self->VB->sb_data,
-		},
-		{
-			.binding = 10,
-			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
-			.buffer  = self->dL_dW->sb_data,
-		},
+			split_W = 0;
+		}
+
+		if(nn_convLayer_newSplit(self, dimX, &dimY,
+		                         split_W) == 0)
 		{
-			.binding = 11,
-			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
-			.buffer  = self->dL_dB->sb_data,
-		},
+			goto fail_split;
+		}
+	}
+
+	// optionally use Winograd for 3x3 stride 1 layers
+	if(nn_convLayer_useWinograd(dimX, dimW, stride,
+	                            dilation, flags))
+	{
+		if(nn_convLayer_newWinograd(self, dimX, dimW) == 0)
 		{
-			.binding = 12,
-			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
-			.buffer  = self->dL_dX->sb_data,
-		},
+			goto fail_winograd;
+		}
+		return self;
+	}
+
+	// optionally lower to im2col + GEMM
+	if(nn_convLayer_useGemm(dimX, dimW, &dimY, stride,
+	                        flags) == 0)
+	{
+		return self;
+	}
+
+	uint32_t rows = yh*yw;
+	uint32_t k    = fh*fw*dimX->depth;
+
+	vkk_updateMode_e um;
+	um = vkk_compute_updateMode(engine->compute);
+	self->sb200_col = vkk_buffer_new(engine->engine, um,
+	                                 VKK_BUFFER_USAGE_STORAGE,
+	                                 bs*rows*k*sizeof(float),
+	                                 NULL);
+	if(self->sb200_col == NULL)
+	{
+		goto fail_sb200_col;
+	}
+
+	self->us2_col = vkk_uniformSet_new(engine->engine, 2, 0, NULL,
+	                                   engine->usf2_conv_col);
+	if(self->us2_col == NULL)
+	{
+		goto fail_us2_col;
+	}
+
+	// sb200: col
+	vkk_uniformAttachment_t ua2_array[] =
+	{
 		{
-			.binding = 13,
+			.binding = 0,
 			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
-			.buffer  = self->sb013_param,
+			.buffer  = self->sb200_col,
 		},
 	};
 
-	vkk_compute_updateUniformSetRefs(engine->compute,
-	                                 self->us0, 14,
-	                                 ua0_array);
+	nn_engine_computeUpdateUniformSetRefs(engine,
+	                                      self->us2_col, 1,
+	                                      ua2_array);
+
+	// Y = col*W^T + B
+	int flags_Y = NN_TENSOR_GEMM_FLAG_TRANS_B |
+	              NN_TENSOR_GEMM_FLAG_BS_M;
+	if((flags & NN_CONV_LAYER_FLAG_DISABLE_BIAS) == 0)
+	{
+		flags_Y |= NN_TENSOR_GEMM_FLAG_BIAS;
+	}
+	self->gemm_Y = nn_tensorGemm_new(engine, 1, rows, fc, k,
+	                                 flags_Y);
+	if(self->gemm_Y == NULL)
+	{
+		goto fail_gemm_Y;
+	}
+
+	// dL_dW = dL_dY^T*col
+	self->gemm_dL_dW = nn_tensorGemm_new(engine, 1, fc, k, rows,
+	                                     NN_TENSOR_GEMM_FLAG_TRANS_A |
+	                                     NN_TENSOR_GEMM_FLAG_BS_K);
+	if(self->gemm_dL_dW == NULL)
+	{
+		goto fail_gemm_dL_dW;
+	}
+
+	// col = dL_dY*W
+	self->gemm_dL_dX = nn_tensorGemm_new(engine, 1, rows, k, fc,
+	                                     NN_TENSOR_GEMM_FLAG_BS_M);
+	if(self->gemm_dL_dX == NULL)
+	{
+		goto fail_gemm_dL_dX;
+	}
 
 	// success
 	return self;
 
 	// failure
+	fail_gemm_dL_dX:
+		nn_tensorGemm_delete(&self->gemm_dL_dW);
+	fail_gemm_dL_dW:
+		nn_tensorGemm_delete(&self->gemm_Y);
+	fail_gemm_Y:
+		vkk_uniformSet_delete(&self->us2_col);
+	fail_us2_col:
+		vkk_buffer_delete(&self->sb200_col);
+	fail_sb200_col:
+	fail_winograd:
+		vkk_uniformSet_delete(&self->us2_split);
+		vkk_buffer_delete(&self->sb202_split);
+		vkk_buffer_delete(&self->sb201_P_dL_dB);
+		vkk_buffer_delete(&self->sb200_P_dL_dW);
+	fail_split:
+		vkk_uniformSet_delete(&self->us1_bp);
 	fail_us1_bp:
 		vkk_uniformSet_delete(&self->us1_fp);
 	fail_us1_fp:
@@ -927,6 +3446,8 @@ nn_convLayer_new(nn_arch_t* arch, nn_dim_t* dimX,
 	fail_stats_dL_dX:
 		nn_tensorStats_delete(&self->stats_Y);
 	fail_stats_Y:
+		nn_tensorStats_delete(&self->stats_X);
+	fail_stats_X:
 		nn_tensor_delete(&self->dL_dX);
 	fail_dL_dX:
 		nn_tensor_delete(&self->dL_dB);
@@ -958,12 +3479,31 @@ void nn_convLayer_delete(nn_convLayer_t** _self)
 	nn_convLayer_t* self = *_self;
 	if(self)
 	{
+		nn_tensorGemm_delete(&self->gemm_wg_dL_dX);
+		nn_tensorGemm_delete(&self->gemm_wg_Y);
+		vkk_uniformSet_delete(&self->us2_wg);
+		vkk_buffer_delete(&self->sb203_M);
+		vkk_buffer_delete(&self->sb202_V);
+		vkk_buffer_delete(&self->sb201_UT);
+		vkk_buffer_delete(&self->sb200_U);
+		nn_tensorGemm_delete(&self->gemm_dL_dX);
+		nn_tensorGemm_delete(&self->gemm_dL_dW);
+		nn_tensorGemm_delete(&self->gemm_Y);
+		vkk_uniformSet_delete(&self->us2_col);
+		vkk_buffer_delete(&self->sb200_col);
+		vkk_uniformSet_delete(&self->us2_split);
+		vkk_buffer_delete(&self->sb202_split);
+		vkk_buffer_delete(&self->sb201_P_dL_dB);
+		vkk_buffer_delete(&self->sb200_P_dL_dW);
 		vkk_uniformSet_delete(&self->us1_bp);
 		vkk_uniformSet_delete(&self->us1_fp);
 		vkk_uniformSet_delete(&self->us0);
 		vkk_buffer_delete(&self->sb013_param);
+		FREE(self->q8_X);
+		nn_tensorQ8_delete(&self->q8);
 		nn_tensorStats_delete(&self->stats_dL_dX);
 		nn_tensorStats_delete(&self->stats_Y);
+		nn_tensorStats_delete(&self->stats_X);
 		nn_tensor_delete(&self->dL_dX);
 		nn_tensor_delete(&self->dL_dB);
 		nn_tensor_delete(&self->dL_dW);
@@ -990,16 +3530,18 @@ nn_convLayer_import(nn_arch_t* arch, cc_jsmnVal_t* val)
 		return NULL;
 	}
 
-	cc_jsmnVal_t* val_dimX   = NULL;
-	cc_jsmnVal_t* val_dimW   = NULL;
-	cc_jsmnVal_t* val_flags  = NULL;
-	cc_jsmnVal_t* val_stride = NULL;
-	cc_jsmnVal_t* val_W      = NULL;
-	cc_jsmnVal_t* val_B      = NULL;
-	cc_jsmnVal_t* val_MW     = NULL;
-	cc_jsmnVal_t* val_VW     = NULL;
-	cc_jsmnVal_t* val_MB     = NULL;
-	cc_jsmnVal_t* val_VB     = NULL;
+	cc_jsmnVal_t* val_dimX     = NULL;
+	cc_jsmnVal_t* val_dimW     = NULL;
+	cc_jsmnVal_t* val_flags    = NULL;
+	cc_jsmnVal_t* val_stride   = NULL;
+	cc_jsmnVal_t* val_dilation = NULL;
+	cc_jsmnVal_t* val_W        = NULL;
+	cc_jsmnVal_t* val_B        = NULL;
+	cc_jsmnVal_t* val_MW       = NULL;
+	cc_jsmnVal_t* val_VW       = NULL;
+	cc_jsmnVal_t* val_MB       = NULL;
+	cc_jsmnVal_t* val_VB       = NULL;
+	cc_jsmnVal_t* val_Q8       = NULL;
 
 	cc_listIter_t* iter = cc_list_head(val->obj->list);
 	while(iter)
@@ -1017,6 +3559,10 @@ nn_convLayer_import(nn_arch_t* arch, cc_jsmnVal_t* val)
 			{
 				val_stride = kv->val;
 			}
+			else if(strcmp(kv->key, "dilation") == 0)
+			{
+				val_dilation = kv->val;
+			}
 		}
 		else if(kv->val->type == CC_JSMN_TYPE_OBJECT)
 		{
@@ -1052,6 +3598,10 @@ nn_convLayer_import(nn_arch_t* arch, cc_jsmnVal_t* val)
 			{
 				val_VB = kv->val;
 			}
+			else if(strcmp(kv->key, "Q8") == 0)
+			{
+				val_Q8 = kv->val;
+			}
 		}
 
 		iter = cc_list_next(iter);
@@ -1062,12 +3612,27 @@ nn_convLayer_import(nn_arch_t* arch, cc_jsmnVal_t* val)
 	   (val_dimW          == NULL) ||
 	   (val_flags         == NULL) ||
 	   (val_stride        == NULL) ||
-	   (val_W             == NULL) ||
-	   (val_B             == NULL) ||
-	   (val_MW            == NULL) ||
-	   (val_VW            == NULL) ||
-	   (val_MB            == NULL) ||
-	   (val_VB            == NULL))
+	   (val_B             == NULL))
+	{
+		LOGE("invalid");
+		return NULL;
+	}
+
+	// quantized layers replace W and the optimizer state
+	// and are inference-only
+	if(val_Q8)
+	{
+		if(nn_arch_trainMode(arch) != NN_TENSOR_MODE_NONE)
+		{
+			LOGE("invalid");
+			return NULL;
+		}
+	}
+	else if((val_W  == NULL) ||
+	        (val_MW == NULL) ||
+	        (val_VW == NULL) ||
+	        (val_MB == NULL) ||
+	        (val_VB == NULL))
 	{
 		LOGE("invalid");
 		return NULL;
@@ -1076,6 +3641,13 @@ nn_convLayer_import(nn_arch_t* arch, cc_jsmnVal_t* val)
 	int      flags  = strtol(val_flags->data, NULL, 0);
 	uint32_t stride = strtol(val_stride->data, NULL, 0);
 
+	// dilation is optional for older models
+	uint32_t dilation = 1;
+	if(val_dilation)
+	{
+		dilation = strtol(val_dilation->data, NULL, 0);
+	}
+
 	nn_dim_t dimX;
 	nn_dim_t dimW;
 	if((nn_dim_import(&dimX, val_dimX) == 0) ||
@@ -1086,18 +3658,40 @@ nn_convLayer_import(nn_arch_t* arch, cc_jsmnVal_t* val)
 
 	nn_convLayer_t* self;
 	self = nn_convLayer_new(arch, &dimX, &dimW,
-	                        stride, flags);
+	                        stride, dilation, flags);
 	if(self == NULL)
 	{
 		return NULL;
 	}
 
-	if((nn_tensor_import(self->W,  val_W)  == 0) ||
-	   (nn_tensor_import(self->B,  val_B)  == 0) ||
-	   (nn_tensor_import(self->MW, val_MW) == 0) ||
-	   (nn_tensor_import(self->VW, val_VW) == 0) ||
-	   (nn_tensor_import(self->MB, val_MB) == 0) ||
-	   (nn_tensor_import(self->VB, val_VB) == 0))
+	if(val_Q8)
+	{
+		if(nn_tensor_import(self->B, val_B) == 0)
+		{
+			goto fail_tensor;
+		}
+
+		nn_tensorQ8_t* q8;
+		q8 = nn_tensorQ8_import(arch->engine,
+		                        nn_tensor_dim(self->dL_dX),
+		                        &dimW, val_Q8);
+		if(q8 == NULL)
+		{
+			goto fail_tensor;
+		}
+
+		if(nn_convLayer_setQ8(self, q8) == 0)
+		{
+			nn_tensorQ8_delete(&q8);
+			goto fail_tensor;
+		}
+	}
+	else if((nn_tensor_import(self->W,  val_W)  == 0) ||
+	        (nn_tensor_import(self->B,  val_B)  == 0) ||
+	        (nn_tensor_import(self->MW, val_MW) == 0) ||
+	        (nn_tensor_import(self->VW, val_VW) == 0) ||
+	        (nn_tensor_import(self->MB, val_MB) == 0) ||
+	        (nn_tensor_import(self->VB, val_VB) == 0))
 	{
 		goto fail_tensor;
 	}
@@ -1130,19 +3724,71 @@ int nn_convLayer_export(nn_convLayer_t* self,
 	ret &= cc_jsmnStream_int(stream, self->flags);
 	ret &= cc_jsmnStream_key(stream, "%s", "stride");
 	ret &= cc_jsmnStream_int(stream, (int) self->stride);
-	ret &= cc_jsmnStream_key(stream, "%s", "W");
-	ret &= nn_tensor_export(self->W, stream);
-	ret &= cc_jsmnStream_key(stream, "%s", "B");
-	ret &= nn_tensor_export(self->B, stream);
-	ret &= cc_jsmnStream_key(stream, "%s", "MW");
-	ret &= nn_tensor_export(self->MW, stream);
-	ret &= cc_jsmnStream_key(stream, "%s", "VW");
-	ret &= nn_tensor_export(self->VW, stream);
-	ret &= cc_jsmnStream_key(stream, "%s", "MB");
-	ret &= nn_tensor_export(self->MB, stream);
-	ret &= cc_jsmnStream_key(stream, "%s", "VB");
-	ret &= nn_tensor_export(self->VB, stream);
+	ret &= cc_jsmnStream_key(stream, "%s", "dilation");
+	ret &= cc_jsmnStream_int(stream, (int) self->dilation);
+	if(self->q8)
+	{
+		// quantized W replaces W and the Adam state
+		ret &= cc_jsmnStream_key(stream, "%s", "Q8");
+		ret &= nn_tensorQ8_export(self->q8, stream);
+		ret &= cc_jsmnStream_key(stream, "%s", "B");
+		ret &= nn_tensor_export(self->B, stream);
+	}
+	else
+	{
+		ret &= cc_jsmnStream_key(stream, "%s", "W");
+		ret &= nn_tensor_export(self->W, stream);
+		ret &= cc_jsmnStream_key(stream, "%s", "B");
+		ret &= nn_tensor_export(self->B, stream);
+		ret &= cc_jsmnStream_key(stream, "%s", "MW");
+		ret &= nn_tensor_export(self->MW, stream);
+		ret &= cc_jsmnStream_key(stream, "%s", "VW");
+		ret &= nn_tensor_export(self->VW, stream);
+		ret &= cc_jsmnStream_key(stream, "%s", "MB");
+		ret &= nn_tensor_export(self->MB, stream);
+		ret &= cc_jsmnStream_key(stream, "%s", "VB");
+		ret &= nn_tensor_export(self->VB, stream);
+	}
 	ret &= cc_jsmnStream_end(stream);
 
 	return ret;
 }
+
+int nn_convLayer_foldBatchNorm(nn_convLayer_t* self,
+                               nn_batchNormLayer_t* bn)
+{
+	ASSERT(self);
+	ASSERT(bn);
+
+	// bake the normalized weights before folding
+	if(nn_convLayer_bakeNorm(self) == 0)
+	{
+		return 0;
+	}
+
+	if(nn_batchNormLayer_fold(bn, self->W, self->B) == 0)
+	{
+		return 0;
+	}
+	self->wg_dirty = 1;
+
+	if((self->flags & NN_CONV_LAYER_FLAG_DISABLE_BIAS) == 0)
+	{
+		return 1;
+	}
+
+	// the folded bias is required
+	self->flags &= ~NN_CONV_LAYER_FLAG_DISABLE_BIAS;
+
+	return nn_convLayer_updateParam(self);
+}
+
+int nn_convLayer_fuseFact(nn_convLayer_t* self,
+                          nn_factLayerFn_e fact_fn)
+{
+	ASSERT(self);
+
+	self->fact_fn = fact_fn;
+
+	return nn_convLayer_updateParam(self);
+}
@@ -27,6 +27,7 @@
 #include "../libcc/jsmn/cc_jsmnStream.h"
 #include "../libcc/jsmn/cc_jsmnWrapper.h"
 #include "../libvkk/vkk.h"
+#include "nn_factLayer.h"
 #include "nn_layer.h"
 
 // defaults:
@@ -48,6 +49,15 @@ typedef struct nn_convLayer_s
 
 	uint32_t stride;
 
+	// dilation spaces the filter taps by d so the receptive
+	// field is d*(fh - 1) + 1 (transpose requires d = 1)
+	uint32_t dilation;
+
+	// fused activation (optional)
+	// Y is replaced by fact(Y) and the backprop kernels
+	// scale dL_dY by dfact(Y) when it is loaded
+	nn_factLayerFn_e fact_fn;
+
 	// weights, bias, output
 	// s  = stride
 	// Standard
@@ -56,8 +66,12 @@ typedef struct nn_convLayer_s
 	// Transpose
 	//   yh = s*xh
 	//   yw = s*xw
+	// Grouped
+	//   wd     = xd/groups (wd is 1 for depthwise)
+	//   filter f reads X channels [g*wd, (g + 1)*wd) where
+	//   g = f/(fc/groups)
 	nn_tensor_t* X; // dim(bs,xh,xw,xd) (reference)
-	nn_tensor_t* W; // dim(fc,fh,fw,xd)
+	nn_tensor_t* W; // dim(fc,fh,fw,wd)
 	nn_tensor_t* B; // dim(fc,1,1,1)
 	nn_tensor_t* Y; // dim(bs,yh,yw,fc)
 
@@ -73,25 +87,74 @@ typedef struct nn_convLayer_s
 	// dY_dW; // X : dim(bs,xh,xw,xd)
 
 	// backprop gradients
+	// fused selects the backprop kernels which apply the
+	// Adam update as dL_dW and dL_dB are reduced, in which
+	// case dL_dW and dL_dB are placeholders
 	//           dL_dY; // dim(bs,yh,yw,fc)
+	int          fused;
 	nn_tensor_t* dL_dW; // dim(fc,fh,fw,xd)
 	nn_tensor_t* dL_dB; // dim(fc,1,1,1)
 	nn_tensor_t* dL_dX; // dim(bs,xh,xw,xd)
 
 	// stats
+	nn_tensorStats_t* stats_X;
 	nn_tensorStats_t* stats_Y;
 	nn_tensorStats_t* stats_dL_dX;
 
+	// int8 inference (optional)
+	// q8_xmax is the calibrated max(|X|) and q8_X is the
+	// quantized input for the CPU backend (see
+	// nn_arch_quantize)
+	float          q8_xmax;
+	nn_tensorQ8_t* q8;
+	int8_t*        q8_X; // dim(bs,xh,xw,xd)
+
 	vkk_buffer_t*     sb013_param;
 	vkk_uniformSet_t* us0;
 	vkk_uniformSet_t* us1_fp;
 	vkk_uniformSet_t* us1_bp;
+
+	// split-K dL_dW/dL_dB (optional)
+	// each split reduces a chunk of the bs*h rows into a
+	// partial sum that is reduced in a second pass
+	uint32_t          split;
+	vkk_buffer_t*     sb200_P_dL_dW; // dim(split*fc,fh,fw,xd)
+	vkk_buffer_t*     sb201_P_dL_dB; // dim(split*fc,1,1,1)
+	vkk_buffer_t*     sb202_split;
+	vkk_uniformSet_t* us2_split;
+
+	// im2col + GEMM (optional)
+	// selected automatically by layer shape where col is
+	// dim(bs*yh*yw,fh*fw*xd) and is reused for dL_dY*W
+	vkk_buffer_t*     sb200_col;
+	vkk_uniformSet_t* us2_col;
+	nn_tensorGemm_t*  gemm_Y;
+	nn_tensorGemm_t*  gemm_dL_dW;
+	nn_tensorGemm_t*  gemm_dL_dX;
+
+	// Winograd F(2x2,3x3) (optional)
+	// selected automatically for 3x3 stride 1 layers where
+	// the transformed filters are recomputed when W changes
+	// wg_dirty only tracks changes outside of backprop since
+	// the update of W also records the transform
+	// th = (yh + 1)/2
+	// tw = (yw + 1)/2
+	// c  = max(xd,fc)
+	int               wg_dirty;
+	vkk_buffer_t*     sb200_U;  // dim(16,fc,xd)
+	vkk_buffer_t*     sb201_UT; // dim(16,xd,fc)
+	vkk_buffer_t*     sb202_V;  // dim(16,bs*th*tw,c)
+	vkk_buffer_t*     sb203_M;  // dim(16,bs*th*tw,c)
+	vkk_uniformSet_t* us2_wg;
+	nn_tensorGemm_t*  gemm_wg_Y;
+	nn_tensorGemm_t*  gemm_wg_dL_dX;
 } nn_convLayer_t;
 
 nn_convLayer_t* nn_convLayer_new(nn_arch_t* arch,
                                  nn_dim_t* dimX,
                                  nn_dim_t* dimW,
                                  uint32_t stride,
+                                 uint32_t dilation,
                                  int flags);
 void            nn_convLayer_delete(nn_convLayer_t** _self);
 nn_convLayer_t* nn_convLayer_import(nn_arch_t* arch,
@@ -99,4 +162,14 @@ nn_convLayer_t* nn_convLayer_import(nn_arch_t* arch,
 int             nn_convLayer_export(nn_convLayer_t* self,
                                     cc_jsmnStream_t* stream);
 
+// fold a batch normalization layer that directly follows
+// the conv layer into W and B (see nn_arch_freeze)
+int             nn_convLayer_foldBatchNorm(nn_convLayer_t* self,
+                                           nn_batchNormLayer_t* bn);
+
+// fuse an activation function that directly follows the
+// conv layer (e.g. nn_coderLayer without batch norm)
+int             nn_convLayer_fuseFact(nn_convLayer_t* self,
+                                      nn_factLayerFn_e fact_fn);
+
 #endif
@@ -0,0 +1,415 @@
+/*
+ * Copyright (c) 2023 Jeff Boody
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#if defined(__ARM_NEON)
+	#include <arm_neon.h>
+#elif defined(__SSE__)
+	#include <xmmintrin.h>
+#endif
+
+#define LOG_TAG "nn"
+#include "../libcc/cc_log.h"
+#include "../libcc/cc_memory.h"
+#include "nn_cpu.h"
+
+/***********************************************************
+* private                                                  *
+***********************************************************/
+
+static void nn_cpu_work(nn_cpu_t* self)
+{
+	ASSERT(self);
+
+	// tasks are claimed one at a time so that the load is
+	// balanced when tasks have an uneven amount of work
+	uint32_t idx;
+	while(1)
+	{
+		idx = __atomic_fetch_add(&self->task_next, 1,
+		                         __ATOMIC_RELAXED);
+		if(idx >= self->task_count)
+		{
+			return;
+		}
+
+		(*self->task_fn)(self->task_priv, idx);
+	}
+}
+
+static void* nn_cpu_thread(void* arg)
+{
+	ASSERT(arg);
+
+	nn_cpu_t* self = (nn_cpu_t*) arg;
+
+	uint32_t generation = 0;
+
+	pthread_mutex_lock(&self->mutex);
+	while(1)
+	{
+		// wait for the next run
+		while(self->running &&
+		      (self->generation == generation))
+		{
+			pthread_cond_wait(&self->cond_run, &self->mutex);
+		}
+
+		if(self->running == 0)
+		{
+			break;
+		}
+		generation = self->generation;
+		pthread_mutex_unlock(&self->mutex);
+
+		nn_cpu_work(self);
+
+		pthread_mutex_lock(&self->mutex);
+		--self->busy;
+		if(self->busy == 0)
+		{
+			pthread_cond_signal(&self->cond_done);
+		}
+	}
+	pthread_mutex_unlock(&self->mutex);
+
+	return NULL;
+}
+
+static void nn_cpu_stop(nn_cpu_t* self, uint32_t count)
+{
+	ASSERT(self);
+
+	pthread_mutex_lock(&self->mutex);
+	self->running = 0;
+	pthread_cond_broadcast(&self->cond_run);
+	pthread_mutex_unlock(&self->mutex);
+
+	uint32_t i;
+	for(i = 0; i < count; ++i)
+	{
+		pthread_join(self->threads[i], NULL);
+	}
+}
+
+/***********************************************************
+* public                                                   *
+***********************************************************/
+
+nn_cpu_t* nn_cpu_new(uint32_t thread_count)
+{
+	nn_cpu_t* self;
+	self = (nn_cpu_t*) CALLOC(1, sizeof(nn_cpu_t));
+	if(self == NULL)
+	{
+		LOGE("CALLOC failed");
+		return NULL;
+	}
+
+	// the calling thread is also a worker
+	if(thread_count == 0)
+	{
+		long cores = sysconf(_SC_NPROCESSORS_ONLN);
+		if(cores > 1)
+		{
+			thread_count = (uint32_t) cores;
+		}
+		else
+		{
+			thread_count = 1;
+		}
+	}
+	self->thread_count = thread_count - 1;
+	self->running      = 1;
+
+	if(self->thread_count)
+	{
+		self->threads = (pthread_t*)
+		                CALLOC(self->thread_count,
+		                       sizeof(pthread_t));
+		if(self->threads == NULL)
+		{
+			LOGE("CALLOC failed");
+			goto fail_threads;
+		}
+	}
+
+	if(pthread_mutex_init(&self->mutex, NULL) != 0)
+	{
+		LOGE("pthread_mutex_init failed");
+		goto fail_mutex;
+	}
+
+	if(pthread_cond_init(&self->cond_run, NULL) != 0)
+	{
+		LOGE("pthread_cond_init failed");
+		goto fail_cond_run;
+	}
+
+	if(pthread_cond_init(&self->cond_done, NULL) != 0)
+	{
+		LOGE("pthread_cond_init failed");
+		goto fail_cond_done;
+	}
+
+	uint32_t i;
+	for(i = 0; i < self->thread_count; ++i)
+	{
+		if(pthread_create(&self->threads[i], NULL,
+		                  nn_cpu_thread, (void*) self) != 0)
+		{
+			LOGE("pthread_create failed");
+			goto fail_create;
+		}
+	}
+
+	// success
+	return self;
+
+	// failure
+	fail_create:
+		nn_cpu_stop(self, i);
+		pthread_cond_destroy(&self->cond_done);
+	fail_cond_done:
+		pthread_cond_destroy(&self->cond_run);
+	fail_cond_run:
+		pthread_mutex_destroy(&self->mutex);
+	fail_mutex:
+		FREE(self->threads);
+	fail_threads:
+		FREE(self);
+	return NULL;
+}
+
+void nn_cpu_delete(nn_cpu_t** _self)
+{
+	ASSERT(_self);
+
+	nn_cpu_t* self = *_self;
+	if(self)
+	{
+		nn_cpu_stop(self, self->thread_count);
+		pthread_cond_destroy(&self->cond_done);
+		pthread_cond_destroy(&self->cond_run);
+		pthread_mutex_destroy(&self->mutex);
+		FREE(self->threads);
+		FREE(self);
+		*_self = NULL;
+	}
+}
+
+void nn_cpu_run(nn_cpu_t* self, nn_cpuTask_fn task_fn,
+                void* priv, uint32_t count)
+{
+	ASSERT(self);
+	ASSERT(task_fn);
+
+	// execute small runs on the calling thread
+	uint32_t idx;
+	if((self->thread_count == 0) || (count <= 1))
+	{
+		for(idx = 0; idx < count; ++idx)
+		{
+			(*task_fn)(priv, idx);
+		}
+		return;
+	}
+
+	pthread_mutex_lock(&self->mutex);
+	self->task_fn    = task_fn;
+	self->task_priv  = priv;
+	self->task_count = count;
+	self->task_next  = 0;
+	self->busy       = self->thread_count;
+	++self->generation;
+	pthread_cond_broadcast(&self->cond_run);
+	pthread_mutex_unlock(&self->mutex);
+
+	nn_cpu_work(self);
+
+	// wait for all workers to finish so the next run may
+	// safely replace the task
+	pthread_mutex_lock(&self->mutex);
+	while(self->busy)
+	{
+		pthread_cond_wait(&self->cond_done, &self->mutex);
+	}
+	pthread_mutex_unlock(&self->mutex);
+}
+
+float nn_cpu_dot(const float* a, const float* b,
+                 uint32_t n)
+{
+	ASSERT(a);
+	ASSERT(b);
+
+	uint32_t i = 0;
+	float    s = 0.0f;
+
+	#if defined(__ARM_NEON)
+	float32x4_t s4 = vdupq_n_f32(0.0f);
+	for(; i + 4 <= n; i += 4)
+	{
+		s4 = vmlaq_f32(s4, vld1q_f32(&a[i]), vld1q_f32(&b[i]));
+	}
+	s = vgetq_lane_f32(s4, 0) + vgetq_lane_f32(s4, 1) +
+	    vgetq_lane_f32(s4, 2) + vgetq_lane_f32(s4, 3);
+	#elif defined(__SSE__)
+	float  t[4];
+	__m128 s4 = _mm_setzero_ps();
+	for(; i + 4 <= n; i += 4)
+	{
+		s4 = _mm_add_ps(s4, _mm_mul_ps(_mm_loadu_ps(&a[i]),
+		                               _mm_loadu_ps(&b[i])));
+	}
+	_mm_storeu_ps(t, s4);
+	s = t[0] + t[1] + t[2] + t[3];
+	#endif
+
+	for(; i < n; ++i)
+	{
+		s += a[i]*b[i];
+	}
+
+	return s;
+}
+
+void nn_cpu_axpy(float alpha, const float* x, float* y,
+                 uint32_t n)
+{
+	ASSERT(x);
+	ASSERT(y);
+
+	uint32_t i = 0;
+
+	#if defined(__ARM_NEON)
+	float32x4_t a4 = vdupq_n_f32(alpha);
+	for(; i + 4 <= n; i += 4)
+	{
+		vst1q_f32(&y[i], vmlaq_f32(vld1q_f32(&y[i]), a4,
+		                           vld1q_f32(&x[i])));
+	}
+	#elif defined(__SSE__)
+	__m128 a4 = _mm_set1_ps(alpha);
+	for(; i + 4 <= n; i += 4)
+	{
+		_mm_storeu_ps(&y[i],
+		              _mm_add_ps(_mm_loadu_ps(&y[i]),
+		                         _mm_mul_ps(a4,
+		                                    _mm_loadu_ps(&x[i]))));
+	}
+	#endif
+
+	for(; i < n; ++i)
+	{
+		y[i] += alpha*x[i];
+	}
+}
+
+void nn_cpu_quantize(float scale, const float* x,
+                     int8_t* q, uint32_t n)
+{
+	ASSERT(x);
+	ASSERT(q);
+
+	float    s = 1.0f/scale;
+	float    v;
+	uint32_t i;
+	for(i = 0; i < n; ++i)
+	{
+		v = roundf(s*x[i]);
+		if(v < -127.0f)
+		{
+			v = -127.0f;
+		}
+		else if(v > 127.0f)
+		{
+			v = 127.0f;
+		}
+		q[i] = (int8_t) v;
+	}
+}
+
+int32_t nn_cpu_dotQ8(const int8_t* a, const int8_t* b,
+                     uint32_t n)
+{
+	ASSERT(a);
+	ASSERT(b);
+
+	uint32_t i = 0;
+	int32_t  s = 0;
+
+	#if defined(__ARM_NEON)
+	int32x4_t s4 = vdupq_n_s32(0);
+	for(; i + 8 <= n; i += 8)
+	{
+		s4 = vpadalq_s16(s4, vmull_s8(vld1_s8(&a[i]),
+		                              vld1_s8(&b[i])));
+	}
+	s = vgetq_lane_s32(s4, 0) + vgetq_lane_s32(s4, 1) +
+	    vgetq_lane_s32(s4, 2) + vgetq_lane_s32(s4, 3);
+	#endif
+
+	for(; i < n; ++i)
+	{
+		s += ((int32_t) a[i])*((int32_t) b[i]);
+	}
+
+	return s;
+}
+
+void nn_cpu_adam(nn_archState_t* state, float* W,
+                 float* MW, float* VW, const float* dL_dW,
+                 uint32_t n)
+{
+	ASSERT(state);
+	ASSERT(W);
+	ASSERT(MW);
+	ASSERT(VW);
+	ASSERT(dL_dW);
+
+	float alpha   = state->adam_alpha;
+	float beta1   = state->adam_beta1;
+	float beta2   = state->adam_beta2;
+	float beta1t  = state->adam_beta1t;
+	float beta2t  = state->adam_beta2t;
+	float epsilon = 1e-07;
+
+	float    g;
+	float    m;
+	float    v;
+	uint32_t i;
+	for(i = 0; i < n; ++i)
+	{
+		g     = dL_dW[i];
+		m     = beta1*MW[i] + (1.0f - beta1)*g;
+		v     = beta2*VW[i] + (1.0f - beta2)*g*g;
+		MW[i] = m;
+		VW[i] = v;
+		W[i] += -alpha*(m/(1.0f - beta1t))/
+		        (sqrtf(v/(1.0f - beta2t)) + epsilon);
+	}
+}
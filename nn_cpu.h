@@ -0,0 +1,87 @@
+/*
+ * Copyright (c) 2023 Jeff Boody
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#ifndef nn_cpu_H
+#define nn_cpu_H
+
+#include <pthread.h>
+
+#include "nn_arch.h"
+
+// task callback
+// idx is in the range [0, count) and each idx is executed
+// exactly once by one of the worker threads or the caller
+typedef void (*nn_cpuTask_fn)(void* priv, uint32_t idx);
+
+typedef struct nn_cpu_s
+{
+	int running;
+
+	// worker threads
+	// the calling thread also participates in each run so
+	// thread_count is zero on single core devices
+	uint32_t   thread_count;
+	pthread_t* threads;
+
+	pthread_mutex_t mutex;
+	pthread_cond_t  cond_run;
+	pthread_cond_t  cond_done;
+
+	// current run
+	uint32_t      generation;
+	uint32_t      busy;
+	nn_cpuTask_fn task_fn;
+	void*         task_priv;
+	uint32_t      task_count;
+	uint32_t      task_next;
+} nn_cpu_t;
+
+// thread_count includes the calling thread and zero
+// selects one thread per online core
+nn_cpu_t* nn_cpu_new(uint32_t thread_count);
+void      nn_cpu_delete(nn_cpu_t** _self);
+void      nn_cpu_run(nn_cpu_t* self,
+                     nn_cpuTask_fn task_fn,
+                     void* priv,
+                     uint32_t count);
+
+// SIMD helpers
+float nn_cpu_dot(const float* a, const float* b,
+                 uint32_t n);
+void  nn_cpu_axpy(float alpha, const float* x, float* y,
+                  uint32_t n);
+
+// int8 helpers (see nn_tensorQ8)
+// q = clamp(round(x/scale), -127, 127)
+void    nn_cpu_quantize(float scale, const float* x,
+                        int8_t* q, uint32_t n);
+int32_t nn_cpu_dotQ8(const int8_t* a, const int8_t* b,
+                     uint32_t n);
+
+// Adam update
+// W += -alpha*m_hat/(sqrt(v_hat) + epsilon)
+void nn_cpu_adam(nn_archState_t* state, float* W,
+                 float* MW, float* VW, const float* dL_dW,
+                 uint32_t n);
+
+#endif
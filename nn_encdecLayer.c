@@ -257,6 +257,54 @@ nn_encdecLayer_postFn(nn_layer_t* base,
 	nn_layer_post(&self->dec0->base,   flags, bs);
 }
 
+static int
+nn_encdecLayer_freezeFn(nn_layer_t* base)
+{
+	ASSERT(base);
+
+	nn_encdecLayer_t* self = (nn_encdecLayer_t*) base;
+
+	int ret = 1;
+	ret &= nn_layer_freeze(&self->enc0->base);
+	ret &= nn_layer_freeze(self->down1.base);
+	ret &= nn_layer_freeze(&self->enc1->base);
+	ret &= nn_layer_freeze(self->down2.base);
+	ret &= nn_layer_freeze(&self->node20->base);
+	ret &= nn_layer_freeze(&self->node21->base);
+	ret &= nn_layer_freeze(&self->node22->base);
+	ret &= nn_layer_freeze(&self->node23->base);
+	ret &= nn_layer_freeze(self->up1.base);
+	ret &= nn_layer_freeze(&self->dec1->base);
+	ret &= nn_layer_freeze(self->up0.base);
+	ret &= nn_layer_freeze(&self->dec0->base);
+
+	return ret;
+}
+
+static int
+nn_encdecLayer_quantizeFn(nn_layer_t* base)
+{
+	ASSERT(base);
+
+	nn_encdecLayer_t* self = (nn_encdecLayer_t*) base;
+
+	int ret = 1;
+	ret &= nn_layer_quantize(&self->enc0->base);
+	ret &= nn_layer_quantize(self->down1.base);
+	ret &= nn_layer_quantize(&self->enc1->base);
+	ret &= nn_layer_quantize(self->down2.base);
+	ret &= nn_layer_quantize(&self->node20->base);
+	ret &= nn_layer_quantize(&self->node21->base);
+	ret &= nn_layer_quantize(&self->node22->base);
+	ret &= nn_layer_quantize(&self->node23->base);
+	ret &= nn_layer_quantize(self->up1.base);
+	ret &= nn_layer_quantize(&self->dec1->base);
+	ret &= nn_layer_quantize(self->up0.base);
+	ret &= nn_layer_quantize(&self->dec0->base);
+
+	return ret;
+}
+
 static nn_dim_t*
 nn_encdecLayer_dimXFn(nn_layer_t* base)
 {
@@ -296,6 +344,8 @@ nn_encdecLayer_new(nn_encdecLayerInfo_t* info)
 		.post_fn       = nn_encdecLayer_postFn,
 		.dimX_fn       = nn_encdecLayer_dimXFn,
 		.dimY_fn       = nn_encdecLayer_dimYFn,
+		.freeze_fn     = nn_encdecLayer_freezeFn,
+		.quantize_fn   = nn_encdecLayer_quantizeFn,
 	};
 
 	nn_encdecLayer_t* self;
@@ -754,6 +804,8 @@ nn_encdecLayer_import(nn_arch_t* arch, cc_jsmnVal_t* val)
 		.post_fn       = nn_encdecLayer_postFn,
 		.dimX_fn       = nn_encdecLayer_dimXFn,
 		.dimY_fn       = nn_encdecLayer_dimYFn,
+		.freeze_fn     = nn_encdecLayer_freezeFn,
+		.quantize_fn   = nn_encdecLayer_quantizeFn,
 	};
 
 	nn_encdecLayer_t*  self;
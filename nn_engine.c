@@ -21,21 +21,25 @@
  *
  */
 
+#include <stddef.h>
 #include <stdlib.h>
 #include <string.h>
 
 #define LOG_TAG "nn"
 #include "../libcc/cc_log.h"
 #include "../libcc/cc_memory.h"
+#include "../libcc/cc_timestamp.h"
 #include "../libvkk/vkk.h"
 #include "nn_batchNormLayer.h"
 #include "nn_convLayer.h"
+#include "nn_cpu.h"
 #include "nn_engine.h"
 #include "nn_lanczosLayer.h"
 #include "nn_layer.h"
 #include "nn_loss.h"
 #include "nn_tensor.h"
 
+// default submission policy
 // split dispatch to improve UI responsiveness
 // 1) the actual number of dispatches issued may vary
 //    depending on NN layer design
@@ -44,10 +48,407 @@
 //    architecure for a particular problem
 #define NN_ENGINE_DISPATCH_HINT 100
 
+// time per dispatch estimate smoothing factor
+#define NN_ENGINE_SUBMIT_ALPHA 0.25
+
+// captured commands
+typedef enum
+{
+	NN_ENGINE_CMD_BIND     = 0,
+	NN_ENGINE_CMD_BIND_US  = 1,
+	NN_ENGINE_CMD_UPDATE   = 2,
+	NN_ENGINE_CMD_DISPATCH = 3,
+	NN_ENGINE_CMD_FILL     = 4,
+	NN_ENGINE_CMD_COPY     = 5,
+	NN_ENGINE_CMD_LAYER    = 6,
+} nn_engineCmdType_e;
+
+typedef struct
+{
+	nn_engineCmdType_e type;
+	vkk_hazard_e       hazard;
+
+	// BIND
+	vkk_computePipeline_t* cp;
+
+	// BIND_US/UPDATE
+	uint32_t                 count;
+	vkk_uniformSet_t*        us;
+	vkk_uniformSet_t**       us_array;
+	vkk_uniformAttachment_t* ua_array;
+
+	// DISPATCH/LAYER
+	uint32_t param[6];
+
+	// FILL/COPY
+	vkk_buffer_t* src;
+	vkk_buffer_t* dst;
+	size_t        src_offset;
+	size_t        dst_offset;
+	size_t        size;
+	uint32_t      data;
+} nn_engineCmd_t;
+
+// compute pipelines are created on first use
+// see nn_engine_getPipeline
+typedef struct
+{
+	size_t      cp;
+	size_t      pl;
+	const char* cs;
+	const char* name;
+} nn_engineCpInfo_t;
+
+#define NN_ENGINE_CP_INFO(cp, pl, cs) \
+	{ offsetof(nn_engine_t, cp), offsetof(nn_engine_t, pl), cs, #cp }
+
+static const nn_engineCpInfo_t NN_ENGINE_CP_INFO[] =
+{
+	NN_ENGINE_CP_INFO(cp_batchNorm_forwardPassXstatsTrain, pl_batchNorm_fp,
+	                  "nn/shaders/nn_batchNormLayer_forwardPassXstatsTrain_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_batchNorm_forwardPassXstatsCompute, pl_batchNorm_fp,
+	                  "nn/shaders/nn_batchNormLayer_forwardPassXstatsCompute_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_batchNorm_forwardPassXhat, pl_batchNorm_fp,
+	                  "nn/shaders/nn_batchNormLayer_forwardPassXhat_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_batchNorm_backprop_dL_dX, pl_batchNorm_bp,
+	                  "nn/shaders/nn_batchNormLayer_backprop_dL_dX_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_batchNorm_backprop_dL_dXhat, pl_batchNorm_bp,
+	                  "nn/shaders/nn_batchNormLayer_backprop_dL_dXhat_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_batchNorm_backpropSum, pl_batchNorm_bp,
+	                  "nn/shaders/nn_batchNormLayer_backpropSum_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_batchNorm_backpropSumNOP, pl_batchNorm_bp,
+	                  "nn/shaders/nn_batchNormLayer_backpropSumNOP_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_batchNorm_forwardPassXhatF16, pl_batchNorm_fp,
+	                  "nn/shaders/nn_batchNormLayer_forwardPassXhatF16_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_batchNorm_backprop_dL_dXF16, pl_batchNorm_bp,
+	                  "nn/shaders/nn_batchNormLayer_backprop_dL_dXF16_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_batchNorm_backprop_dL_dXhatF16, pl_batchNorm_bp,
+	                  "nn/shaders/nn_batchNormLayer_backprop_dL_dXhatF16_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_batchNorm_backpropSumF16, pl_batchNorm_bp,
+	                  "nn/shaders/nn_batchNormLayer_backpropSumF16_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_batchNorm_backpropSumNOPF16, pl_batchNorm_bp,
+	                  "nn/shaders/nn_batchNormLayer_backpropSumNOPF16_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_conv_forwardPassClamp, pl_conv_fp,
+	                  "nn/shaders/nn_convLayer_forwardPassClamp_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_conv_forwardPassPad, pl_conv_fp,
+	                  "nn/shaders/nn_convLayer_forwardPassPad_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_conv_forwardPassTileClamp, pl_conv_fp,
+	                  "nn/shaders/nn_convLayer_forwardPassTileClamp_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_conv_forwardPassTilePad, pl_conv_fp,
+	                  "nn/shaders/nn_convLayer_forwardPassTilePad_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_conv_forwardPassTClamp, pl_conv_fp,
+	                  "nn/shaders/nn_convLayer_forwardPassTClamp_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_conv_forwardPassTPad, pl_conv_fp,
+	                  "nn/shaders/nn_convLayer_forwardPassTPad_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_conv_forwardPassQ8Clamp, pl_conv_q8,
+	                  "nn/shaders/nn_convLayer_forwardPassQ8Clamp_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_conv_forwardPassQ8Pad, pl_conv_q8,
+	                  "nn/shaders/nn_convLayer_forwardPassQ8Pad_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_conv_forwardPassQ8X, pl_conv_q8,
+	                  "nn/shaders/nn_tensorQ8_quantizeX_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_conv_backprop_dL_dX, pl_conv_bp,
+	                  "nn/shaders/nn_convLayer_backprop_dL_dX_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_conv_backprop_dL_dW, pl_conv_bp,
+	                  "nn/shaders/nn_convLayer_backprop_dL_dW_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_conv_backprop_dL_dWAdam, pl_conv_bp,
+	                  "nn/shaders/nn_convLayer_backprop_dL_dWAdam_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_conv_backprop_dL_dB, pl_conv_bp,
+	                  "nn/shaders/nn_convLayer_backprop_dL_dB_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_conv_backprop_dL_dBAdam, pl_conv_bp,
+	                  "nn/shaders/nn_convLayer_backprop_dL_dBAdam_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_conv_backpropT_dL_dX, pl_conv_bp,
+	                  "nn/shaders/nn_convLayer_backpropT_dL_dX_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_conv_backpropT_dL_dW, pl_conv_bp,
+	                  "nn/shaders/nn_convLayer_backpropT_dL_dW_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_conv_backpropT_dL_dWAdam, pl_conv_bp,
+	                  "nn/shaders/nn_convLayer_backpropT_dL_dWAdam_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_conv_backpropUpdateW, pl_conv_bp,
+	                  "nn/shaders/nn_convLayer_backpropUpdateW_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_conv_backpropUpdateB, pl_conv_bp,
+	                  "nn/shaders/nn_convLayer_backpropUpdateB_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_conv_backpropSplit_dL_dW, pl_conv_split,
+	                  "nn/shaders/nn_convLayer_backpropSplit_dL_dW_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_conv_backpropTSplit_dL_dW, pl_conv_split,
+	                  "nn/shaders/nn_convLayer_backpropTSplit_dL_dW_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_conv_backpropSplit_dL_dB, pl_conv_split,
+	                  "nn/shaders/nn_convLayer_backpropSplit_dL_dB_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_conv_backpropReduce_dL_dW, pl_conv_split,
+	                  "nn/shaders/nn_convLayer_backpropReduce_dL_dW_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_conv_backpropReduce_dL_dWAdam, pl_conv_split,
+	                  "nn/shaders/nn_convLayer_backpropReduce_dL_dWAdam_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_conv_backpropReduce_dL_dB, pl_conv_split,
+	                  "nn/shaders/nn_convLayer_backpropReduce_dL_dB_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_conv_backpropReduce_dL_dBAdam, pl_conv_split,
+	                  "nn/shaders/nn_convLayer_backpropReduce_dL_dBAdam_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_conv_im2colClamp, pl_conv_col,
+	                  "nn/shaders/nn_convLayer_im2colClamp_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_conv_im2colPad, pl_conv_col,
+	                  "nn/shaders/nn_convLayer_im2colPad_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_conv_im2colTClamp, pl_conv_col,
+	                  "nn/shaders/nn_convLayer_im2colTClamp_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_conv_im2colTPad, pl_conv_col,
+	                  "nn/shaders/nn_convLayer_im2colTPad_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_conv_col2im, pl_conv_col,
+	                  "nn/shaders/nn_convLayer_col2im_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_conv_col2imT, pl_conv_col,
+	                  "nn/shaders/nn_convLayer_col2imT_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_conv_winogradW, pl_conv_wg_fp,
+	                  "nn/shaders/nn_convLayer_winogradW_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_conv_winogradWT, pl_conv_wg_fp,
+	                  "nn/shaders/nn_convLayer_winogradWT_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_conv_winogradXClamp, pl_conv_wg_fp,
+	                  "nn/shaders/nn_convLayer_winogradXClamp_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_conv_winogradXPad, pl_conv_wg_fp,
+	                  "nn/shaders/nn_convLayer_winogradXPad_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_conv_winogradY, pl_conv_wg_fp,
+	                  "nn/shaders/nn_convLayer_winogradY_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_conv_winograd_dL_dY, pl_conv_wg_bp,
+	                  "nn/shaders/nn_convLayer_winograd_dL_dY_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_conv_winograd_dL_dX, pl_conv_wg_bp,
+	                  "nn/shaders/nn_convLayer_winograd_dL_dX_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_fact_forwardPassLinear, pl_fact_fp,
+	                  "nn/shaders/nn_factLayer_forwardPassLinear_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_fact_forwardPassLogistic, pl_fact_fp,
+	                  "nn/shaders/nn_factLayer_forwardPassLogistic_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_fact_forwardPassReLU, pl_fact_fp,
+	                  "nn/shaders/nn_factLayer_forwardPassReLU_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_fact_forwardPassPReLU, pl_fact_fp,
+	                  "nn/shaders/nn_factLayer_forwardPassPReLU_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_fact_forwardPassLReLU, pl_fact_fp,
+	                  "nn/shaders/nn_factLayer_forwardPassLReLU_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_fact_forwardPassTanh, pl_fact_fp,
+	                  "nn/shaders/nn_factLayer_forwardPassTanh_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_fact_forwardPassSink, pl_fact_fp,
+	                  "nn/shaders/nn_factLayer_forwardPassSink_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_fact_backpropLinear, pl_fact_bp,
+	                  "nn/shaders/nn_factLayer_backpropLinear_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_fact_backpropLogistic, pl_fact_bp,
+	                  "nn/shaders/nn_factLayer_backpropLogistic_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_fact_backpropReLU, pl_fact_bp,
+	                  "nn/shaders/nn_factLayer_backpropReLU_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_fact_backpropPReLU, pl_fact_bp,
+	                  "nn/shaders/nn_factLayer_backpropPReLU_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_fact_backpropLReLU, pl_fact_bp,
+	                  "nn/shaders/nn_factLayer_backpropLReLU_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_fact_backpropTanh, pl_fact_bp,
+	                  "nn/shaders/nn_factLayer_backpropTanh_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_fact_backpropSink, pl_fact_bp,
+	                  "nn/shaders/nn_factLayer_backpropSink_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_groupNorm_forwardPassXstats, pl_groupNorm_fp,
+	                  "nn/shaders/nn_groupNormLayer_forwardPassXstats_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_groupNorm_forwardPassXhat, pl_groupNorm_fp,
+	                  "nn/shaders/nn_groupNormLayer_forwardPassXhat_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_groupNorm_backpropSum, pl_groupNorm_bp,
+	                  "nn/shaders/nn_groupNormLayer_backpropSum_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_groupNorm_backpropSumGB, pl_groupNorm_bp,
+	                  "nn/shaders/nn_groupNormLayer_backpropSumGB_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_groupNorm_backprop_dL_dX, pl_groupNorm_bp,
+	                  "nn/shaders/nn_groupNormLayer_backprop_dL_dX_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_groupNorm_backpropUpdate, pl_groupNorm_bp,
+	                  "nn/shaders/nn_groupNormLayer_backpropUpdate_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_lanczos_forwardPassT, pl_lanczos_fp,
+	                  "nn/shaders/nn_lanczosLayer_forwardPassT_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_lanczos_forwardPassY, pl_lanczos_fp,
+	                  "nn/shaders/nn_lanczosLayer_forwardPassY_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_lanczos_backprop_dL_dT, pl_lanczos_bp,
+	                  "nn/shaders/nn_lanczosLayer_backprop_dL_dT_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_lanczos_backprop_dL_dX, pl_lanczos_bp,
+	                  "nn/shaders/nn_lanczosLayer_backprop_dL_dX_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_skip_forwardPassAdd, pl_skip_fp,
+	                  "nn/shaders/nn_skipLayer_forwardPassAdd_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_skip_forwardPassCat, pl_skip_fp,
+	                  "nn/shaders/nn_skipLayer_forwardPassCat_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_skip_backpropAdd, pl_skip_bp,
+	                  "nn/shaders/nn_skipLayer_backpropAdd_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_skip_backpropCat, pl_skip_bp,
+	                  "nn/shaders/nn_skipLayer_backpropCat_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_skip_backpropFork, pl_skip_bp,
+	                  "nn/shaders/nn_skipLayer_backpropFork_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_weight_forwardPass, pl_weight_fp,
+	                  "nn/shaders/nn_weightLayer_forwardPass_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_weight_forwardPassQ8, pl_weight_q8,
+	                  "nn/shaders/nn_weightLayer_forwardPassQ8_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_weight_forwardPassQ8X, pl_weight_q8,
+	                  "nn/shaders/nn_tensorQ8_quantizeX_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_weight_backpropUpdateW, pl_weight_bp,
+	                  "nn/shaders/nn_weightLayer_backpropUpdateW_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_weight_backpropUpdateB, pl_weight_bp,
+	                  "nn/shaders/nn_weightLayer_backpropUpdateB_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_weight_backprop_dL_dX, pl_weight_bp,
+	                  "nn/shaders/nn_weightLayer_backprop_dL_dX_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_weight_backprop_dL_dW, pl_weight_bp,
+	                  "nn/shaders/nn_weightLayer_backprop_dL_dW_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_weight_backprop_dL_dWAdam, pl_weight_bp,
+	                  "nn/shaders/nn_weightLayer_backprop_dL_dWAdam_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_weight_backprop_dL_dB, pl_weight_bp,
+	                  "nn/shaders/nn_weightLayer_backprop_dL_dB_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_weight_backprop_dL_dBAdam, pl_weight_bp,
+	                  "nn/shaders/nn_weightLayer_backprop_dL_dBAdam_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_loss_dL_dY_mse, pl_loss,
+	                  "nn/shaders/nn_loss_dL_dY_mse_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_loss_dL_dY_mae, pl_loss,
+	                  "nn/shaders/nn_loss_dL_dY_mae_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_loss_dL_dY_bce, pl_loss,
+	                  "nn/shaders/nn_loss_dL_dY_bce_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_loss_mse, pl_loss,
+	                  "nn/shaders/nn_loss_mse_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_loss_mae, pl_loss,
+	                  "nn/shaders/nn_loss_mae_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_loss_bce, pl_loss,
+	                  "nn/shaders/nn_loss_bce_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_tensor_stats, pl_tensor_stats,
+	                  "nn/shaders/nn_tensor_stats_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_tensor_sn, pl_tensor_norm,
+	                  "nn/shaders/nn_tensor_sn_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_tensor_bssn, pl_tensor_norm,
+	                  "nn/shaders/nn_tensor_bssn_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_tensor_computeFillOp, pl_tensor_op,
+	                  "nn/shaders/nn_tensor_computeFillOp_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_tensor_computeCopyOp, pl_tensor_op,
+	                  "nn/shaders/nn_tensor_computeCopyOp_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_tensor_computeAddOp, pl_tensor_op,
+	                  "nn/shaders/nn_tensor_computeAddOp_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_tensor_computeMixOp, pl_tensor_op,
+	                  "nn/shaders/nn_tensor_computeMixOp_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_tensor_computeMulOp, pl_tensor_op,
+	                  "nn/shaders/nn_tensor_computeMulOp_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_tensor_computeScaleOp, pl_tensor_op,
+	                  "nn/shaders/nn_tensor_computeScaleOp_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_tensor_computeScaleAddOp, pl_tensor_op,
+	                  "nn/shaders/nn_tensor_computeScaleAddOp_comp.spv"),
+	NN_ENGINE_CP_INFO(cp_tensor_gemm, pl_tensor_gemm,
+	                  "nn/shaders/nn_tensor_gemm_comp.spv"),
+};
+
+#define NN_ENGINE_CP_INFO_COUNT \
+	((int) (sizeof(NN_ENGINE_CP_INFO)/sizeof(nn_engineCpInfo_t)))
+
+// uniform set references
+#define NN_ENGINE_UA_MAX 20
+
+typedef struct
+{
+	uint32_t                count;
+	vkk_uniformAttachment_t ua_array[NN_ENGINE_UA_MAX];
+} nn_engineUs_t;
+
+// shared dimensions buffer
+typedef struct
+{
+	vkk_buffer_t* sb_dim;
+	uint32_t      ref;
+} nn_engineDim_t;
+
+// tensor op cache key
+// the key must be cleared since it contains padding
+typedef struct
+{
+	vkk_buffer_t*       sb_buffer[6];
+	nn_tensorOpUs0Idx_t idx;
+} nn_engineTensorOpKey_t;
+
+typedef struct
+{
+	nn_engineTensorOpKey_t key;
+	nn_tensorOpUs0Data_t*  data;
+} nn_engineTensorOp_t;
+
+// profile entry
+// aggregated per layer/kernel
+typedef struct
+{
+	int         layer;
+	const char* kernel;
+	uint32_t    count;
+	double      time;
+} nn_engineProfile_t;
+
 /***********************************************************
 * private                                                  *
 ***********************************************************/
 
+static nn_engineCmd_t*
+nn_engine_captureCmd(nn_engine_t* self,
+                     nn_engineCmdType_e type,
+                     vkk_hazard_e hazard,
+                     size_t extra)
+{
+	ASSERT(self);
+
+	// the us_array/ua_array is stored after the command
+	nn_engineCmd_t* cmd;
+	cmd = (nn_engineCmd_t*)
+	      CALLOC(1, sizeof(nn_engineCmd_t) + extra);
+	if(cmd == NULL)
+	{
+		LOGE("CALLOC failed");
+		self->capture_error = 1;
+		return NULL;
+	}
+	cmd->type   = type;
+	cmd->hazard = hazard;
+
+	if(cc_list_append(self->capture_cmds, NULL, cmd) == NULL)
+	{
+		self->capture_error = 1;
+		FREE(cmd);
+		return NULL;
+	}
+
+	return cmd;
+}
+
+static void
+nn_engine_usRegister(nn_engine_t* self,
+                     vkk_uniformSet_t* us,
+                     uint32_t ua_count,
+                     vkk_uniformAttachment_t* ua_array)
+{
+	ASSERT(self);
+	ASSERT(us);
+	ASSERT(ua_array);
+
+	if(ua_count > NN_ENGINE_UA_MAX)
+	{
+		LOGW("invalid ua_count=%u", ua_count);
+		self->map_us_error = 1;
+		return;
+	}
+
+	nn_engineUs_t* data;
+
+	cc_mapIter_t* miter;
+	miter = cc_map_findp(self->map_us,
+	                     sizeof(vkk_uniformSet_t*), &us);
+	if(miter)
+	{
+		data = (nn_engineUs_t*) cc_map_val(miter);
+	}
+	else
+	{
+		data = (nn_engineUs_t*)
+		       CALLOC(1, sizeof(nn_engineUs_t));
+		if(data == NULL)
+		{
+			LOGE("CALLOC failed");
+			self->map_us_error = 1;
+			return;
+		}
+
+		if(cc_map_addp(self->map_us, data,
+		               sizeof(vkk_uniformSet_t*), &us) == NULL)
+		{
+			self->map_us_error = 1;
+			FREE(data);
+			return;
+		}
+	}
+
+	data->count = ua_count;
+	memcpy(data->ua_array, ua_array,
+	       ua_count*sizeof(vkk_uniformAttachment_t));
+}
+
 static void
 nn_engine_initUbArray(vkk_uniformBinding_t* ub_array,
                       uint32_t count)
@@ -63,33 +464,17 @@ nn_engine_initUbArray(vkk_uniformBinding_t* ub_array,
 	}
 }
 
-/***********************************************************
-* public                                                   *
-***********************************************************/
-
-nn_engine_t*
-nn_engine_new(vkk_engine_t* engine)
+static int
+nn_engine_newCompute(nn_engine_t* self)
 {
-	ASSERT(engine);
-
-	nn_engine_t* self;
-	self = (nn_engine_t*)
-	       CALLOC(1, sizeof(nn_engine_t));
-	if(self == NULL)
-	{
-		LOGE("CALLOC failed");
-		return NULL;
-	}
-
-	self->engine = engine;
+	ASSERT(self);
 
-	cc_rngUniform_init(&self->rng_uniform);
-	cc_rngNormal_init(&self->rng_normal, 0.0, 1.0);
+	vkk_engine_t* engine = self->engine;
 
 	self->compute = vkk_compute_new(engine);
 	if(self->compute == NULL)
 	{
-		goto failure;
+		return 0;
 	}
 
 	vkk_updateMode_e um;
@@ -119,10 +504,6 @@ nn_engine_new(vkk_engine_t* engine)
 	self->usf1_batchNorm_bp = vkk_uniformSetFactory_new(engine, um,
 	                                                    3, ub_array);
 
-	// sb200: idx (k)
-	self->usf2_batchNorm = vkk_uniformSetFactory_new(engine, um,
-	                                                 1, ub_array);
-
 	// sb000: dimX (xbs,xh,xw,xd)
 	// ...
 	// sb013: param (disable_bias,stride)
@@ -141,6 +522,23 @@ nn_engine_new(vkk_engine_t* engine)
 	self->usf1_conv_bp = vkk_uniformSetFactory_new(engine, um,
 	                                               4, ub_array);
 
+	// sb200: col
+	self->usf2_conv_col = vkk_uniformSetFactory_new(engine, um,
+	                                                1, ub_array);
+
+	// sb200: U
+	// sb201: UT
+	// sb202: V
+	// sb203: M
+	self->usf2_conv_wg = vkk_uniformSetFactory_new(engine, um,
+	                                               4, ub_array);
+
+	// sb200: P_dL_dW
+	// sb201: P_dL_dB
+	// sb202: split
+	self->usf2_conv_split = vkk_uniformSetFactory_new(engine, um,
+	                                                  3, ub_array);
+
 	// sb000: dimX
 	// sb001: Y
 	self->usf0_fact = vkk_uniformSetFactory_new(engine, um,
@@ -158,6 +556,24 @@ nn_engine_new(vkk_engine_t* engine)
 	self->usf1_fact_bp = vkk_uniformSetFactory_new(engine, um,
 	                                               4, ub_array);
 
+	// sb000: dimX (xbs,xh,xw,xd)
+	// ...
+	// sb015: dL_dB
+	self->usf0_groupNorm = vkk_uniformSetFactory_new(engine, um,
+	                                                 16, ub_array);
+
+	// sb100: bs
+	// ...
+	// sb102: X
+	self->usf1_groupNorm_fp = vkk_uniformSetFactory_new(engine, um,
+	                                                    3, ub_array);
+
+	// sb100: bs
+	// ...
+	// sb102: dL_dY
+	self->usf1_groupNorm_bp = vkk_uniformSetFactory_new(engine, um,
+	                                                    3, ub_array);
+
 	// sb000: dimX (bs,xh,xw,xd)
 	// ...
 	// sb008: param (stride)
@@ -250,16 +666,36 @@ nn_engine_new(vkk_engine_t* engine)
 	                                                 um, 7,
 	                                                 ub_array);
 
+	// sb000: bs
+	// ...
+	// sb006: YA
+	self->usf0_tensor_gemm = vkk_uniformSetFactory_new(engine,
+	                                                   um, 7,
+	                                                   ub_array);
+
+	// sb200: Wq
+	// sb201: scale_w
+	// sb202: param (scale_x,stride,depth,groups)
+	// sb203: Xq
+	self->usf2_tensor_q8 = vkk_uniformSetFactory_new(engine,
+	                                                 um, 4,
+	                                                 ub_array);
+
 	if((self->usf0_batchNorm    == NULL) ||
 	   (self->usf1_batchNorm_fp == NULL) ||
 	   (self->usf1_batchNorm_bp == NULL) ||
-	   (self->usf2_batchNorm    == NULL) ||
 	   (self->usf0_conv         == NULL) ||
 	   (self->usf1_conv_fp      == NULL) ||
 	   (self->usf1_conv_bp      == NULL) ||
+	   (self->usf2_conv_col     == NULL) ||
+	   (self->usf2_conv_wg      == NULL) ||
+	   (self->usf2_conv_split   == NULL) ||
 	   (self->usf0_fact         == NULL) ||
 	   (self->usf1_fact_fp      == NULL) ||
 	   (self->usf1_fact_bp      == NULL) ||
+	   (self->usf0_groupNorm    == NULL) ||
+	   (self->usf1_groupNorm_fp == NULL) ||
+	   (self->usf1_groupNorm_bp == NULL) ||
 	   (self->usf0_lanczos      == NULL) ||
 	   (self->usf1_lanczos_fp   == NULL) ||
 	   (self->usf1_lanczos_bp   == NULL) ||
@@ -275,27 +711,27 @@ nn_engine_new(vkk_engine_t* engine)
 	   (self->usf0_tensor       == NULL) ||
 	   (self->usf1_tensor_stats == NULL) ||
 	   (self->usf1_tensor_norm  == NULL) ||
-	   (self->usf0_tensor_op    == NULL))
+	   (self->usf0_tensor_op    == NULL) ||
+	   (self->usf0_tensor_gemm  == NULL) ||
+	   (self->usf2_tensor_q8    == NULL))
 	{
-		goto failure;
+		return 0;
 	}
 
 	vkk_uniformSetFactory_t* usf_array_batchNorm_fp[] =
 	{
 		self->usf0_batchNorm,
 		self->usf1_batchNorm_fp,
-		self->usf2_batchNorm,
 	};
-	self->pl_batchNorm_fp = vkk_pipelineLayout_new(engine, 3,
+	self->pl_batchNorm_fp = vkk_pipelineLayout_new(engine, 2,
 	                                               usf_array_batchNorm_fp);
 
 	vkk_uniformSetFactory_t* usf_array_batchNorm_bp[] =
 	{
 		self->usf0_batchNorm,
 		self->usf1_batchNorm_bp,
-		self->usf2_batchNorm,
 	};
-	self->pl_batchNorm_bp = vkk_pipelineLayout_new(engine, 3,
+	self->pl_batchNorm_bp = vkk_pipelineLayout_new(engine, 2,
 	                                               usf_array_batchNorm_bp);
 
 	vkk_uniformSetFactory_t* usf_array_conv_fp[] =
@@ -314,6 +750,51 @@ nn_engine_new(vkk_engine_t* engine)
 	self->pl_conv_bp = vkk_pipelineLayout_new(engine, 2,
 	                                          usf_array_conv_bp);
 
+	vkk_uniformSetFactory_t* usf_array_conv_col[] =
+	{
+		self->usf0_conv,
+		self->usf1_conv_fp,
+		self->usf2_conv_col,
+	};
+	self->pl_conv_col = vkk_pipelineLayout_new(engine, 3,
+	                                           usf_array_conv_col);
+
+	vkk_uniformSetFactory_t* usf_array_conv_wg_fp[] =
+	{
+		self->usf0_conv,
+		self->usf1_conv_fp,
+		self->usf2_conv_wg,
+	};
+	self->pl_conv_wg_fp = vkk_pipelineLayout_new(engine, 3,
+	                                             usf_array_conv_wg_fp);
+
+	vkk_uniformSetFactory_t* usf_array_conv_wg_bp[] =
+	{
+		self->usf0_conv,
+		self->usf1_conv_bp,
+		self->usf2_conv_wg,
+	};
+	self->pl_conv_wg_bp = vkk_pipelineLayout_new(engine, 3,
+	                                             usf_array_conv_wg_bp);
+
+	vkk_uniformSetFactory_t* usf_array_conv_split[] =
+	{
+		self->usf0_conv,
+		self->usf1_conv_bp,
+		self->usf2_conv_split,
+	};
+	self->pl_conv_split = vkk_pipelineLayout_new(engine, 3,
+	                                             usf_array_conv_split);
+
+	vkk_uniformSetFactory_t* usf_array_conv_q8[] =
+	{
+		self->usf0_conv,
+		self->usf1_conv_fp,
+		self->usf2_tensor_q8,
+	};
+	self->pl_conv_q8 = vkk_pipelineLayout_new(engine, 3,
+	                                          usf_array_conv_q8);
+
 	vkk_uniformSetFactory_t* usf_array_fact_fp[] =
 	{
 		self->usf0_fact,
@@ -330,6 +811,22 @@ nn_engine_new(vkk_engine_t* engine)
 	self->pl_fact_bp = vkk_pipelineLayout_new(engine, 2,
 	                                          usf_array_fact_bp);
 
+	vkk_uniformSetFactory_t* usf_array_groupNorm_fp[] =
+	{
+		self->usf0_groupNorm,
+		self->usf1_groupNorm_fp,
+	};
+	self->pl_groupNorm_fp = vkk_pipelineLayout_new(engine, 2,
+	                                               usf_array_groupNorm_fp);
+
+	vkk_uniformSetFactory_t* usf_array_groupNorm_bp[] =
+	{
+		self->usf0_groupNorm,
+		self->usf1_groupNorm_bp,
+	};
+	self->pl_groupNorm_bp = vkk_pipelineLayout_new(engine, 2,
+	                                               usf_array_groupNorm_bp);
+
 	vkk_uniformSetFactory_t* usf_array_lanczos_fp[] =
 	{
 		self->usf0_lanczos,
@@ -379,6 +876,15 @@ nn_engine_new(vkk_engine_t* engine)
 	self->pl_weight_bp = vkk_pipelineLayout_new(engine, 2,
 	                                            usf_array_weight_bp);
 
+	vkk_uniformSetFactory_t* usf_array_weight_q8[] =
+	{
+		self->usf0_weight,
+		self->usf1_weight_fp,
+		self->usf2_tensor_q8,
+	};
+	self->pl_weight_q8 = vkk_pipelineLayout_new(engine, 3,
+	                                            usf_array_weight_q8);
+
 	vkk_uniformSetFactory_t* usf_array_loss[] =
 	{
 		self->usf0_loss,
@@ -410,1250 +916,1668 @@ nn_engine_new(vkk_engine_t* engine)
 	self->pl_tensor_op = vkk_pipelineLayout_new(engine, 1,
 	                                            usf_array_tensor_op);
 
+	vkk_uniformSetFactory_t* usf_array_tensor_gemm[] =
+	{
+		self->usf0_tensor_gemm,
+	};
+	self->pl_tensor_gemm = vkk_pipelineLayout_new(engine, 1,
+	                                              usf_array_tensor_gemm);
+
 	if((self->pl_batchNorm_fp == NULL) ||
 	   (self->pl_batchNorm_bp == NULL) ||
 	   (self->pl_conv_fp      == NULL) ||
 	   (self->pl_conv_bp      == NULL) ||
+	   (self->pl_conv_col     == NULL) ||
+	   (self->pl_conv_wg_fp   == NULL) ||
+	   (self->pl_conv_wg_bp   == NULL) ||
+	   (self->pl_conv_split   == NULL) ||
+	   (self->pl_conv_q8      == NULL) ||
 	   (self->pl_fact_fp      == NULL) ||
 	   (self->pl_fact_bp      == NULL) ||
+	   (self->pl_groupNorm_fp == NULL) ||
+	   (self->pl_groupNorm_bp == NULL) ||
 	   (self->pl_lanczos_fp   == NULL) ||
 	   (self->pl_lanczos_bp   == NULL) ||
 	   (self->pl_skip_fp      == NULL) ||
 	   (self->pl_skip_bp      == NULL) ||
 	   (self->pl_weight_fp    == NULL) ||
 	   (self->pl_weight_bp    == NULL) ||
+	   (self->pl_weight_q8    == NULL) ||
 	   (self->pl_loss         == NULL) ||
 	   (self->pl_tensor_stats == NULL) ||
 	   (self->pl_tensor_norm  == NULL) ||
-	   (self->pl_tensor_op    == NULL))
+	   (self->pl_tensor_op    == NULL) ||
+	   (self->pl_tensor_gemm  == NULL))
 	{
-		goto failure;
+		return 0;
 	}
 
-	vkk_computePipelineInfo_t cpi_batchNorm_forwardPassXmeanTrain =
-	{
-		.compute = self->compute,
-		.pl      = self->pl_batchNorm_fp,
-		.cs      = "nn/shaders/nn_batchNormLayer_forwardPassXmeanTrain_comp.spv",
-	};
-
-	self->cp_batchNorm_forwardPassXmeanTrain =
-		vkk_computePipeline_new(engine,
-		                        &cpi_batchNorm_forwardPassXmeanTrain);
+	return 1;
+}
 
-	vkk_computePipelineInfo_t cpi_batchNorm_forwardPassXvarTrain =
-	{
-		.compute = self->compute,
-		.pl      = self->pl_batchNorm_fp,
-		.cs      = "nn/shaders/nn_batchNormLayer_forwardPassXvarTrain_comp.spv",
-	};
+static double nn_engine_submitEnd(nn_engine_t* self)
+{
+	ASSERT(self);
 
-	self->cp_batchNorm_forwardPassXvarTrain =
-		vkk_computePipeline_new(engine,
-		                        &cpi_batchNorm_forwardPassXvarTrain);
+	// vkk_compute_end waits for the submitted dispatches to
+	// complete so the elapsed time includes the GPU time
+	vkk_compute_end(self->compute);
 
-	vkk_computePipelineInfo_t cpi_batchNorm_forwardPassXmeanCompute =
+	double elapsed = cc_timestamp() - self->submit_t0;
+	if((self->submit == NN_ENGINE_SUBMIT_BUDGET) &&
+	   self->dispatch)
 	{
-		.compute = self->compute,
-		.pl      = self->pl_batchNorm_fp,
-		.cs      = "nn/shaders/nn_batchNormLayer_forwardPassXmeanCompute_comp.spv",
-	};
+		double dt = elapsed/((double) self->dispatch);
+		if(self->submit_dt > 0.0)
+		{
+			self->submit_dt += NN_ENGINE_SUBMIT_ALPHA*
+			                   (dt - self->submit_dt);
+		}
+		else
+		{
+			self->submit_dt = dt;
+		}
+	}
 
-	self->cp_batchNorm_forwardPassXmeanCompute =
-		vkk_computePipeline_new(engine,
-		                        &cpi_batchNorm_forwardPassXmeanCompute);
+	self->dispatch = 0;
 
-	vkk_computePipelineInfo_t cpi_batchNorm_forwardPassXvarCompute =
-	{
-		.compute = self->compute,
-		.pl      = self->pl_batchNorm_fp,
-		.cs      = "nn/shaders/nn_batchNormLayer_forwardPassXvarCompute_comp.spv",
-	};
+	return elapsed;
+}
 
-	self->cp_batchNorm_forwardPassXvarCompute =
-		vkk_computePipeline_new(engine,
-		                        &cpi_batchNorm_forwardPassXvarCompute);
+static int
+nn_engine_hazardFind(vkk_buffer_t* buffer,
+                     uint32_t count, vkk_buffer_t** array)
+{
+	ASSERT(buffer);
+	ASSERT(array);
 
-	vkk_computePipelineInfo_t cpi_batchNorm_forwardPassXhat =
+	uint32_t i;
+	for(i = 0; i < count; ++i)
 	{
-		.compute = self->compute,
-		.pl      = self->pl_batchNorm_fp,
-		.cs      = "nn/shaders/nn_batchNormLayer_forwardPassXhat_comp.spv",
-	};
-
-	self->cp_batchNorm_forwardPassXhat =
-		vkk_computePipeline_new(engine,
-		                        &cpi_batchNorm_forwardPassXhat);
+		if(array[i] == buffer)
+		{
+			return 1;
+		}
+	}
 
-	vkk_computePipelineInfo_t cpi_batchNorm_forwardPassY =
-	{
-		.compute = self->compute,
-		.pl      = self->pl_batchNorm_fp,
-		.cs      = "nn/shaders/nn_batchNormLayer_forwardPassY_comp.spv",
-	};
+	return 0;
+}
 
-	self->cp_batchNorm_forwardPassY =
-		vkk_computePipeline_new(engine,
-		                        &cpi_batchNorm_forwardPassY);
+static void nn_engine_hazardAppend(nn_engine_t* self)
+{
+	ASSERT(self);
 
-	vkk_computePipelineInfo_t cpi_batchNorm_backprop_dL_dX =
+	// the tracking is invalidated when the buffer lists
+	// overflow which causes the next barrier to be kept
+	if((self->hazard_read_count + self->access_read_count >
+	    NN_ENGINE_HAZARD_MAX) ||
+	   (self->hazard_write_count + self->access_write_count >
+	    NN_ENGINE_HAZARD_MAX))
 	{
-		.compute = self->compute,
-		.pl      = self->pl_batchNorm_bp,
-		.cs      = "nn/shaders/nn_batchNormLayer_backprop_dL_dX_comp.spv",
-	};
-
-	self->cp_batchNorm_backprop_dL_dX =
-		vkk_computePipeline_new(engine,
-		                        &cpi_batchNorm_backprop_dL_dX);
+		self->hazard_valid = 0;
+		return;
+	}
 
-	vkk_computePipelineInfo_t cpi_batchNorm_backprop_dL_dXhat =
+	uint32_t i;
+	for(i = 0; i < self->access_read_count; ++i)
 	{
-		.compute = self->compute,
-		.pl      = self->pl_batchNorm_bp,
-		.cs      = "nn/shaders/nn_batchNormLayer_backprop_dL_dXhat_comp.spv",
-	};
-
-	self->cp_batchNorm_backprop_dL_dXhat =
-		vkk_computePipeline_new(engine,
-		                        &cpi_batchNorm_backprop_dL_dXhat);
+		self->hazard_read[self->hazard_read_count++] =
+			self->access_read[i];
+	}
 
-	vkk_computePipelineInfo_t cpi_batchNorm_backpropSum =
+	for(i = 0; i < self->access_write_count; ++i)
 	{
-		.compute = self->compute,
-		.pl      = self->pl_batchNorm_bp,
-		.cs      = "nn/shaders/nn_batchNormLayer_backpropSum_comp.spv",
-	};
+		self->hazard_write[self->hazard_write_count++] =
+			self->access_write[i];
+	}
+}
 
-	self->cp_batchNorm_backpropSum =
-		vkk_computePipeline_new(engine,
-		                        &cpi_batchNorm_backpropSum);
+static void nn_engine_hazardReset(nn_engine_t* self)
+{
+	ASSERT(self);
 
-	vkk_computePipelineInfo_t cpi_batchNorm_backpropSumNOP =
-	{
-		.compute = self->compute,
-		.pl      = self->pl_batchNorm_bp,
-		.cs      = "nn/shaders/nn_batchNormLayer_backpropSumNOP_comp.spv",
-	};
+	self->hazard_valid       = 1;
+	self->hazard_read_count  = 0;
+	self->hazard_write_count = 0;
+}
 
-	self->cp_batchNorm_backpropSumNOP =
-		vkk_computePipeline_new(engine,
-		                        &cpi_batchNorm_backpropSumNOP);
+static vkk_hazard_e
+nn_engine_hazardTrack(nn_engine_t* self,
+                      vkk_hazard_e hazard)
+{
+	ASSERT(self);
 
-	vkk_computePipelineInfo_t cpi_conv_forwardPassClamp =
+	// the buffers accessed by undeclared commands are unknown
+	if(self->access_declared == 0)
 	{
-		.compute = self->compute,
-		.pl      = self->pl_conv_fp,
-		.cs      = "nn/shaders/nn_convLayer_forwardPassClamp_comp.spv",
-	};
-
-	self->cp_conv_forwardPassClamp =
-		vkk_computePipeline_new(engine,
-		                        &cpi_conv_forwardPassClamp);
+		self->hazard_valid = 0;
+		return hazard;
+	}
+	self->access_declared = 0;
 
-	vkk_computePipelineInfo_t cpi_conv_forwardPassPad =
+	// the caller did not request a barrier
+	if(hazard == VKK_HAZARD_NONE)
 	{
-		.compute = self->compute,
-		.pl      = self->pl_conv_fp,
-		.cs      = "nn/shaders/nn_convLayer_forwardPassPad_comp.spv",
-	};
-
-	self->cp_conv_forwardPassPad =
-		vkk_computePipeline_new(engine,
-		                        &cpi_conv_forwardPassPad);
+		if(self->hazard_valid)
+		{
+			nn_engine_hazardAppend(self);
+		}
+		return hazard;
+	}
 
-	vkk_computePipelineInfo_t cpi_conv_forwardPassTClamp =
+	// the barrier is required when the buffers accessed
+	// since the previous barrier are unknown
+	if(self->hazard_valid == 0)
 	{
-		.compute = self->compute,
-		.pl      = self->pl_conv_fp,
-		.cs      = "nn/shaders/nn_convLayer_forwardPassTClamp_comp.spv",
-	};
-
-	self->cp_conv_forwardPassTClamp =
-		vkk_computePipeline_new(engine,
-		                        &cpi_conv_forwardPassTClamp);
+		nn_engine_hazardReset(self);
+		nn_engine_hazardAppend(self);
+		return hazard;
+	}
 
-	vkk_computePipelineInfo_t cpi_conv_forwardPassTPad =
+	// check for RAW, WAW and WAR dependencies
+	uint32_t i;
+	int      conflict = 0;
+	for(i = 0; i < self->access_read_count; ++i)
 	{
-		.compute = self->compute,
-		.pl      = self->pl_conv_fp,
-		.cs      = "nn/shaders/nn_convLayer_forwardPassTPad_comp.spv",
-	};
+		if(nn_engine_hazardFind(self->access_read[i],
+		                        self->hazard_write_count,
+		                        self->hazard_write))
+		{
+			conflict = 1;
+			break;
+		}
+	}
 
-	self->cp_conv_forwardPassTPad =
-		vkk_computePipeline_new(engine,
-		                        &cpi_conv_forwardPassTPad);
+	for(i = 0; (conflict == 0) &&
+	           (i < self->access_write_count); ++i)
+	{
+		if(nn_engine_hazardFind(self->access_write[i],
+		                        self->hazard_write_count,
+		                        self->hazard_write) ||
+		   nn_engine_hazardFind(self->access_write[i],
+		                        self->hazard_read_count,
+		                        self->hazard_read))
+		{
+			conflict = 1;
+		}
+	}
 
-	vkk_computePipelineInfo_t cpi_conv_backprop_dL_dX =
+	if(conflict)
 	{
-		.compute = self->compute,
-		.pl      = self->pl_conv_bp,
-		.cs      = "nn/shaders/nn_convLayer_backprop_dL_dX_comp.spv",
-	};
+		nn_engine_hazardReset(self);
+		nn_engine_hazardAppend(self);
+		return hazard;
+	}
 
-	self->cp_conv_backprop_dL_dX =
-		vkk_computePipeline_new(engine,
-		                        &cpi_conv_backprop_dL_dX);
+	// elide the barrier
+	++self->hazard_elided;
+	nn_engine_hazardAppend(self);
+	return VKK_HAZARD_NONE;
+}
 
-	vkk_computePipelineInfo_t cpi_conv_backprop_dL_dW =
-	{
-		.compute = self->compute,
-		.pl      = self->pl_conv_bp,
-		.cs      = "nn/shaders/nn_convLayer_backprop_dL_dW_comp.spv",
-	};
+static int nn_engine_submitBegin(nn_engine_t* self)
+{
+	ASSERT(self);
 
-	self->cp_conv_backprop_dL_dW =
-		vkk_computePipeline_new(engine,
-		                        &cpi_conv_backprop_dL_dW);
+	// the first dispatch may be captured and replayed after
+	// commands that are unknown to the tracker
+	self->hazard_valid = 0;
 
-	vkk_computePipelineInfo_t cpi_conv_backprop_dL_dB =
-	{
-		.compute = self->compute,
-		.pl      = self->pl_conv_bp,
-		.cs      = "nn/shaders/nn_convLayer_backprop_dL_dB_comp.spv",
-	};
+	self->submit_t0 = cc_timestamp();
+
+	return vkk_compute_begin(self->compute);
+}
 
-	self->cp_conv_backprop_dL_dB =
-		vkk_computePipeline_new(engine,
-		                        &cpi_conv_backprop_dL_dB);
+static int nn_engine_submitSplit(nn_engine_t* self)
+{
+	ASSERT(self);
 
-	vkk_computePipelineInfo_t cpi_conv_backpropT_dL_dX =
+	if(self->dispatch == 0)
 	{
-		.compute = self->compute,
-		.pl      = self->pl_conv_bp,
-		.cs      = "nn/shaders/nn_convLayer_backpropT_dL_dX_comp.spv",
-	};
+		return 0;
+	}
+	else if(self->submit == NN_ENGINE_SUBMIT_HEADLESS)
+	{
+		return 0;
+	}
+	else if((self->submit == NN_ENGINE_SUBMIT_BUDGET) &&
+	        (self->submit_dt > 0.0))
+	{
+		return (((double) self->dispatch)*self->submit_dt) >=
+		       self->submit_budget;
+	}
 
-	self->cp_conv_backpropT_dL_dX =
-		vkk_computePipeline_new(engine,
-		                        &cpi_conv_backpropT_dL_dX);
+	// NN_ENGINE_SUBMIT_DISPATCH or the time per dispatch
+	// has not been measured
+	return self->dispatch >= self->submit_hint;
+}
 
-	vkk_computePipelineInfo_t cpi_conv_backpropT_dL_dW =
-	{
-		.compute = self->compute,
-		.pl      = self->pl_conv_bp,
-		.cs      = "nn/shaders/nn_convLayer_backpropT_dL_dW_comp.spv",
-	};
+static const nn_engineCpInfo_t*
+nn_engine_cpInfo(nn_engine_t* self,
+                 vkk_computePipeline_t** _cp)
+{
+	ASSERT(self);
+	ASSERT(_cp);
 
-	self->cp_conv_backpropT_dL_dW =
-		vkk_computePipeline_new(engine,
-		                        &cpi_conv_backpropT_dL_dW);
+	size_t offset = (size_t) (((char*) _cp) - ((char*) self));
 
-	vkk_computePipelineInfo_t cpi_conv_backpropUpdateW =
+	int i;
+	for(i = 0; i < NN_ENGINE_CP_INFO_COUNT; ++i)
 	{
-		.compute = self->compute,
-		.pl      = self->pl_conv_bp,
-		.cs      = "nn/shaders/nn_convLayer_backpropUpdateW_comp.spv",
-	};
+		if(NN_ENGINE_CP_INFO[i].cp == offset)
+		{
+			return &NN_ENGINE_CP_INFO[i];
+		}
+	}
+
+	return NULL;
+}
 
-	self->cp_conv_backpropUpdateW =
-		vkk_computePipeline_new(engine,
-		                        &cpi_conv_backpropUpdateW);
+static const char*
+nn_engine_profileKernel(nn_engine_t* self,
+                        vkk_computePipeline_t* cp)
+{
+	ASSERT(self);
+	ASSERT(cp);
 
-	vkk_computePipelineInfo_t cpi_conv_backpropUpdateB =
+	int i;
+	for(i = 0; i < NN_ENGINE_CP_INFO_COUNT; ++i)
 	{
-		.compute = self->compute,
-		.pl      = self->pl_conv_bp,
-		.cs      = "nn/shaders/nn_convLayer_backpropUpdateB_comp.spv",
-	};
+		vkk_computePipeline_t** _cp;
+		_cp = (vkk_computePipeline_t**)
+		      (((char*) self) + NN_ENGINE_CP_INFO[i].cp);
+		if(*_cp == cp)
+		{
+			return NN_ENGINE_CP_INFO[i].name;
+		}
+	}
 
-	self->cp_conv_backpropUpdateB =
-		vkk_computePipeline_new(engine,
-		                        &cpi_conv_backpropUpdateB);
+	return "unknown";
+}
 
-	vkk_computePipelineInfo_t cpi_fact_forwardPassLinear =
-	{
-		.compute = self->compute,
-		.pl      = self->pl_fact_fp,
-		.cs      = "nn/shaders/nn_factLayer_forwardPassLinear_comp.spv",
-	};
+static void
+nn_engine_profileAdd(nn_engine_t* self, double time)
+{
+	ASSERT(self);
 
-	self->cp_fact_forwardPassLinear =
-		vkk_computePipeline_new(engine,
-		                        &cpi_fact_forwardPassLinear);
+	if(self->profile_kernel == NULL)
+	{
+		return;
+	}
 
-	vkk_computePipelineInfo_t cpi_fact_forwardPassLogistic =
+	nn_engineProfile_t* p;
+	cc_listIter_t*      iter = cc_list_head(self->profile_list);
+	while(iter)
 	{
-		.compute = self->compute,
-		.pl      = self->pl_fact_fp,
-		.cs      = "nn/shaders/nn_factLayer_forwardPassLogistic_comp.spv",
-	};
+		p = (nn_engineProfile_t*) cc_list_peekIter(iter);
+		if((p->layer  == self->profile_kernel_layer) &&
+		   (p->kernel == self->profile_kernel))
+		{
+			++p->count;
+			p->time += time;
+			return;
+		}
 
-	self->cp_fact_forwardPassLogistic =
-		vkk_computePipeline_new(engine,
-		                        &cpi_fact_forwardPassLogistic);
+		iter = cc_list_next(iter);
+	}
 
-	vkk_computePipelineInfo_t cpi_fact_forwardPassReLU =
+	p = (nn_engineProfile_t*)
+	    CALLOC(1, sizeof(nn_engineProfile_t));
+	if(p == NULL)
 	{
-		.compute = self->compute,
-		.pl      = self->pl_fact_fp,
-		.cs      = "nn/shaders/nn_factLayer_forwardPassReLU_comp.spv",
-	};
-
-	self->cp_fact_forwardPassReLU =
-		vkk_computePipeline_new(engine,
-		                        &cpi_fact_forwardPassReLU);
+		LOGE("CALLOC failed");
+		return;
+	}
+	p->layer  = self->profile_kernel_layer;
+	p->kernel = self->profile_kernel;
+	p->count  = 1;
+	p->time   = time;
 
-	vkk_computePipelineInfo_t cpi_fact_forwardPassPReLU =
+	if(cc_list_append(self->profile_list, NULL, p) == NULL)
 	{
-		.compute = self->compute,
-		.pl      = self->pl_fact_fp,
-		.cs      = "nn/shaders/nn_factLayer_forwardPassPReLU_comp.spv",
-	};
+		FREE(p);
+	}
+}
 
-	self->cp_fact_forwardPassPReLU =
-		vkk_computePipeline_new(engine,
-		                        &cpi_fact_forwardPassPReLU);
+static void nn_engine_profileClear(nn_engine_t* self)
+{
+	ASSERT(self);
 
-	vkk_computePipelineInfo_t cpi_fact_forwardPassLReLU =
+	if(self->profile_list == NULL)
 	{
-		.compute = self->compute,
-		.pl      = self->pl_fact_fp,
-		.cs      = "nn/shaders/nn_factLayer_forwardPassLReLU_comp.spv",
-	};
-
-	self->cp_fact_forwardPassLReLU =
-		vkk_computePipeline_new(engine,
-		                        &cpi_fact_forwardPassLReLU);
+		return;
+	}
 
-	vkk_computePipelineInfo_t cpi_fact_forwardPassTanh =
+	cc_listIter_t* iter = cc_list_head(self->profile_list);
+	while(iter)
 	{
-		.compute = self->compute,
-		.pl      = self->pl_fact_fp,
-		.cs      = "nn/shaders/nn_factLayer_forwardPassTanh_comp.spv",
-	};
+		nn_engineProfile_t* p;
+		p = (nn_engineProfile_t*)
+		    cc_list_remove(self->profile_list, &iter);
+		FREE(p);
+	}
+}
 
-	self->cp_fact_forwardPassTanh =
-		vkk_computePipeline_new(engine,
-		                        &cpi_fact_forwardPassTanh);
+/***********************************************************
+* public                                                   *
+***********************************************************/
 
-	vkk_computePipelineInfo_t cpi_fact_forwardPassSink =
+nn_engine_t*
+nn_engine_new(vkk_engine_t* engine)
+{
+	// engine may be NULL
+
+	nn_engine_t* self;
+	self = (nn_engine_t*)
+	       CALLOC(1, sizeof(nn_engine_t));
+	if(self == NULL)
 	{
-		.compute = self->compute,
-		.pl      = self->pl_fact_fp,
-		.cs      = "nn/shaders/nn_factLayer_forwardPassSink_comp.spv",
-	};
+		LOGE("CALLOC failed");
+		return NULL;
+	}
 
-	self->cp_fact_forwardPassSink =
-		vkk_computePipeline_new(engine,
-		                        &cpi_fact_forwardPassSink);
+	self->engine      = engine;
+	self->submit      = NN_ENGINE_SUBMIT_DISPATCH;
+	self->submit_hint = NN_ENGINE_DISPATCH_HINT;
 
-	vkk_computePipelineInfo_t cpi_fact_backpropLinear =
-	{
-		.compute = self->compute,
-		.pl      = self->pl_fact_bp,
-		.cs      = "nn/shaders/nn_factLayer_backpropLinear_comp.spv",
-	};
+	self->profile_layer = -1;
 
-	self->cp_fact_backpropLinear =
-		vkk_computePipeline_new(engine,
-		                        &cpi_fact_backpropLinear);
+	cc_rngUniform_init(&self->rng_uniform);
+	cc_rngNormal_init(&self->rng_normal, 0.0, 1.0);
 
-	vkk_computePipelineInfo_t cpi_fact_backpropLogistic =
+	// the CPU backend is selected when engine is NULL
+	if(engine == NULL)
 	{
-		.compute = self->compute,
-		.pl      = self->pl_fact_bp,
-		.cs      = "nn/shaders/nn_factLayer_backpropLogistic_comp.spv",
-	};
+		self->cpu = nn_cpu_new(0);
+		if(self->cpu == NULL)
+		{
+			goto failure;
+		}
+	}
+	else if(nn_engine_newCompute(self) == 0)
+	{
+		goto failure;
+	}
 
-	self->cp_fact_backpropLogistic =
-		vkk_computePipeline_new(engine,
-		                        &cpi_fact_backpropLogistic);
+	self->map_dim = cc_map_new();
+	if(self->map_dim == NULL)
+	{
+		goto failure;
+	}
 
-	vkk_computePipelineInfo_t cpi_fact_backpropReLU =
+	self->map_us = cc_map_new();
+	if(self->map_us == NULL)
 	{
-		.compute = self->compute,
-		.pl      = self->pl_fact_bp,
-		.cs      = "nn/shaders/nn_factLayer_backpropReLU_comp.spv",
+		goto failure;
+	}
+
+	nn_dim_t dimNull =
+	{
+		.count  = 1,
+		.height = 1,
+		.width  = 1,
+		.depth  = 1,
 	};
+	self->Null = nn_tensor_new(self, &dimNull,
+	                           NN_TENSOR_INIT_ZERO,
+	                           NN_TENSOR_MODE_COMPUTE);
+	if(self->Null == NULL)
+	{
+		goto failure;
+	}
 
-	self->cp_fact_backpropReLU =
-		vkk_computePipeline_new(engine,
-		                        &cpi_fact_backpropReLU);
+	self->map_lanczos_us2 = cc_map_new();
+	if(self->map_lanczos_us2 == NULL)
+	{
+		goto failure;
+	}
 
-	vkk_computePipelineInfo_t cpi_fact_backpropPReLU =
+	self->map_tensorOp_us0 = cc_map_new();
+	if(self->map_tensorOp_us0 == NULL)
 	{
-		.compute = self->compute,
-		.pl      = self->pl_fact_bp,
-		.cs      = "nn/shaders/nn_factLayer_backpropPReLU_comp.spv",
-	};
+		goto failure;
+	}
 
-	self->cp_fact_backpropPReLU =
-		vkk_computePipeline_new(engine,
-		                        &cpi_fact_backpropPReLU);
+	// success
+	return self;
+
+	// failure
+	failure:
+		nn_engine_delete(&self);
+	return NULL;
+}
 
-	vkk_computePipelineInfo_t cpi_fact_backpropLReLU =
+void nn_engine_delete(nn_engine_t** _self)
+{
+	ASSERT(_self);
+
+	nn_engine_t* self = *_self;
+	if(self)
 	{
-		.compute = self->compute,
-		.pl      = self->pl_fact_bp,
-		.cs      = "nn/shaders/nn_factLayer_backpropLReLU_comp.spv",
-	};
+		nn_engine_profileClear(self);
+		cc_list_delete(&self->profile_list);
+
+		cc_mapIter_t* miter;
+		if(self->map_tensorOp_us0)
+		{
+			miter = cc_map_head(self->map_tensorOp_us0);
+			while(miter)
+			{
+				nn_engineTensorOp_t* op;
+				op = (nn_engineTensorOp_t*)
+				     cc_map_remove(self->map_tensorOp_us0, &miter);
+				nn_tensorOpUs0Data_delete(&op->data);
+				FREE(op);
+			}
+			cc_map_delete(&self->map_tensorOp_us0);
+		}
+
+		if(self->map_lanczos_us2)
+		{
+			miter = cc_map_head(self->map_lanczos_us2);
+			while(miter)
+			{
+				nn_lanczosUs2Data_t* data;
+				data = (nn_lanczosUs2Data_t*)
+				       cc_map_remove(self->map_lanczos_us2, &miter);
+				nn_lanczosUs2Data_delete(&data);
+			}
+			cc_map_delete(&self->map_lanczos_us2);
+		}
+
+		nn_tensor_delete(&self->Null);
+
+		if(self->map_dim)
+		{
+			miter = cc_map_head(self->map_dim);
+			while(miter)
+			{
+				nn_engineDim_t* data;
+				data = (nn_engineDim_t*)
+				       cc_map_remove(self->map_dim, &miter);
+				LOGW("leaked sb_dim ref=%u", data->ref);
+				vkk_buffer_delete(&data->sb_dim);
+				FREE(data);
+			}
+			cc_map_delete(&self->map_dim);
+		}
+
+		if(self->map_us)
+		{
+			miter = cc_map_head(self->map_us);
+			while(miter)
+			{
+				nn_engineUs_t* data;
+				data = (nn_engineUs_t*)
+				       cc_map_remove(self->map_us, &miter);
+				FREE(data);
+			}
+			cc_map_delete(&self->map_us);
+		}
+
+		// compute pipelines are deleted in reverse order of
+		// the table (see nn_engine_getPipeline)
+		int i;
+		for(i = NN_ENGINE_CP_INFO_COUNT - 1; i >= 0; --i)
+		{
+			vkk_computePipeline_t** _cp;
+			_cp = (vkk_computePipeline_t**)
+			      (((char*) self) + NN_ENGINE_CP_INFO[i].cp);
+			vkk_computePipeline_delete(_cp);
+		}
+
+		vkk_pipelineLayout_delete(&self->pl_tensor_gemm);
+		vkk_pipelineLayout_delete(&self->pl_tensor_op);
+		vkk_pipelineLayout_delete(&self->pl_tensor_norm);
+		vkk_pipelineLayout_delete(&self->pl_tensor_stats);
+		vkk_pipelineLayout_delete(&self->pl_loss);
+		vkk_pipelineLayout_delete(&self->pl_weight_q8);
+		vkk_pipelineLayout_delete(&self->pl_weight_bp);
+		vkk_pipelineLayout_delete(&self->pl_weight_fp);
+		vkk_pipelineLayout_delete(&self->pl_skip_bp);
+		vkk_pipelineLayout_delete(&self->pl_skip_fp);
+		vkk_pipelineLayout_delete(&self->pl_lanczos_bp);
+		vkk_pipelineLayout_delete(&self->pl_lanczos_fp);
+		vkk_pipelineLayout_delete(&self->pl_groupNorm_bp);
+		vkk_pipelineLayout_delete(&self->pl_groupNorm_fp);
+		vkk_pipelineLayout_delete(&self->pl_fact_bp);
+		vkk_pipelineLayout_delete(&self->pl_fact_fp);
+		vkk_pipelineLayout_delete(&self->pl_conv_q8);
+		vkk_pipelineLayout_delete(&self->pl_conv_split);
+		vkk_pipelineLayout_delete(&self->pl_conv_wg_bp);
+		vkk_pipelineLayout_delete(&self->pl_conv_wg_fp);
+		vkk_pipelineLayout_delete(&self->pl_conv_col);
+		vkk_pipelineLayout_delete(&self->pl_conv_bp);
+		vkk_pipelineLayout_delete(&self->pl_conv_fp);
+		vkk_pipelineLayout_delete(&self->pl_batchNorm_bp);
+		vkk_pipelineLayout_delete(&self->pl_batchNorm_fp);
+		vkk_uniformSetFactory_delete(&self->usf2_tensor_q8);
+		vkk_uniformSetFactory_delete(&self->usf0_tensor_gemm);
+		vkk_uniformSetFactory_delete(&self->usf0_tensor_op);
+		vkk_uniformSetFactory_delete(&self->usf1_tensor_norm);
+		vkk_uniformSetFactory_delete(&self->usf1_tensor_stats);
+		vkk_uniformSetFactory_delete(&self->usf0_tensor);
+		vkk_uniformSetFactory_delete(&self->usf1_loss);
+		vkk_uniformSetFactory_delete(&self->usf0_loss);
+		vkk_uniformSetFactory_delete(&self->usf1_weight_bp);
+		vkk_uniformSetFactory_delete(&self->usf1_weight_fp);
+		vkk_uniformSetFactory_delete(&self->usf0_weight);
+		vkk_uniformSetFactory_delete(&self->usf1_skip_bp);
+		vkk_uniformSetFactory_delete(&self->usf1_skip_fp);
+		vkk_uniformSetFactory_delete(&self->usf0_skip);
+		vkk_uniformSetFactory_delete(&self->usf2_lanczos);
+		vkk_uniformSetFactory_delete(&self->usf1_lanczos_bp);
+		vkk_uniformSetFactory_delete(&self->usf1_lanczos_fp);
+		vkk_uniformSetFactory_delete(&self->usf0_lanczos);
+		vkk_uniformSetFactory_delete(&self->usf1_groupNorm_bp);
+		vkk_uniformSetFactory_delete(&self->usf1_groupNorm_fp);
+		vkk_uniformSetFactory_delete(&self->usf0_groupNorm);
+		vkk_uniformSetFactory_delete(&self->usf1_fact_bp);
+		vkk_uniformSetFactory_delete(&self->usf1_fact_fp);
+		vkk_uniformSetFactory_delete(&self->usf0_fact);
+		vkk_uniformSetFactory_delete(&self->usf2_conv_split);
+		vkk_uniformSetFactory_delete(&self->usf2_conv_wg);
+		vkk_uniformSetFactory_delete(&self->usf2_conv_col);
+		vkk_uniformSetFactory_delete(&self->usf1_conv_bp);
+		vkk_uniformSetFactory_delete(&self->usf1_conv_fp);
+		vkk_uniformSetFactory_delete(&self->usf0_conv);
+		vkk_uniformSetFactory_delete(&self->usf1_batchNorm_bp);
+		vkk_uniformSetFactory_delete(&self->usf1_batchNorm_fp);
+		vkk_uniformSetFactory_delete(&self->usf0_batchNorm);
+		vkk_compute_delete(&self->compute);
+		nn_cpu_delete(&self->cpu);
+		FREE(self);
+		*_self = NULL;
+	}
+}
+
+vkk_buffer_t*
+nn_engine_getDim(nn_engine_t* self, nn_dim_t* dim)
+{
+	ASSERT(self);
+	ASSERT(dim);
 
-	self->cp_fact_backpropLReLU =
-		vkk_computePipeline_new(engine,
-		                        &cpi_fact_backpropLReLU);
+	nn_engineDim_t* data;
 
-	vkk_computePipelineInfo_t cpi_fact_backpropTanh =
+	// find existing data
+	cc_mapIter_t* miter;
+	miter = cc_map_findp(self->map_dim, sizeof(nn_dim_t), dim);
+	if(miter)
 	{
-		.compute = self->compute,
-		.pl      = self->pl_fact_bp,
-		.cs      = "nn/shaders/nn_factLayer_backpropTanh_comp.spv",
-	};
+		data = (nn_engineDim_t*) cc_map_val(miter);
+		++data->ref;
+		return data->sb_dim;
+	}
 
-	self->cp_fact_backpropTanh =
-		vkk_computePipeline_new(engine,
-		                        &cpi_fact_backpropTanh);
+	data = (nn_engineDim_t*)
+	       CALLOC(1, sizeof(nn_engineDim_t));
+	if(data == NULL)
+	{
+		LOGE("CALLOC failed");
+		return NULL;
+	}
+
+	vkk_updateMode_e um;
+	um = vkk_compute_updateMode(self->compute);
 
-	vkk_computePipelineInfo_t cpi_fact_backpropSink =
+	data->sb_dim = vkk_buffer_new(self->engine, um,
+	                              VKK_BUFFER_USAGE_STORAGE,
+	                              sizeof(nn_dim_t), dim);
+	if(data->sb_dim == NULL)
 	{
-		.compute = self->compute,
-		.pl      = self->pl_fact_bp,
-		.cs      = "nn/shaders/nn_factLayer_backpropSink_comp.spv",
-	};
+		goto fail_sb_dim;
+	}
+	data->ref = 1;
 
-	self->cp_fact_backpropSink =
-		vkk_computePipeline_new(engine,
-		                        &cpi_fact_backpropSink);
+	if(cc_map_addp(self->map_dim, data,
+	               sizeof(nn_dim_t), dim) == NULL)
+	{
+		goto fail_add;
+	}
+
+	// success
+	return data->sb_dim;
+
+	// failure
+	fail_add:
+		vkk_buffer_delete(&data->sb_dim);
+	fail_sb_dim:
+		FREE(data);
+	return NULL;
+}
 
-	vkk_computePipelineInfo_t cpi_lanczos_forwardPassT =
+void nn_engine_putDim(nn_engine_t* self, nn_dim_t* dim,
+                      vkk_buffer_t** _sb_dim)
+{
+	ASSERT(self);
+	ASSERT(dim);
+	ASSERT(_sb_dim);
+
+	if(*_sb_dim == NULL)
 	{
-		.compute = self->compute,
-		.pl      = self->pl_lanczos_fp,
-		.cs      = "nn/shaders/nn_lanczosLayer_forwardPassT_comp.spv",
-	};
+		return;
+	}
+
+	cc_mapIter_t* miter;
+	miter = cc_map_findp(self->map_dim, sizeof(nn_dim_t), dim);
+	if(miter == NULL)
+	{
+		LOGE("invalid");
+		return;
+	}
 
-	self->cp_lanczos_forwardPassT =
-		vkk_computePipeline_new(engine,
-		                        &cpi_lanczos_forwardPassT);
+	nn_engineDim_t* data = (nn_engineDim_t*) cc_map_val(miter);
+	ASSERT(data->sb_dim == *_sb_dim);
 
-	vkk_computePipelineInfo_t cpi_lanczos_forwardPassY =
+	--data->ref;
+	if(data->ref == 0)
 	{
-		.compute = self->compute,
-		.pl      = self->pl_lanczos_fp,
-		.cs      = "nn/shaders/nn_lanczosLayer_forwardPassY_comp.spv",
-	};
+		nn_engine_flushTensorOpUs0(self, data->sb_dim);
+		cc_map_remove(self->map_dim, &miter);
+		vkk_buffer_delete(&data->sb_dim);
+		FREE(data);
+	}
+	*_sb_dim = NULL;
+}
+
+vkk_uniformSet_t*
+nn_engine_getLanczos3Us2(nn_engine_t* self, uint32_t n)
+{
+	ASSERT(self);
 
-	self->cp_lanczos_forwardPassY =
-		vkk_computePipeline_new(engine,
-		                        &cpi_lanczos_forwardPassY);
+	nn_lanczosUs2Data_t* data;
 
-	vkk_computePipelineInfo_t cpi_lanczos_backprop_dL_dT =
+	nn_lanczosUs2Key_t key =
 	{
-		.compute = self->compute,
-		.pl      = self->pl_lanczos_bp,
-		.cs      = "nn/shaders/nn_lanczosLayer_backprop_dL_dT_comp.spv",
+		.n = n,
 	};
 
-	self->cp_lanczos_backprop_dL_dT =
-		vkk_computePipeline_new(engine,
-		                        &cpi_lanczos_backprop_dL_dT);
+	// find existing data
+	cc_mapIter_t* miter;
+	miter = cc_map_findp(self->map_lanczos_us2,
+	                     sizeof(nn_lanczosUs2Key_t),
+	                     &key);
+	if(miter)
+	{
+		data = (nn_lanczosUs2Data_t*) cc_map_val(miter);
+		return data->us2;
+	}
 
-	vkk_computePipelineInfo_t cpi_lanczos_backprop_dL_dX =
+	data = nn_lanczosUs2Data_new(self, &key);
+	if(data == NULL)
 	{
-		.compute = self->compute,
-		.pl      = self->pl_lanczos_bp,
-		.cs      = "nn/shaders/nn_lanczosLayer_backprop_dL_dX_comp.spv",
-	};
+		return NULL;
+	}
 
-	self->cp_lanczos_backprop_dL_dX =
-		vkk_computePipeline_new(engine,
-		                        &cpi_lanczos_backprop_dL_dX);
+	if(cc_map_addp(self->map_lanczos_us2,
+	               data, sizeof(nn_lanczosUs2Key_t),
+	               &key) == NULL)
+	{
+		goto fail_add;
+	}
+
+	// success
+	return data->us2;
+
+	// failure
+	fail_add:
+		nn_lanczosUs2Data_delete(&data);
+	return NULL;
+}
+
+vkk_uniformSet_t*
+nn_engine_getTensorOpUs0(nn_engine_t* self,
+                         nn_tensor_t* X1,
+                         nn_tensor_t* X2,
+                         nn_tensor_t* Y,
+                         nn_tensorOpUs0Idx_t* idx)
+{
+	// X2 and Y may be NULL
+	ASSERT(self);
+	ASSERT(X1);
+	ASSERT(idx);
 
-	vkk_computePipelineInfo_t cpi_skip_forwardPassAdd =
+	// optionally replace X2 and Y with the Null tensor
+	if(X2 == NULL)
 	{
-		.compute = self->compute,
-		.pl      = self->pl_skip_fp,
-		.cs      = "nn/shaders/nn_skipLayer_forwardPassAdd_comp.spv",
-	};
-
-	self->cp_skip_forwardPassAdd =
-		vkk_computePipeline_new(engine,
-		                        &cpi_skip_forwardPassAdd);
-
-	vkk_computePipelineInfo_t cpi_skip_forwardPassCat =
+		X2 = self->Null;
+	}
+	if(Y == NULL)
 	{
-		.compute = self->compute,
-		.pl      = self->pl_skip_fp,
-		.cs      = "nn/shaders/nn_skipLayer_forwardPassCat_comp.spv",
-	};
+		Y = self->Null;
+	}
 
-	self->cp_skip_forwardPassCat =
-		vkk_computePipeline_new(engine,
-		                        &cpi_skip_forwardPassCat);
+	nn_engineTensorOpKey_t key;
+	memset(&key, 0, sizeof(nn_engineTensorOpKey_t));
+	key.sb_buffer[0] = X1->sb_dim;
+	key.sb_buffer[1] = X1->sb_data;
+	key.sb_buffer[2] = X2->sb_dim;
+	key.sb_buffer[3] = X2->sb_data;
+	key.sb_buffer[4] = Y->sb_dim;
+	key.sb_buffer[5] = Y->sb_data;
+	key.idx          = *idx;
 
-	vkk_computePipelineInfo_t cpi_skip_backpropAdd =
+	// find existing data
+	nn_engineTensorOp_t* op;
+	cc_mapIter_t*        miter;
+	miter = cc_map_findp(self->map_tensorOp_us0,
+	                     sizeof(nn_engineTensorOpKey_t), &key);
+	if(miter)
 	{
-		.compute = self->compute,
-		.pl      = self->pl_skip_bp,
-		.cs      = "nn/shaders/nn_skipLayer_backpropAdd_comp.spv",
-	};
-
-	self->cp_skip_backpropAdd =
-		vkk_computePipeline_new(engine,
-		                        &cpi_skip_backpropAdd);
+		op = (nn_engineTensorOp_t*) cc_map_val(miter);
+		++self->tensorOp_hit;
+		return op->data->us0;
+	}
 
-	vkk_computePipelineInfo_t cpi_skip_backpropCat =
+	op = (nn_engineTensorOp_t*)
+	     CALLOC(1, sizeof(nn_engineTensorOp_t));
+	if(op == NULL)
 	{
-		.compute = self->compute,
-		.pl      = self->pl_skip_bp,
-		.cs      = "nn/shaders/nn_skipLayer_backpropCat_comp.spv",
-	};
-
-	self->cp_skip_backpropCat =
-		vkk_computePipeline_new(engine,
-		                        &cpi_skip_backpropCat);
+		LOGE("CALLOC failed");
+		return NULL;
+	}
+	op->key = key;
 
-	vkk_computePipelineInfo_t cpi_skip_backpropFork =
+	op->data = nn_tensorOpUs0Data_new(X1, X2, Y, idx);
+	if(op->data == NULL)
 	{
-		.compute = self->compute,
-		.pl      = self->pl_skip_bp,
-		.cs      = "nn/shaders/nn_skipLayer_backpropFork_comp.spv",
-	};
-
-	self->cp_skip_backpropFork =
-		vkk_computePipeline_new(engine,
-		                        &cpi_skip_backpropFork);
+		goto fail_data;
+	}
 
-	vkk_computePipelineInfo_t cpi_weight_forwardPass =
+	if(cc_map_addp(self->map_tensorOp_us0, op,
+	               sizeof(nn_engineTensorOpKey_t), &key) == NULL)
 	{
-		.compute = self->compute,
-		.pl      = self->pl_weight_fp,
-		.cs      = "nn/shaders/nn_weightLayer_forwardPass_comp.spv",
-	};
+		goto fail_add;
+	}
+	++self->tensorOp_miss;
 
-	self->cp_weight_forwardPass =
-		vkk_computePipeline_new(engine,
-		                        &cpi_weight_forwardPass);
+	// success
+	return op->data->us0;
 
-	vkk_computePipelineInfo_t cpi_weight_backpropUpdateW =
-	{
-		.compute = self->compute,
-		.pl      = self->pl_weight_bp,
-		.cs      = "nn/shaders/nn_weightLayer_backpropUpdateW_comp.spv",
-	};
+	// failure
+	fail_add:
+		nn_tensorOpUs0Data_delete(&op->data);
+	fail_data:
+		FREE(op);
+	return NULL;
+}
 
-	self->cp_weight_backpropUpdateW =
-		vkk_computePipeline_new(engine,
-		                        &cpi_weight_backpropUpdateW);
+void nn_engine_flushTensorOpUs0(nn_engine_t* self,
+                                vkk_buffer_t* sb)
+{
+	ASSERT(self);
 
-	vkk_computePipelineInfo_t cpi_weight_backpropUpdateB =
+	// the Null tensor is deleted after the cache
+	if((sb == NULL) || (self->map_tensorOp_us0 == NULL))
 	{
-		.compute = self->compute,
-		.pl      = self->pl_weight_bp,
-		.cs      = "nn/shaders/nn_weightLayer_backpropUpdateB_comp.spv",
-	};
+		return;
+	}
 
-	self->cp_weight_backpropUpdateB =
-		vkk_computePipeline_new(engine,
-		                        &cpi_weight_backpropUpdateB);
+	nn_engineTensorOp_t* op;
+	nn_engineUs_t*       data;
+	vkk_uniformSet_t*    us;
+	cc_mapIter_t*        miter;
+	cc_mapIter_t*        uiter;
+	int                  i;
+	miter = cc_map_head(self->map_tensorOp_us0);
+	while(miter)
+	{
+		op = (nn_engineTensorOp_t*) cc_map_val(miter);
+		for(i = 0; i < 6; ++i)
+		{
+			if(op->key.sb_buffer[i] == sb)
+			{
+				break;
+			}
+		}
 
-	vkk_computePipelineInfo_t cpi_weight_backprop_dL_dX =
-	{
-		.compute = self->compute,
-		.pl      = self->pl_weight_bp,
-		.cs      = "nn/shaders/nn_weightLayer_backprop_dL_dX_comp.spv",
-	};
+		if(i == 6)
+		{
+			miter = cc_map_next(miter);
+			continue;
+		}
 
-	self->cp_weight_backprop_dL_dX =
-		vkk_computePipeline_new(engine,
-		                        &cpi_weight_backprop_dL_dX);
+		// remove the refs retained for the memory planner
+		us    = op->data->us0;
+		uiter = cc_map_findp(self->map_us,
+		                     sizeof(vkk_uniformSet_t*), &us);
+		if(uiter)
+		{
+			data = (nn_engineUs_t*)
+			       cc_map_remove(self->map_us, &uiter);
+			FREE(data);
+		}
 
-	vkk_computePipelineInfo_t cpi_weight_backprop_dL_dW =
-	{
-		.compute = self->compute,
-		.pl      = self->pl_weight_bp,
-		.cs      = "nn/shaders/nn_weightLayer_backprop_dL_dW_comp.spv",
-	};
+		cc_map_remove(self->map_tensorOp_us0, &miter);
+		nn_tensorOpUs0Data_delete(&op->data);
+		FREE(op);
+	}
+}
 
-	self->cp_weight_backprop_dL_dW =
-		vkk_computePipeline_new(engine,
-		                        &cpi_weight_backprop_dL_dW);
+vkk_computePipeline_t*
+nn_engine_getPipeline(nn_engine_t* self,
+                      vkk_computePipeline_t** _cp)
+{
+	ASSERT(self);
+	ASSERT(_cp);
 
-	vkk_computePipelineInfo_t cpi_weight_backprop_dL_dB =
+	if(*_cp)
 	{
-		.compute = self->compute,
-		.pl      = self->pl_weight_bp,
-		.cs      = "nn/shaders/nn_weightLayer_backprop_dL_dB_comp.spv",
-	};
-
-	self->cp_weight_backprop_dL_dB =
-		vkk_computePipeline_new(engine,
-		                        &cpi_weight_backprop_dL_dB);
+		return *_cp;
+	}
 
-	vkk_computePipelineInfo_t cpi_loss_dL_dY_mse =
+	const nn_engineCpInfo_t* info = nn_engine_cpInfo(self, _cp);
+	if(info == NULL)
 	{
-		.compute = self->compute,
-		.pl      = self->pl_loss,
-		.cs      = "nn/shaders/nn_loss_dL_dY_mse_comp.spv",
-	};
+		LOGE("invalid");
+		return NULL;
+	}
 
-	self->cp_loss_dL_dY_mse =
-		vkk_computePipeline_new(engine,
-		                        &cpi_loss_dL_dY_mse);
+	vkk_pipelineLayout_t** _pl;
+	_pl = (vkk_pipelineLayout_t**)
+	      (((char*) self) + info->pl);
 
-	vkk_computePipelineInfo_t cpi_loss_dL_dY_mae =
+	vkk_computePipelineInfo_t cpi =
 	{
 		.compute = self->compute,
-		.pl      = self->pl_loss,
-		.cs      = "nn/shaders/nn_loss_dL_dY_mae_comp.spv",
+		.pl      = *_pl,
+		.cs      = info->cs,
 	};
 
-	self->cp_loss_dL_dY_mae =
-		vkk_computePipeline_new(engine,
-		                        &cpi_loss_dL_dY_mae);
-
-	vkk_computePipelineInfo_t cpi_loss_dL_dY_bce =
+	*_cp = vkk_computePipeline_new(self->engine, &cpi);
+	if(*_cp == NULL)
 	{
-		.compute = self->compute,
-		.pl      = self->pl_loss,
-		.cs      = "nn/shaders/nn_loss_dL_dY_bce_comp.spv",
-	};
-
-	self->cp_loss_dL_dY_bce =
-		vkk_computePipeline_new(engine,
-		                        &cpi_loss_dL_dY_bce);
+		LOGE("invalid %s", info->name);
+	}
 
-	vkk_computePipelineInfo_t cpi_loss_mse =
-	{
-		.compute = self->compute,
-		.pl      = self->pl_loss,
-		.cs      = "nn/shaders/nn_loss_mse_comp.spv",
-	};
+	return *_cp;
+}
 
-	self->cp_loss_mse =
-		vkk_computePipeline_new(engine,
-		                        &cpi_loss_mse);
+int nn_engine_computeBegin(nn_engine_t* self)
+{
+	ASSERT(self);
 
-	vkk_computePipelineInfo_t cpi_loss_mae =
+	if(self->cpu)
 	{
-		.compute = self->compute,
-		.pl      = self->pl_loss,
-		.cs      = "nn/shaders/nn_loss_mae_comp.spv",
-	};
+		self->cpu_active = 1;
+		return 1;
+	}
 
-	self->cp_loss_mae =
-		vkk_computePipeline_new(engine,
-		                        &cpi_loss_mae);
+	self->split = 0;
 
-	vkk_computePipelineInfo_t cpi_loss_bce =
+	// sample passes for profiling
+	self->profile_active = 0;
+	self->profile_kernel = NULL;
+	if(self->profile_rate)
 	{
-		.compute = self->compute,
-		.pl      = self->pl_loss,
-		.cs      = "nn/shaders/nn_loss_bce_comp.spv",
-	};
-
-	self->cp_loss_bce =
-		vkk_computePipeline_new(engine,
-		                        &cpi_loss_bce);
+		self->profile_active = ((self->profile_pass %
+		                         self->profile_rate) == 0);
+		++self->profile_pass;
+	}
 
-	vkk_computePipelineInfo_t cpi_tensor_stats =
-	{
-		.compute = self->compute,
-		.pl      = self->pl_tensor_stats,
-		.cs      = "nn/shaders/nn_tensor_stats_comp.spv",
-	};
+	return nn_engine_submitBegin(self);
+}
 
-	self->cp_tensor_stats =
-		vkk_computePipeline_new(engine,
-		                        &cpi_tensor_stats);
+void nn_engine_computeEnd(nn_engine_t* self)
+{
+	ASSERT(self);
 
-	vkk_computePipelineInfo_t cpi_tensor_sn =
+	if(self->cpu)
 	{
-		.compute = self->compute,
-		.pl      = self->pl_tensor_norm,
-		.cs      = "nn/shaders/nn_tensor_sn_comp.spv",
-	};
-
-	self->cp_tensor_sn =
-		vkk_computePipeline_new(engine,
-		                        &cpi_tensor_sn);
+		self->cpu_active = 0;
+		return;
+	}
 
-	vkk_computePipelineInfo_t cpi_tensor_bssn =
+	if(self->dispatch || self->split)
 	{
-		.compute = self->compute,
-		.pl      = self->pl_tensor_norm,
-		.cs      = "nn/shaders/nn_tensor_bssn_comp.spv",
-	};
-
-	self->cp_tensor_bssn =
-		vkk_computePipeline_new(engine,
-		                        &cpi_tensor_bssn);
+		LOGD("DISPATCH %i, SPLIT %u",
+		     self->dispatch, self->split);
+	}
 
-	vkk_computePipelineInfo_t cpi_tensor_computeFillOp =
+	double elapsed = nn_engine_submitEnd(self);
+	if(self->profile_active)
 	{
-		.compute = self->compute,
-		.pl      = self->pl_tensor_op,
-		.cs      = "nn/shaders/nn_tensor_computeFillOp_comp.spv",
-	};
-
-	self->cp_tensor_computeFillOp =
-		vkk_computePipeline_new(engine,
-		                        &cpi_tensor_computeFillOp);
+		nn_engine_profileAdd(self, elapsed);
+		self->profile_kernel = NULL;
+	}
 
-	vkk_computePipelineInfo_t cpi_tensor_computeCopyOp =
-	{
-		.compute = self->compute,
-		.pl      = self->pl_tensor_op,
-		.cs      = "nn/shaders/nn_tensor_computeCopyOp_comp.spv",
-	};
+	self->split_last   = self->split;
+	self->split_total += self->split;
+	self->split        = 0;
+}
 
-	self->cp_tensor_computeCopyOp =
-		vkk_computePipeline_new(engine,
-		                        &cpi_tensor_computeCopyOp);
+void nn_engine_submitPolicy(nn_engine_t* self,
+                            nn_engineSubmit_e submit,
+                            uint32_t hint,
+                            double budget)
+{
+	ASSERT(self);
 
-	vkk_computePipelineInfo_t cpi_tensor_computeAddOp =
+	if(hint == 0)
 	{
-		.compute = self->compute,
-		.pl      = self->pl_tensor_op,
-		.cs      = "nn/shaders/nn_tensor_computeAddOp_comp.spv",
-	};
+		hint = NN_ENGINE_DISPATCH_HINT;
+	}
 
-	self->cp_tensor_computeAddOp =
-		vkk_computePipeline_new(engine,
-		                        &cpi_tensor_computeAddOp);
+	self->submit        = submit;
+	self->submit_hint   = hint;
+	self->submit_budget = budget;
+	self->submit_dt     = 0.0;
+}
 
-	vkk_computePipelineInfo_t cpi_tensor_computeMixOp =
-	{
-		.compute = self->compute,
-		.pl      = self->pl_tensor_op,
-		.cs      = "nn/shaders/nn_tensor_computeMixOp_comp.spv",
-	};
+uint32_t nn_engine_splitCount(nn_engine_t* self)
+{
+	ASSERT(self);
 
-	self->cp_tensor_computeMixOp =
-		vkk_computePipeline_new(engine,
-		                        &cpi_tensor_computeMixOp);
+	return self->split_last;
+}
+
+int nn_engine_profile(nn_engine_t* self, uint32_t rate)
+{
+	ASSERT(self);
 
-	vkk_computePipelineInfo_t cpi_tensor_computeMulOp =
+	if(rate && (self->profile_list == NULL))
 	{
-		.compute = self->compute,
-		.pl      = self->pl_tensor_op,
-		.cs      = "nn/shaders/nn_tensor_computeMulOp_comp.spv",
-	};
+		self->profile_list = cc_list_new();
+		if(self->profile_list == NULL)
+		{
+			return 0;
+		}
+	}
 
-	self->cp_tensor_computeMulOp =
-		vkk_computePipeline_new(engine,
-		                        &cpi_tensor_computeMulOp);
+	nn_engine_profileClear(self);
 
-	vkk_computePipelineInfo_t cpi_tensor_computeScaleOp =
-	{
-		.compute = self->compute,
-		.pl      = self->pl_tensor_op,
-		.cs      = "nn/shaders/nn_tensor_computeScaleOp_comp.spv",
-	};
+	self->profile_rate   = rate;
+	self->profile_pass   = 0;
+	self->profile_active = 0;
 
-	self->cp_tensor_computeScaleOp =
-		vkk_computePipeline_new(engine,
-		                        &cpi_tensor_computeScaleOp);
+	return 1;
+}
 
-	vkk_computePipelineInfo_t cpi_tensor_computeScaleAddOp =
-	{
-		.compute = self->compute,
-		.pl      = self->pl_tensor_op,
-		.cs      = "nn/shaders/nn_tensor_computeScaleAddOp_comp.spv",
-	};
+void nn_engine_profileLayer(nn_engine_t* self, int layer)
+{
+	ASSERT(self);
 
-	self->cp_tensor_computeScaleAddOp =
-		vkk_computePipeline_new(engine,
-		                        &cpi_tensor_computeScaleAddOp);
-
-	if((self->cp_batchNorm_forwardPassXmeanTrain   == NULL) ||
-	   (self->cp_batchNorm_forwardPassXvarTrain    == NULL) ||
-	   (self->cp_batchNorm_forwardPassXmeanCompute == NULL) ||
-	   (self->cp_batchNorm_forwardPassXvarCompute  == NULL) ||
-	   (self->cp_batchNorm_forwardPassXhat         == NULL) ||
-	   (self->cp_batchNorm_forwardPassY            == NULL) ||
-	   (self->cp_batchNorm_backprop_dL_dX          == NULL) ||
-	   (self->cp_batchNorm_backprop_dL_dXhat       == NULL) ||
-	   (self->cp_batchNorm_backpropSum             == NULL) ||
-	   (self->cp_batchNorm_backpropSumNOP          == NULL) ||
-	   (self->cp_conv_forwardPassClamp             == NULL) ||
-	   (self->cp_conv_forwardPassPad               == NULL) ||
-	   (self->cp_conv_forwardPassTClamp            == NULL) ||
-	   (self->cp_conv_forwardPassTPad              == NULL) ||
-	   (self->cp_conv_backprop_dL_dX               == NULL) ||
-	   (self->cp_conv_backprop_dL_dW               == NULL) ||
-	   (self->cp_conv_backprop_dL_dB               == NULL) ||
-	   (self->cp_conv_backpropT_dL_dX              == NULL) ||
-	   (self->cp_conv_backpropT_dL_dW              == NULL) ||
-	   (self->cp_conv_backpropUpdateW              == NULL) ||
-	   (self->cp_conv_backpropUpdateB              == NULL) ||
-	   (self->cp_fact_forwardPassLinear            == NULL) ||
-	   (self->cp_fact_forwardPassLogistic          == NULL) ||
-	   (self->cp_fact_forwardPassReLU              == NULL) ||
-	   (self->cp_fact_forwardPassPReLU             == NULL) ||
-	   (self->cp_fact_forwardPassLReLU             == NULL) ||
-	   (self->cp_fact_forwardPassTanh              == NULL) ||
-	   (self->cp_fact_forwardPassSink              == NULL) ||
-	   (self->cp_fact_backpropLinear               == NULL) ||
-	   (self->cp_fact_backpropLogistic             == NULL) ||
-	   (self->cp_fact_backpropReLU                 == NULL) ||
-	   (self->cp_fact_backpropPReLU                == NULL) ||
-	   (self->cp_fact_backpropLReLU                == NULL) ||
-	   (self->cp_fact_backpropTanh                 == NULL) ||
-	   (self->cp_fact_backpropSink                 == NULL) ||
-	   (self->cp_lanczos_forwardPassT              == NULL) ||
-	   (self->cp_lanczos_forwardPassY              == NULL) ||
-	   (self->cp_lanczos_backprop_dL_dT            == NULL) ||
-	   (self->cp_lanczos_backprop_dL_dX            == NULL) ||
-	   (self->cp_skip_forwardPassAdd               == NULL) ||
-	   (self->cp_skip_forwardPassCat               == NULL) ||
-	   (self->cp_skip_backpropAdd                  == NULL) ||
-	   (self->cp_skip_backpropCat                  == NULL) ||
-	   (self->cp_skip_backpropFork                 == NULL) ||
-	   (self->cp_weight_forwardPass                == NULL) ||
-	   (self->cp_weight_backpropUpdateW            == NULL) ||
-	   (self->cp_weight_backpropUpdateB            == NULL) ||
-	   (self->cp_weight_backprop_dL_dX             == NULL) ||
-	   (self->cp_weight_backprop_dL_dW             == NULL) ||
-	   (self->cp_weight_backprop_dL_dB             == NULL) ||
-	   (self->cp_loss_dL_dY_mse                    == NULL) ||
-	   (self->cp_loss_dL_dY_mae                    == NULL) ||
-	   (self->cp_loss_dL_dY_bce                    == NULL) ||
-	   (self->cp_loss_mse                          == NULL) ||
-	   (self->cp_loss_mae                          == NULL) ||
-	   (self->cp_loss_bce                          == NULL) ||
-	   (self->cp_tensor_stats                      == NULL) ||
-	   (self->cp_tensor_sn                         == NULL) ||
-	   (self->cp_tensor_bssn                       == NULL) ||
-	   (self->cp_tensor_computeFillOp              == NULL) ||
-	   (self->cp_tensor_computeCopyOp              == NULL) ||
-	   (self->cp_tensor_computeAddOp               == NULL) ||
-	   (self->cp_tensor_computeMixOp               == NULL) ||
-	   (self->cp_tensor_computeMulOp               == NULL) ||
-	   (self->cp_tensor_computeScaleOp             == NULL) ||
-	   (self->cp_tensor_computeScaleAddOp          == NULL))
+	if(self->capture_cmds)
 	{
-		goto failure;
+		nn_engineCmd_t* cmd;
+		cmd = nn_engine_captureCmd(self, NN_ENGINE_CMD_LAYER,
+		                           VKK_HAZARD_NONE, 0);
+		if(cmd)
+		{
+			cmd->param[0] = (uint32_t) layer;
+		}
 	}
 
-	nn_dim_t dimNull =
-	{
-		.count  = 1,
-		.height = 1,
-		.width  = 1,
-		.depth  = 1,
-	};
-	self->Null = nn_tensor_new(self, &dimNull,
-	                           NN_TENSOR_INIT_ZERO,
-	                           NN_TENSOR_MODE_COMPUTE);
-	if(self->Null == NULL)
-	{
-		goto failure;
-	}
+	self->profile_layer = layer;
+}
 
-	self->map_bn_us2 = cc_map_new();
-	if(self->map_bn_us2 == NULL)
-	{
-		goto failure;
-	}
+void nn_engine_profileReport(nn_engine_t* self,
+                             const char* pass)
+{
+	ASSERT(self);
+	ASSERT(pass);
 
-	self->map_lanczos_us2 = cc_map_new();
-	if(self->map_lanczos_us2 == NULL)
+	if((self->profile_list == NULL) ||
+	   (cc_list_size(self->profile_list) == 0))
 	{
-		goto failure;
+		return;
 	}
 
-	self->list_tensorOp_us0[0] = cc_list_new();
-	if(self->list_tensorOp_us0[0] == NULL)
+	double total = 0.0;
+
+	nn_engineProfile_t* p;
+	cc_listIter_t*      iter = cc_list_head(self->profile_list);
+	while(iter)
 	{
-		goto failure;
+		p = (nn_engineProfile_t*) cc_list_peekIter(iter);
+		total += p->time;
+		iter = cc_list_next(iter);
 	}
 
-	self->list_tensorOp_us0[1] = cc_list_new();
-	if(self->list_tensorOp_us0[1] == NULL)
+	LOGI("PROFILE %s: total=%0.3f ms", pass, 1000.0*total);
+
+	iter = cc_list_head(self->profile_list);
+	while(iter)
 	{
-		goto failure;
+		p = (nn_engineProfile_t*) cc_list_peekIter(iter);
+		LOGI("PROFILE %s: layer=%i, kernel=%s, count=%u, time=%0.3f ms (%0.1f%%)",
+		     pass, p->layer, p->kernel, p->count,
+		     1000.0*p->time,
+		     (total > 0.0) ? 100.0*p->time/total : 0.0);
+		iter = cc_list_next(iter);
 	}
 
-	// success
-	return self;
-
-	// failure
-	failure:
-		nn_engine_delete(&self);
-	return NULL;
+	nn_engine_profileClear(self);
 }
 
-void nn_engine_delete(nn_engine_t** _self)
+int nn_engine_computeActive(nn_engine_t* self)
 {
-	ASSERT(_self);
+	ASSERT(self);
 
-	nn_engine_t* self = *_self;
-	if(self)
+	if(self->cpu)
 	{
-		if(self->list_tensorOp_us0[0] &&
-		   self->list_tensorOp_us0[1])
-		{
-			cc_list_appendList(self->list_tensorOp_us0[0],
-			                   self->list_tensorOp_us0[1]);
-			cc_list_delete(&self->list_tensorOp_us0[1]);
-		}
-
-		nn_tensorOpUs0Data_t* data;
-		cc_listIter_t*        iter;
-		if(self->list_tensorOp_us0[0])
-		{
-			iter = cc_list_head(self->list_tensorOp_us0[0]);
-			while(iter)
-			{
-				data = (nn_tensorOpUs0Data_t*)
-				       cc_list_remove(self->list_tensorOp_us0[0],
-				                      &iter);
-				nn_tensorOpUs0Data_delete(&data);
-			}
-			cc_list_delete(&self->list_tensorOp_us0[0]);
-		}
-
-		cc_mapIter_t* miter;
-		if(self->map_bn_us2)
-		{
-			miter = cc_map_head(self->map_bn_us2);
-			while(miter)
-			{
-				nn_batchNormUs2Data_t* data;
-				data = (nn_batchNormUs2Data_t*)
-				       cc_map_remove(self->map_bn_us2,
-				                     &miter);
-				nn_batchNormUs2Data_delete(&data);
-			}
-			cc_map_delete(&self->map_bn_us2);
-		}
-
-		if(self->map_lanczos_us2)
-		{
-			miter = cc_map_head(self->map_lanczos_us2);
-			while(miter)
-			{
-				nn_lanczosUs2Data_t* data;
-				data = (nn_lanczosUs2Data_t*)
-				       cc_map_remove(self->map_lanczos_us2, &miter);
-				nn_lanczosUs2Data_delete(&data);
-			}
-			cc_map_delete(&self->map_lanczos_us2);
-		}
-
-		nn_tensor_delete(&self->Null);
-		vkk_computePipeline_delete(&self->cp_tensor_computeScaleAddOp);
-		vkk_computePipeline_delete(&self->cp_tensor_computeScaleOp);
-		vkk_computePipeline_delete(&self->cp_tensor_computeMulOp);
-		vkk_computePipeline_delete(&self->cp_tensor_computeMixOp);
-		vkk_computePipeline_delete(&self->cp_tensor_computeAddOp);
-		vkk_computePipeline_delete(&self->cp_tensor_computeCopyOp);
-		vkk_computePipeline_delete(&self->cp_tensor_computeFillOp);
-		vkk_computePipeline_delete(&self->cp_tensor_bssn);
-		vkk_computePipeline_delete(&self->cp_tensor_sn);
-		vkk_computePipeline_delete(&self->cp_tensor_stats);
-		vkk_computePipeline_delete(&self->cp_loss_bce);
-		vkk_computePipeline_delete(&self->cp_loss_mae);
-		vkk_computePipeline_delete(&self->cp_loss_mse);
-		vkk_computePipeline_delete(&self->cp_loss_dL_dY_bce);
-		vkk_computePipeline_delete(&self->cp_loss_dL_dY_mae);
-		vkk_computePipeline_delete(&self->cp_loss_dL_dY_mse);
-		vkk_computePipeline_delete(&self->cp_weight_backprop_dL_dB);
-		vkk_computePipeline_delete(&self->cp_weight_backprop_dL_dW);
-		vkk_computePipeline_delete(&self->cp_weight_backprop_dL_dX);
-		vkk_computePipeline_delete(&self->cp_weight_backpropUpdateB);
-		vkk_computePipeline_delete(&self->cp_weight_backpropUpdateW);
-		vkk_computePipeline_delete(&self->cp_weight_forwardPass);
-		vkk_computePipeline_delete(&self->cp_skip_backpropFork);
-		vkk_computePipeline_delete(&self->cp_skip_backpropCat);
-		vkk_computePipeline_delete(&self->cp_skip_backpropAdd);
-		vkk_computePipeline_delete(&self->cp_skip_forwardPassCat);
-		vkk_computePipeline_delete(&self->cp_skip_forwardPassAdd);
-		vkk_computePipeline_delete(&self->cp_lanczos_backprop_dL_dX);
-		vkk_computePipeline_delete(&self->cp_lanczos_backprop_dL_dT);
-		vkk_computePipeline_delete(&self->cp_lanczos_forwardPassY);
-		vkk_computePipeline_delete(&self->cp_lanczos_forwardPassT);
-		vkk_computePipeline_delete(&self->cp_fact_backpropSink);
-		vkk_computePipeline_delete(&self->cp_fact_backpropTanh);
-		vkk_computePipeline_delete(&self->cp_fact_backpropLReLU);
-		vkk_computePipeline_delete(&self->cp_fact_backpropPReLU);
-		vkk_computePipeline_delete(&self->cp_fact_backpropReLU);
-		vkk_computePipeline_delete(&self->cp_fact_backpropLogistic);
-		vkk_computePipeline_delete(&self->cp_fact_backpropLinear);
-		vkk_computePipeline_delete(&self->cp_fact_forwardPassSink);
-		vkk_computePipeline_delete(&self->cp_fact_forwardPassTanh);
-		vkk_computePipeline_delete(&self->cp_fact_forwardPassLReLU);
-		vkk_computePipeline_delete(&self->cp_fact_forwardPassPReLU);
-		vkk_computePipeline_delete(&self->cp_fact_forwardPassReLU);
-		vkk_computePipeline_delete(&self->cp_fact_forwardPassLogistic);
-		vkk_computePipeline_delete(&self->cp_fact_forwardPassLinear);
-		vkk_computePipeline_delete(&self->cp_conv_backpropUpdateB);
-		vkk_computePipeline_delete(&self->cp_conv_backpropUpdateW);
-		vkk_computePipeline_delete(&self->cp_conv_backpropT_dL_dW);
-		vkk_computePipeline_delete(&self->cp_conv_backpropT_dL_dX);
-		vkk_computePipeline_delete(&self->cp_conv_backprop_dL_dB);
-		vkk_computePipeline_delete(&self->cp_conv_backprop_dL_dW);
-		vkk_computePipeline_delete(&self->cp_conv_backprop_dL_dX);
-		vkk_computePipeline_delete(&self->cp_conv_forwardPassTPad);
-		vkk_computePipeline_delete(&self->cp_conv_forwardPassTClamp);
-		vkk_computePipeline_delete(&self->cp_conv_forwardPassPad);
-		vkk_computePipeline_delete(&self->cp_conv_forwardPassClamp);
-		vkk_computePipeline_delete(&self->cp_batchNorm_backpropSum);
-		vkk_computePipeline_delete(&self->cp_batchNorm_backpropSumNOP);
-		vkk_computePipeline_delete(&self->cp_batchNorm_backprop_dL_dXhat);
-		vkk_computePipeline_delete(&self->cp_batchNorm_backprop_dL_dX);
-		vkk_computePipeline_delete(&self->cp_batchNorm_forwardPassY);
-		vkk_computePipeline_delete(&self->cp_batchNorm_forwardPassXhat);
-		vkk_computePipeline_delete(&self->cp_batchNorm_forwardPassXvarCompute);
-		vkk_computePipeline_delete(&self->cp_batchNorm_forwardPassXmeanCompute);
-		vkk_computePipeline_delete(&self->cp_batchNorm_forwardPassXvarTrain);
-		vkk_computePipeline_delete(&self->cp_batchNorm_forwardPassXmeanTrain);
-		vkk_pipelineLayout_delete(&self->pl_tensor_op);
-		vkk_pipelineLayout_delete(&self->pl_tensor_norm);
-		vkk_pipelineLayout_delete(&self->pl_tensor_stats);
-		vkk_pipelineLayout_delete(&self->pl_loss);
-		vkk_pipelineLayout_delete(&self->pl_weight_bp);
-		vkk_pipelineLayout_delete(&self->pl_weight_fp);
-		vkk_pipelineLayout_delete(&self->pl_skip_bp);
-		vkk_pipelineLayout_delete(&self->pl_skip_fp);
-		vkk_pipelineLayout_delete(&self->pl_lanczos_bp);
-		vkk_pipelineLayout_delete(&self->pl_lanczos_fp);
-		vkk_pipelineLayout_delete(&self->pl_fact_bp);
-		vkk_pipelineLayout_delete(&self->pl_fact_fp);
-		vkk_pipelineLayout_delete(&self->pl_conv_bp);
-		vkk_pipelineLayout_delete(&self->pl_conv_fp);
-		vkk_pipelineLayout_delete(&self->pl_batchNorm_bp);
-		vkk_pipelineLayout_delete(&self->pl_batchNorm_fp);
-		vkk_uniformSetFactory_delete(&self->usf0_tensor_op);
-		vkk_uniformSetFactory_delete(&self->usf1_tensor_norm);
-		vkk_uniformSetFactory_delete(&self->usf1_tensor_stats);
-		vkk_uniformSetFactory_delete(&self->usf0_tensor);
-		vkk_uniformSetFactory_delete(&self->usf1_loss);
-		vkk_uniformSetFactory_delete(&self->usf0_loss);
-		vkk_uniformSetFactory_delete(&self->usf1_weight_bp);
-		vkk_uniformSetFactory_delete(&self->usf1_weight_fp);
-		vkk_uniformSetFactory_delete(&self->usf0_weight);
-		vkk_uniformSetFactory_delete(&self->usf1_skip_bp);
-		vkk_uniformSetFactory_delete(&self->usf1_skip_fp);
-		vkk_uniformSetFactory_delete(&self->usf0_skip);
-		vkk_uniformSetFactory_delete(&self->usf2_lanczos);
-		vkk_uniformSetFactory_delete(&self->usf1_lanczos_bp);
-		vkk_uniformSetFactory_delete(&self->usf1_lanczos_fp);
-		vkk_uniformSetFactory_delete(&self->usf0_lanczos);
-		vkk_uniformSetFactory_delete(&self->usf1_fact_bp);
-		vkk_uniformSetFactory_delete(&self->usf1_fact_fp);
-		vkk_uniformSetFactory_delete(&self->usf0_fact);
-		vkk_uniformSetFactory_delete(&self->usf1_conv_bp);
-		vkk_uniformSetFactory_delete(&self->usf1_conv_fp);
-		vkk_uniformSetFactory_delete(&self->usf0_conv);
-		vkk_uniformSetFactory_delete(&self->usf2_batchNorm);
-		vkk_uniformSetFactory_delete(&self->usf1_batchNorm_bp);
-		vkk_uniformSetFactory_delete(&self->usf1_batchNorm_fp);
-		vkk_uniformSetFactory_delete(&self->usf0_batchNorm);
-		vkk_compute_delete(&self->compute);
-		FREE(self);
-		*_self = NULL;
+		return self->cpu_active;
 	}
+
+	return vkk_compute_active(self->compute);
 }
 
-vkk_uniformSet_t*
-nn_engine_getBatchNormUs2(nn_engine_t* self, uint32_t k)
+void nn_engine_computeAccess(nn_engine_t* self,
+                             uint32_t read_count,
+                             vkk_buffer_t** read,
+                             uint32_t write_count,
+                             vkk_buffer_t** write)
 {
 	ASSERT(self);
 
-	nn_batchNormUs2Data_t* data;
-
-	nn_batchNormUs2Key_t key =
-	{
-		.k = k,
-	};
-
-	// find existing data
-	cc_mapIter_t* miter;
-	miter = cc_map_findp(self->map_bn_us2,
-	                     sizeof(nn_batchNormUs2Key_t),
-	                     &key);
-	if(miter)
+	if((read_count  > NN_ENGINE_ACCESS_MAX) ||
+	   (write_count > NN_ENGINE_ACCESS_MAX))
 	{
-		data = (nn_batchNormUs2Data_t*) cc_map_val(miter);
-		return data->us2;
+		LOGW("invalid read_count=%u, write_count=%u",
+		     read_count, write_count);
+		self->access_declared = 0;
+		return;
 	}
 
-	data = nn_batchNormUs2Data_new(self, &key);
-	if(data == NULL)
+	uint32_t i;
+	for(i = 0; i < read_count; ++i)
 	{
-		return NULL;
+		self->access_read[i] = read[i];
 	}
 
-	if(cc_map_addp(self->map_bn_us2,
-	               data, sizeof(nn_batchNormUs2Key_t),
-	               &key) == NULL)
+	for(i = 0; i < write_count; ++i)
 	{
-		goto fail_add;
+		self->access_write[i] = write[i];
 	}
 
-	// success
-	return data->us2;
-
-	// failure
-	fail_add:
-		nn_batchNormUs2Data_delete(&data);
-	return NULL;
+	self->access_declared    = 1;
+	self->access_read_count  = read_count;
+	self->access_write_count = write_count;
 }
 
-vkk_uniformSet_t*
-nn_engine_getLanczos3Us2(nn_engine_t* self, uint32_t n)
+void nn_engine_computeDispatch(nn_engine_t* self,
+                               vkk_hazard_e hazard,
+                               uint32_t count_x,
+                               uint32_t count_y,
+                               uint32_t count_z,
+                               uint32_t local_size_x,
+                               uint32_t local_size_y,
+                               uint32_t local_size_z)
 {
 	ASSERT(self);
 
-	nn_lanczosUs2Data_t* data;
+	hazard = nn_engine_hazardTrack(self, hazard);
 
-	nn_lanczosUs2Key_t key =
+	if(self->capture_cmds)
 	{
-		.n = n,
-	};
+		nn_engineCmd_t* cmd;
+		cmd = nn_engine_captureCmd(self, NN_ENGINE_CMD_DISPATCH,
+		                           hazard, 0);
+		if(cmd)
+		{
+			cmd->param[0] = count_x;
+			cmd->param[1] = count_y;
+			cmd->param[2] = count_z;
+			cmd->param[3] = local_size_x;
+			cmd->param[4] = local_size_y;
+			cmd->param[5] = local_size_z;
+		}
+	}
 
-	// find existing data
-	cc_mapIter_t* miter;
-	miter = cc_map_findp(self->map_lanczos_us2,
-	                     sizeof(nn_lanczosUs2Key_t),
-	                     &key);
-	if(miter)
+	vkk_compute_dispatch(self->compute, hazard,
+	                     count_x, count_y, count_z,
+	                     local_size_x, local_size_y,
+	                     local_size_z);
+	++self->dispatch;
+}
+
+int
+nn_engine_computeBind(nn_engine_t* self,
+                      vkk_computePipeline_t* cp)
+{
+	// cp may be NULL if the pipeline failed to be created
+	ASSERT(self);
+
+	if(cp == NULL)
 	{
-		data = (nn_lanczosUs2Data_t*) cc_map_val(miter);
-		return data->us2;
+		return 0;
 	}
 
-	data = nn_lanczosUs2Data_new(self, &key);
-	if(data == NULL)
+	// profiled passes submit each bound pipeline separately
+	// to measure the time spent by each kernel
+	if(self->profile_active)
 	{
-		return NULL;
+		if(self->dispatch)
+		{
+			nn_engine_profileAdd(self,
+			                     nn_engine_submitEnd(self));
+			if(nn_engine_submitBegin(self) == 0)
+			{
+				return 0;
+			}
+		}
+
+		self->profile_kernel = nn_engine_profileKernel(self,
+		                                               cp);
+		self->profile_kernel_layer = self->profile_layer;
 	}
+	else if(nn_engine_submitSplit(self))
+	{
+		LOGD("DISPATCH %i", self->dispatch);
 
-	if(cc_map_addp(self->map_lanczos_us2,
-	               data, sizeof(nn_lanczosUs2Key_t),
-	               &key) == NULL)
+		++self->split;
+
+		nn_engine_submitEnd(self);
+		if(nn_engine_submitBegin(self) == 0)
+		{
+			return 0;
+		}
+	}
+
+	if(self->capture_cmds)
 	{
-		goto fail_add;
+		nn_engineCmd_t* cmd;
+		cmd = nn_engine_captureCmd(self, NN_ENGINE_CMD_BIND,
+		                           VKK_HAZARD_NONE, 0);
+		if(cmd)
+		{
+			cmd->cp = cp;
+		}
 	}
 
-	// success
-	return data->us2;
+	vkk_compute_bindComputePipeline(self->compute, cp);
 
-	// failure
-	fail_add:
-		nn_lanczosUs2Data_delete(&data);
-	return NULL;
+	return 1;
 }
 
-vkk_uniformSet_t*
-nn_engine_getTensorOpUs0(nn_engine_t* self,
-                         nn_tensor_t* X1,
-                         nn_tensor_t* X2,
-                         nn_tensor_t* Y,
-                         nn_tensorOpUs0Idx_t* idx)
+void
+nn_engine_computeBindUniformSets(nn_engine_t* self,
+                                 uint32_t us_count,
+                                 vkk_uniformSet_t** us_array)
 {
-	// X2 and Y may be NULL
 	ASSERT(self);
-	ASSERT(X1);
-	ASSERT(idx);
+	ASSERT(us_array);
 
-	nn_tensorOpUs0Data_t* data;
-	cc_listIter_t*        iter;
-	iter = cc_list_head(self->list_tensorOp_us0[0]);
-	if(iter)
+	if(self->capture_cmds)
 	{
-		data = (nn_tensorOpUs0Data_t*)
-		       cc_list_peekIter(iter);
+		size_t size = us_count*sizeof(vkk_uniformSet_t*);
 
-		if(nn_tensorOpUs0Data_update(data, X1, X2, Y, idx) == 0)
+		nn_engineCmd_t* cmd;
+		cmd = nn_engine_captureCmd(self, NN_ENGINE_CMD_BIND_US,
+		                           VKK_HAZARD_NONE, size);
+		if(cmd)
 		{
-			return NULL;
+			cmd->count    = us_count;
+			cmd->us_array = (vkk_uniformSet_t**) &cmd[1];
+			memcpy(cmd->us_array, us_array, size);
 		}
+	}
+
+	vkk_compute_bindUniformSets(self->compute, us_count,
+	                            us_array);
+}
+
+void
+nn_engine_computeUpdateUniformSetRefs(nn_engine_t* self,
+                                      vkk_uniformSet_t* us,
+                                      uint32_t ua_count,
+                                      vkk_uniformAttachment_t* ua_array)
+{
+	ASSERT(self);
+	ASSERT(us);
+	ASSERT(ua_array);
 
-		cc_list_swapn(self->list_tensorOp_us0[0],
-		              self->list_tensorOp_us0[1],
-		              iter, NULL);
+	if(self->capture_cmds)
+	{
+		size_t size = ua_count*sizeof(vkk_uniformAttachment_t);
+
+		nn_engineCmd_t* cmd;
+		cmd = nn_engine_captureCmd(self, NN_ENGINE_CMD_UPDATE,
+		                           VKK_HAZARD_NONE, size);
+		if(cmd)
+		{
+			cmd->us       = us;
+			cmd->count    = ua_count;
+			cmd->ua_array = (vkk_uniformAttachment_t*) &cmd[1];
+			memcpy(cmd->ua_array, ua_array, size);
+		}
 	}
-	else
+
+	nn_engine_usRegister(self, us, ua_count, ua_array);
+
+	vkk_compute_updateUniformSetRefs(self->compute, us,
+	                                 ua_count, ua_array);
+}
+
+void
+nn_engine_computeFillStorage(nn_engine_t* self,
+                             vkk_hazard_e hazard,
+                             vkk_buffer_t* buffer,
+                             size_t offset, size_t size,
+                             uint32_t data)
+{
+	ASSERT(self);
+	ASSERT(buffer);
+
+	if(self->capture_cmds)
 	{
-		data = nn_tensorOpUs0Data_new(X1, X2, Y, idx);
-		if(data == NULL)
+		nn_engineCmd_t* cmd;
+		cmd = nn_engine_captureCmd(self, NN_ENGINE_CMD_FILL,
+		                           hazard, 0);
+		if(cmd)
 		{
-			return NULL;
+			cmd->dst        = buffer;
+			cmd->dst_offset = offset;
+			cmd->size       = size;
+			cmd->data       = data;
 		}
+	}
+
+	self->hazard_valid    = 0;
+	self->access_declared = 0;
+
+	vkk_compute_fillStorage(self->compute, hazard, buffer,
+	                        offset, size, data);
+}
+
+void
+nn_engine_computeCopyStorage(nn_engine_t* self,
+                             vkk_hazard_e hazard,
+                             vkk_buffer_t* src,
+                             vkk_buffer_t* dst,
+                             size_t src_offset,
+                             size_t dst_offset,
+                             size_t size)
+{
+	ASSERT(self);
+	ASSERT(src);
+	ASSERT(dst);
 
-		if(cc_list_append(self->list_tensorOp_us0[1], NULL,
-		                  data) == NULL)
+	if(self->capture_cmds)
+	{
+		nn_engineCmd_t* cmd;
+		cmd = nn_engine_captureCmd(self, NN_ENGINE_CMD_COPY,
+		                           hazard, 0);
+		if(cmd)
 		{
-			goto fail_append;
+			cmd->src        = src;
+			cmd->dst        = dst;
+			cmd->src_offset = src_offset;
+			cmd->dst_offset = dst_offset;
+			cmd->size       = size;
 		}
 	}
 
-	// success
-	return data->us0;
+	self->hazard_valid    = 0;
+	self->access_declared = 0;
 
-	// failure
-	fail_append:
-		nn_tensorOpUs0Data_delete(&data);
-	return NULL;
+	vkk_compute_copyStorage(self->compute, hazard, src, dst,
+	                        src_offset, dst_offset, size);
 }
 
-int nn_engine_computeBegin(nn_engine_t* self)
+void nn_engine_captureBegin(nn_engine_t* self,
+                            cc_list_t* cmds)
 {
 	ASSERT(self);
+	ASSERT(cmds);
+	ASSERT(self->cpu == NULL);
+	ASSERT(self->capture_cmds == NULL);
 
-	return vkk_compute_begin(self->compute);
+	self->capture_cmds  = cmds;
+	self->capture_error = 0;
+
+	// the captured commands may be replayed after commands
+	// that are unknown to the tracker
+	self->hazard_valid = 0;
 }
 
-void nn_engine_computeEnd(nn_engine_t* self)
+int nn_engine_captureEnd(nn_engine_t* self)
+{
+	ASSERT(self);
+
+	int ret = (self->capture_error == 0);
+
+	self->capture_cmds  = NULL;
+	self->capture_error = 0;
+
+	return ret;
+}
+
+int nn_engine_captureReplay(nn_engine_t* self,
+                            cc_list_t* cmds)
 {
 	ASSERT(self);
+	ASSERT(cmds);
+	ASSERT(self->capture_cmds == NULL);
 
-	if(self->dispatch)
+	nn_engineCmd_t* cmd;
+	cc_listIter_t*  iter = cc_list_head(cmds);
+	while(iter)
 	{
-		LOGD("DISPATCH %i", self->dispatch);
-		self->dispatch = 0;
-	}
+		cmd = (nn_engineCmd_t*) cc_list_peekIter(iter);
 
-	vkk_compute_end(self->compute);
+		if(cmd->type == NN_ENGINE_CMD_BIND)
+		{
+			if(nn_engine_computeBind(self, cmd->cp) == 0)
+			{
+				return 0;
+			}
+		}
+		else if(cmd->type == NN_ENGINE_CMD_BIND_US)
+		{
+			nn_engine_computeBindUniformSets(self, cmd->count,
+			                                 cmd->us_array);
+		}
+		else if(cmd->type == NN_ENGINE_CMD_UPDATE)
+		{
+			nn_engine_computeUpdateUniformSetRefs(self, cmd->us,
+			                                      cmd->count,
+			                                      cmd->ua_array);
+		}
+		else if(cmd->type == NN_ENGINE_CMD_DISPATCH)
+		{
+			nn_engine_computeDispatch(self, cmd->hazard,
+			                          cmd->param[0],
+			                          cmd->param[1],
+			                          cmd->param[2],
+			                          cmd->param[3],
+			                          cmd->param[4],
+			                          cmd->param[5]);
+		}
+		else if(cmd->type == NN_ENGINE_CMD_FILL)
+		{
+			nn_engine_computeFillStorage(self, cmd->hazard,
+			                             cmd->dst,
+			                             cmd->dst_offset,
+			                             cmd->size, cmd->data);
+		}
+		else if(cmd->type == NN_ENGINE_CMD_COPY)
+		{
+			nn_engine_computeCopyStorage(self, cmd->hazard,
+			                             cmd->src, cmd->dst,
+			                             cmd->src_offset,
+			                             cmd->dst_offset,
+			                             cmd->size);
+		}
+		else if(cmd->type == NN_ENGINE_CMD_LAYER)
+		{
+			nn_engine_profileLayer(self, (int) cmd->param[0]);
+		}
+
+		iter = cc_list_next(iter);
+	}
 
-	// make data available for next pass
-	cc_list_appendList(self->list_tensorOp_us0[0],
-	                   self->list_tensorOp_us0[1]);
+	return 1;
 }
 
-void nn_engine_computeDispatch(nn_engine_t* self,
-                               vkk_hazard_e hazard,
-                               uint32_t count_x,
-                               uint32_t count_y,
-                               uint32_t count_z,
-                               uint32_t local_size_x,
-                               uint32_t local_size_y,
-                               uint32_t local_size_z)
+void nn_engine_captureDiscard(nn_engine_t* self,
+                              cc_list_t* cmds)
 {
 	ASSERT(self);
+	ASSERT(cmds);
 
-	vkk_compute_dispatch(self->compute, hazard,
-	                     count_x, count_y, count_z,
-	                     local_size_x, local_size_y,
-	                     local_size_z);
-	++self->dispatch;
+	nn_engineCmd_t* cmd;
+	cc_listIter_t*  iter = cc_list_head(cmds);
+	while(iter)
+	{
+		cmd = (nn_engineCmd_t*) cc_list_remove(cmds, &iter);
+		FREE(cmd);
+	}
 }
 
-int
-nn_engine_computeBind(nn_engine_t* self,
-                      vkk_computePipeline_t* cp)
+int nn_engine_captureLiveness(nn_engine_t* self,
+                              cc_list_t* cmds,
+                              uint32_t count,
+                              vkk_buffer_t** buffers,
+                              uint32_t* first,
+                              uint32_t* last)
 {
 	ASSERT(self);
-	ASSERT(cp);
+	ASSERT(cmds);
+	ASSERT(buffers);
+	ASSERT(first);
+	ASSERT(last);
 
-	// split dispatch to improve UI responsiveness
-	if(self->dispatch >= NN_ENGINE_DISPATCH_HINT)
+	if(self->map_us_error)
 	{
-		LOGD("DISPATCH %i", self->dispatch);
+		LOGE("invalid");
+		return 0;
+	}
+
+	uint32_t i;
+	for(i = 0; i < count; ++i)
+	{
+		first[i] = 1;
+		last[i]  = 0;
+	}
 
-		self->dispatch = 0;
+	// refs updated by the captured commands override the
+	// refs retained by the engine
+	cc_map_t* map_update = cc_map_new();
+	if(map_update == NULL)
+	{
+		return 0;
+	}
 
-		vkk_compute_end(self->compute);
-		if(vkk_compute_begin(self->compute) == 0)
+	vkk_buffer_t*     refs[4*NN_ENGINE_UA_MAX];
+	uint32_t          refs_count = 0;
+	vkk_uniformSet_t* us_array[4];
+	uint32_t          us_count = 0;
+	uint32_t          epoch    = 0;
+
+	nn_engineCmd_t*          cmd;
+	nn_engineUs_t*           data;
+	vkk_uniformAttachment_t* ua_array;
+	uint32_t                 ua_count;
+	cc_mapIter_t*            miter;
+	uint32_t                 j;
+	uint32_t                 k;
+	cc_listIter_t*           iter = cc_list_head(cmds);
+	while(iter)
+	{
+		cmd = (nn_engineCmd_t*) cc_list_peekIter(iter);
+
+		if(cmd->type == NN_ENGINE_CMD_BIND_US)
 		{
-			return 0;
+			if(cmd->count > 4)
+			{
+				LOGE("invalid count=%u", cmd->count);
+				goto fail_cmd;
+			}
+
+			us_count = cmd->count;
+			for(i = 0; i < us_count; ++i)
+			{
+				us_array[i] = cmd->us_array[i];
+			}
+		}
+		else if(cmd->type == NN_ENGINE_CMD_UPDATE)
+		{
+			miter = cc_map_findp(map_update,
+			                     sizeof(vkk_uniformSet_t*),
+			                     &cmd->us);
+			if(miter)
+			{
+				cc_map_remove(map_update, &miter);
+			}
+
+			if(cc_map_addp(map_update, cmd,
+			               sizeof(vkk_uniformSet_t*),
+			               &cmd->us) == NULL)
+			{
+				goto fail_cmd;
+			}
+		}
+
+		// collect the buffers referenced by the command
+		refs_count = 0;
+		if(cmd->type == NN_ENGINE_CMD_DISPATCH)
+		{
+			for(i = 0; i < us_count; ++i)
+			{
+				miter = cc_map_findp(map_update,
+				                     sizeof(vkk_uniformSet_t*),
+				                     &us_array[i]);
+				if(miter)
+				{
+					nn_engineCmd_t* update;
+					update   = (nn_engineCmd_t*) cc_map_val(miter);
+					ua_count = update->count;
+					ua_array = update->ua_array;
+				}
+				else
+				{
+					miter = cc_map_findp(self->map_us,
+					                     sizeof(vkk_uniformSet_t*),
+					                     &us_array[i]);
+					if(miter == NULL)
+					{
+						continue;
+					}
+
+					data     = (nn_engineUs_t*) cc_map_val(miter);
+					ua_count = data->count;
+					ua_array = data->ua_array;
+				}
+
+				for(j = 0; j < ua_count; ++j)
+				{
+					refs[refs_count++] = ua_array[j].buffer;
+				}
+			}
+		}
+		else if(cmd->type == NN_ENGINE_CMD_FILL)
+		{
+			refs[refs_count++] = cmd->dst;
+		}
+		else if(cmd->type == NN_ENGINE_CMD_COPY)
+		{
+			refs[refs_count++] = cmd->src;
+			refs[refs_count++] = cmd->dst;
+		}
+		else
+		{
+			iter = cc_list_next(iter);
+			continue;
+		}
+
+		// the barrier precedes the command
+		if(cmd->hazard != VKK_HAZARD_NONE)
+		{
+			++epoch;
 		}
+
+		for(i = 0; i < count; ++i)
+		{
+			for(k = 0; k < refs_count; ++k)
+			{
+				if(refs[k] == buffers[i])
+				{
+					if(first[i] > last[i])
+					{
+						first[i] = epoch;
+					}
+					last[i] = epoch;
+					break;
+				}
+			}
+		}
+
+		iter = cc_list_next(iter);
 	}
 
-	vkk_compute_bindComputePipeline(self->compute, cp);
+	miter = cc_map_head(map_update);
+	while(miter)
+	{
+		cc_map_remove(map_update, &miter);
+	}
+	cc_map_delete(&map_update);
 
+	// success
 	return 1;
+
+	// failure
+	fail_cmd:
+	{
+		miter = cc_map_head(map_update);
+		while(miter)
+		{
+			cc_map_remove(map_update, &miter);
+		}
+		cc_map_delete(&map_update);
+	}
+	return 0;
+}
+
+int nn_engine_captureAlias(nn_engine_t* self,
+                           cc_list_t* cmds,
+                           vkk_buffer_t* src,
+                           vkk_buffer_t* dst)
+{
+	ASSERT(self);
+	ASSERT(cmds);
+	ASSERT(src);
+	ASSERT(dst);
+
+	if(self->map_us_error)
+	{
+		LOGE("invalid");
+		return 0;
+	}
+
+	// only the uniform sets bound by cmds are known to be
+	// alive while the retained refs may include sets which
+	// were deleted
+	vkk_uniformAttachment_t ua_array[NN_ENGINE_UA_MAX];
+	nn_engineCmd_t*         cmd;
+	nn_engineUs_t*          data;
+	vkk_uniformSet_t*       us;
+	cc_mapIter_t*           miter;
+	uint32_t                i;
+	uint32_t                j;
+	int                     found;
+	cc_listIter_t*          iter = cc_list_head(cmds);
+	while(iter)
+	{
+		cmd = (nn_engineCmd_t*) cc_list_peekIter(iter);
+		if(cmd->type != NN_ENGINE_CMD_BIND_US)
+		{
+			iter = cc_list_next(iter);
+			continue;
+		}
+
+		for(i = 0; i < cmd->count; ++i)
+		{
+			us    = cmd->us_array[i];
+			miter = cc_map_findp(self->map_us,
+			                     sizeof(vkk_uniformSet_t*), &us);
+			if(miter == NULL)
+			{
+				continue;
+			}
+
+			data  = (nn_engineUs_t*) cc_map_val(miter);
+			found = 0;
+			for(j = 0; j < data->count; ++j)
+			{
+				ua_array[j] = data->ua_array[j];
+				if(ua_array[j].buffer == src)
+				{
+					ua_array[j].buffer = dst;
+					found = 1;
+				}
+			}
+
+			if(found)
+			{
+				nn_engine_computeUpdateUniformSetRefs(self, us,
+				                                      data->count,
+				                                      ua_array);
+			}
+		}
+
+		iter = cc_list_next(iter);
+	}
+
+	return self->map_us_error == 0;
 }
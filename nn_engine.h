@@ -31,27 +31,104 @@
 #include "../libvkk/vkk.h"
 #include "nn.h"
 
+// hazard tracking limits
+#define NN_ENGINE_ACCESS_MAX 8
+#define NN_ENGINE_HAZARD_MAX 64
+
+// submission policy
+// DISPATCH: split the compute pass every hint dispatches to
+//           improve UI responsiveness (default)
+// HEADLESS: never split the compute pass
+// BUDGET:   split the compute pass when the estimated time
+//           of the recorded dispatches exceeds the budget
+//           (in seconds) where the time per dispatch is
+//           measured from the previous submissions
+// A hint of zero selects the default dispatch hint which is
+// also used by BUDGET until the time has been measured.
+typedef enum
+{
+	NN_ENGINE_SUBMIT_DISPATCH = 0,
+	NN_ENGINE_SUBMIT_HEADLESS = 1,
+	NN_ENGINE_SUBMIT_BUDGET   = 2,
+} nn_engineSubmit_e;
+
 typedef struct nn_engine_s
 {
 	vkk_engine_t* engine;
 
 	int dispatch;
 
+	// submission policy
+	nn_engineSubmit_e submit;
+	uint32_t          submit_hint;
+	double            submit_budget;
+	double            submit_t0;
+	double            submit_dt;
+
+	// split counters
+	// split:       current pass
+	// split_last:  previous pass
+	// split_total: all passes
+	uint32_t split;
+	uint32_t split_last;
+	uint64_t split_total;
+
+	// hazard tracking
+	// access declares the buffers accessed by the next
+	// dispatch and hazard tracks the buffers accessed since
+	// the last barrier
+	int           access_declared;
+	uint32_t      access_read_count;
+	uint32_t      access_write_count;
+	vkk_buffer_t* access_read[NN_ENGINE_ACCESS_MAX];
+	vkk_buffer_t* access_write[NN_ENGINE_ACCESS_MAX];
+	int           hazard_valid;
+	uint32_t      hazard_read_count;
+	uint32_t      hazard_write_count;
+	uint32_t      hazard_elided;
+	vkk_buffer_t* hazard_read[NN_ENGINE_HAZARD_MAX];
+	vkk_buffer_t* hazard_write[NN_ENGINE_HAZARD_MAX];
+
+	// profiler
+	// profile_layer is set by the arch to tag dispatches
+	// with the owning layer (-1 for none)
+	uint32_t    profile_rate;
+	uint32_t    profile_pass;
+	int         profile_active;
+	int         profile_layer;
+	int         profile_kernel_layer;
+	const char* profile_kernel;
+	cc_list_t*  profile_list;
+
 	cc_rngUniform_t rng_uniform;
 	cc_rngNormal_t  rng_normal;
 
 	vkk_compute_t* compute;
 
+	// CPU backend
+	nn_cpu_t* cpu;
+	int       cpu_active;
+
+	// captured command stream
+	// commands are recorded when capture_cmds is set
+	cc_list_t* capture_cmds;
+	int        capture_error;
+
 	vkk_uniformSetFactory_t* usf0_batchNorm;
 	vkk_uniformSetFactory_t* usf1_batchNorm_fp;
 	vkk_uniformSetFactory_t* usf1_batchNorm_bp;
-	vkk_uniformSetFactory_t* usf2_batchNorm;
 	vkk_uniformSetFactory_t* usf0_conv;
 	vkk_uniformSetFactory_t* usf1_conv_fp;
 	vkk_uniformSetFactory_t* usf1_conv_bp;
+	vkk_uniformSetFactory_t* usf2_conv_col;
+	vkk_uniformSetFactory_t* usf2_conv_wg;
+	vkk_uniformSetFactory_t* usf2_conv_split;
 	vkk_uniformSetFactory_t* usf0_fact;
 	vkk_uniformSetFactory_t* usf1_fact_fp;
 	vkk_uniformSetFactory_t* usf1_fact_bp;
+	vkk_uniformSetFactory_t* usf0_groupNorm;
+	vkk_uniformSetFactory_t* usf1_groupNorm_fp;
+	vkk_uniformSetFactory_t* usf1_groupNorm_bp;
 	vkk_uniformSetFactory_t* usf0_lanczos;
 	vkk_uniformSetFactory_t* usf1_lanczos_fp;
 	vkk_uniformSetFactory_t* usf1_lanczos_bp;
@@ -68,45 +145,87 @@ typedef struct nn_engine_s
 	vkk_uniformSetFactory_t* usf1_tensor_stats;
 	vkk_uniformSetFactory_t* usf1_tensor_norm;
 	vkk_uniformSetFactory_t* usf0_tensor_op;
+	vkk_uniformSetFactory_t* usf0_tensor_gemm;
+	vkk_uniformSetFactory_t* usf2_tensor_q8;
 
 	vkk_pipelineLayout_t* pl_batchNorm_fp;
 	vkk_pipelineLayout_t* pl_batchNorm_bp;
 	vkk_pipelineLayout_t* pl_conv_fp;
 	vkk_pipelineLayout_t* pl_conv_bp;
+	vkk_pipelineLayout_t* pl_conv_col;
+	vkk_pipelineLayout_t* pl_conv_wg_fp;
+	vkk_pipelineLayout_t* pl_conv_wg_bp;
+	vkk_pipelineLayout_t* pl_conv_split;
+	vkk_pipelineLayout_t* pl_conv_q8;
 	vkk_pipelineLayout_t* pl_fact_fp;
 	vkk_pipelineLayout_t* pl_fact_bp;
+	vkk_pipelineLayout_t* pl_groupNorm_fp;
+	vkk_pipelineLayout_t* pl_groupNorm_bp;
 	vkk_pipelineLayout_t* pl_lanczos_fp;
 	vkk_pipelineLayout_t* pl_lanczos_bp;
 	vkk_pipelineLayout_t* pl_skip_fp;
 	vkk_pipelineLayout_t* pl_skip_bp;
 	vkk_pipelineLayout_t* pl_weight_fp;
 	vkk_pipelineLayout_t* pl_weight_bp;
+	vkk_pipelineLayout_t* pl_weight_q8;
 	vkk_pipelineLayout_t* pl_loss;
 	vkk_pipelineLayout_t* pl_tensor_stats;
 	vkk_pipelineLayout_t* pl_tensor_norm;
 	vkk_pipelineLayout_t* pl_tensor_op;
+	vkk_pipelineLayout_t* pl_tensor_gemm;
 
-	vkk_computePipeline_t* cp_batchNorm_forwardPassXmeanTrain;
-	vkk_computePipeline_t* cp_batchNorm_forwardPassXvarTrain;
-	vkk_computePipeline_t* cp_batchNorm_forwardPassXmeanCompute;
-	vkk_computePipeline_t* cp_batchNorm_forwardPassXvarCompute;
+	// compute pipelines (see nn_engine_getPipeline)
+	vkk_computePipeline_t* cp_batchNorm_forwardPassXstatsTrain;
+	vkk_computePipeline_t* cp_batchNorm_forwardPassXstatsCompute;
 	vkk_computePipeline_t* cp_batchNorm_forwardPassXhat;
-	vkk_computePipeline_t* cp_batchNorm_forwardPassY;
 	vkk_computePipeline_t* cp_batchNorm_backprop_dL_dX;
 	vkk_computePipeline_t* cp_batchNorm_backprop_dL_dXhat;
 	vkk_computePipeline_t* cp_batchNorm_backpropSum;
 	vkk_computePipeline_t* cp_batchNorm_backpropSumNOP;
+	vkk_computePipeline_t* cp_batchNorm_forwardPassXhatF16;
+	vkk_computePipeline_t* cp_batchNorm_backprop_dL_dXF16;
+	vkk_computePipeline_t* cp_batchNorm_backprop_dL_dXhatF16;
+	vkk_computePipeline_t* cp_batchNorm_backpropSumF16;
+	vkk_computePipeline_t* cp_batchNorm_backpropSumNOPF16;
 	vkk_computePipeline_t* cp_conv_forwardPassClamp;
 	vkk_computePipeline_t* cp_conv_forwardPassPad;
+	vkk_computePipeline_t* cp_conv_forwardPassTileClamp;
+	vkk_computePipeline_t* cp_conv_forwardPassTilePad;
 	vkk_computePipeline_t* cp_conv_forwardPassTClamp;
 	vkk_computePipeline_t* cp_conv_forwardPassTPad;
+	vkk_computePipeline_t* cp_conv_forwardPassQ8Clamp;
+	vkk_computePipeline_t* cp_conv_forwardPassQ8Pad;
+	vkk_computePipeline_t* cp_conv_forwardPassQ8X;
 	vkk_computePipeline_t* cp_conv_backprop_dL_dX;
 	vkk_computePipeline_t* cp_conv_backprop_dL_dW;
+	vkk_computePipeline_t* cp_conv_backprop_dL_dWAdam;
 	vkk_computePipeline_t* cp_conv_backprop_dL_dB;
+	vkk_computePipeline_t* cp_conv_backprop_dL_dBAdam;
 	vkk_computePipeline_t* cp_conv_backpropT_dL_dX;
 	vkk_computePipeline_t* cp_conv_backpropT_dL_dW;
+	vkk_computePipeline_t* cp_conv_backpropT_dL_dWAdam;
 	vkk_computePipeline_t* cp_conv_backpropUpdateW;
 	vkk_computePipeline_t* cp_conv_backpropUpdateB;
+	vkk_computePipeline_t* cp_conv_backpropSplit_dL_dW;
+	vkk_computePipeline_t* cp_conv_backpropTSplit_dL_dW;
+	vkk_computePipeline_t* cp_conv_backpropSplit_dL_dB;
+	vkk_computePipeline_t* cp_conv_backpropReduce_dL_dW;
+	vkk_computePipeline_t* cp_conv_backpropReduce_dL_dWAdam;
+	vkk_computePipeline_t* cp_conv_backpropReduce_dL_dB;
+	vkk_computePipeline_t* cp_conv_backpropReduce_dL_dBAdam;
+	vkk_computePipeline_t* cp_conv_im2colClamp;
+	vkk_computePipeline_t* cp_conv_im2colPad;
+	vkk_computePipeline_t* cp_conv_im2colTClamp;
+	vkk_computePipeline_t* cp_conv_im2colTPad;
+	vkk_computePipeline_t* cp_conv_col2im;
+	vkk_computePipeline_t* cp_conv_col2imT;
+	vkk_computePipeline_t* cp_conv_winogradW;
+	vkk_computePipeline_t* cp_conv_winogradWT;
+	vkk_computePipeline_t* cp_conv_winogradXClamp;
+	vkk_computePipeline_t* cp_conv_winogradXPad;
+	vkk_computePipeline_t* cp_conv_winogradY;
+	vkk_computePipeline_t* cp_conv_winograd_dL_dY;
+	vkk_computePipeline_t* cp_conv_winograd_dL_dX;
 	vkk_computePipeline_t* cp_fact_forwardPassLinear;
 	vkk_computePipeline_t* cp_fact_forwardPassLogistic;
 	vkk_computePipeline_t* cp_fact_forwardPassReLU;
@@ -121,6 +240,12 @@ typedef struct nn_engine_s
 	vkk_computePipeline_t* cp_fact_backpropLReLU;
 	vkk_computePipeline_t* cp_fact_backpropTanh;
 	vkk_computePipeline_t* cp_fact_backpropSink;
+	vkk_computePipeline_t* cp_groupNorm_forwardPassXstats;
+	vkk_computePipeline_t* cp_groupNorm_forwardPassXhat;
+	vkk_computePipeline_t* cp_groupNorm_backpropSum;
+	vkk_computePipeline_t* cp_groupNorm_backpropSumGB;
+	vkk_computePipeline_t* cp_groupNorm_backprop_dL_dX;
+	vkk_computePipeline_t* cp_groupNorm_backpropUpdate;
 	vkk_computePipeline_t* cp_lanczos_forwardPassT;
 	vkk_computePipeline_t* cp_lanczos_forwardPassY;
 	vkk_computePipeline_t* cp_lanczos_backprop_dL_dT;
@@ -131,11 +256,15 @@ typedef struct nn_engine_s
 	vkk_computePipeline_t* cp_skip_backpropCat;
 	vkk_computePipeline_t* cp_skip_backpropFork;
 	vkk_computePipeline_t* cp_weight_forwardPass;
+	vkk_computePipeline_t* cp_weight_forwardPassQ8;
+	vkk_computePipeline_t* cp_weight_forwardPassQ8X;
 	vkk_computePipeline_t* cp_weight_backpropUpdateW;
 	vkk_computePipeline_t* cp_weight_backpropUpdateB;
 	vkk_computePipeline_t* cp_weight_backprop_dL_dX;
 	vkk_computePipeline_t* cp_weight_backprop_dL_dW;
+	vkk_computePipeline_t* cp_weight_backprop_dL_dWAdam;
 	vkk_computePipeline_t* cp_weight_backprop_dL_dB;
+	vkk_computePipeline_t* cp_weight_backprop_dL_dBAdam;
 	vkk_computePipeline_t* cp_loss_dL_dY_mse;
 	vkk_computePipeline_t* cp_loss_dL_dY_mae;
 	vkk_computePipeline_t* cp_loss_dL_dY_bce;
@@ -152,27 +281,77 @@ typedef struct nn_engine_s
 	vkk_computePipeline_t* cp_tensor_computeMulOp;
 	vkk_computePipeline_t* cp_tensor_computeScaleOp;
 	vkk_computePipeline_t* cp_tensor_computeScaleAddOp;
+	vkk_computePipeline_t* cp_tensor_gemm;
 
 	nn_tensor_t* Null;
 
-	cc_map_t*  map_bn_us2;
 	cc_map_t*  map_lanczos_us2;
-	cc_list_t* list_tensorOp_us0[2];
+	cc_map_t*  map_dim;
+
+	// tensor op cache
+	// uniform sets are keyed by the X1/X2/Y buffers and idx
+	// so entries are never updated and may be referenced by
+	// captured command streams until the buffers are deleted
+	cc_map_t* map_tensorOp_us0;
+	uint32_t  tensorOp_hit;
+	uint32_t  tensorOp_miss;
+
+	// uniform set references
+	// the most recent refs of each uniform set are retained
+	// so the memory planner may replace aliased buffers
+	// (entries are replaced when the address is reused)
+	cc_map_t* map_us;
+	int       map_us_error;
+
 } nn_engine_t;
 
+// engine may be NULL to select the multithreaded CPU
+// backend which implements the compute pipelines on the
+// host and shares the layer/arch API with the GPU backend
 nn_engine_t*      nn_engine_new(vkk_engine_t* engine);
 void              nn_engine_delete(nn_engine_t** _self);
-vkk_uniformSet_t* nn_engine_getBatchNormUs2(nn_engine_t* self,
-                                            uint32_t k);
 vkk_uniformSet_t* nn_engine_getLanczos3Us2(nn_engine_t* self,
                                            uint32_t n);
+vkk_buffer_t*     nn_engine_getDim(nn_engine_t* self,
+                                   nn_dim_t* dim);
+void              nn_engine_putDim(nn_engine_t* self,
+                                   nn_dim_t* dim,
+                                   vkk_buffer_t** _sb_dim);
 vkk_uniformSet_t* nn_engine_getTensorOpUs0(nn_engine_t* self,
                                            nn_tensor_t* X1,
                                            nn_tensor_t* X2,
                                            nn_tensor_t* Y,
                                            nn_tensorOpUs0Idx_t* idx);
+// flushTensorOpUs0 deletes the cached tensor op uniform
+// sets which reference sb (e.g. when sb is deleted)
+void              nn_engine_flushTensorOpUs0(nn_engine_t* self,
+                                             vkk_buffer_t* sb);
+void              nn_engine_submitPolicy(nn_engine_t* self,
+                                         nn_engineSubmit_e submit,
+                                         uint32_t hint,
+                                         double budget);
+uint32_t          nn_engine_splitCount(nn_engine_t* self);
+
+// profiler
+// rate selects one of every rate passes to profile and zero
+// disables the profiler. vkk does not expose timestamp
+// queries so profiled passes submit each bound pipeline
+// separately and measure the elapsed time on the host.
+// The unsampled passes are not affected.
+int               nn_engine_profile(nn_engine_t* self,
+                                    uint32_t rate);
+void              nn_engine_profileLayer(nn_engine_t* self,
+                                         int layer);
+void              nn_engine_profileReport(nn_engine_t* self,
+                                          const char* pass);
 int               nn_engine_computeBegin(nn_engine_t* self);
 void              nn_engine_computeEnd(nn_engine_t* self);
+int               nn_engine_computeActive(nn_engine_t* self);
+void              nn_engine_computeAccess(nn_engine_t* self,
+                                          uint32_t read_count,
+                                          vkk_buffer_t** read,
+                                          uint32_t write_count,
+                                          vkk_buffer_t** write);
 void              nn_engine_computeDispatch(nn_engine_t* self,
                                             vkk_hazard_e hazard,
                                             uint32_t count_x,
@@ -183,5 +362,68 @@ void              nn_engine_computeDispatch(nn_engine_t* self,
                                             uint32_t local_size_z);
 int               nn_engine_computeBind(nn_engine_t* self,
                                         vkk_computePipeline_t* cp);
+void              nn_engine_computeBindUniformSets(nn_engine_t* self,
+                                                   uint32_t us_count,
+                                                   vkk_uniformSet_t** us_array);
+void              nn_engine_computeUpdateUniformSetRefs(nn_engine_t* self,
+                                                        vkk_uniformSet_t* us,
+                                                        uint32_t ua_count,
+                                                        vkk_uniformAttachment_t* ua_array);
+void              nn_engine_computeFillStorage(nn_engine_t* self,
+                                               vkk_hazard_e hazard,
+                                               vkk_buffer_t* buffer,
+                                               size_t offset,
+                                               size_t size,
+                                               uint32_t data);
+void              nn_engine_computeCopyStorage(nn_engine_t* self,
+                                               vkk_hazard_e hazard,
+                                               vkk_buffer_t* src,
+                                               vkk_buffer_t* dst,
+                                               size_t src_offset,
+                                               size_t dst_offset,
+                                               size_t size);
+
+// hazard tracking
+// computeAccess optionally declares the GPU written buffers
+// that are read or written by the next dispatch. The
+// requested barrier of a declared dispatch is elided when it
+// has no RAW, WAW or WAR dependency on the dispatches issued
+// since the last barrier. Undeclared dispatches, fill and
+// copy always keep their barrier and invalidate the tracking.
+
+// compute pipelines are created on first use
+// e.g. nn_engine_getPipeline(engine, &engine->cp_xxx)
+vkk_computePipeline_t* nn_engine_getPipeline(nn_engine_t* self,
+                                             vkk_computePipeline_t** _cp);
+
+// capture records the commands issued between captureBegin
+// and captureEnd so they may be replayed within a later
+// compute pass (e.g. see nn_arch_step)
+void              nn_engine_captureBegin(nn_engine_t* self,
+                                         cc_list_t* cmds);
+int               nn_engine_captureEnd(nn_engine_t* self);
+int               nn_engine_captureReplay(nn_engine_t* self,
+                                          cc_list_t* cmds);
+void              nn_engine_captureDiscard(nn_engine_t* self,
+                                           cc_list_t* cmds);
+
+// liveness
+// captureLiveness computes the first/last epoch in which
+// each buffer is referenced by a captured command where the
+// epoch is incremented by each command which requests a
+// barrier. Unreferenced buffers return first > last.
+// A buffer may alias another buffer whose last epoch is
+// less than its first epoch. captureAlias replaces the refs
+// to src with dst for the uniform sets bound by cmds.
+int               nn_engine_captureLiveness(nn_engine_t* self,
+                                            cc_list_t* cmds,
+                                            uint32_t count,
+                                            vkk_buffer_t** buffers,
+                                            uint32_t* first,
+                                            uint32_t* last);
+int               nn_engine_captureAlias(nn_engine_t* self,
+                                         cc_list_t* cmds,
+                                         vkk_buffer_t* src,
+                                         vkk_buffer_t* dst);
 
 #endif
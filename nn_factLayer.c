@@ -29,6 +29,7 @@
 #include "../libcc/cc_log.h"
 #include "../libcc/cc_memory.h"
 #include "nn_arch.h"
+#include "nn_cpu.h"
 #include "nn_engine.h"
 #include "nn_factLayer.h"
 #include "nn_layer.h"
@@ -60,15 +61,15 @@ nn_factLayer_computeFpFn(nn_layer_t* base,
 
 	nn_dim_t* dimX = nn_tensor_dim(X);
 
-	vkk_computePipeline_t* cp[NN_FACT_LAYER_FN_COUNT] =
+	vkk_computePipeline_t** cp[NN_FACT_LAYER_FN_COUNT] =
 	{
-		engine->cp_fact_forwardPassLinear,
-		engine->cp_fact_forwardPassLogistic,
-		engine->cp_fact_forwardPassReLU,
-		engine->cp_fact_forwardPassPReLU,
-		engine->cp_fact_forwardPassLReLU,
-		engine->cp_fact_forwardPassTanh,
-		engine->cp_fact_forwardPassSink,
+		&engine->cp_fact_forwardPassLinear,
+		&engine->cp_fact_forwardPassLogistic,
+		&engine->cp_fact_forwardPassReLU,
+		&engine->cp_fact_forwardPassPReLU,
+		&engine->cp_fact_forwardPassLReLU,
+		&engine->cp_fact_forwardPassTanh,
+		&engine->cp_fact_forwardPassSink,
 	};
 
 	// sb100: bs
@@ -92,9 +93,9 @@ nn_factLayer_computeFpFn(nn_layer_t* base,
 			.buffer  = X->sb_data,
 		},
 	};
-	vkk_compute_updateUniformSetRefs(engine->compute,
-	                                 self->us1_fp, 3,
-	                                 ua1_array);
+	nn_engine_computeUpdateUniformSetRefs(engine,
+	                                      self->us1_fp, 3,
+	                                      ua1_array);
 
 	vkk_uniformSet_t* us_array[] =
 	{
@@ -104,11 +105,13 @@ nn_factLayer_computeFpFn(nn_layer_t* base,
 
 	// nn_factLayer_forwardPass
 	// dispatch(RAW, bs, xh, xw, 1, 8, 8)
-	if(nn_engine_computeBind(engine, cp[self->fn]) == 0)
+	vkk_computePipeline_t* cp_fn;
+	cp_fn = nn_engine_getPipeline(engine, cp[self->fn]);
+	if(nn_engine_computeBind(engine, cp_fn) == 0)
 	{
 		return NULL;
 	}
-	vkk_compute_bindUniformSets(engine->compute, 2, us_array);
+	nn_engine_computeBindUniformSets(engine, 2, us_array);
 	nn_engine_computeDispatch(engine, VKK_HAZARD_RAW,
 	                          bs, dimX->height, dimX->width,
 	                          1, 8, 8);
@@ -133,15 +136,15 @@ nn_factLayer_computeBpFn(nn_layer_t* base,
 
 	nn_dim_t* dimX = nn_tensor_dim(self->X);
 
-	vkk_computePipeline_t* cp[NN_FACT_LAYER_FN_COUNT] =
+	vkk_computePipeline_t** cp[NN_FACT_LAYER_FN_COUNT] =
 	{
-		engine->cp_fact_backpropLinear,
-		engine->cp_fact_backpropLogistic,
-		engine->cp_fact_backpropReLU,
-		engine->cp_fact_backpropPReLU,
-		engine->cp_fact_backpropLReLU,
-		engine->cp_fact_backpropTanh,
-		engine->cp_fact_backpropSink,
+		&engine->cp_fact_backpropLinear,
+		&engine->cp_fact_backpropLogistic,
+		&engine->cp_fact_backpropReLU,
+		&engine->cp_fact_backpropPReLU,
+		&engine->cp_fact_backpropLReLU,
+		&engine->cp_fact_backpropTanh,
+		&engine->cp_fact_backpropSink,
 	};
 
 	// sb100: bs
@@ -171,9 +174,9 @@ nn_factLayer_computeBpFn(nn_layer_t* base,
 			.buffer  = dL_dY->sb_data
 		},
 	};
-	vkk_compute_updateUniformSetRefs(engine->compute,
-	                                 self->us1_bp, 4,
-	                                 ua1_array);
+	nn_engine_computeUpdateUniformSetRefs(engine,
+	                                      self->us1_bp, 4,
+	                                      ua1_array);
 
 	vkk_uniformSet_t* us_array[] =
 	{
@@ -183,11 +186,13 @@ nn_factLayer_computeBpFn(nn_layer_t* base,
 
 	// nn_factLayer_backprop
 	// dispatch(RAW, bs, xh, xw, 1, 8, 8)
-	if(nn_engine_computeBind(engine, cp[self->fn]) == 0)
+	vkk_computePipeline_t* cp_fn;
+	cp_fn = nn_engine_getPipeline(engine, cp[self->fn]);
+	if(nn_engine_computeBind(engine, cp_fn) == 0)
 	{
 		return NULL;
 	}
-	vkk_compute_bindUniformSets(engine->compute, 2, us_array);
+	nn_engine_computeBindUniformSets(engine, 2, us_array);
 	nn_engine_computeDispatch(engine, VKK_HAZARD_RAW,
 	                          bs, dimX->height, dimX->width,
 	                          1, 8, 8);
@@ -196,6 +201,110 @@ nn_factLayer_computeBpFn(nn_layer_t* base,
 	return dL_dY;
 }
 
+typedef struct
+{
+	nn_factLayer_t* self;
+	nn_tensor_t*    X;
+	nn_tensor_t*    dL_dY;
+} nn_factLayerTask_t;
+
+static void
+nn_factLayer_fpCpuTask(void* priv, uint32_t idx)
+{
+	ASSERT(priv);
+
+	nn_factLayerTask_t* task = (nn_factLayerTask_t*) priv;
+	nn_factLayer_t*     self = task->self;
+
+	nn_dim_t* dimX = nn_tensor_dim(task->X);
+	uint32_t  n    = dimX->width*dimX->depth;
+	float*    X    = &task->X->data[idx*n];
+	float*    Y    = &self->Y->data[idx*n];
+
+	// dispatch(bs*xh)
+	uint32_t i;
+	for(i = 0; i < n; ++i)
+	{
+		Y[i] = nn_factLayer_fact(self->fn, X[i]);
+	}
+}
+
+static void
+nn_factLayer_bpCpuTask(void* priv, uint32_t idx)
+{
+	ASSERT(priv);
+
+	nn_factLayerTask_t* task = (nn_factLayerTask_t*) priv;
+	nn_factLayer_t*     self = task->self;
+
+	nn_dim_t* dimX  = nn_tensor_dim(task->X);
+	uint32_t  n     = dimX->width*dimX->depth;
+	float*    X     = &task->X->data[idx*n];
+	float*    dL_dY = &task->dL_dY->data[idx*n];
+
+	// dispatch(bs*xh)
+	// dL_dY replaced by dL_dX
+	uint32_t i;
+	for(i = 0; i < n; ++i)
+	{
+		dL_dY[i] *= nn_factLayer_dfact(self->fn, X[i]);
+	}
+}
+
+static nn_tensor_t*
+nn_factLayer_computeFpCpuFn(nn_layer_t* base,
+                            int flags, uint32_t bs,
+                            nn_tensor_t* X)
+{
+	ASSERT(base);
+	ASSERT(X);
+
+	nn_factLayer_t* self   = (nn_factLayer_t*) base;
+	nn_arch_t*      arch   = base->arch;
+	nn_engine_t*    engine = arch->engine;
+
+	nn_dim_t* dimX = nn_tensor_dim(X);
+
+	nn_factLayerTask_t task =
+	{
+		.self = self,
+		.X    = X,
+	};
+	nn_cpu_run(engine->cpu, nn_factLayer_fpCpuTask,
+	           &task, bs*dimX->height);
+
+	// reference for backprop
+	self->X = X;
+
+	return self->Y;
+}
+
+static nn_tensor_t*
+nn_factLayer_computeBpCpuFn(nn_layer_t* base,
+                            int flags, uint32_t bs,
+                            nn_tensor_t* dL_dY)
+{
+	ASSERT(base);
+	ASSERT(dL_dY); // dim(bs,xh,xw,xd)
+
+	nn_factLayer_t* self   = (nn_factLayer_t*) base;
+	nn_arch_t*      arch   = base->arch;
+	nn_engine_t*    engine = arch->engine;
+
+	nn_dim_t* dimX = nn_tensor_dim(self->X);
+
+	nn_factLayerTask_t task =
+	{
+		.self  = self,
+		.X     = self->X,
+		.dL_dY = dL_dY,
+	};
+	nn_cpu_run(engine->cpu, nn_factLayer_bpCpuTask,
+	           &task, bs*dimX->height);
+
+	return dL_dY;
+}
+
 static nn_dim_t*
 nn_factLayer_dimXFn(nn_layer_t* base)
 {
@@ -293,6 +402,12 @@ nn_factLayer_new(nn_arch_t* arch, nn_dim_t* dimX,
 		.dimY_fn       = nn_factLayer_dimYFn,
 	};
 
+	if(engine->cpu)
+	{
+		info.compute_fp_fn = nn_factLayer_computeFpCpuFn;
+		info.compute_bp_fn = nn_factLayer_computeBpCpuFn;
+	}
+
 	nn_factLayer_t* self;
 	self = (nn_factLayer_t*)
 	       nn_layer_new(sizeof(nn_factLayer_t), &info);
@@ -311,6 +426,12 @@ nn_factLayer_new(nn_arch_t* arch, nn_dim_t* dimX,
 		goto fail_Y;
 	}
 
+	// the CPU backend does not require uniform sets
+	if(engine->cpu)
+	{
+		return self;
+	}
+
 	self->us0 = vkk_uniformSet_new(engine->engine, 0, 0, NULL,
 	                               engine->usf0_fact);
 	if(self->us0 == NULL)
@@ -350,9 +471,9 @@ nn_factLayer_new(nn_arch_t* arch, nn_dim_t* dimX,
 		},
 	};
 
-	vkk_compute_updateUniformSetRefs(engine->compute,
-	                                 self->us0, 2,
-	                                 ua0_array);
+	nn_engine_computeUpdateUniformSetRefs(engine,
+	                                      self->us0, 2,
+	                                      ua0_array);
 
 	// success
 	return self;
@@ -465,3 +586,109 @@ int nn_factLayer_export(nn_factLayer_t* self,
 
 	return ret;
 }
+
+float nn_factLayer_fact(nn_factLayerFn_e fn, float x)
+{
+	if(fn == NN_FACT_LAYER_FN_LOGISTIC)
+	{
+		return 1.0f/(1.0f + expf(-x));
+	}
+	else if(fn == NN_FACT_LAYER_FN_RELU)
+	{
+		return (x < 0.0f) ? 0.0f : x;
+	}
+	else if(fn == NN_FACT_LAYER_FN_PRELU)
+	{
+		return (x < 0.0f) ? 0.01f*x : x;
+	}
+	else if(fn == NN_FACT_LAYER_FN_LRELU)
+	{
+		return (x < 0.0f) ? 0.2f*x : x;
+	}
+	else if(fn == NN_FACT_LAYER_FN_TANH)
+	{
+		return tanhf(x);
+	}
+	else if(fn == NN_FACT_LAYER_FN_SINK)
+	{
+		if(x < -4.0f)
+		{
+			return 0.01f*(x + 4.0f);
+		}
+		else if(x > 4.0f)
+		{
+			return 0.01f*(x - 4.0f) + 1.0f;
+		}
+		return 0.125f*x + 0.5f;
+	}
+
+	// linear
+	return x;
+}
+
+float nn_factLayer_dfact(nn_factLayerFn_e fn, float x)
+{
+	float fx;
+	if(fn == NN_FACT_LAYER_FN_LOGISTIC)
+	{
+		fx = 1.0f/(1.0f + expf(-x));
+		return fx*(1.0f - fx);
+	}
+	else if(fn == NN_FACT_LAYER_FN_RELU)
+	{
+		return (x < 0.0f) ? 0.0f : 1.0f;
+	}
+	else if(fn == NN_FACT_LAYER_FN_PRELU)
+	{
+		return (x < 0.0f) ? 0.01f : 1.0f;
+	}
+	else if(fn == NN_FACT_LAYER_FN_LRELU)
+	{
+		return (x < 0.0f) ? 0.2f : 1.0f;
+	}
+	else if(fn == NN_FACT_LAYER_FN_TANH)
+	{
+		fx = tanhf(x);
+		return 1.0f - fx*fx;
+	}
+	else if(fn == NN_FACT_LAYER_FN_SINK)
+	{
+		return ((x < -4.0f) || (x > 4.0f)) ? 0.01f : 0.125f;
+	}
+
+	// linear
+	return 1.0f;
+}
+
+float nn_factLayer_dfactY(nn_factLayerFn_e fn, float y)
+{
+	// each function is monotonic so the derivative may be
+	// recovered from the output
+	if(fn == NN_FACT_LAYER_FN_LOGISTIC)
+	{
+		return y*(1.0f - y);
+	}
+	else if(fn == NN_FACT_LAYER_FN_RELU)
+	{
+		return (y > 0.0f) ? 1.0f : 0.0f;
+	}
+	else if(fn == NN_FACT_LAYER_FN_PRELU)
+	{
+		return (y < 0.0f) ? 0.01f : 1.0f;
+	}
+	else if(fn == NN_FACT_LAYER_FN_LRELU)
+	{
+		return (y < 0.0f) ? 0.2f : 1.0f;
+	}
+	else if(fn == NN_FACT_LAYER_FN_TANH)
+	{
+		return 1.0f - y*y;
+	}
+	else if(fn == NN_FACT_LAYER_FN_SINK)
+	{
+		return ((y < 0.0f) || (y > 1.0f)) ? 0.01f : 0.125f;
+	}
+
+	// linear
+	return 1.0f;
+}
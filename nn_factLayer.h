@@ -74,4 +74,15 @@ nn_factLayer_t* nn_factLayer_import(nn_arch_t* arch,
 int             nn_factLayer_export(nn_factLayer_t* self,
                                     cc_jsmnStream_t* stream);
 
+// activation function and derivative
+// dfactY computes the derivative from the output y=fact(x)
+// which allows the activation to be fused with a preceding
+// conv/weight layer (see nn_convLayer_fuseFact)
+float           nn_factLayer_fact(nn_factLayerFn_e fn,
+                                  float x);
+float           nn_factLayer_dfact(nn_factLayerFn_e fn,
+                                   float x);
+float           nn_factLayer_dfactY(nn_factLayerFn_e fn,
+                                    float y);
+
 #endif
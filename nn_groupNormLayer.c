@@ -0,0 +1,1081 @@
+/*
+ * Copyright (c) 2023 Jeff Boody
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define LOG_TAG "nn"
+#include "../libcc/cc_log.h"
+#include "../libcc/cc_memory.h"
+#include "nn_arch.h"
+#include "nn_cpu.h"
+#include "nn_engine.h"
+#include "nn_groupNormLayer.h"
+#include "nn_layer.h"
+#include "nn_tensor.h"
+
+// the variance of a single sample may be near zero
+// (e.g. instance normalization of a flat region) so the
+// epsilon is larger than the batch norm epsilon
+#define NN_GROUP_NORM_LAYER_EPSILON 1e-05f
+
+/***********************************************************
+* private                                                  *
+***********************************************************/
+
+static nn_tensor_t*
+nn_groupNormLayer_computeFpFn(nn_layer_t* base,
+                              int flags, uint32_t bs,
+                              nn_tensor_t* X)
+{
+	ASSERT(base);
+	ASSERT(X);
+
+	nn_groupNormLayer_t* self   = (nn_groupNormLayer_t*) base;
+	nn_arch_t*           arch   = base->arch;
+	nn_engine_t*         engine = arch->engine;
+
+	nn_dim_t* dimX = nn_tensor_dim(self->Xhat);
+	uint32_t  xh   = dimX->height;
+	uint32_t  xw   = dimX->width;
+
+	// sb100: bs
+	// sb101: state
+	// sb102: X
+	vkk_uniformAttachment_t ua1_array[] =
+	{
+		{
+			.binding = 0,
+			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
+			.buffer  = arch->sb100_bs,
+		},
+		{
+			.binding = 1,
+			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
+			.buffer  = arch->sb101_state,
+		},
+		{
+			.binding = 2,
+			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
+			.buffer  = X->sb_data,
+		},
+	};
+	nn_engine_computeUpdateUniformSetRefs(engine,
+	                                      self->us1_fp, 3,
+	                                      ua1_array);
+
+	vkk_uniformSet_t* us_array[] =
+	{
+		self->us0,
+		self->us1_fp,
+	};
+
+	// nn_groupNormLayer_forwardPassXstats
+	// each workgroup reduces one group of one sample
+	// dispatch(RAW, 64, bs, groups, 64, 1, 1)
+	vkk_computePipeline_t* cp;
+	cp = nn_engine_getPipeline(engine,
+	                           &engine->cp_groupNorm_forwardPassXstats);
+	if(nn_engine_computeBind(engine, cp) == 0)
+	{
+		return NULL;
+	}
+	nn_engine_computeBindUniformSets(engine, 2, us_array);
+	nn_engine_computeDispatch(engine, VKK_HAZARD_RAW,
+	                          64, bs, self->groups, 64, 1, 1);
+
+	// nn_groupNormLayer_forwardPassXhat (includes Y)
+	// dispatch(RAW, bs, xh, xw, 1, 8, 8)
+	cp = nn_engine_getPipeline(engine,
+	                           &engine->cp_groupNorm_forwardPassXhat);
+	if(nn_engine_computeBind(engine, cp) == 0)
+	{
+		return NULL;
+	}
+	nn_engine_computeBindUniformSets(engine, 2, us_array);
+	nn_engine_computeDispatch(engine, VKK_HAZARD_RAW,
+	                          bs, xh, xw, 1, 8, 8);
+
+	return self->Y;
+}
+
+static nn_tensor_t*
+nn_groupNormLayer_computeBpFn(nn_layer_t* base,
+                              int flags, uint32_t bs,
+                              nn_tensor_t* dL_dY)
+{
+	ASSERT(base);
+	ASSERT(dL_dY); // dim(bs,xh,xw,xd)
+
+	nn_groupNormLayer_t* self   = (nn_groupNormLayer_t*) base;
+	nn_arch_t*           arch   = base->arch;
+	nn_engine_t*         engine = arch->engine;
+
+	nn_dim_t* dimX = nn_tensor_dim(self->Xhat);
+	uint32_t  xh   = dimX->height;
+	uint32_t  xw   = dimX->width;
+	uint32_t  xd   = dimX->depth;
+
+	// sb100: bs
+	// sb101: state
+	// sb102: dL_dY
+	vkk_uniformAttachment_t ua1_array[] =
+	{
+		{
+			.binding = 0,
+			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
+			.buffer  = arch->sb100_bs,
+		},
+		{
+			.binding = 1,
+			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
+			.buffer  = arch->sb101_state,
+		},
+		{
+			.binding = 2,
+			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
+			.buffer  = dL_dY->sb_data,
+		},
+	};
+	nn_engine_computeUpdateUniformSetRefs(engine,
+	                                      self->us1_bp, 3,
+	                                      ua1_array);
+
+	vkk_uniformSet_t* us_array[] =
+	{
+		self->us0,
+		self->us1_bp,
+	};
+
+	// nn_groupNormLayer_backpropSum
+	// dispatch(RAW, 64, bs, groups, 64, 1, 1)
+	vkk_computePipeline_t* cp;
+	cp = nn_engine_getPipeline(engine,
+	                           &engine->cp_groupNorm_backpropSum);
+	if(nn_engine_computeBind(engine, cp) == 0)
+	{
+		return NULL;
+	}
+	nn_engine_computeBindUniformSets(engine, 2, us_array);
+	nn_engine_computeDispatch(engine, VKK_HAZARD_RAW,
+	                          64, bs, self->groups, 64, 1, 1);
+
+	// optionally skip parameter update
+	// nn_groupNormLayer_backpropSumGB
+	// dispatch(RAW, 64, xd, 1, 64, 1, 1)
+	int update = ((flags & NN_ARCH_FLAG_BP_NOP) == 0);
+	if(update)
+	{
+		cp = nn_engine_getPipeline(engine,
+		                           &engine->cp_groupNorm_backpropSumGB);
+		if(nn_engine_computeBind(engine, cp) == 0)
+		{
+			return NULL;
+		}
+		nn_engine_computeBindUniformSets(engine, 2, us_array);
+		nn_engine_computeDispatch(engine, VKK_HAZARD_RAW,
+		                          64, xd, 1, 64, 1, 1);
+	}
+
+	// nn_groupNormLayer_backprop_dL_dX
+	// dispatch(RAW, bs, xh, xw, 1, 8, 8)
+	cp = nn_engine_getPipeline(engine,
+	                           &engine->cp_groupNorm_backprop_dL_dX);
+	if(nn_engine_computeBind(engine, cp) == 0)
+	{
+		return NULL;
+	}
+	nn_engine_computeBindUniformSets(engine, 2, us_array);
+	nn_engine_computeDispatch(engine, VKK_HAZARD_RAW,
+	                          bs, xh, xw, 1, 8, 8);
+
+	// nn_groupNormLayer_backpropUpdate
+	// dispatch(RAW, xd, 1, 1, 64, 1, 1)
+	if(update)
+	{
+		cp = nn_engine_getPipeline(engine,
+		                           &engine->cp_groupNorm_backpropUpdate);
+		if(nn_engine_computeBind(engine, cp) == 0)
+		{
+			return NULL;
+		}
+		nn_engine_computeBindUniformSets(engine, 2, us_array);
+		nn_engine_computeDispatch(engine, VKK_HAZARD_RAW,
+		                          xd, 1, 1, 64, 1, 1);
+	}
+
+	// dL_dY replaced by dL_dX
+	return dL_dY;
+}
+
+typedef struct
+{
+	nn_groupNormLayer_t* self;
+	nn_tensor_t*         X;
+	nn_tensor_t*         dL_dY;
+	uint32_t             bs;
+} nn_groupNormLayerTask_t;
+
+static void
+nn_groupNormLayer_fpStatsCpuTask(void* priv, uint32_t idx)
+{
+	ASSERT(priv);
+
+	nn_groupNormLayerTask_t* task = (nn_groupNormLayerTask_t*) priv;
+	nn_groupNormLayer_t*     self = task->self;
+
+	nn_dim_t* dimX = nn_tensor_dim(self->Xhat);
+	uint32_t  hw   = dimX->height*dimX->width;
+	uint32_t  xd   = dimX->depth;
+	uint32_t  cg   = xd/self->groups;
+
+	// dispatch(bs*groups)
+	uint32_t m = idx/self->groups;
+	uint32_t g = idx - m*self->groups;
+	float*   X = &task->X->data[m*hw*xd + g*cg];
+
+	// Welford's single pass mean and variance
+	uint32_t p;
+	uint32_t c;
+	float    x;
+	float    dx;
+	float    count = 0.0f;
+	float    xmean = 0.0f;
+	float    m2    = 0.0f;
+	for(p = 0; p < hw; ++p)
+	{
+		for(c = 0; c < cg; ++c)
+		{
+			x      = X[p*xd + c];
+			count += 1.0f;
+			dx     = x - xmean;
+			xmean += dx/count;
+			m2    += dx*(x - xmean);
+		}
+	}
+
+	self->Xmean->data[idx] = xmean;
+	self->Xvar->data[idx]  = m2/count;
+}
+
+static void
+nn_groupNormLayer_fpCpuTask(void* priv, uint32_t idx)
+{
+	ASSERT(priv);
+
+	nn_groupNormLayerTask_t* task = (nn_groupNormLayerTask_t*) priv;
+	nn_groupNormLayer_t*     self = task->self;
+
+	nn_dim_t* dimX  = nn_tensor_dim(self->Xhat);
+	uint32_t  xw    = dimX->width;
+	uint32_t  xd    = dimX->depth;
+	uint32_t  cg    = xd/self->groups;
+	uint32_t  n     = xw*xd;
+	float*    X     = &task->X->data[idx*n];
+	float*    Xhat  = &self->Xhat->data[idx*n];
+	float*    Y     = &self->Y->data[idx*n];
+	float*    G     = self->G->data;
+	float*    B     = self->B->data;
+
+	// dispatch(bs*xh)
+	uint32_t m     = idx/dimX->height;
+	float*   Xmean = &self->Xmean->data[m*self->groups];
+	float*   Xvar  = &self->Xvar->data[m*self->groups];
+
+	uint32_t j;
+	uint32_t k;
+	uint32_t g;
+	uint32_t i;
+	float    epsilon = NN_GROUP_NORM_LAYER_EPSILON;
+	for(j = 0; j < xw; ++j)
+	{
+		for(k = 0; k < xd; ++k)
+		{
+			i       = j*xd + k;
+			g       = k/cg;
+			Xhat[i] = (X[i] - Xmean[g])/sqrtf(Xvar[g] + epsilon);
+			Y[i]    = G[k]*Xhat[i] + B[k];
+		}
+	}
+}
+
+static void
+nn_groupNormLayer_bpSumCpuTask(void* priv, uint32_t idx)
+{
+	ASSERT(priv);
+
+	nn_groupNormLayerTask_t* task = (nn_groupNormLayerTask_t*) priv;
+	nn_groupNormLayer_t*     self = task->self;
+
+	nn_dim_t* dimX = nn_tensor_dim(self->Xhat);
+	uint32_t  hw   = dimX->height*dimX->width;
+	uint32_t  xd   = dimX->depth;
+	uint32_t  cg   = xd/self->groups;
+
+	// dispatch(bs*groups)
+	uint32_t m     = idx/self->groups;
+	uint32_t g     = idx - m*self->groups;
+	float*   dL_dY = &task->dL_dY->data[m*hw*xd + g*cg];
+	float*   Xhat  = &self->Xhat->data[m*hw*xd + g*cg];
+	float*   G     = &self->G->data[g*cg];
+
+	// dL_dXhat = dL_dY*G
+	uint32_t p;
+	uint32_t c;
+	float    dl_dxhat;
+	float    bsum = 0.0f;
+	float    csum = 0.0f;
+	for(p = 0; p < hw; ++p)
+	{
+		for(c = 0; c < cg; ++c)
+		{
+			dl_dxhat = dL_dY[p*xd + c]*G[c];
+			bsum    += dl_dxhat;
+			csum    += dl_dxhat*Xhat[p*xd + c];
+		}
+	}
+	self->Bsum->data[idx] = bsum;
+	self->Csum->data[idx] = csum;
+}
+
+static void
+nn_groupNormLayer_bpSumGBCpuTask(void* priv, uint32_t idx)
+{
+	ASSERT(priv);
+
+	nn_groupNormLayerTask_t* task = (nn_groupNormLayerTask_t*) priv;
+	nn_groupNormLayer_t*     self = task->self;
+
+	nn_dim_t* dimX  = nn_tensor_dim(self->Xhat);
+	uint32_t  n     = task->bs*dimX->height*dimX->width;
+	uint32_t  xd    = dimX->depth;
+	float*    dL_dY = task->dL_dY->data;
+	float*    Xhat  = self->Xhat->data;
+
+	// dispatch(xd)
+	uint32_t k = idx;
+
+	uint32_t i;
+	float    dl_dg = 0.0f;
+	float    dl_db = 0.0f;
+	for(i = 0; i < n; ++i)
+	{
+		dl_dg += dL_dY[i*xd + k]*Xhat[i*xd + k];
+		dl_db += dL_dY[i*xd + k];
+	}
+	self->dL_dG->data[k] = dl_dg;
+	self->dL_dB->data[k] = dl_db;
+}
+
+static void
+nn_groupNormLayer_bp_dL_dXCpuTask(void* priv, uint32_t idx)
+{
+	ASSERT(priv);
+
+	nn_groupNormLayerTask_t* task = (nn_groupNormLayerTask_t*) priv;
+	nn_groupNormLayer_t*     self = task->self;
+
+	nn_dim_t* dimX  = nn_tensor_dim(self->Xhat);
+	uint32_t  xw    = dimX->width;
+	uint32_t  xd    = dimX->depth;
+	uint32_t  cg    = xd/self->groups;
+	uint32_t  n     = xw*xd;
+	float*    dL_dX = &task->dL_dY->data[idx*n];
+	float*    Xhat  = &self->Xhat->data[idx*n];
+	float*    G     = self->G->data;
+	float     M     = (float) (dimX->height*xw*cg);
+
+	// dispatch(bs*xh)
+	uint32_t m    = idx/dimX->height;
+	float*   Xvar = &self->Xvar->data[m*self->groups];
+	float*   Bsum = &self->Bsum->data[m*self->groups];
+	float*   Csum = &self->Csum->data[m*self->groups];
+
+	uint32_t j;
+	uint32_t k;
+	uint32_t g;
+	uint32_t i;
+	float    epsilon = NN_GROUP_NORM_LAYER_EPSILON;
+	for(j = 0; j < xw; ++j)
+	{
+		for(k = 0; k < xd; ++k)
+		{
+			i        = j*xd + k;
+			g        = k/cg;
+			dL_dX[i] = (M*dL_dX[i]*G[k] - Bsum[g] - Xhat[i]*Csum[g])/
+			           (M*sqrtf(Xvar[g] + epsilon));
+		}
+	}
+}
+
+static nn_tensor_t*
+nn_groupNormLayer_computeFpCpuFn(nn_layer_t* base,
+                                 int flags, uint32_t bs,
+                                 nn_tensor_t* X)
+{
+	ASSERT(base);
+	ASSERT(X);
+
+	nn_groupNormLayer_t* self   = (nn_groupNormLayer_t*) base;
+	nn_arch_t*           arch   = base->arch;
+	nn_engine_t*         engine = arch->engine;
+
+	nn_dim_t* dimX = nn_tensor_dim(self->Xhat);
+
+	nn_groupNormLayerTask_t task =
+	{
+		.self = self,
+		.X    = X,
+		.bs   = bs,
+	};
+
+	nn_cpu_run(engine->cpu, nn_groupNormLayer_fpStatsCpuTask,
+	           &task, bs*self->groups);
+	nn_cpu_run(engine->cpu, nn_groupNormLayer_fpCpuTask,
+	           &task, bs*dimX->height);
+
+	return self->Y;
+}
+
+static nn_tensor_t*
+nn_groupNormLayer_computeBpCpuFn(nn_layer_t* base,
+                                 int flags, uint32_t bs,
+                                 nn_tensor_t* dL_dY)
+{
+	ASSERT(base);
+	ASSERT(dL_dY); // dim(bs,xh,xw,xd)
+
+	nn_groupNormLayer_t* self   = (nn_groupNormLayer_t*) base;
+	nn_arch_t*           arch   = base->arch;
+	nn_engine_t*         engine = arch->engine;
+
+	nn_dim_t* dimX = nn_tensor_dim(self->Xhat);
+	uint32_t  xd   = dimX->depth;
+
+	nn_groupNormLayerTask_t task =
+	{
+		.self  = self,
+		.dL_dY = dL_dY,
+		.bs    = bs,
+	};
+
+	nn_cpu_run(engine->cpu, nn_groupNormLayer_bpSumCpuTask,
+	           &task, bs*self->groups);
+
+	// optionally skip parameter update
+	int update = ((flags & NN_ARCH_FLAG_BP_NOP) == 0);
+	if(update)
+	{
+		nn_cpu_run(engine->cpu, nn_groupNormLayer_bpSumGBCpuTask,
+		           &task, xd);
+	}
+
+	nn_cpu_run(engine->cpu, nn_groupNormLayer_bp_dL_dXCpuTask,
+	           &task, bs*dimX->height);
+
+	if(update)
+	{
+		nn_archState_t* state = &arch->state;
+		nn_cpu_adam(state, self->G->data,
+		            self->MG->data, self->VG->data,
+		            self->dL_dG->data, xd);
+		nn_cpu_adam(state, self->B->data,
+		            self->MB->data, self->VB->data,
+		            self->dL_dB->data, xd);
+	}
+
+	// dL_dY replaced by dL_dX
+	return dL_dY;
+}
+
+static nn_dim_t*
+nn_groupNormLayer_dimXFn(nn_layer_t* base)
+{
+	ASSERT(base);
+
+	nn_groupNormLayer_t* self = (nn_groupNormLayer_t*) base;
+
+	return nn_tensor_dim(self->Xhat);
+}
+
+static nn_dim_t*
+nn_groupNormLayer_dimYFn(nn_layer_t* base)
+{
+	ASSERT(base);
+
+	nn_groupNormLayer_t* self = (nn_groupNormLayer_t*) base;
+
+	return nn_tensor_dim(self->Y);
+}
+
+/***********************************************************
+* public                                                   *
+***********************************************************/
+
+nn_groupNormLayer_t*
+nn_groupNormLayer_new(nn_arch_t* arch, nn_dim_t* dimX,
+                      uint32_t groups)
+{
+	ASSERT(arch);
+	ASSERT(dimX);
+
+	nn_engine_t* engine = arch->engine;
+
+	uint32_t xd = dimX->depth;
+	if((groups == 0) || (xd%groups))
+	{
+		LOGE("invalid xd=%u, groups=%u", xd, groups);
+		return NULL;
+	}
+
+	nn_dim_t dim_111d =
+	{
+		.count  = 1,
+		.height = 1,
+		.width  = 1,
+		.depth  = xd,
+	};
+
+	nn_dim_t dim_b11g =
+	{
+		.count  = dimX->count,
+		.height = 1,
+		.width  = 1,
+		.depth  = groups,
+	};
+
+	nn_layerInfo_t info =
+	{
+		.arch          = arch,
+		.compute_fp_fn = nn_groupNormLayer_computeFpFn,
+		.compute_bp_fn = nn_groupNormLayer_computeBpFn,
+		.dimX_fn       = nn_groupNormLayer_dimXFn,
+		.dimY_fn       = nn_groupNormLayer_dimYFn,
+	};
+
+	if(engine->cpu)
+	{
+		info.compute_fp_fn = nn_groupNormLayer_computeFpCpuFn;
+		info.compute_bp_fn = nn_groupNormLayer_computeBpCpuFn;
+	}
+
+	nn_groupNormLayer_t* self;
+	self = (nn_groupNormLayer_t*)
+	       nn_layer_new(sizeof(nn_groupNormLayer_t), &info);
+	if(self == NULL)
+	{
+		return NULL;
+	}
+
+	self->groups = groups;
+
+	self->G = nn_tensor_new(engine, &dim_111d,
+	                        NN_TENSOR_INIT_ZERO,
+	                        NN_TENSOR_MODE_COMPUTE);
+	if(self->G == NULL)
+	{
+		goto fail_G;
+	}
+
+	nn_tensor_t* tmpG;
+	tmpG = nn_tensor_new(engine, &dim_111d,
+	                     NN_TENSOR_INIT_ZERO,
+	                     NN_TENSOR_MODE_IO);
+	if(tmpG == NULL)
+	{
+		goto fail_tmpG;
+	}
+
+	// initialize G to 1.0f
+	uint32_t k;
+	for(k = 0; k < xd; ++k)
+	{
+		nn_tensor_ioSet(tmpG, 0, 0, 0, k, 1.0f);
+	}
+
+	if(nn_tensor_copy(tmpG, self->G, 0, 0, 1) == 0)
+	{
+		goto fail_copyG;
+	}
+
+	self->B = nn_tensor_new(engine, &dim_111d,
+	                        NN_TENSOR_INIT_ZERO,
+	                        NN_TENSOR_MODE_COMPUTE);
+	if(self->B == NULL)
+	{
+		goto fail_B;
+	}
+
+	self->Xhat = nn_tensor_new(engine, dimX,
+	                           NN_TENSOR_INIT_ZERO,
+	                           NN_TENSOR_MODE_COMPUTE);
+	if(self->Xhat == NULL)
+	{
+		goto fail_Xhat;
+	}
+
+	self->Y = nn_tensor_new(engine, dimX,
+	                        NN_TENSOR_INIT_ZERO,
+	                        NN_TENSOR_MODE_COMPUTE);
+	if(self->Y == NULL)
+	{
+		goto fail_Y;
+	}
+
+	// optimizer state
+	nn_tensorMode_e mode = nn_arch_trainMode(arch);
+
+	self->MG = nn_tensor_new(engine, &dim_111d,
+	                         NN_TENSOR_INIT_ZERO,
+	                         mode);
+	if(self->MG == NULL)
+	{
+		goto fail_MG;
+	}
+
+	self->VG = nn_tensor_new(engine, &dim_111d,
+	                         NN_TENSOR_INIT_ZERO,
+	                         mode);
+	if(self->VG == NULL)
+	{
+		goto fail_VG;
+	}
+
+	self->MB = nn_tensor_new(engine, &dim_111d,
+	                         NN_TENSOR_INIT_ZERO,
+	                         mode);
+	if(self->MB == NULL)
+	{
+		goto fail_MB;
+	}
+
+	self->VB = nn_tensor_new(engine, &dim_111d,
+	                         NN_TENSOR_INIT_ZERO,
+	                         mode);
+	if(self->VB == NULL)
+	{
+		goto fail_VB;
+	}
+
+	self->Xmean = nn_tensor_new(engine, &dim_b11g,
+	                            NN_TENSOR_INIT_ZERO,
+	                            NN_TENSOR_MODE_COMPUTE);
+	if(self->Xmean == NULL)
+	{
+		goto fail_Xmean;
+	}
+
+	self->Xvar = nn_tensor_new(engine, &dim_b11g,
+	                           NN_TENSOR_INIT_ZERO,
+	                           NN_TENSOR_MODE_COMPUTE);
+	if(self->Xvar == NULL)
+	{
+		goto fail_Xvar;
+	}
+
+	self->Bsum = nn_tensor_new(engine, &dim_b11g,
+	                           NN_TENSOR_INIT_ZERO,
+	                           mode);
+	if(self->Bsum == NULL)
+	{
+		goto fail_Bsum;
+	}
+
+	self->Csum = nn_tensor_new(engine, &dim_b11g,
+	                           NN_TENSOR_INIT_ZERO,
+	                           mode);
+	if(self->Csum == NULL)
+	{
+		goto fail_Csum;
+	}
+
+	self->dL_dG = nn_tensor_new(engine, &dim_111d,
+	                            NN_TENSOR_INIT_ZERO,
+	                            mode);
+	if(self->dL_dG == NULL)
+	{
+		goto fail_dL_dG;
+	}
+
+	self->dL_dB = nn_tensor_new(engine, &dim_111d,
+	                            NN_TENSOR_INIT_ZERO,
+	                            mode);
+	if(self->dL_dB == NULL)
+	{
+		goto fail_dL_dB;
+	}
+
+	// the CPU backend does not require uniform sets
+	if(engine->cpu)
+	{
+		nn_tensor_delete(&tmpG);
+		return self;
+	}
+
+	self->us0 = vkk_uniformSet_new(engine->engine, 0, 0, NULL,
+	                               engine->usf0_groupNorm);
+	if(self->us0 == NULL)
+	{
+		goto fail_us0;
+	}
+
+	self->us1_fp = vkk_uniformSet_new(engine->engine, 1, 0, NULL,
+	                                  engine->usf1_groupNorm_fp);
+	if(self->us1_fp == NULL)
+	{
+		goto fail_us1_fp;
+	}
+
+	self->us1_bp = vkk_uniformSet_new(engine->engine, 1, 0, NULL,
+	                                  engine->usf1_groupNorm_bp);
+	if(self->us1_bp == NULL)
+	{
+		goto fail_us1_bp;
+	}
+
+	// sb000: dimX (xbs,xh,xw,xd)
+	// sb001: G
+	// sb002: B
+	// sb003: Xhat
+	// sb004: Y
+	// sb005: MG
+	// sb006: VG
+	// sb007: MB
+	// sb008: VB
+	// sb009: dimS (xbs,1,1,groups)
+	// sb010: Xmean
+	// sb011: Xvar
+	// sb012: Bsum
+	// sb013: Csum
+	// sb014: dL_dG
+	// sb015: dL_dB
+	vkk_uniformAttachment_t ua0_array[] =
+	{
+		{
+			.binding = 0,
+			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
+			.buffer  = self->Xhat->sb_dim,
+		},
+		{
+			.binding = 1,
+			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
+			.buffer  = self->G->sb_data,
+		},
+		{
+			.binding = 2,
+			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
+			.buffer  = self->B->sb_data,
+		},
+		{
+			.binding = 3,
+			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
+			.buffer  = self->Xhat->sb_data,
+		},
+		{
+			.binding = 4,
+			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
+			.buffer  = self->Y->sb_data,
+		},
+		{
+			.binding = 5,
+			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
+			.buffer  = self->MG->sb_data,
+		},
+		{
+			.binding = 6,
+			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
+			.buffer  = self->VG->sb_data,
+		},
+		{
+			.binding = 7,
+			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
+			.buffer  = self->MB->sb_data,
+		},
+		{
+			.binding = 8,
+			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
+			.buffer  = self->VB->sb_data,
+		},
+		{
+			.binding = 9,
+			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
+			.buffer  = self->Xmean->sb_dim,
+		},
+		{
+			.binding = 10,
+			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
+			.buffer  = self->Xmean->sb_data,
+		},
+		{
+			.binding = 11,
+			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
+			.buffer  = self->Xvar->sb_data,
+		},
+		{
+			.binding = 12,
+			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
+			.buffer  = self->Bsum->sb_data,
+		},
+		{
+			.binding = 13,
+			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
+			.buffer  = self->Csum->sb_data,
+		},
+		{
+			.binding = 14,
+			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
+			.buffer  = self->dL_dG->sb_data,
+		},
+		{
+			.binding = 15,
+			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
+			.buffer  = self->dL_dB->sb_data,
+		},
+	};
+	nn_engine_computeUpdateUniformSetRefs(engine,
+	                                      self->us0, 16,
+	                                      ua0_array);
+
+	nn_tensor_delete(&tmpG);
+
+	// success
+	return self;
+
+	// failure
+	fail_us1_bp:
+		vkk_uniformSet_delete(&self->us1_fp);
+	fail_us1_fp:
+		vkk_uniformSet_delete(&self->us0);
+	fail_us0:
+		nn_tensor_delete(&self->dL_dB);
+	fail_dL_dB:
+		nn_tensor_delete(&self->dL_dG);
+	fail_dL_dG:
+		nn_tensor_delete(&self->Csum);
+	fail_Csum:
+		nn_tensor_delete(&self->Bsum);
+	fail_Bsum:
+		nn_tensor_delete(&self->Xvar);
+	fail_Xvar:
+		nn_tensor_delete(&self->Xmean);
+	fail_Xmean:
+		nn_tensor_delete(&self->VB);
+	fail_VB:
+		nn_tensor_delete(&self->MB);
+	fail_MB:
+		nn_tensor_delete(&self->VG);
+	fail_VG:
+		nn_tensor_delete(&self->MG);
+	fail_MG:
+		nn_tensor_delete(&self->Y);
+	fail_Y:
+		nn_tensor_delete(&self->Xhat);
+	fail_Xhat:
+		nn_tensor_delete(&self->B);
+	fail_B:
+	fail_copyG:
+		nn_tensor_delete(&tmpG);
+	fail_tmpG:
+		nn_tensor_delete(&self->G);
+	fail_G:
+		nn_layer_delete((nn_layer_t**) &self);
+	return NULL;
+}
+
+void nn_groupNormLayer_delete(nn_groupNormLayer_t** _self)
+{
+	ASSERT(_self);
+
+	nn_groupNormLayer_t* self = *_self;
+	if(self)
+	{
+		vkk_uniformSet_delete(&self->us1_bp);
+		vkk_uniformSet_delete(&self->us1_fp);
+		vkk_uniformSet_delete(&self->us0);
+		nn_tensor_delete(&self->dL_dB);
+		nn_tensor_delete(&self->dL_dG);
+		nn_tensor_delete(&self->Csum);
+		nn_tensor_delete(&self->Bsum);
+		nn_tensor_delete(&self->Xvar);
+		nn_tensor_delete(&self->Xmean);
+		nn_tensor_delete(&self->VB);
+		nn_tensor_delete(&self->MB);
+		nn_tensor_delete(&self->VG);
+		nn_tensor_delete(&self->MG);
+		nn_tensor_delete(&self->Y);
+		nn_tensor_delete(&self->Xhat);
+		nn_tensor_delete(&self->B);
+		nn_tensor_delete(&self->G);
+		nn_layer_delete((nn_layer_t**) &self);
+	}
+}
+
+nn_groupNormLayer_t*
+nn_groupNormLayer_import(nn_arch_t* arch, cc_jsmnVal_t* val)
+{
+	ASSERT(arch);
+	ASSERT(val);
+
+	if(val->type != CC_JSMN_TYPE_OBJECT)
+	{
+		LOGE("invalid");
+		return NULL;
+	}
+
+	cc_jsmnVal_t* val_groups = NULL;
+	cc_jsmnVal_t* val_dimX   = NULL;
+	cc_jsmnVal_t* val_G      = NULL;
+	cc_jsmnVal_t* val_B      = NULL;
+	cc_jsmnVal_t* val_MG     = NULL;
+	cc_jsmnVal_t* val_VG     = NULL;
+	cc_jsmnVal_t* val_MB     = NULL;
+	cc_jsmnVal_t* val_VB     = NULL;
+
+	cc_listIter_t* iter = cc_list_head(val->obj->list);
+	while(iter)
+	{
+		cc_jsmnKeyval_t* kv;
+		kv = (cc_jsmnKeyval_t*) cc_list_peekIter(iter);
+
+		if(kv->val->type == CC_JSMN_TYPE_PRIMITIVE)
+		{
+			if(strcmp(kv->key, "groups") == 0)
+			{
+				val_groups = kv->val;
+			}
+		}
+		else if(kv->val->type == CC_JSMN_TYPE_OBJECT)
+		{
+			if(strcmp(kv->key, "dimX") == 0)
+			{
+				val_dimX = kv->val;
+			}
+			else if(strcmp(kv->key, "G") == 0)
+			{
+				val_G = kv->val;
+			}
+			else if(strcmp(kv->key, "B") == 0)
+			{
+				val_B = kv->val;
+			}
+			else if(strcmp(kv->key, "MG") == 0)
+			{
+				val_MG = kv->val;
+			}
+			else if(strcmp(kv->key, "VG") == 0)
+			{
+				val_VG = kv->val;
+			}
+			else if(strcmp(kv->key, "MB") == 0)
+			{
+				val_MB = kv->val;
+			}
+			else if(strcmp(kv->key, "VB") == 0)
+			{
+				val_VB = kv->val;
+			}
+		}
+
+		iter = cc_list_next(iter);
+	}
+
+	// check for required parameters
+	if((val_groups == NULL) ||
+	   (val_dimX   == NULL) ||
+	   (val_G      == NULL) ||
+	   (val_B      == NULL) ||
+	   (val_MG     == NULL) ||
+	   (val_VG     == NULL) ||
+	   (val_MB     == NULL) ||
+	   (val_VB     == NULL))
+	{
+		LOGE("invalid");
+		return NULL;
+	}
+
+	uint32_t groups = strtol(val_groups->data, NULL, 0);
+
+	nn_dim_t dimX;
+	if(nn_dim_import(&dimX, val_dimX) == 0)
+	{
+		return NULL;
+	}
+
+	nn_groupNormLayer_t* self;
+	self = nn_groupNormLayer_new(arch, &dimX, groups);
+	if(self == NULL)
+	{
+		return NULL;
+	}
+
+	if((nn_tensor_import(self->G,  val_G)  == 0) ||
+	   (nn_tensor_import(self->B,  val_B)  == 0) ||
+	   (nn_tensor_import(self->MG, val_MG) == 0) ||
+	   (nn_tensor_import(self->VG, val_VG) == 0) ||
+	   (nn_tensor_import(self->MB, val_MB) == 0) ||
+	   (nn_tensor_import(self->VB, val_VB) == 0))
+	{
+		goto fail_tensor;
+	}
+
+	// success
+	return self;
+
+	// failure
+	fail_tensor:
+		nn_groupNormLayer_delete(&self);
+	return NULL;
+}
+
+int nn_groupNormLayer_export(nn_groupNormLayer_t* self,
+                             cc_jsmnStream_t* stream)
+{
+	ASSERT(self);
+	ASSERT(stream);
+
+	nn_dim_t* dimX = nn_tensor_dim(self->Xhat);
+
+	int ret = 1;
+	ret &= cc_jsmnStream_beginObject(stream);
+	ret &= cc_jsmnStream_key(stream, "%s", "groups");
+	ret &= cc_jsmnStream_int(stream, (int) self->groups);
+	ret &= cc_jsmnStream_key(stream, "%s", "dimX");
+	ret &= nn_dim_export(dimX, stream);
+	ret &= cc_jsmnStream_key(stream, "%s", "G");
+	ret &= nn_tensor_export(self->G, stream);
+	ret &= cc_jsmnStream_key(stream, "%s", "B");
+	ret &= nn_tensor_export(self->B, stream);
+	ret &= cc_jsmnStream_key(stream, "%s", "MG");
+	ret &= nn_tensor_export(self->MG, stream);
+	ret &= cc_jsmnStream_key(stream, "%s", "VG");
+	ret &= nn_tensor_export(self->VG, stream);
+	ret &= cc_jsmnStream_key(stream, "%s", "MB");
+	ret &= nn_tensor_export(self->MB, stream);
+	ret &= cc_jsmnStream_key(stream, "%s", "VB");
+	ret &= nn_tensor_export(self->VB, stream);
+	ret &= cc_jsmnStream_end(stream);
+
+	return ret;
+}
@@ -0,0 +1,86 @@
+/*
+ * Copyright (c) 2023 Jeff Boody
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+
+#ifndef nn_groupNormLayer_H
+#define nn_groupNormLayer_H
+
+#include "../libcc/jsmn/cc_jsmnStream.h"
+#include "../libcc/jsmn/cc_jsmnWrapper.h"
+#include "../libvkk/vkk.h"
+#include "nn_layer.h"
+
+// group normalization computes the mean/variance of each
+// sample over groups of xd/groups channels such that the
+// layer does not depend on the batch size
+// groups = 1:  layer normalization
+// groups = xd: instance normalization
+typedef struct nn_groupNormLayer_s
+{
+	nn_layer_t base;
+
+	uint32_t groups;
+
+	// gamma, beta, xhat, output
+	nn_tensor_t* G;    // dim(1,1,1,xd)
+	nn_tensor_t* B;    // dim(1,1,1,xd)
+	nn_tensor_t* Xhat; // dim(bs,xh,xw,xd)
+	nn_tensor_t* Y;    // dim(bs,xh,xw,xd)
+
+	// Adam moment estimates
+	nn_tensor_t* MG; // dim(1,1,1,xd)
+	nn_tensor_t* VG; // dim(1,1,1,xd)
+	nn_tensor_t* MB; // dim(1,1,1,xd)
+	nn_tensor_t* VB; // dim(1,1,1,xd)
+
+	// per-sample mean/variance
+	nn_tensor_t* Xmean; // dim(bs,1,1,groups)
+	nn_tensor_t* Xvar;  // dim(bs,1,1,groups)
+
+	// working sums
+	nn_tensor_t* Bsum; // dim(bs,1,1,groups)
+	nn_tensor_t* Csum; // dim(bs,1,1,groups)
+
+	// backprop gradients (dL_dY replaced by dL_dX)
+	// dL_dG and dL_dB are reduced before dL_dX since the
+	// update of G must follow dL_dX
+	//           dL_dY; // dim(bs,xh,xw,xd)
+	//           dL_dX; // dim(bs,xh,xw,xd)
+	nn_tensor_t* dL_dG; // dim(1,1,1,xd)
+	nn_tensor_t* dL_dB; // dim(1,1,1,xd)
+
+	vkk_uniformSet_t* us0;
+	vkk_uniformSet_t* us1_fp;
+	vkk_uniformSet_t* us1_bp;
+} nn_groupNormLayer_t;
+
+nn_groupNormLayer_t* nn_groupNormLayer_new(nn_arch_t* arch,
+                                           nn_dim_t* dimX,
+                                           uint32_t groups);
+void                 nn_groupNormLayer_delete(nn_groupNormLayer_t** _self);
+nn_groupNormLayer_t* nn_groupNormLayer_import(nn_arch_t* arch,
+                                              cc_jsmnVal_t* val);
+int                  nn_groupNormLayer_export(nn_groupNormLayer_t* self,
+                                              cc_jsmnStream_t* stream);
+
+#endif
@@ -31,6 +31,7 @@
 #include "../libcc/cc_memory.h"
 #include "../libvkk/vkk.h"
 #include "nn_arch.h"
+#include "nn_cpu.h"
 #include "nn_lanczosResampler.h"
 #include "nn_lanczosLayer.h"
 #include "nn_engine.h"
@@ -78,9 +79,9 @@ nn_lanczosLayer_computeFpFn(nn_layer_t* base,
 		},
 	};
 
-	vkk_compute_updateUniformSetRefs(engine->compute,
-	                                 self->us1_fp, 3,
-	                                 ua1_array);
+	nn_engine_computeUpdateUniformSetRefs(engine,
+	                                      self->us1_fp, 3,
+	                                      ua1_array);
 
 	vkk_uniformSet_t* us_array[] =
 	{
@@ -91,19 +92,21 @@ nn_lanczosLayer_computeFpFn(nn_layer_t* base,
 	// nn_lanczosLayer_forwardPassT
 	// dispatch(RAW, bs, xh, yw, 1, 8, 8)
 	vkk_computePipeline_t* cp;
-	cp = engine->cp_lanczos_forwardPassT;
+	cp = nn_engine_getPipeline(engine,
+	                           &engine->cp_lanczos_forwardPassT);
 	if(nn_engine_computeBind(engine, cp) == 0)
 	{
 		return NULL;
 	}
-	vkk_compute_bindUniformSets(engine->compute, 2, us_array);
+	nn_engine_computeBindUniformSets(engine, 2, us_array);
 	nn_engine_computeDispatch(engine, VKK_HAZARD_RAW,
 	                          bs, dimX->height, dimY->width,
 	                          1, 8, 8);
 
 	// nn_lanczosLayer_forwardPassY
 	// dispatch(RAW, bs, yh, yw, 1, 8, 8)
-	cp = engine->cp_lanczos_forwardPassY;
+	cp = nn_engine_getPipeline(engine,
+	                           &engine->cp_lanczos_forwardPassY);
 	if(nn_engine_computeBind(engine, cp) == 0)
 	{
 		return NULL;
@@ -168,9 +171,9 @@ nn_lanczosLayer_computeBpFn(nn_layer_t* base,
 		},
 	};
 
-	vkk_compute_updateUniformSetRefs(engine->compute,
-	                                 self->us1_bp, 3,
-	                                 ua1_array);
+	nn_engine_computeUpdateUniformSetRefs(engine,
+	                                      self->us1_bp, 3,
+	                                      ua1_array);
 
 	vkk_uniformSet_t* us_array[] =
 	{
@@ -184,7 +187,8 @@ nn_lanczosLayer_computeBpFn(nn_layer_t* base,
 	// dispatch(RAW, bs, yh, yw, 1, 8, 8)
 	uint n;
 	vkk_computePipeline_t* cp;
-	cp = engine->cp_lanczos_backprop_dL_dT;
+	cp = nn_engine_getPipeline(engine,
+	                           &engine->cp_lanczos_backprop_dL_dT);
 	if(nn_engine_computeBind(engine, cp) == 0)
 	{
 		return NULL;
@@ -196,8 +200,8 @@ nn_lanczosLayer_computeBpFn(nn_layer_t* base,
 		{
 			return NULL;
 		}
-		vkk_compute_bindUniformSets(engine->compute, 3,
-		                            us_array);
+		nn_engine_computeBindUniformSets(engine, 3,
+		                                 us_array);
 		nn_engine_computeDispatch(engine, VKK_HAZARD_RAW,
 		                          bs, dimY->height, dimY->width,
 		                          1, 8, 8);
@@ -206,7 +210,8 @@ nn_lanczosLayer_computeBpFn(nn_layer_t* base,
 	// nn_lanczosLayer_backprop_dL_dX
 	// dispatch required for each n
 	// dispatch(RAW, bs, xh, yw, 1, 8, 8)
-	cp = engine->cp_lanczos_backprop_dL_dX;
+	cp = nn_engine_getPipeline(engine,
+	                           &engine->cp_lanczos_backprop_dL_dX);
 	if(nn_engine_computeBind(engine, cp) == 0)
 	{
 		return NULL;
@@ -218,8 +223,8 @@ nn_lanczosLayer_computeBpFn(nn_layer_t* base,
 		{
 			return NULL;
 		}
-		vkk_compute_bindUniformSets(engine->compute, 3,
-		                            us_array);
+		nn_engine_computeBindUniformSets(engine, 3,
+		                                 us_array);
 		nn_engine_computeDispatch(engine, VKK_HAZARD_RAW,
 		                          bs, dimX->height, dimY->width,
 		                          1, 8, 8);
@@ -228,6 +233,265 @@ nn_lanczosLayer_computeBpFn(nn_layer_t* base,
 	return self->dL_dX;
 }
 
+typedef struct
+{
+	nn_lanczosLayer_t* self;
+	nn_tensor_t*       X;
+	nn_tensor_t*       dL_dY;
+	uint32_t           bs;
+} nn_lanczosLayerTask_t;
+
+static void
+nn_lanczosLayer_fpTCpuTask(void* priv, uint32_t idx)
+{
+	ASSERT(priv);
+
+	nn_lanczosLayerTask_t* task  = (nn_lanczosLayerTask_t*) priv;
+	nn_lanczosLayer_t*     self  = task->self;
+	nn_lanczosParam_t*     param = &self->param;
+
+	nn_dim_t* dimX = nn_tensor_dim(task->X);
+	nn_dim_t* dimY = nn_tensor_dim(self->Y);
+	int       xw   = (int) dimX->width;
+	uint32_t  xd   = dimX->depth;
+	int       yw   = (int) dimY->width;
+	int       fs   = param->fsw;
+	int       a    = param->a;
+	float*    X    = &task->X->data[idx*xw*xd];
+	float*    T    = &self->T->data[idx*yw*xd];
+	float*    Lw;
+
+	// dispatch(bs*xh)
+	int      j;
+	int      jj;
+	int      lj;
+	uint32_t k;
+	float    x;
+	float    step = ((float) xw)/((float) yw);
+	for(j = 0; j < yw; ++j)
+	{
+		Lw = &self->Lw->data[(j%param->fcw)*param->szw];
+		x  = (((float) j) + 0.5f)*step - 0.5f;
+		for(k = 0; k < xd; ++k)
+		{
+			T[j*xd + k] = 0.0f;
+		}
+
+		for(lj = -(fs*a) + 1; lj <= (fs*a); ++lj)
+		{
+			jj = ((int) floorf(x)) + lj;
+			if(jj < 0)
+			{
+				jj = 0;
+			}
+			else if(jj >= xw)
+			{
+				jj = xw - 1;
+			}
+
+			nn_cpu_axpy(Lw[lj + fs*a - 1], &X[jj*xd],
+			            &T[j*xd], xd);
+		}
+	}
+}
+
+static void
+nn_lanczosLayer_fpYCpuTask(void* priv, uint32_t idx)
+{
+	ASSERT(priv);
+
+	nn_lanczosLayerTask_t* task  = (nn_lanczosLayerTask_t*) priv;
+	nn_lanczosLayer_t*     self  = task->self;
+	nn_lanczosParam_t*     param = &self->param;
+
+	nn_dim_t* dimX = nn_tensor_dim(self->dL_dX);
+	nn_dim_t* dimY = nn_tensor_dim(self->Y);
+	int       xh   = (int) dimX->height;
+	uint32_t  xd   = dimX->depth;
+	int       yh   = (int) dimY->height;
+	uint32_t  n    = dimY->width*xd;
+	int       fs   = param->fsh;
+	int       a    = param->a;
+
+	// dispatch(bs*yh)
+	uint32_t m  = idx/yh;
+	int      i  = (int) (idx%yh);
+	float*   Y  = &self->Y->data[idx*n];
+	float*   T  = &self->T->data[m*xh*n];
+	float*   Lh = &self->Lh->data[(i%param->fch)*param->szh];
+
+	int   ii;
+	int   li;
+	float step = ((float) xh)/((float) yh);
+	float y    = (((float) i) + 0.5f)*step - 0.5f;
+	memset(Y, 0, n*sizeof(float));
+	for(li = -(fs*a) + 1; li <= (fs*a); ++li)
+	{
+		ii = ((int) floorf(y)) + li;
+		if(ii < 0)
+		{
+			ii = 0;
+		}
+		else if(ii >= xh)
+		{
+			ii = xh - 1;
+		}
+
+		nn_cpu_axpy(Lh[li + fs*a - 1], &T[ii*n], Y, n);
+	}
+}
+
+static void
+nn_lanczosLayer_bp_dL_dTCpuTask(void* priv, uint32_t idx)
+{
+	ASSERT(priv);
+
+	nn_lanczosLayerTask_t* task  = (nn_lanczosLayerTask_t*) priv;
+	nn_lanczosLayer_t*     self  = task->self;
+	nn_lanczosParam_t*     param = &self->param;
+
+	nn_dim_t* dimX = nn_tensor_dim(self->dL_dX);
+	nn_dim_t* dimY = nn_tensor_dim(self->Y);
+	int       xh   = (int) dimX->height;
+	int       yh   = (int) dimY->height;
+	uint32_t  n    = dimY->width*dimX->depth;
+	int       fs   = param->fsh;
+	int       a    = param->a;
+
+	// dispatch(bs)
+	// dL_dT rows are only shared within a batch
+	uint32_t m     = idx;
+	float*   dL_dY = &task->dL_dY->data[m*yh*n];
+	float*   dL_dT = &self->dL_dT->data[m*xh*n];
+	memset(dL_dT, 0, xh*n*sizeof(float));
+
+	int   i;
+	int   ii;
+	int   li;
+	float y;
+	float dy_dt;
+	float step = ((float) xh)/((float) yh);
+	for(li = -(fs*a) + 1; li <= (fs*a); ++li)
+	{
+		for(i = 0; i < yh; ++i)
+		{
+			y  = (((float) i) + 0.5f)*step - 0.5f;
+			ii = ((int) floorf(y)) + li;
+			if((ii < 0) || (ii >= xh))
+			{
+				continue;
+			}
+
+			dy_dt = self->Lh->data[(i%param->fch)*param->szh +
+			                       li + fs*a - 1];
+			nn_cpu_axpy(dy_dt, &dL_dY[i*n], &dL_dT[ii*n], n);
+		}
+	}
+}
+
+static void
+nn_lanczosLayer_bp_dL_dXCpuTask(void* priv, uint32_t idx)
+{
+	ASSERT(priv);
+
+	nn_lanczosLayerTask_t* task  = (nn_lanczosLayerTask_t*) priv;
+	nn_lanczosLayer_t*     self  = task->self;
+	nn_lanczosParam_t*     param = &self->param;
+
+	nn_dim_t* dimX  = nn_tensor_dim(self->dL_dX);
+	nn_dim_t* dimY  = nn_tensor_dim(self->Y);
+	int       xw    = (int) dimX->width;
+	uint32_t  xd    = dimX->depth;
+	int       yw    = (int) dimY->width;
+	int       fs    = param->fsw;
+	int       a     = param->a;
+	float*    dL_dT = &self->dL_dT->data[idx*yw*xd];
+	float*    dL_dX = &self->dL_dX->data[idx*xw*xd];
+
+	// dispatch(bs*xh)
+	memset(dL_dX, 0, xw*xd*sizeof(float));
+
+	int   j;
+	int   jj;
+	int   lj;
+	float x;
+	float dt_dx;
+	float step = ((float) xw)/((float) yw);
+	for(lj = -(fs*a) + 1; lj <= (fs*a); ++lj)
+	{
+		for(j = 0; j < yw; ++j)
+		{
+			x  = (((float) j) + 0.5f)*step - 0.5f;
+			jj = ((int) floorf(x)) + lj;
+			if((jj < 0) || (jj >= xw))
+			{
+				continue;
+			}
+
+			dt_dx = self->Lw->data[(j%param->fcw)*param->szw +
+			                       lj + fs*a - 1];
+			nn_cpu_axpy(dt_dx, &dL_dT[j*xd], &dL_dX[jj*xd], xd);
+		}
+	}
+}
+
+static nn_tensor_t*
+nn_lanczosLayer_computeFpCpuFn(nn_layer_t* base,
+                               int flags, uint32_t bs,
+                               nn_tensor_t* X)
+{
+	ASSERT(base);
+	ASSERT(X);
+
+	nn_lanczosLayer_t* self   = (nn_lanczosLayer_t*) base;
+	nn_arch_t*         arch   = base->arch;
+	nn_engine_t*       engine = arch->engine;
+
+	nn_dim_t* dimX = nn_tensor_dim(X);
+	nn_dim_t* dimY = nn_tensor_dim(self->Y);
+
+	nn_lanczosLayerTask_t task =
+	{
+		.self = self,
+		.X    = X,
+		.bs   = bs,
+	};
+	nn_cpu_run(engine->cpu, nn_lanczosLayer_fpTCpuTask,
+	           &task, bs*dimX->height);
+	nn_cpu_run(engine->cpu, nn_lanczosLayer_fpYCpuTask,
+	           &task, bs*dimY->height);
+
+	return self->Y;
+}
+
+static nn_tensor_t*
+nn_lanczosLayer_computeBpCpuFn(nn_layer_t* base,
+                               int flags, uint32_t bs,
+                               nn_tensor_t* dL_dY)
+{
+	ASSERT(base);
+	ASSERT(dL_dY); // dim(bs,yh,yw,xd)
+
+	nn_lanczosLayer_t* self   = (nn_lanczosLayer_t*) base;
+	nn_arch_t*         arch   = base->arch;
+	nn_engine_t*       engine = arch->engine;
+
+	nn_dim_t* dimX = nn_tensor_dim(self->dL_dX);
+
+	nn_lanczosLayerTask_t task =
+	{
+		.self  = self,
+		.dL_dY = dL_dY,
+		.bs    = bs,
+	};
+	nn_cpu_run(engine->cpu, nn_lanczosLayer_bp_dL_dTCpuTask,
+	           &task, bs);
+	nn_cpu_run(engine->cpu, nn_lanczosLayer_bp_dL_dXCpuTask,
+	           &task, bs*dimX->height);
+
+	return self->dL_dX;
+}
+
 static void
 nn_lanczosLayer_postFn(nn_layer_t* base,
                        int flags, uint32_t bs)
@@ -301,9 +565,9 @@ nn_lanczosUs2Data_new(nn_engine_t* engine,
 		},
 	};
 
-	vkk_compute_updateUniformSetRefs(engine->compute,
-	                                 self->us2, 1,
-	                                 ua2_array);
+	nn_engine_computeUpdateUniformSetRefs(engine,
+	                                      self->us2, 1,
+	                                      ua2_array);
 
 	// success
 	return self;
@@ -355,6 +619,12 @@ nn_lanczosLayer_new(nn_arch_t* arch, nn_dim_t* dimX,
 		.dimY_fn       = nn_lanczosLayer_dimYFn,
 	};
 
+	if(engine->cpu)
+	{
+		info.compute_fp_fn = nn_lanczosLayer_computeFpCpuFn;
+		info.compute_bp_fn = nn_lanczosLayer_computeBpCpuFn;
+	}
+
 	nn_lanczosLayer_t* self;
 	self = (nn_lanczosLayer_t*)
 	       nn_layer_new(sizeof(nn_lanczosLayer_t), &info);
@@ -423,9 +693,12 @@ nn_lanczosLayer_new(nn_arch_t* arch, nn_dim_t* dimX,
 		goto failure;
 	}
 
+	// backprop gradients
+	nn_tensorMode_e mode = nn_arch_trainMode(arch);
+
 	self->dL_dT = nn_tensor_new(engine, &dimT,
 	                            NN_TENSOR_INIT_ZERO,
-	                            NN_TENSOR_MODE_COMPUTE);
+	                            mode);
 	if(self->dL_dT == NULL)
 	{
 		goto failure;
@@ -433,12 +706,19 @@ nn_lanczosLayer_new(nn_arch_t* arch, nn_dim_t* dimX,
 
 	self->dL_dX = nn_tensor_new(engine, dimX,
 	                            NN_TENSOR_INIT_ZERO,
-	                            NN_TENSOR_MODE_COMPUTE);
+	                            mode);
 	if(self->dL_dX == NULL)
 	{
 		goto failure;
 	}
 
+	// the CPU backend does not require uniform sets
+	if(engine->cpu)
+	{
+		nn_lanczosResampler_delete(&lanczos);
+		return self;
+	}
+
 	self->sb008_param = vkk_buffer_new(engine->engine,
 	                                   VKK_UPDATE_MODE_STATIC,
 	                                   VKK_BUFFER_USAGE_STORAGE,
@@ -528,9 +808,9 @@ nn_lanczosLayer_new(nn_arch_t* arch, nn_dim_t* dimX,
 		},
 	};
 
-	vkk_compute_updateUniformSetRefs(engine->compute,
-	                                 self->us0, 9,
-	                                 ua0_array);
+	nn_engine_computeUpdateUniformSetRefs(engine,
+	                                      self->us0, 9,
+	                                      ua0_array);
 
 	nn_lanczosResampler_delete(&lanczos);
 
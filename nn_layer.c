@@ -26,6 +26,7 @@
 #define LOG_TAG "nn"
 #include "../libcc/cc_log.h"
 #include "../libcc/cc_memory.h"
+#include "nn_arch.h"
 #include "nn_layer.h"
 #include "nn_tensor.h"
 
@@ -57,6 +58,8 @@ nn_layer_t* nn_layer_new(size_t base_size,
 	self->post_fn       = info->post_fn;
 	self->dimX_fn       = info->dimX_fn;
 	self->dimY_fn       = info->dimY_fn;
+	self->freeze_fn     = info->freeze_fn;
+	self->quantize_fn   = info->quantize_fn;
 
 	// success
 	return self;
@@ -112,7 +115,21 @@ nn_layer_computeFp(nn_layer_t* self,
 
 	nn_layerComputeFp_fn compute_fp_fn;
 	compute_fp_fn = self->compute_fp_fn;
-	return (*compute_fp_fn)(self, flags, bs, X);
+
+	nn_tensor_t* Y = (*compute_fp_fn)(self, flags, bs, X);
+
+	// record the activations for the memory planner
+	// including those of the nested layers
+	nn_arch_t* arch = self->arch;
+	if(Y && arch->plan_Y)
+	{
+		if(cc_list_append(arch->plan_Y, NULL, Y) == NULL)
+		{
+			return NULL;
+		}
+	}
+
+	return Y;
 }
 
 nn_tensor_t*
@@ -151,3 +168,31 @@ void nn_layer_post(nn_layer_t* self, int flags, uint32_t bs)
 		return (*post_fn)(self, flags, bs);
 	}
 }
+
+int nn_layer_freeze(nn_layer_t* self)
+{
+	ASSERT(self);
+
+	// optional inference optimization
+	nn_layerFreeze_fn freeze_fn = self->freeze_fn;
+	if(freeze_fn)
+	{
+		return (*freeze_fn)(self);
+	}
+
+	return 1;
+}
+
+int nn_layer_quantize(nn_layer_t* self)
+{
+	ASSERT(self);
+
+	// optional int8 inference
+	nn_layerQuantize_fn quantize_fn = self->quantize_fn;
+	if(quantize_fn)
+	{
+		return (*quantize_fn)(self);
+	}
+
+	return 1;
+}
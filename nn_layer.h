@@ -36,6 +36,8 @@ typedef void (*nn_layerPost_fn)(nn_layer_t* base,
                                 int flags, uint32_t bs);
 typedef nn_dim_t* (*nn_layerDim_fn)
                   (nn_layer_t* base);
+typedef int (*nn_layerFreeze_fn)(nn_layer_t* base);
+typedef int (*nn_layerQuantize_fn)(nn_layer_t* base);
 
 typedef struct nn_layerInfo_s
 {
@@ -45,6 +47,8 @@ typedef struct nn_layerInfo_s
 	nn_layerPost_fn      post_fn;
 	nn_layerDim_fn       dimX_fn;
 	nn_layerDim_fn       dimY_fn;
+	nn_layerFreeze_fn    freeze_fn;
+	nn_layerQuantize_fn  quantize_fn;
 } nn_layerInfo_t;
 
 typedef struct nn_layer_s
@@ -55,6 +59,8 @@ typedef struct nn_layer_s
 	nn_layerPost_fn      post_fn;
 	nn_layerDim_fn       dimX_fn;
 	nn_layerDim_fn       dimY_fn;
+	nn_layerFreeze_fn    freeze_fn;
+	nn_layerQuantize_fn  quantize_fn;
 } nn_layer_t;
 
 // flags defined by arch
@@ -73,5 +79,7 @@ nn_tensor_t* nn_layer_computeBp(nn_layer_t* self,
                                 nn_tensor_t* dL_dY);
 void         nn_layer_post(nn_layer_t* self,
                            int flags, uint32_t bs);
+int          nn_layer_freeze(nn_layer_t* self);
+int          nn_layer_quantize(nn_layer_t* self);
 
 #endif
@@ -31,6 +31,7 @@
 #include "../libcc/cc_log.h"
 #include "../libcc/cc_memory.h"
 #include "nn_arch.h"
+#include "nn_cpu.h"
 #include "nn_engine.h"
 #include "nn_layer.h"
 #include "nn_loss.h"
@@ -87,23 +88,130 @@ nn_loss_function(const char* str, nn_lossFn_e* _loss_fn)
 	return 0;
 }
 
-static void
-nn_loss_post(nn_loss_t* self, int flags, uint32_t bs)
+typedef struct
+{
+	nn_loss_t*   self;
+	nn_tensor_t* Y;
+	nn_tensor_t* Yt;
+} nn_lossTask_t;
+
+static void nn_loss_cpuTask(void* priv, uint32_t t)
+{
+	ASSERT(priv);
+
+	nn_lossTask_t* task = (nn_lossTask_t*) priv;
+	nn_loss_t*     self = task->self;
+	nn_dim_t*      dimY = nn_tensor_dim(self->dL_dY);
+
+	// task per row (m,i)
+	uint32_t size  = dimY->width*dimY->depth;
+	float*   Y     = &task->Y->data[t*size];
+	float*   Yt    = &task->Yt->data[t*size];
+	float*   dL_dY = &self->dL_dY->data[t*size];
+
+	float epsilon = 1.192092896e-07;
+
+	float    y;
+	float    yt;
+	float    dy;
+	float    sum = 0.0f;
+	uint32_t e;
+	if(self->loss_fn == NN_LOSS_FN_MSE)
+	{
+		for(e = 0; e < size; ++e)
+		{
+			dy        = Y[e] - Yt[e];
+			sum      += dy*dy;
+			dL_dY[e]  = dy;
+		}
+	}
+	else if(self->loss_fn == NN_LOSS_FN_MAE)
+	{
+		for(e = 0; e < size; ++e)
+		{
+			dy        = Y[e] - Yt[e];
+			sum      += fabsf(dy);
+			dL_dY[e]  = dy/(fabsf(dy) + epsilon);
+		}
+	}
+	else
+	{
+		for(e = 0; e < size; ++e)
+		{
+			y         = cc_clamp(Y[e], epsilon, 1.0f - epsilon);
+			yt        = Yt[e];
+			sum      += -yt*logf(y) - (1.0f - yt)*logf(1.0f - y);
+			dL_dY[e]  = -yt/y + (1.0f - yt)/(1.0f - y);
+		}
+	}
+
+	self->loss_work[t] = sum;
+}
+
+static nn_tensor_t*
+nn_loss_cpuPass(nn_loss_t* self, int flags, uint32_t bs,
+                nn_tensor_t* Y, nn_tensor_t* Yt)
 {
 	ASSERT(self);
+	ASSERT(Y);
+	ASSERT(Yt);
+
+	nn_engine_t* engine = self->engine;
+	nn_tensor_t* dL_dY  = self->dL_dY;
+	nn_dim_t*    dimY   = nn_tensor_dim(dL_dY);
+
+	if(nn_engine_computeBegin(engine) == 0)
+	{
+		return NULL;
+	}
+
+	nn_lossTask_t task =
+	{
+		.self = self,
+		.Y    = Y,
+		.Yt   = Yt,
+	};
+
+	uint32_t count = bs*dimY->height;
+	nn_cpu_run(engine->cpu, nn_loss_cpuTask, &task, count);
+
+	double   sum = 0.0;
+	uint32_t t;
+	for(t = 0; t < count; ++t)
+	{
+		sum += self->loss_work[t];
+	}
 
-	vkk_buffer_readStorage(self->sb001_loss, 0,
-	                       sizeof(float), &self->loss);
+	double M = (double) (count*dimY->width*dimY->depth);
+	if(self->loss_fn == NN_LOSS_FN_MSE)
+	{
+		self->loss = (float) (sum/(2.0*M));
+	}
+	else
+	{
+		self->loss = (float) (sum/M);
+	}
 
+	// optionally compute stats
 	if(flags & NN_LOSS_FLAG_STATS)
 	{
-		LOGI("dL_dY min=%f, max=%f, mean=%f, stddev=%f, norm=%f",
-		     nn_tensorStats_min(self->stats_dL_dY),
-		     nn_tensorStats_max(self->stats_dL_dY),
-		     nn_tensorStats_mean(self->stats_dL_dY),
-		     nn_tensorStats_stddev(self->stats_dL_dY),
-		     nn_tensorStats_norm(self->stats_dL_dY));
+		if(nn_tensor_computeStats(dL_dY, VKK_HAZARD_RAW, bs,
+		                          self->stats_dL_dY) == 0)
+		{
+			goto fail_stats;
+		}
 	}
+
+	nn_engine_computeEnd(engine);
+	nn_loss_post(self, flags, bs);
+
+	// success
+	return dL_dY;
+
+	// failure
+	fail_stats:
+		nn_engine_computeEnd(engine);
+	return NULL;
 }
 
 /***********************************************************
@@ -142,6 +250,21 @@ nn_loss_new(nn_engine_t* engine, nn_dim_t* dimY,
 		goto fail_stats_dL_dY;
 	}
 
+	// the CPU backend computes a partial loss per row
+	if(engine->cpu)
+	{
+		self->loss_work = (float*)
+		                  CALLOC(dimY->count*dimY->height,
+		                         sizeof(float));
+		if(self->loss_work == NULL)
+		{
+			LOGE("CALLOC failed");
+			goto fail_sb000_bs;
+		}
+
+		return self;
+	}
+
 	vkk_updateMode_e um;
 	um = vkk_compute_updateMode(engine->compute);
 
@@ -203,9 +326,9 @@ nn_loss_new(nn_engine_t* engine, nn_dim_t* dimY,
 		},
 	};
 
-	vkk_compute_updateUniformSetRefs(engine->compute,
-	                                 self->us0, 4,
-	                                 ua0_array);
+	nn_engine_computeUpdateUniformSetRefs(engine,
+	                                      self->us0, 4,
+	                                      ua0_array);
 
 	// success
 	return self;
@@ -237,6 +360,7 @@ void nn_loss_delete(nn_loss_t** _self)
 		vkk_uniformSet_delete(&self->us0);
 		vkk_buffer_delete(&self->sb001_loss);
 		vkk_buffer_delete(&self->sb000_bs);
+		FREE(self->loss_work);
 		nn_tensorStats_delete(&self->stats_dL_dY);
 		nn_tensor_delete(&self->dL_dY);
 		FREE(self);
@@ -346,6 +470,28 @@ float nn_loss_loss(nn_loss_t* self)
 	return self->loss;
 }
 
+void nn_loss_post(nn_loss_t* self, int flags, uint32_t bs)
+{
+	ASSERT(self);
+
+	// the CPU backend computes the loss directly
+	if(self->engine->cpu == NULL)
+	{
+		vkk_buffer_readStorage(self->sb001_loss, 0,
+		                       sizeof(float), &self->loss);
+	}
+
+	if(flags & NN_LOSS_FLAG_STATS)
+	{
+		LOGI("dL_dY min=%f, max=%f, mean=%f, stddev=%f, norm=%f",
+		     nn_tensorStats_min(self->stats_dL_dY),
+		     nn_tensorStats_max(self->stats_dL_dY),
+		     nn_tensorStats_mean(self->stats_dL_dY),
+		     nn_tensorStats_stddev(self->stats_dL_dY),
+		     nn_tensorStats_norm(self->stats_dL_dY));
+	}
+}
+
 nn_tensor_t*
 nn_loss_pass(nn_loss_t* self,
              int flags, uint32_t bs,
@@ -380,22 +526,33 @@ nn_loss_pass(nn_loss_t* self,
 		return NULL;
 	}
 
+	if(engine->cpu)
+	{
+		return nn_loss_cpuPass(self, flags, bs, Y, Yt);
+	}
+
 	vkk_computePipeline_t* cp;
 	vkk_computePipeline_t* cp_dL_dY;
 	if(self->loss_fn == NN_LOSS_FN_MSE)
 	{
-		cp       = engine->cp_loss_mse;
-		cp_dL_dY = engine->cp_loss_dL_dY_mse;
+		cp = nn_engine_getPipeline(engine,
+		                           &engine->cp_loss_mse);
+		cp_dL_dY = nn_engine_getPipeline(engine,
+		                                 &engine->cp_loss_dL_dY_mse);
 	}
 	else if(self->loss_fn == NN_LOSS_FN_MAE)
 	{
-		cp       = engine->cp_loss_mae;
-		cp_dL_dY = engine->cp_loss_dL_dY_mae;
+		cp = nn_engine_getPipeline(engine,
+		                           &engine->cp_loss_mae);
+		cp_dL_dY = nn_engine_getPipeline(engine,
+		                                 &engine->cp_loss_dL_dY_mae);
 	}
 	else if(self->loss_fn == NN_LOSS_FN_BCE)
 	{
-		cp       = engine->cp_loss_bce;
-		cp_dL_dY = engine->cp_loss_dL_dY_bce;
+		cp = nn_engine_getPipeline(engine,
+		                           &engine->cp_loss_bce);
+		cp_dL_dY = nn_engine_getPipeline(engine,
+		                                 &engine->cp_loss_dL_dY_bce);
 	}
 	else
 	{
@@ -427,9 +584,9 @@ nn_loss_pass(nn_loss_t* self,
 		},
 	};
 
-	vkk_compute_updateUniformSetRefs(engine->compute,
-	                                 self->us1, 2,
-	                                 ua1_array);
+	nn_engine_computeUpdateUniformSetRefs(engine,
+	                                      self->us1, 2,
+	                                      ua1_array);
 
 	vkk_uniformSet_t* us_array[] =
 	{
@@ -443,7 +600,7 @@ nn_loss_pass(nn_loss_t* self,
 	{
 		return NULL;
 	}
-	vkk_compute_bindUniformSets(engine->compute, 2, us_array);
+	nn_engine_computeBindUniformSets(engine, 2, us_array);
 	nn_engine_computeDispatch(engine, VKK_HAZARD_RAW,
 	                          1, 1, 1, 8, 8, 1);
 
@@ -468,6 +625,7 @@ nn_loss_pass(nn_loss_t* self,
 	}
 
 	nn_engine_computeEnd(engine);
+	nn_engine_profileReport(engine, "loss");
 	nn_loss_post(self, flags, bs);
 
 	// success
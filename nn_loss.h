@@ -55,6 +55,9 @@ typedef struct nn_loss_s
 
 	nn_tensorStats_t* stats_dL_dY;
 
+	// CPU backend
+	float* loss_work; // dim(bs*yh)
+
 	vkk_buffer_t*     sb000_bs;
 	vkk_buffer_t*     sb001_loss;
 	vkk_uniformSet_t* us0;
@@ -76,5 +79,8 @@ nn_tensor_t* nn_loss_pass(nn_loss_t* self,
                           uint32_t bs,
                           nn_tensor_t* Y,
                           nn_tensor_t* Yt);
+void         nn_loss_post(nn_loss_t* self,
+                          int flags,
+                          uint32_t bs);
 
 #endif
@@ -90,11 +90,14 @@ nn_resLayer_computeFpFn(nn_layer_t* base,
 		}
 	}
 
-	X = nn_layer_computeFp(&self->fact2->base,
-	                       flags, bs, X);
-	if(X == NULL)
+	if(self->fuse_fact2 == 0)
 	{
-		return NULL;
+		X = nn_layer_computeFp(&self->fact2->base,
+		                       flags, bs, X);
+		if(X == NULL)
+		{
+			return NULL;
+		}
 	}
 
 	X = nn_layer_computeFp(&self->conv2->base,
@@ -138,11 +141,14 @@ nn_resLayer_computeBpFn(nn_layer_t* base,
 		return NULL;
 	}
 
-	dL_dY = nn_layer_computeBp(&self->fact2->base,
-	                           flags, bs, dL_dY);
-	if(dL_dY == NULL)
+	if(self->fuse_fact2 == 0)
 	{
-		return NULL;
+		dL_dY = nn_layer_computeBp(&self->fact2->base,
+		                           flags, bs, dL_dY);
+		if(dL_dY == NULL)
+		{
+			return NULL;
+		}
 	}
 
 	if(self->bn2)
@@ -217,6 +223,60 @@ nn_resLayer_postFn(nn_layer_t* base,
 	nn_layer_post(&self->skip2->base, flags, bs);
 }
 
+static int
+nn_resLayer_fuseFact(nn_resLayer_t* self)
+{
+	ASSERT(self);
+
+	// fact2 directly follows conv1 without bn2
+	if(self->bn2 || self->fuse_fact2)
+	{
+		return 1;
+	}
+
+	if(nn_convLayer_fuseFact(self->conv1, self->fact2->fn) == 0)
+	{
+		return 0;
+	}
+	self->fuse_fact2 = 1;
+
+	return 1;
+}
+
+static int
+nn_resLayer_freezeFn(nn_layer_t* base)
+{
+	ASSERT(base);
+
+	nn_resLayer_t* self = (nn_resLayer_t*) base;
+
+	// bn1 follows the skip fork and cannot be folded
+	if(self->bn2 == NULL)
+	{
+		return 1;
+	}
+
+	if(nn_convLayer_foldBatchNorm(self->conv1, self->bn2) == 0)
+	{
+		return 0;
+	}
+
+	nn_batchNormLayer_delete(&self->bn2);
+
+	return nn_resLayer_fuseFact(self);
+}
+
+static int
+nn_resLayer_quantizeFn(nn_layer_t* base)
+{
+	ASSERT(base);
+
+	nn_resLayer_t* self = (nn_resLayer_t*) base;
+
+	return nn_layer_quantize(&self->conv1->base) &&
+	       nn_layer_quantize(&self->conv2->base);
+}
+
 static nn_dim_t*
 nn_resLayer_dimXFn(nn_layer_t* base)
 {
@@ -264,6 +324,8 @@ nn_resLayer_new(nn_arch_t* arch,
 		.post_fn       = nn_resLayer_postFn,
 		.dimX_fn       = nn_resLayer_dimXFn,
 		.dimY_fn       = nn_resLayer_dimYFn,
+		.freeze_fn     = nn_resLayer_freezeFn,
+		.quantize_fn   = nn_resLayer_quantizeFn,
 	};
 
 	nn_resLayer_t* self;
@@ -315,7 +377,7 @@ nn_resLayer_new(nn_arch_t* arch,
 	flags |= norm_flags;
 
 	self->conv1 = nn_convLayer_new(arch, dimX, &dimW,
-	                               1, flags);
+	                               1, 1, flags);
 	if(self->conv1 == NULL)
 	{
 		goto failure;
@@ -337,7 +399,7 @@ nn_resLayer_new(nn_arch_t* arch,
 	}
 
 	self->conv2 = nn_convLayer_new(arch, dimX, &dimW,
-	                               1, flags);
+	                               1, 1, flags);
 	if(self->conv2 == NULL)
 	{
 		goto failure;
@@ -351,6 +413,11 @@ nn_resLayer_new(nn_arch_t* arch,
 		goto failure;
 	}
 
+	if(nn_resLayer_fuseFact(self) == 0)
+	{
+		goto failure;
+	}
+
 	// success
 	return self;
 
@@ -466,6 +533,8 @@ nn_resLayer_import(nn_arch_t* arch, cc_jsmnVal_t* val)
 		.post_fn       = nn_resLayer_postFn,
 		.dimX_fn       = nn_resLayer_dimXFn,
 		.dimY_fn       = nn_resLayer_dimYFn,
+		.freeze_fn     = nn_resLayer_freezeFn,
+		.quantize_fn   = nn_resLayer_quantizeFn,
 	};
 
 	nn_resLayer_t*  self;
@@ -533,6 +602,11 @@ nn_resLayer_import(nn_arch_t* arch, cc_jsmnVal_t* val)
 		goto failure;
 	}
 
+	if(nn_resLayer_fuseFact(self) == 0)
+	{
+		goto failure;
+	}
+
 	// success
 	return self;
 
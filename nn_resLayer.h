@@ -48,6 +48,9 @@ typedef struct nn_resLayer_s
 	nn_factLayer_t*      fact2;
 	nn_convLayer_t*      conv2;
 	nn_skipLayer_t*      skip2;
+
+	// fact2 is fused with conv1 when bn2 is disabled
+	int fuse_fact2;
 } nn_resLayer_t;
 
 nn_resLayer_t* nn_resLayer_new(nn_arch_t* arch,
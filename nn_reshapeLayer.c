@@ -104,22 +104,19 @@ nn_reshapeLayer_newCompute(nn_reshapeLayer_t* self,
 	nn_tensor_t* Y      = &self->Y;
 	nn_tensor_t* dL_dX  = &self->dL_dX;
 
-	vkk_updateMode_e um;
-	um = vkk_compute_updateMode(engine->compute);
+	// the CPU backend does not require sb_dim
+	if(engine->cpu)
+	{
+		return 1;
+	}
 
-	Y->sb_dim = vkk_buffer_new(engine->engine, um,
-	                           VKK_BUFFER_USAGE_STORAGE,
-	                           sizeof(nn_dim_t),
-	                           dimY);
+	Y->sb_dim = nn_engine_getDim(engine, dimY);
 	if(Y->sb_dim == NULL)
 	{
 		return 0;
 	}
 
-	dL_dX->sb_dim = vkk_buffer_new(engine->engine, um,
-	                               VKK_BUFFER_USAGE_STORAGE,
-	                               sizeof(nn_dim_t),
-	                               dimX);
+	dL_dX->sb_dim = nn_engine_getDim(engine, dimX);
 	if(dL_dX->sb_dim == NULL)
 	{
 		goto fail_dL_dX;
@@ -130,7 +127,7 @@ nn_reshapeLayer_newCompute(nn_reshapeLayer_t* self,
 
 	// failure
 	fail_dL_dX:
-		vkk_buffer_delete(&Y->sb_dim);
+		nn_engine_putDim(engine, dimY, &Y->sb_dim);
 	return 0;
 }
 
@@ -139,11 +136,13 @@ nn_reshapeLayer_deleteCompute(nn_reshapeLayer_t* self)
 {
 	ASSERT(self);
 
-	nn_tensor_t* Y     = &self->Y;
-	nn_tensor_t* dL_dX = &self->dL_dX;
+	nn_engine_t* engine = self->base.arch->engine;
+	nn_tensor_t* Y      = &self->Y;
+	nn_tensor_t* dL_dX  = &self->dL_dX;
 
-	vkk_buffer_delete(&dL_dX->sb_dim);
-	vkk_buffer_delete(&Y->sb_dim);
+	nn_engine_putDim(engine, nn_tensor_dim(dL_dX),
+	                 &dL_dX->sb_dim);
+	nn_engine_putDim(engine, nn_tensor_dim(Y), &Y->sb_dim);
 }
 
 /***********************************************************
@@ -155,9 +155,9 @@ nn_skipLayer_computeBpForkFn(nn_layer_t* base,
 		},
 	};
 
-	vkk_compute_updateUniformSetRefs(engine->compute,
-	                                 self->us1_bp, 10,
-	                                 ua1_array);
+	nn_engine_computeUpdateUniformSetRefs(engine,
+	                                      self->us1_bp, 10,
+	                                      ua1_array);
 
 	vkk_uniformSet_t* us_array[] =
 	{
@@ -168,12 +168,13 @@ nn_skipLayer_computeBpForkFn(nn_layer_t* base,
 	// nn_skipLayer_backpropFork
 	// dispatch(RAW, bs, xh, xw, 1, 8, 8)
 	vkk_computePipeline_t* cp;
-	cp = engine->cp_skip_backpropFork;
+	cp = nn_engine_getPipeline(engine,
+	                           &engine->cp_skip_backpropFork);
 	if(nn_engine_computeBind(engine, cp) == 0)
 	{
 		return NULL;
 	}
-	vkk_compute_bindUniformSets(engine->compute, 2, us_array);
+	nn_engine_computeBindUniformSets(engine, 2, us_array);
 	nn_engine_computeDispatch(engine, VKK_HAZARD_RAW,
 	                          bs, dimX->height, dimX->width,
 	                          1, 8, 8);
@@ -262,9 +263,9 @@ nn_skipLayer_computeFpAddFn(nn_layer_t* base,
 		},
 	};
 
-	vkk_compute_updateUniformSetRefs(engine->compute,
-	                                 self->us1_fp, 8,
-	                                 ua1_array);
+	nn_engine_computeUpdateUniformSetRefs(engine,
+	                                      self->us1_fp, 8,
+	                                      ua1_array);
 
 	vkk_uniformSet_t* us_array[] =
 	{
@@ -275,12 +276,13 @@ nn_skipLayer_computeFpAddFn(nn_layer_t* base,
 	// nn_skipLayer_forwardPassAdd
 	// dispatch(RAW, bs, xh, xw, 1, 8, 8)
 	vkk_computePipeline_t* cp;
-	cp = engine->cp_skip_forwardPassAdd;
+	cp = nn_engine_getPipeline(engine,
+	                           &engine->cp_skip_forwardPassAdd);
 	if(nn_engine_computeBind(engine, cp) == 0)
 	{
 		return NULL;
 	}
-	vkk_compute_bindUniformSets(engine->compute, 2, us_array);
+	nn_engine_computeBindUniformSets(engine, 2, us_array);
 	nn_engine_computeDispatch(engine, VKK_HAZARD_RAW,
 	                          bs, dimX->height, dimX->width,
 	                          1, 8, 8);
@@ -318,11 +320,11 @@ nn_skipLayer_computeBpAddFn(nn_layer_t* base,
 	if(self->skip_beta == 1.0f)
 	{
 		size_t size = bs*xh*xw*xd*sizeof(float);
-		vkk_compute_copyStorage(engine->compute,
-		                        VKK_HAZARD_RAW,
-		                        dL_dY->sb_data,
-		                        dL_dX1->sb_data,
-		                        0, 0, size);
+		nn_engine_computeCopyStorage(engine,
+		                             VKK_HAZARD_RAW,
+		                             dL_dY->sb_data,
+		                             dL_dX1->sb_data,
+		                             0, 0, size);
 		return dL_dX1;
 	}
 
@@ -396,9 +398,9 @@ nn_skipLayer_computeBpAddFn(nn_layer_t* base,
 		},
 	};
 
-	vkk_compute_updateUniformSetRefs(engine->compute,
-	                                 self->us1_bp, 10,
-	                                 ua1_array);
+	nn_engine_computeUpdateUniformSetRefs(engine,
+	                                      self->us1_bp, 10,
+	                                      ua1_array);
 
 	vkk_uniformSet_t* us_array[] =
 	{
@@ -409,12 +411,13 @@ nn_skipLayer_computeBpAddFn(nn_layer_t* base,
 	// nn_skipLayer_backpropAdd
 	// dispatch(RAW, bs, xh, xw, 1, 8, 8)
 	vkk_computePipeline_t* cp;
-	cp = engine->cp_skip_backpropAdd;
+	cp = nn_engine_getPipeline(engine,
+	                           &engine->cp_skip_backpropAdd);
 	if(nn_engine_computeBind(engine, cp) == 0)
 	{
 		return NULL;
 	}
-	vkk_compute_bindUniformSets(engine->compute, 2, us_array);
+	nn_engine_computeBindUniformSets(engine, 2, us_array);
 	nn_engine_computeDispatch(engine, VKK_HAZARD_RAW,
 	                          bs, dimX->height, dimX->width,
 	                          1, 8, 8);
@@ -503,9 +506,9 @@ nn_skipLayer_computeFpCatFn(nn_layer_t* base,
 		},
 	};
 
-	vkk_compute_updateUniformSetRefs(engine->compute,
-	                                 self->us1_fp, 8,
-	                                 ua1_array);
+	nn_engine_computeUpdateUniformSetRefs(engine,
+	                                      self->us1_fp, 8,
+	                                      ua1_array);
 
 	vkk_uniformSet_t* us_array[] =
 	{
@@ -516,12 +519,13 @@ nn_skipLayer_computeFpCatFn(nn_layer_t* base,
 	// nn_skipLayer_forwardPassCat
 	// dispatch(RAW, bs, xh, xw, 1, 8, 8)
 	vkk_computePipeline_t* cp;
-	cp = engine->cp_skip_forwardPassCat;
+	cp = nn_engine_getPipeline(engine,
+	                           &engine->cp_skip_forwardPassCat);
 	if(nn_engine_computeBind(engine, cp) == 0)
 	{
 		return NULL;
 	}
-	vkk_compute_bindUniformSets(engine->compute, 2, us_array);
+	nn_engine_computeBindUniformSets(engine, 2, us_array);
 	nn_engine_computeDispatch(engine, VKK_HAZARD_RAW,
 	                          bs, dimX->height, dimX->width,
 	                          1, 8, 8);
@@ -619,9 +623,9 @@ nn_skipLayer_computeBpCatFn(nn_layer_t* base,
 		},
 	};
 
-	vkk_compute_updateUniformSetRefs(engine->compute,
-	                                 self->us1_bp, 10,
-	                                 ua1_array);
+	nn_engine_computeUpdateUniformSetRefs(engine,
+	                                      self->us1_bp, 10,
+	                                      ua1_array);
 
 	vkk_uniformSet_t* us_array[] =
 	{
@@ -632,12 +636,13 @@ nn_skipLayer_computeBpCatFn(nn_layer_t* base,
 	// nn_skipLayer_backpropCat
 	// dispatch(RAW, bs, xh, xw, 1, 8, 8)
 	vkk_computePipeline_t* cp;
-	cp = engine->cp_skip_backpropCat;
+	cp = nn_engine_getPipeline(engine,
+	                           &engine->cp_skip_backpropCat);
 	if(nn_engine_computeBind(engine, cp) == 0)
 	{
 		return NULL;
 	}
-	vkk_compute_bindUniformSets(engine->compute, 2, us_array);
+	nn_engine_computeBindUniformSets(engine, 2, us_array);
 	nn_engine_computeDispatch(engine, VKK_HAZARD_RAW,
 	                          bs, dimX->height, dimX->width,
 	                          1, 8, 8);
@@ -645,6 +650,184 @@ nn_skipLayer_computeBpCatFn(nn_layer_t* base,
 	return dL_dX1;
 }
 
+static nn_tensor_t*
+nn_skipLayer_computeBpForkCpuFn(nn_layer_t* base,
+                                int flags, uint32_t bs,
+                                nn_tensor_t* dL_dY)
+{
+	ASSERT(base);
+	ASSERT(dL_dY); // dim(bs,xh,xw,xd)
+
+	nn_skipLayer_t* self = (nn_skipLayer_t*) base;
+
+	if((self->skip == NULL) || (self->skip->dL_dX2 == NULL))
+	{
+		LOGE("invalid");
+		return NULL;
+	}
+
+	// reference
+	self->dL_dX1 = dL_dY;
+
+	nn_dim_t* dimX = &self->dimX;
+
+	// dL_dY1 += dL_dY2
+	if(nn_tensor_computeAddOp(dL_dY, self->skip->dL_dX2, dL_dY,
+	                          VKK_HAZARD_RAW, 0, 0, 0, bs,
+	                          0, 0, 0, dimX->height,
+	                          0, 0, 0, dimX->width,
+	                          0, 0, 0, dimX->depth) == 0)
+	{
+		return NULL;
+	}
+
+	return self->dL_dX1;
+}
+
+static nn_tensor_t*
+nn_skipLayer_computeFpAddCpuFn(nn_layer_t* base,
+                               int flags, uint32_t bs,
+                               nn_tensor_t* X)
+{
+	ASSERT(base);
+	ASSERT(X);
+
+	nn_skipLayer_t* self = (nn_skipLayer_t*) base;
+
+	if((self->skip == NULL) || (self->skip->Y == NULL))
+	{
+		LOGE("invalid");
+		return NULL;
+	}
+
+	nn_dim_t* dimX = &self->dimX;
+
+	// Y = beta*X1 + X2
+	if(nn_tensor_computeScaleAddOp(X, self->skip->Y, self->Y,
+	                               VKK_HAZARD_RAW, 0, 0, 0, bs,
+	                               0, 0, 0, dimX->height,
+	                               0, 0, 0, dimX->width,
+	                               0, 0, 0, dimX->depth,
+	                               self->skip_beta) == 0)
+	{
+		return NULL;
+	}
+
+	return self->Y;
+}
+
+static nn_tensor_t*
+nn_skipLayer_computeBpAddCpuFn(nn_layer_t* base,
+                               int flags, uint32_t bs,
+                               nn_tensor_t* dL_dY)
+{
+	ASSERT(base);
+	ASSERT(dL_dY); // dim(bs,xh,xw,xd)
+
+	nn_skipLayer_t* self = (nn_skipLayer_t*) base;
+
+	// reference
+	self->dL_dX2 = dL_dY;
+
+	nn_dim_t* dimX = &self->dimX;
+
+	// add (skip_beta == 1.0): fast path
+	if(self->skip_beta == 1.0f)
+	{
+		if(nn_tensor_computeCopy(dL_dY, self->dL_dX1,
+		                         VKK_HAZARD_RAW, 0, 0, bs) == 0)
+		{
+			return NULL;
+		}
+		return self->dL_dX1;
+	}
+
+	// dL_dX1 = beta*dL_dY
+	if(nn_tensor_computeScaleOp(dL_dY, self->dL_dX1,
+	                            VKK_HAZARD_RAW, 0, 0, bs,
+	                            0, 0, dimX->height,
+	                            0, 0, dimX->width,
+	                            0, 0, dimX->depth,
+	                            self->skip_beta) == 0)
+	{
+		return NULL;
+	}
+
+	return self->dL_dX1;
+}
+
+static nn_tensor_t*
+nn_skipLayer_computeFpCatCpuFn(nn_layer_t* base,
+                               int flags, uint32_t bs,
+                               nn_tensor_t* X)
+{
+	ASSERT(base);
+	ASSERT(X);
+
+	nn_skipLayer_t* self = (nn_skipLayer_t*) base;
+
+	if((self->skip == NULL) || (self->skip->Y == NULL))
+	{
+		LOGE("invalid");
+		return NULL;
+	}
+
+	nn_tensor_t* X2    = self->skip->Y;
+	nn_dim_t*    dimX1 = nn_tensor_dim(X);
+	nn_dim_t*    dimX2 = nn_tensor_dim(X2);
+
+	// Y = X1 | X2
+	if((nn_tensor_computeCopyOp(X, self->Y, VKK_HAZARD_RAW,
+	                            0, 0, bs,
+	                            0, 0, dimX1->height,
+	                            0, 0, dimX1->width,
+	                            0, 0, dimX1->depth) == 0) ||
+	   (nn_tensor_computeCopyOp(X2, self->Y, VKK_HAZARD_RAW,
+	                            0, 0, bs,
+	                            0, 0, dimX2->height,
+	                            0, 0, dimX2->width,
+	                            0, dimX1->depth,
+	                            dimX2->depth) == 0))
+	{
+		return NULL;
+	}
+
+	return self->Y;
+}
+
+static nn_tensor_t*
+nn_skipLayer_computeBpCatCpuFn(nn_layer_t* base,
+                               int flags, uint32_t bs,
+                               nn_tensor_t* dL_dY)
+{
+	ASSERT(base);
+	ASSERT(dL_dY); // dim(bs,xh,xw,x1d + x2d)
+
+	nn_skipLayer_t* self = (nn_skipLayer_t*) base;
+
+	nn_dim_t* dimX1 = nn_tensor_dim(self->dL_dX1);
+	nn_dim_t* dimX2 = nn_tensor_dim(self->dL_dX2);
+
+	// dL_dX1 = select(dL_dY1, 0, x1d)
+	// dL_dX2 = select(dL_dY1, x1d, x1d + x2d)
+	if((nn_tensor_computeCopyOp(dL_dY, self->dL_dX1,
+	                            VKK_HAZARD_RAW, 0, 0, bs,
+	                            0, 0, dimX1->height,
+	                            0, 0, dimX1->width,
+	                            0, 0, dimX1->depth) == 0) ||
+	   (nn_tensor_computeCopyOp(dL_dY, self->dL_dX2,
+	                            VKK_HAZARD_RAW, 0, 0, bs,
+	                            0, 0, dimX2->height,
+	                            0, 0, dimX2->width,
+	                            dimX1->depth, 0,
+	                            dimX2->depth) == 0))
+	{
+		return NULL;
+	}
+
+	return self->dL_dX1;
+}
+
 static int nn_skipLayer_newCompute(nn_skipLayer_t* self)
 {
 	ASSERT(self);
@@ -652,6 +835,12 @@ static int nn_skipLayer_newCompute(nn_skipLayer_t* self)
 	nn_arch_t*   arch   = self->base.arch;
 	nn_engine_t* engine = arch->engine;
 
+	// the CPU backend does not require uniform sets
+	if(engine->cpu)
+	{
+		return 1;
+	}
+
 	nn_skipLayerParam_t param =
 	{
 		.beta = self->skip_beta,
@@ -697,9 +886,9 @@ static int nn_skipLayer_newCompute(nn_skipLayer_t* self)
 		},
 	};
 
-	vkk_compute_updateUniformSetRefs(engine->compute,
-	                                 self->us0, 1,
-	                                 ua0_array);
+	nn_engine_computeUpdateUniformSetRefs(engine,
+	                                      self->us0, 1,
+	                                      ua0_array);
 
 	// success
 	return 1;
@@ -762,6 +951,11 @@ nn_skipLayer_newFork(nn_arch_t* arch, nn_dim_t* dimX,
 		.dimY_fn       = nn_skipLayer_dimYFn,
 	};
 
+	if(arch->engine->cpu)
+	{
+		info.compute_bp_fn = nn_skipLayer_computeBpForkCpuFn;
+	}
+
 	nn_skipLayer_t* self;
 	self = (nn_skipLayer_t*)
 	       nn_layer_new(sizeof(nn_skipLayer_t), &info);
@@ -843,6 +1037,12 @@ nn_skipLayer_newAdd(nn_arch_t* arch,
 		.dimY_fn       = nn_skipLayer_dimYFn,
 	};
 
+	if(engine->cpu)
+	{
+		info.compute_fp_fn = nn_skipLayer_computeFpAddCpuFn;
+		info.compute_bp_fn = nn_skipLayer_computeBpAddCpuFn;
+	}
+
 	nn_skipLayer_t* self;
 	self = (nn_skipLayer_t*)
 	       nn_layer_new(sizeof(nn_skipLayer_t), &info);
@@ -867,9 +1067,12 @@ nn_skipLayer_newAdd(nn_arch_t* arch,
 		goto fail_Y;
 	}
 
+	// backprop gradients
+	nn_tensorMode_e mode = nn_arch_trainMode(arch);
+
 	self->dL_dX1 = nn_tensor_new(engine, dimX1,
 	                             NN_TENSOR_INIT_ZERO,
-	                             NN_TENSOR_MODE_COMPUTE);
+	                             mode);
 	if(self->dL_dX1 == NULL)
 	{
 		goto fail_dL_dX1;
@@ -938,6 +1141,12 @@ nn_skipLayer_newCat(nn_arch_t* arch,
 		.dimY_fn       = nn_skipLayer_dimYFn,
 	};
 
+	if(engine->cpu)
+	{
+		info.compute_fp_fn = nn_skipLayer_computeFpCatCpuFn;
+		info.compute_bp_fn = nn_skipLayer_computeBpCatCpuFn;
+	}
+
 	nn_skipLayer_t* self;
 	self = (nn_skipLayer_t*)
 	       nn_layer_new(sizeof(nn_skipLayer_t), &info);
@@ -969,9 +1178,12 @@ nn_skipLayer_newCat(nn_arch_t* arch,
 		goto fail_Y;
 	}
 
+	// backprop gradients
+	nn_tensorMode_e mode = nn_arch_trainMode(arch);
+
 	self->dL_dX1 = nn_tensor_new(engine, dimX1,
 	                             NN_TENSOR_INIT_ZERO,
-	                             NN_TENSOR_MODE_COMPUTE);
+	                             mode);
 	if(self->dL_dX1 == NULL)
 	{
 		goto fail_dL_dX1;
@@ -979,7 +1191,7 @@ nn_skipLayer_newCat(nn_arch_t* arch,
 
 	self->dL_dX2 = nn_tensor_new(engine, dimX2,
 	                             NN_TENSOR_INIT_ZERO,
-	                             NN_TENSOR_MODE_COMPUTE);
+	                             mode);
 	if(self->dL_dX2 == NULL)
 	{
 		goto fail_dL_dX2;
@@ -32,6 +32,7 @@
 #include "../libcc/cc_memory.h"
 #include "../texgz/texgz_png.h"
 #include "nn_arch.h"
+#include "nn_cpu.h"
 #include "nn_engine.h"
 #include "nn_tensorStats.h"
 #include "nn_tensor.h"
@@ -42,6 +43,26 @@ typedef union
 	uint32_t u32;
 } nn_tensorValue_t;
 
+typedef enum
+{
+	NN_TENSOR_OP_FILL     = 0,
+	NN_TENSOR_OP_COPY     = 1,
+	NN_TENSOR_OP_ADD      = 2,
+	NN_TENSOR_OP_MIX      = 3,
+	NN_TENSOR_OP_MUL      = 4,
+	NN_TENSOR_OP_SCALE    = 5,
+	NN_TENSOR_OP_SCALEADD = 6,
+} nn_tensorOp_e;
+
+typedef struct
+{
+	nn_tensorOp_e        op;
+	nn_tensor_t*         X1;
+	nn_tensor_t*         X2;
+	nn_tensor_t*         Y;
+	nn_tensorOpUs0Idx_t* idx;
+} nn_tensorOpTask_t;
+
 const char* NN_TENSOR_NORM_STRING_NONE = "none";
 const char* NN_TENSOR_NORM_STRING_SN   = "sn";
 const char* NN_TENSOR_NORM_STRING_BSSN = "bssn";
@@ -73,13 +94,11 @@ nn_tensor_data(nn_tensor_t* self, uint32_t n)
 }
 
 static int
-nn_tensor_importStorage(nn_tensor_t* self,
-                        cc_jsmnVal_t* val,
-                        vkk_buffer_t* buf)
+nn_tensor_importArray(cc_jsmnVal_t* val, float* data,
+                      uint32_t count)
 {
-	ASSERT(self);
 	ASSERT(val);
-	ASSERT(buf);
+	ASSERT(data);
 
 	if(val->type != CC_JSMN_TYPE_ARRAY)
 	{
@@ -87,24 +106,15 @@ nn_tensor_importStorage(nn_tensor_t* self,
 		return 0;
 	}
 
-	size_t   size  = vkk_buffer_size(buf);
-	uint32_t count = (uint32_t) (size/sizeof(float));
-	float*   tmp   = (float*) CALLOC(1, size);
-	if(tmp == NULL)
-	{
-		LOGE("CALLOC failed");
-		return 0;
-	}
-
-	// fill tmp
+	// fill data
 	uint32_t       i;
-	cc_listIter_t* iter  = cc_list_head(val->array->list);
+	cc_listIter_t* iter = cc_list_head(val->array->list);
 	for(i = 0; i < count; ++i)
 	{
 		if(iter == NULL)
 		{
 			LOGE("invalid");
-			goto fail_array;
+			return 0;
 		}
 
 		cc_jsmnVal_t* elem;
@@ -112,14 +122,63 @@ nn_tensor_importStorage(nn_tensor_t* self,
 		if(elem->type != CC_JSMN_TYPE_PRIMITIVE)
 		{
 			LOGE("invalid");
-			goto fail_array;
+			return 0;
 		}
 
-		tmp[i] = strtof(elem->data, NULL);
+		data[i] = strtof(elem->data, NULL);
 
 		iter = cc_list_next(iter);
 	}
 
+	return 1;
+}
+
+static int
+nn_tensor_exportArray(cc_jsmnStream_t* stream,
+                      const char* name, float* data,
+                      uint32_t count)
+{
+	// data may be NULL when count is zero
+	ASSERT(stream);
+	ASSERT(name);
+
+	int ret = 1;
+	ret &= cc_jsmnStream_key(stream, "%s", name);
+	ret &= cc_jsmnStream_beginArray(stream);
+
+	uint32_t i;
+	for(i = 0; i < count; ++i)
+	{
+		ret &= cc_jsmnStream_float(stream, data[i]);
+	}
+	ret &= cc_jsmnStream_end(stream);
+
+	return ret;
+}
+
+static int
+nn_tensor_importStorage(nn_tensor_t* self,
+                        cc_jsmnVal_t* val,
+                        vkk_buffer_t* buf)
+{
+	ASSERT(self);
+	ASSERT(val);
+	ASSERT(buf);
+
+	size_t   size  = vkk_buffer_size(buf);
+	uint32_t count = (uint32_t) (size/sizeof(float));
+	float*   tmp   = (float*) CALLOC(1, size);
+	if(tmp == NULL)
+	{
+		LOGE("CALLOC failed");
+		return 0;
+	}
+
+	if(nn_tensor_importArray(val, tmp, count) == 0)
+	{
+		goto fail_array;
+	}
+
 	if(vkk_buffer_writeStorage(buf, 0, size, tmp) == 0)
 	{
 		goto fail_write;
@@ -162,16 +221,7 @@ nn_tensor_exportStorage(nn_tensor_t* self,
 		goto fail_read;
 	}
 
-	int ret = 0;
-	ret &= cc_jsmnStream_key(stream, "%s", name);
-	ret &= cc_jsmnStream_beginArray(stream);
-
-	uint32_t i;
-	for(i = 0; i < count; ++i)
-	{
-		ret &= cc_jsmnStream_float(stream, tmp[i]);
-	}
-	ret &= cc_jsmnStream_end(stream);
+	int ret = nn_tensor_exportArray(stream, name, tmp, count);
 
 	FREE(tmp);
 
@@ -190,45 +240,18 @@ nn_tensor_importData(nn_tensor_t* self, cc_jsmnVal_t* val)
 	ASSERT(self);
 	ASSERT(val);
 
-	if(val->type != CC_JSMN_TYPE_ARRAY)
-	{
-		LOGE("invalid type=%i", val->type);
-		return 0;
-	}
+	nn_engine_t* engine = self->engine;
 
-	if(self->mode == NN_TENSOR_MODE_COMPUTE)
+	if((self->mode == NN_TENSOR_MODE_COMPUTE) &&
+	   (engine->cpu == NULL))
 	{
 		return nn_tensor_importStorage(self, val,
 		                               self->sb_data);
 	}
 
-	// fill data
-	uint32_t       i;
-	nn_dim_t*      dim   = nn_tensor_dim(self);
-	uint32_t       count = nn_dim_sizeElements(dim);
-	cc_listIter_t* iter  = cc_list_head(val->array->list);
-	for(i = 0; i < count; ++i)
-	{
-		if(iter == NULL)
-		{
-			LOGE("invalid");
-			return 0;
-		}
-
-		cc_jsmnVal_t* elem;
-		elem = (cc_jsmnVal_t*) cc_list_peekIter(iter);
-		if(elem->type != CC_JSMN_TYPE_PRIMITIVE)
-		{
-			LOGE("invalid");
-			return 0;
-		}
-
-		self->data[i] = strtof(elem->data, NULL);
-
-		iter = cc_list_next(iter);
-	}
-
-	return 1;
+	nn_dim_t* dim = nn_tensor_dim(self);
+	return nn_tensor_importArray(val, self->data,
+	                             nn_dim_sizeElements(dim));
 }
 
 static void
@@ -339,6 +362,80 @@ nn_tensor_initSN(nn_engine_t* engine, float* buf,
 	}
 }
 
+static int
+nn_tensor_initNormModeCpu(nn_tensor_t* self,
+                          nn_tensorNorm_e norm,
+                          float c, int init_sn)
+{
+	ASSERT(self);
+
+	nn_engine_t* engine = self->engine;
+
+	nn_dim_t* dim = &self->dim;
+	uint32_t  fc  = dim->count;
+	uint32_t  fh  = dim->height;
+	uint32_t  fw  = dim->width;
+	uint32_t  xd  = dim->depth;
+
+	self->data_u1 = (float*) CALLOC(fc, sizeof(float));
+	if(self->data_u1 == NULL)
+	{
+		LOGE("CALLOC failed");
+		return 0;
+	}
+
+	self->data_v1 = (float*) CALLOC(fh*fw*xd, sizeof(float));
+	if(self->data_v1 == NULL)
+	{
+		LOGE("CALLOC failed");
+		goto fail_data_v1;
+	}
+
+	if(norm == NN_TENSOR_NORM_BSSN)
+	{
+		self->data_u2 = (float*) CALLOC(xd, sizeof(float));
+		if(self->data_u2 == NULL)
+		{
+			LOGE("CALLOC failed");
+			goto fail_data_u2;
+		}
+
+		self->data_v2 = (float*) CALLOC(fc*fh*fw, sizeof(float));
+		if(self->data_v2 == NULL)
+		{
+			LOGE("CALLOC failed");
+			goto fail_data_v2;
+		}
+	}
+
+	if(init_sn)
+	{
+		nn_tensor_initSN(engine, self->data_u1, fc);
+		if(self->data_u2)
+		{
+			nn_tensor_initSN(engine, self->data_u2, xd);
+		}
+	}
+
+	self->c    = c;
+	self->norm = norm;
+
+	// success
+	return 1;
+
+	// failure
+	fail_data_v2:
+		FREE(self->data_u2);
+		self->data_u2 = NULL;
+	fail_data_u2:
+		FREE(self->data_v1);
+		self->data_v1 = NULL;
+	fail_data_v1:
+		FREE(self->data_u1);
+		self->data_u1 = NULL;
+	return 0;
+}
+
 static int
 nn_tensor_initNormMode(nn_tensor_t* self,
                        nn_tensorNorm_e norm,
@@ -362,6 +459,12 @@ nn_tensor_initNormMode(nn_tensor_t* self,
 	}
 	else if(norm == self->norm)
 	{
+		if(engine->cpu)
+		{
+			self->c = c;
+			return 1;
+		}
+
 		vkk_buffer_writeStorage(self->sb104_c, 0,
 		                        sizeof(float), &c);
 		return 1;
@@ -369,6 +472,14 @@ nn_tensor_initNormMode(nn_tensor_t* self,
 
 	// reset norm state
 	self->norm = NN_TENSOR_NORM_NONE;
+	FREE(self->data_u1);
+	FREE(self->data_v1);
+	FREE(self->data_u2);
+	FREE(self->data_v2);
+	self->data_u1 = NULL;
+	self->data_v1 = NULL;
+	self->data_u2 = NULL;
+	self->data_v2 = NULL;
 	vkk_buffer_delete(&self->sb100_data_u1);
 	vkk_buffer_delete(&self->sb101_data_v1);
 	vkk_buffer_delete(&self->sb102_data_u2);
@@ -376,6 +487,12 @@ nn_tensor_initNormMode(nn_tensor_t* self,
 	vkk_buffer_delete(&self->sb104_c);
 	vkk_uniformSet_delete(&self->us1_norm);
 
+	if(engine->cpu)
+	{
+		return nn_tensor_initNormModeCpu(self, norm, c,
+		                                 init_sn);
+	}
+
 	float* tmp_u1 = NULL;
 	if(init_sn)
 	{
@@ -458,31 +575,430 @@ nn_tensor_initNormMode(nn_tensor_t* self,
 		goto fail_us1_norm;
 	}
 
-	// free tmp buffers
-	FREE(tmp_u2);
-	FREE(tmp_u1);
-
-	self->norm = norm;
+	// free tmp buffers
+	FREE(tmp_u2);
+	FREE(tmp_u1);
+
+	self->norm = norm;
+
+	// success
+	return 1;
+
+	// failure
+	fail_us1_norm:
+		vkk_buffer_delete(&self->sb104_c);
+	fail_sb104_c:
+		vkk_buffer_delete(&self->sb103_data_v2);
+	fail_sb103_data_v2:
+		vkk_buffer_delete(&self->sb102_data_u2);
+	fail_sb102_data_u2:
+		FREE(tmp_u2);
+	fail_tmp_u2:
+		vkk_buffer_delete(&self->sb101_data_v1);
+	fail_sb101_data_v1:
+		vkk_buffer_delete(&self->sb100_data_u1);
+	fail_sb100_data_u1:
+		FREE(tmp_u1);
+	return 0;
+}
+
+static float*
+nn_tensor_cpuData(nn_tensor_t* self, uint32_t n,
+                  uint32_t i, uint32_t j, uint32_t k)
+{
+	ASSERT(self);
+
+	nn_dim_t* dim = &self->dim;
+	return &self->data[((n*dim->height + i)*dim->width + j)*
+	                   dim->depth + k];
+}
+
+static void nn_tensor_cpuOpTask(void* priv, uint32_t t)
+{
+	ASSERT(priv);
+
+	nn_tensorOpTask_t*   task = (nn_tensorOpTask_t*) priv;
+	nn_tensorOpUs0Idx_t* idx  = task->idx;
+
+	// task per row
+	uint32_t m = t/idx->height;
+	uint32_t i = t%idx->height;
+	float    s = idx->value;
+
+	float*   x1;
+	float*   x2 = NULL;
+	float*   y  = NULL;
+	uint32_t j;
+	uint32_t k;
+	for(j = 0; j < idx->width; ++j)
+	{
+		x1 = nn_tensor_cpuData(task->X1, idx->x1n + m,
+		                       idx->x1i + i, idx->x1j + j,
+		                       idx->x1k);
+		if(task->X2)
+		{
+			x2 = nn_tensor_cpuData(task->X2, idx->x2n + m,
+			                       idx->x2i + i, idx->x2j + j,
+			                       idx->x2k);
+		}
+		if(task->Y)
+		{
+			y = nn_tensor_cpuData(task->Y, idx->yn + m,
+			                      idx->yi + i, idx->yj + j,
+			                      idx->yk);
+		}
+
+		if(task->op == NN_TENSOR_OP_FILL)
+		{
+			for(k = 0; k < idx->depth; ++k)
+			{
+				x1[k] = s;
+			}
+		}
+		else if(task->op == NN_TENSOR_OP_COPY)
+		{
+			memmove(y, x1, idx->depth*sizeof(float));
+		}
+		else if(task->op == NN_TENSOR_OP_ADD)
+		{
+			for(k = 0; k < idx->depth; ++k)
+			{
+				y[k] = x1[k] + x2[k];
+			}
+		}
+		else if(task->op == NN_TENSOR_OP_MIX)
+		{
+			for(k = 0; k < idx->depth; ++k)
+			{
+				y[k] = x1[k]*(1.0f - s) + x2[k]*s;
+			}
+		}
+		else if(task->op == NN_TENSOR_OP_MUL)
+		{
+			for(k = 0; k < idx->depth; ++k)
+			{
+				x1[k] *= s;
+			}
+		}
+		else if(task->op == NN_TENSOR_OP_SCALE)
+		{
+			for(k = 0; k < idx->depth; ++k)
+			{
+				y[k] = s*x1[k];
+			}
+		}
+		else
+		{
+			for(k = 0; k < idx->depth; ++k)
+			{
+				y[k] = s*x1[k] + x2[k];
+			}
+		}
+	}
+}
+
+static void
+nn_tensor_cpuOp(nn_tensorOp_e op, nn_tensor_t* X1,
+                nn_tensor_t* X2, nn_tensor_t* Y,
+                nn_tensorOpUs0Idx_t* idx)
+{
+	// X2 and Y may be NULL
+	ASSERT(X1);
+	ASSERT(idx);
+
+	nn_engine_t* engine = X1->engine;
+
+	nn_tensorOpTask_t task =
+	{
+		.op  = op,
+		.X1  = X1,
+		.X2  = X2,
+		.Y   = Y,
+		.idx = idx,
+	};
+
+	nn_cpu_run(engine->cpu, nn_tensor_cpuOpTask, &task,
+	           idx->count*idx->height);
+}
+
+static void
+nn_tensor_cpuNormalizeArray(float* data, uint32_t count)
+{
+	ASSERT(data);
+
+	float epsilon = 1.192092896e-07;
+	float norm    = sqrtf(nn_cpu_dot(data, data, count));
+
+	uint32_t i;
+	for(i = 0; i < count; ++i)
+	{
+		data[i] /= norm + epsilon;
+	}
+}
+
+static float nn_tensor_cpuSigma1(nn_tensor_t* self)
+{
+	ASSERT(self);
+
+	nn_dim_t* dim = &self->dim;
+	uint32_t  fc  = dim->count;
+	uint32_t  sn  = dim->height*dim->width*dim->depth;
+	float*    W   = self->data;
+	float*    u1  = self->data_u1;
+	float*    v1  = self->data_v1;
+
+	// power iteration: v1 = normalize(W^T*u1)
+	uint32_t n;
+	memset(v1, 0, sn*sizeof(float));
+	for(n = 0; n < fc; ++n)
+	{
+		nn_cpu_axpy(u1[n], &W[n*sn], v1, sn);
+	}
+	nn_tensor_cpuNormalizeArray(v1, sn);
+
+	// power iteration: u1 = normalize(W*v1)
+	for(n = 0; n < fc; ++n)
+	{
+		u1[n] = nn_cpu_dot(&W[n*sn], v1, sn);
+	}
+	nn_tensor_cpuNormalizeArray(u1, fc);
+
+	// sigma1 = u1^T*W*v1
+	float sigma1 = 0.0f;
+	for(n = 0; n < fc; ++n)
+	{
+		sigma1 += u1[n]*nn_cpu_dot(&W[n*sn], v1, sn);
+	}
+
+	return sigma1;
+}
+
+static float nn_tensor_cpuSigma2(nn_tensor_t* self)
+{
+	ASSERT(self);
+
+	nn_dim_t* dim = &self->dim;
+	uint32_t  fc  = dim->count;
+	uint32_t  xd  = dim->depth;
+	uint32_t  nij = fc*dim->height*dim->width;
+	float*    W   = self->data;
+	float*    u2  = self->data_u2;
+	float*    v2  = self->data_v2;
+
+	// power iteration: v2 = normalize(W^T*u2)
+	uint32_t n;
+	for(n = 0; n < nij; ++n)
+	{
+		v2[n] = nn_cpu_dot(&W[n*xd], u2, xd);
+	}
+	nn_tensor_cpuNormalizeArray(v2, nij);
+
+	// power iteration: u2 = normalize(W*v2)
+	memset(u2, 0, xd*sizeof(float));
+	for(n = 0; n < nij; ++n)
+	{
+		nn_cpu_axpy(v2[n], &W[n*xd], u2, xd);
+	}
+	nn_tensor_cpuNormalizeArray(u2, xd);
+
+	// sigma2 = u2^T*W*v2
+	float sigma2 = 0.0f;
+	for(n = 0; n < nij; ++n)
+	{
+		sigma2 += v2[n]*nn_cpu_dot(&W[n*xd], u2, xd);
+	}
+
+	return sigma2;
+}
+
+static void
+nn_tensor_cpuNormalize(nn_tensor_t* self,
+                       nn_tensorNorm_e norm)
+{
+	ASSERT(self);
+
+	nn_dim_t* dim = &self->dim;
+
+	float epsilon = 1.192092896e-07;
+	float sigma1  = nn_tensor_cpuSigma1(self);
+	float scale   = 1.0f/(sigma1 + epsilon);
+	if(norm == NN_TENSOR_NORM_BSSN)
+	{
+		float sigma2 = nn_tensor_cpuSigma2(self);
+		scale = self->c/((sigma1 + sigma2)/2.0f + epsilon);
+	}
+
+	uint32_t i;
+	uint32_t count = nn_dim_sizeElements(dim);
+	for(i = 0; i < count; ++i)
+	{
+		self->data[i] *= scale;
+	}
+}
+
+static void
+nn_tensor_cpuStats(nn_tensor_t* self, uint32_t count,
+                   nn_tensorStats_t* stats)
+{
+	ASSERT(self);
+	ASSERT(stats);
+
+	nn_dim_t* dim  = &self->dim;
+	uint32_t  size = count*nn_dim_strideElements(dim);
+	float*    X    = self->data;
+
+	float    x;
+	float    min   = X[0];
+	float    max   = X[0];
+	double   sumx  = 0.0;
+	double   sumxx = 0.0;
+	uint32_t i;
+	for(i = 0; i < size; ++i)
+	{
+		x      = X[i];
+		sumx  += x;
+		sumxx += x*x;
+		if(x < min)
+		{
+			min = x;
+		}
+		if(x > max)
+		{
+			max = x;
+		}
+	}
+
+	float  mean   = (float) (sumx/((double) size));
+	double sumxm2 = 0.0;
+	for(i = 0; i < size; ++i)
+	{
+		x       = X[i] - mean;
+		sumxm2 += x*x;
+	}
+
+	stats->data.min    = min;
+	stats->data.max    = max;
+	stats->data.mean   = mean;
+	stats->data.norm   = (float) sqrt(sumxx);
+	stats->data.stddev = (float) sqrt(sumxm2/((double) size));
+}
+
+typedef struct
+{
+	uint32_t m;
+	uint32_t n;
+	uint32_t k;
+	uint32_t flags;
+} nn_tensorGemmParam_t;
+
+static int
+nn_tensorGemm_computeFn(nn_tensorGemm_t* self,
+                        vkk_hazard_e hazard,
+                        uint32_t bs,
+                        vkk_buffer_t* sb_bs,
+                        vkk_buffer_t* A,
+                        vkk_buffer_t* YA,
+                        vkk_buffer_t* B,
+                        vkk_buffer_t* bias,
+                        vkk_buffer_t* C)
+{
+	// YA and bias may be NULL
+	ASSERT(self);
+	ASSERT(sb_bs);
+	ASSERT(A);
+	ASSERT(B);
+	ASSERT(C);
+
+	nn_engine_t* engine = self->engine;
+
+	if(YA == NULL)
+	{
+		YA = engine->Null->sb_data;
+	}
+
+	if(bias == NULL)
+	{
+		bias = engine->Null->sb_data;
+	}
+
+	// sb000: bs
+	// sb001: param (m,n,k,flags)
+	// sb002: A
+	// sb003: B
+	// sb004: bias
+	// sb005: C
+	// sb006: YA
+	vkk_uniformAttachment_t ua0_array[] =
+	{
+		{
+			.binding = 0,
+			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
+			.buffer  = sb_bs,
+		},
+		{
+			.binding = 1,
+			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
+			.buffer  = self->sb001_param,
+		},
+		{
+			.binding = 2,
+			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
+			.buffer  = A,
+		},
+		{
+			.binding = 3,
+			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
+			.buffer  = B,
+		},
+		{
+			.binding = 4,
+			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
+			.buffer  = bias,
+		},
+		{
+			.binding = 5,
+			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
+			.buffer  = C,
+		},
+		{
+			.binding = 6,
+			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
+			.buffer  = YA,
+		},
+	};
+
+	nn_engine_computeUpdateUniformSetRefs(engine, self->us0,
+	                                      7, ua0_array);
+
+	uint32_t m = self->m;
+	if(self->flags & NN_TENSOR_GEMM_FLAG_BS_M)
+	{
+		m *= bs;
+	}
+
+	// nn_tensor_gemm
+	// dispatch(hazard, 16*mb, 16*nb, batch, 16, 16, 1)
+	vkk_computePipeline_t* cp;
+	cp = nn_engine_getPipeline(engine, &engine->cp_tensor_gemm);
+	if(nn_engine_computeBind(engine, cp) == 0)
+	{
+		return 0;
+	}
+	nn_engine_computeBindUniformSets(engine, 1, &self->us0);
+	vkk_buffer_t* read[] =
+	{
+		A,
+		B,
+		bias,
+		YA,
+	};
+	nn_engine_computeAccess(engine, 4, read, 1, &C);
+	nn_engine_computeDispatch(engine, hazard,
+	                          16*((m + 63)/64),
+	                          16*((self->n + 63)/64),
+	                          self->batch, 16, 16, 1);
 
-	// success
 	return 1;
-
-	// failure
-	fail_us1_norm:
-		vkk_buffer_delete(&self->sb104_c);
-	fail_sb104_c:
-		vkk_buffer_delete(&self->sb103_data_v2);
-	fail_sb103_data_v2:
-		vkk_buffer_delete(&self->sb102_data_u2);
-	fail_sb102_data_u2:
-		FREE(tmp_u2);
-	fail_tmp_u2:
-		vkk_buffer_delete(&self->sb101_data_v1);
-	fail_sb101_data_v1:
-		vkk_buffer_delete(&self->sb100_data_u1);
-	fail_sb100_data_u1:
-		FREE(tmp_u1);
-	return 0;
 }
 
 /***********************************************************
@@ -585,9 +1101,9 @@ nn_tensorOpUs0Data_new(nn_tensor_t* X1,
 		},
 	};
 
-	vkk_compute_updateUniformSetRefs(engine->compute,
-	                                 self->us0, 7,
-	                                 ua0_array);
+	nn_engine_computeUpdateUniformSetRefs(engine,
+	                                      self->us0, 7,
+	                                      ua0_array);
 
 	// success
 	return self;
@@ -615,87 +1131,116 @@ nn_tensorOpUs0Data_delete(nn_tensorOpUs0Data_t** _self)
 	}
 }
 
-int
-nn_tensorOpUs0Data_update(nn_tensorOpUs0Data_t* self,
-                          nn_tensor_t* X1,
-                          nn_tensor_t* X2,
-                          nn_tensor_t* Y,
-                          nn_tensorOpUs0Idx_t* idx)
+nn_tensorGemm_t*
+nn_tensorGemm_new(nn_engine_t* engine, uint32_t batch,
+                  uint32_t m, uint32_t n, uint32_t k,
+                  int flags)
 {
-	// X2 and Y may be NULL
-	ASSERT(self);
-	ASSERT(X1);
-	ASSERT(idx);
-
-	nn_engine_t* engine = X1->engine;
+	ASSERT(engine);
 
-	if(vkk_buffer_writeStorage(self->sb006_idx, 0,
-	                           sizeof(nn_tensorOpUs0Idx_t),
-	                           idx) == 0)
+	nn_tensorGemm_t* self;
+	self = (nn_tensorGemm_t*)
+	       CALLOC(1, sizeof(nn_tensorGemm_t));
+	if(self == NULL)
 	{
-		return 0;
+		LOGE("CALLOC failed");
+		return NULL;
 	}
 
-	// optionally replace X2 and Y with the Null tensor
-	if(X2 == NULL)
+	self->engine = engine;
+	self->batch  = batch;
+	self->m      = m;
+	self->n      = n;
+	self->k      = k;
+	self->flags  = flags;
+
+	nn_tensorGemmParam_t param =
+	{
+		.m     = m,
+		.n     = n,
+		.k     = k,
+		.flags = (uint32_t) flags,
+	};
+	self->sb001_param = vkk_buffer_new(engine->engine,
+	                                   VKK_UPDATE_MODE_STATIC,
+	                                   VKK_BUFFER_USAGE_STORAGE,
+	                                   sizeof(nn_tensorGemmParam_t),
+	                                   &param);
+	if(self->sb001_param == NULL)
 	{
-		X2 = engine->Null;
+		goto fail_sb001_param;
 	}
-	if(Y == NULL)
+
+	self->us0 = vkk_uniformSet_new(engine->engine, 0, 0, NULL,
+	                               engine->usf0_tensor_gemm);
+	if(self->us0 == NULL)
 	{
-		Y = engine->Null;
+		goto fail_us0;
 	}
 
-	// sb000: dimX1
-	// sb001: X1
-	// sb002: dimX2
-	// sb003: X2
-	// sb004: dimY
-	// sb005: Y
-	// sb006: idx (x1n,x2n,yn,count,x1k,x2k,yk,depth,value)
-	vkk_uniformAttachment_t ua0_array[] =
+	// success
+	return self;
+
+	// failure
+	fail_us0:
+		vkk_buffer_delete(&self->sb001_param);
+	fail_sb001_param:
+		FREE(self);
+	return NULL;
+}
+
+void nn_tensorGemm_delete(nn_tensorGemm_t** _self)
+{
+	ASSERT(_self);
+
+	nn_tensorGemm_t* self = *_self;
+	if(self)
 	{
-		{
-			.binding = 0,
-			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
-			.buffer  = X1->sb_dim,
-		},
-		{
-			.binding = 1,
-			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
-			.buffer  = X1->sb_data,
-		},
-		{
-			.binding = 2,
-			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
-			.buffer  = X2->sb_dim,
-		},
-		{
-			.binding = 3,
-			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
-			.buffer  = X2->sb_data,
-		},
-		{
-			.binding = 4,
-			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
-			.buffer  = Y->sb_dim,
-		},
-		{
-			.binding = 5,
-			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
-			.buffer  = Y->sb_data,
-		},
-		{
-			.binding = 6,
-			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
-			.buffer  = self->sb006_idx,
-		},
-	};
+		vkk_uniformSet_delete(&self->us0);
+		vkk_buffer_delete(&self->sb001_param);
+		FREE(self);
+		*_self = NULL;
+	}
+}
 
-	vkk_compute_updateUniformSetRefs(engine->compute,
-	                                 self->us0, 7,
-	                                 ua0_array);
-	return 1;
+int nn_tensorGemm_compute(nn_tensorGemm_t* self,
+                          vkk_hazard_e hazard,
+                          uint32_t bs,
+                          vkk_buffer_t* sb_bs,
+                          vkk_buffer_t* A,
+                          vkk_buffer_t* B,
+                          vkk_buffer_t* bias,
+                          vkk_buffer_t* C)
+{
+	// bias may be NULL
+	ASSERT(self);
+	ASSERT(sb_bs);
+	ASSERT(A);
+	ASSERT(B);
+	ASSERT(C);
+
+	return nn_tensorGemm_computeFn(self, hazard, bs, sb_bs,
+	                               A, NULL, B, bias, C);
+}
+
+int nn_tensorGemm_computeDfactA(nn_tensorGemm_t* self,
+                                vkk_hazard_e hazard,
+                                uint32_t bs,
+                                vkk_buffer_t* sb_bs,
+                                vkk_buffer_t* A,
+                                vkk_buffer_t* YA,
+                                vkk_buffer_t* B,
+                                vkk_buffer_t* C)
+{
+	ASSERT(self);
+	ASSERT(sb_bs);
+	ASSERT(A);
+	ASSERT(YA);
+	ASSERT(B);
+	ASSERT(C);
+
+	return nn_tensorGemm_computeFn(self, hazard, bs, sb_bs,
+	                               A, YA, B, NULL, C);
 }
 
 nn_tensor_t*
@@ -715,15 +1260,36 @@ nn_tensor_new(nn_engine_t* engine, nn_dim_t* dim,
 		return NULL;
 	}
 
+	// the CPU backend stores FP32
+	if((mode == NN_TENSOR_MODE_COMPUTE_FP16) && engine->cpu)
+	{
+		mode = NN_TENSOR_MODE_COMPUTE;
+	}
+
 	self->engine = engine;
 	self->mode   = mode;
 
 	nn_dim_copy(dim, &self->dim);
 
-	vkk_updateMode_e um;
-	um = vkk_compute_updateMode(engine->compute);
+	if(mode == NN_TENSOR_MODE_NONE)
+	{
+		// the CPU backend does not require sb_dim
+		if(engine->cpu)
+		{
+			return self;
+		}
+
+		self->sb_dim = nn_engine_getDim(engine, dim);
+		if(self->sb_dim == NULL)
+		{
+			goto fail_data;
+		}
 
-	if(mode == NN_TENSOR_MODE_COMPUTE)
+		// sb_data is owned by the Null tensor
+		self->sb_data = engine->Null->sb_data;
+		self->alias   = 1;
+	}
+	else if(mode == NN_TENSOR_MODE_COMPUTE)
 	{
 		nn_tensor_t* tmp;
 		tmp = nn_tensor_new(engine, dim, init,
@@ -733,10 +1299,20 @@ nn_tensor_new(nn_engine_t* engine, nn_dim_t* dim,
 			goto fail_data;
 		}
 
-		self->sb_dim = vkk_buffer_new(engine->engine, um,
-		                              VKK_BUFFER_USAGE_STORAGE,
-		                              sizeof(nn_dim_t),
-		                              dim);
+		// the CPU backend keeps the data in host memory
+		if(engine->cpu)
+		{
+			self->data = tmp->data;
+			tmp->data  = NULL;
+			nn_tensor_delete(&tmp);
+			return self;
+		}
+
+		vkk_updateMode_e um;
+		um = vkk_compute_updateMode(engine->compute);
+
+		// tensors of the same dimensions share sb_dim
+		self->sb_dim = nn_engine_getDim(engine, dim);
 		if(self->sb_dim == NULL)
 		{
 			nn_tensor_delete(&tmp);
@@ -749,7 +1325,7 @@ nn_tensor_new(nn_engine_t* engine, nn_dim_t* dim,
 		                               tmp->data);
 		if(self->sb_data == NULL)
 		{
-			vkk_buffer_delete(&self->sb_dim);
+			nn_engine_putDim(engine, dim, &self->sb_dim);
 			nn_tensor_delete(&tmp);
 			goto fail_data;
 		}
@@ -760,7 +1336,7 @@ nn_tensor_new(nn_engine_t* engine, nn_dim_t* dim,
 		if(self->us0 == NULL)
 		{
 			vkk_buffer_delete(&self->sb_data);
-			vkk_buffer_delete(&self->sb_dim);
+			nn_engine_putDim(engine, dim, &self->sb_dim);
 			nn_tensor_delete(&tmp);
 			goto fail_data;
 		}
@@ -781,12 +1357,37 @@ nn_tensor_new(nn_engine_t* engine, nn_dim_t* dim,
 			},
 		};
 
-		vkk_compute_updateUniformSetRefs(engine->compute,
-		                                 self->us0, 2,
-		                                 ua0_array);
+		nn_engine_computeUpdateUniformSetRefs(engine,
+		                                      self->us0, 2,
+		                                      ua0_array);
 
 		nn_tensor_delete(&tmp);
 	}
+	else if(mode == NN_TENSOR_MODE_COMPUTE_FP16)
+	{
+		vkk_updateMode_e um;
+		um = vkk_compute_updateMode(engine->compute);
+
+		self->sb_dim = nn_engine_getDim(engine, dim);
+		if(self->sb_dim == NULL)
+		{
+			goto fail_data;
+		}
+
+		// each (n,i,j) row stores (depth + 1)/2 packed pairs
+		// and the data is initialized by the owner
+		size_t size = ((size_t) dim->count)*dim->height*
+		              dim->width*((dim->depth + 1)/2)*
+		              sizeof(uint32_t);
+		self->sb_data = vkk_buffer_new(engine->engine, um,
+		                               VKK_BUFFER_USAGE_STORAGE,
+		                               size, NULL);
+		if(self->sb_data == NULL)
+		{
+			nn_engine_putDim(engine, dim, &self->sb_dim);
+			goto fail_data;
+		}
+	}
 	else
 	{
 		self->data = (float*)
@@ -830,8 +1431,21 @@ void nn_tensor_delete(nn_tensor_t** _self)
 		vkk_buffer_delete(&self->sb101_data_v1);
 		vkk_buffer_delete(&self->sb100_data_u1);
 		vkk_uniformSet_delete(&self->us0);
-		vkk_buffer_delete(&self->sb_data);
-		vkk_buffer_delete(&self->sb_dim);
+		if(self->alias == 0)
+		{
+			nn_engine_flushTensorOpUs0(self->engine,
+			                           self->sb_data);
+			vkk_buffer_delete(&self->sb_data);
+		}
+		if(self->sb_dim)
+		{
+			nn_engine_putDim(self->engine, &self->dim,
+			                 &self->sb_dim);
+		}
+		FREE(self->data_v2);
+		FREE(self->data_u2);
+		FREE(self->data_v1);
+		FREE(self->data_u1);
 		FREE(self->data);
 		FREE(self);
 		*_self = NULL;
@@ -849,6 +1463,17 @@ int nn_tensor_import(nn_tensor_t* self, cc_jsmnVal_t* val)
 		return 0;
 	}
 
+	// placeholders discard the data
+	if(self->mode == NN_TENSOR_MODE_NONE)
+	{
+		return 1;
+	}
+	else if(self->mode == NN_TENSOR_MODE_COMPUTE_FP16)
+	{
+		LOGE("invalid mode=%i", self->mode);
+		return 0;
+	}
+
 	cc_jsmnVal_t* val_dim  = NULL;
 	cc_jsmnVal_t* val_data = NULL;
 	cc_jsmnVal_t* val_norm = NULL;
@@ -950,6 +1575,34 @@ int nn_tensor_import(nn_tensor_t* self, cc_jsmnVal_t* val)
 			return 0;
 		}
 
+		nn_dim_t* dimW = &self->dim;
+		uint32_t  fc   = dimW->count;
+		uint32_t  fh   = dimW->height;
+		uint32_t  fw   = dimW->width;
+		uint32_t  xd   = dimW->depth;
+		if(self->engine->cpu)
+		{
+			// u2 and v2 are only used by BSSN
+			if((nn_tensor_importArray(val_u1, self->data_u1,
+			                          fc) == 0) ||
+			   (nn_tensor_importArray(val_v1, self->data_v1,
+			                          fh*fw*xd) == 0))
+			{
+				return 0;
+			}
+
+			if(self->data_u2 &&
+			   ((nn_tensor_importArray(val_u2, self->data_u2,
+			                           xd) == 0) ||
+			    (nn_tensor_importArray(val_v2, self->data_v2,
+			                           fc*fh*fw) == 0)))
+			{
+				return 0;
+			}
+
+			return 1;
+		}
+
 		if((nn_tensor_importStorage(self, val_u1,
 		                            self->sb100_data_u1) == 0) ||
 		   (nn_tensor_importStorage(self, val_v1,
@@ -972,6 +1625,13 @@ int nn_tensor_export(nn_tensor_t* self,
 	ASSERT(self);
 	ASSERT(stream);
 
+	if((self->mode == NN_TENSOR_MODE_NONE) ||
+	   (self->mode == NN_TENSOR_MODE_COMPUTE_FP16))
+	{
+		LOGE("invalid mode=%i", self->mode);
+		return 0;
+	}
+
 	nn_dim_t* dim = nn_tensor_dim(self);
 
 	const char* norm_array[NN_TENSOR_NORM_COUNT] =
@@ -987,15 +1647,42 @@ int nn_tensor_export(nn_tensor_t* self,
 	ret &= nn_dim_export(dim, stream);
 	if(self->mode == NN_TENSOR_MODE_IO)
 	{
-		ret &= cc_jsmnStream_key(stream, "%s", "data");
-		ret &= cc_jsmnStream_beginArray(stream);
+		ret &= nn_tensor_exportArray(stream, "data", self->data,
+		                             nn_dim_sizeElements(dim));
+	}
+	else if(self->engine->cpu)
+	{
+		ret &= nn_tensor_exportArray(stream, "data", self->data,
+		                             nn_dim_sizeElements(dim));
 
-		uint32_t i;
-		for(i = 0; i < nn_dim_sizeElements(dim); ++i)
+		if(self->norm)
 		{
-			ret &= cc_jsmnStream_float(stream, self->data[i]);
+			uint32_t fc = dim->count;
+			uint32_t fh = dim->height;
+			uint32_t fw = dim->width;
+			uint32_t xd = dim->depth;
+
+			// u2 and v2 are empty for SN
+			uint32_t u2_count = 0;
+			uint32_t v2_count = 0;
+			if(self->norm == NN_TENSOR_NORM_BSSN)
+			{
+				u2_count = xd;
+				v2_count = fc*fh*fw;
+			}
+
+			ret &= cc_jsmnStream_key(stream, "%s", "norm");
+			ret &= cc_jsmnStream_string(stream, "%s",
+			                            norm_array[self->norm]);
+			ret &= nn_tensor_exportArray(stream, "u1",
+			                             self->data_u1, fc);
+			ret &= nn_tensor_exportArray(stream, "v1",
+			                             self->data_v1, fh*fw*xd);
+			ret &= nn_tensor_exportArray(stream, "u2",
+			                             self->data_u2, u2_count);
+			ret &= nn_tensor_exportArray(stream, "v2",
+			                             self->data_v2, v2_count);
 		}
-		ret &= cc_jsmnStream_end(stream);
 	}
 	else
 	{
@@ -1045,6 +1732,15 @@ int nn_tensor_copy(nn_tensor_t* X,
 	ASSERT(X);
 	ASSERT(Y);
 
+	if((X->mode == NN_TENSOR_MODE_NONE)         ||
+	   (Y->mode == NN_TENSOR_MODE_NONE)         ||
+	   (X->mode == NN_TENSOR_MODE_COMPUTE_FP16) ||
+	   (Y->mode == NN_TENSOR_MODE_COMPUTE_FP16))
+	{
+		LOGE("invalid mode=%i:%i", X->mode, Y->mode);
+		return 0;
+	}
+
 	nn_dim_t* dimX = nn_tensor_dim(X);
 	nn_dim_t* dimY = nn_tensor_dim(Y);
 
@@ -1084,7 +1780,13 @@ int nn_tensor_copy(nn_tensor_t* X,
 	}
 
 	size_t size = count*x_stride;
-	if((X->mode == NN_TENSOR_MODE_IO) &&
+	if(X->engine->cpu)
+	{
+		// the CPU backend keeps compute tensors in host memory
+		memcpy(&Y->data[yn*nn_dim_strideElements(dimY)],
+		       &X->data[xn*nn_dim_strideElements(dimX)], size);
+	}
+	else if((X->mode == NN_TENSOR_MODE_IO) &&
 	   (Y->mode == NN_TENSOR_MODE_COMPUTE))
 	{
 		vkk_buffer_writeStorage(Y->sb_data, yn, size,
@@ -1391,7 +2093,7 @@ int nn_tensor_computeFill(nn_tensor_t* self,
 		return 0;
 	}
 
-	if(vkk_compute_active(engine->compute) == 0)
+	if(nn_engine_computeActive(engine) == 0)
 	{
 		LOGE("invalid");
 		return 0;
@@ -1405,15 +2107,28 @@ int nn_tensor_computeFill(nn_tensor_t* self,
 		return 0;
 	}
 
+	if(engine->cpu)
+	{
+		uint32_t stride = nn_dim_strideElements(dim);
+		float*   data   = &self->data[n*stride];
+
+		uint32_t i;
+		for(i = 0; i < count*stride; ++i)
+		{
+			data[i] = value;
+		}
+		return 1;
+	}
+
 	nn_tensorValue_t data =
 	{
 		.f32 = value,
 	};
 
 	size_t bytes = nn_dim_strideBytes(dim);
-	vkk_compute_fillStorage(engine->compute, hazard,
-	                        self->sb_data, n*bytes,
-	                        count*bytes, data.u32);
+	nn_engine_computeFillStorage(engine, hazard,
+	                             self->sb_data, n*bytes,
+	                             count*bytes, data.u32);
 
 	return 1;
 }
@@ -1438,7 +2153,7 @@ int nn_tensor_computeCopy(nn_tensor_t* X,
 		return 0;
 	}
 
-	if(vkk_compute_active(engine->compute) == 0)
+	if(nn_engine_computeActive(engine) == 0)
 	{
 		LOGE("invalid");
 		return 0;
@@ -1462,11 +2177,19 @@ int nn_tensor_computeCopy(nn_tensor_t* X,
 		return 0;
 	}
 
+	if(engine->cpu)
+	{
+		uint32_t stride = nn_dim_strideElements(dimX);
+		memmove(&Y->data[yn*stride], &X->data[xn*stride],
+		        count*x_stride);
+		return 1;
+	}
+
 	size_t bytes = nn_dim_strideBytes(dimX);
-	vkk_compute_copyStorage(engine->compute, hazard,
-	                        X->sb_data, Y->sb_data,
-	                        xn*bytes, yn*bytes,
-	                        count*bytes);
+	nn_engine_computeCopyStorage(engine, hazard,
+	                             X->sb_data, Y->sb_data,
+	                             xn*bytes, yn*bytes,
+	                             count*bytes);
 
 	return 1;
 }
@@ -1493,7 +2216,7 @@ int nn_tensor_computeFillOp(nn_tensor_t* self,
 		return 0;
 	}
 
-	if(vkk_compute_active(engine->compute) == 0)
+	if(nn_engine_computeActive(engine) == 0)
 	{
 		LOGE("invalid");
 		return 0;
@@ -1536,6 +2259,13 @@ int nn_tensor_computeFillOp(nn_tensor_t* self,
 		.value  = value,
 	};
 
+	if(engine->cpu)
+	{
+		nn_tensor_cpuOp(NN_TENSOR_OP_FILL, self, NULL, NULL,
+		                &idx);
+		return 1;
+	}
+
 	vkk_uniformSet_t* us0;
 	us0 = nn_engine_getTensorOpUs0(engine, self, NULL, NULL,
 	                               &idx);
@@ -1551,13 +2281,14 @@ int nn_tensor_computeFillOp(nn_tensor_t* self,
 
 	// dispatch(hazard, count, height, width, 1, 8, 8)
 	vkk_computePipeline_t* cp;
-	cp = engine->cp_tensor_computeFillOp;
+	cp = nn_engine_getPipeline(engine,
+	                           &engine->cp_tensor_computeFillOp);
 	if(nn_engine_computeBind(engine, cp) == 0)
 	{
 		return 0;
 	}
-	vkk_compute_bindUniformSets(engine->compute, 1,
-	                            us_array);
+	nn_engine_computeBindUniformSets(engine, 1,
+	                                 us_array);
 	nn_engine_computeDispatch(engine, hazard,
 	                          count, height, width,
 	                          1, 8, 8);
@@ -1593,7 +2324,7 @@ int nn_tensor_computeCopyOp(nn_tensor_t* X,
 		return 0;
 	}
 
-	if(vkk_compute_active(engine->compute) == 0)
+	if(nn_engine_computeActive(engine) == 0)
 	{
 		LOGE("invalid");
 		return 0;
@@ -1650,6 +2381,13 @@ int nn_tensor_computeCopyOp(nn_tensor_t* X,
 		.depth  = depth,
 	};
 
+	if(engine->cpu)
+	{
+		nn_tensor_cpuOp(NN_TENSOR_OP_COPY, X, NULL, Y,
+		                &idx);
+		return 1;
+	}
+
 	vkk_uniformSet_t* us0;
 	us0 = nn_engine_getTensorOpUs0(engine, X, NULL, Y, &idx);
 	if(us0 == NULL)
@@ -1664,13 +2402,14 @@ int nn_tensor_computeCopyOp(nn_tensor_t* X,
 
 	// dispatch(hazard, count, height, width, 1, 8, 8)
 	vkk_computePipeline_t* cp;
-	cp = engine->cp_tensor_computeCopyOp;
+	cp = nn_engine_getPipeline(engine,
+	                           &engine->cp_tensor_computeCopyOp);
 	if(nn_engine_computeBind(engine, cp) == 0)
 	{
 		return 0;
 	}
-	vkk_compute_bindUniformSets(engine->compute, 1,
-	                            us_array);
+	nn_engine_computeBindUniformSets(engine, 1,
+	                                 us_array);
 	nn_engine_computeDispatch(engine, hazard,
 	                          count, height, width,
 	                          1, 8, 8);
@@ -1714,7 +2453,7 @@ int nn_tensor_computeAddOp(nn_tensor_t* X1,
 		return 0;
 	}
 
-	if(vkk_compute_active(engine->compute) == 0)
+	if(nn_engine_computeActive(engine) == 0)
 	{
 		LOGE("invalid");
 		return 0;
@@ -1784,6 +2523,13 @@ int nn_tensor_computeAddOp(nn_tensor_t* X1,
 		.depth  = depth,
 	};
 
+	if(engine->cpu)
+	{
+		nn_tensor_cpuOp(NN_TENSOR_OP_ADD, X1, X2, Y,
+		                &idx);
+		return 1;
+	}
+
 	vkk_uniformSet_t* us0;
 	us0 = nn_engine_getTensorOpUs0(engine, X1, X2, Y, &idx);
 	if(us0 == NULL)
@@ -1798,13 +2544,14 @@ int nn_tensor_computeAddOp(nn_tensor_t* X1,
 
 	// dispatch(hazard, count, height, width, 1, 8, 8)
 	vkk_computePipeline_t* cp;
-	cp = engine->cp_tensor_computeAddOp;
+	cp = nn_engine_getPipeline(engine,
+	                           &engine->cp_tensor_computeAddOp);
 	if(nn_engine_computeBind(engine, cp) == 0)
 	{
 		return 0;
 	}
-	vkk_compute_bindUniformSets(engine->compute, 1,
-	                            us_array);
+	nn_engine_computeBindUniformSets(engine, 1,
+	                                 us_array);
 	nn_engine_computeDispatch(engine, hazard,
 	                          count, height, width,
 	                          1, 8, 8);
@@ -1849,7 +2596,7 @@ int nn_tensor_computeMixOp(nn_tensor_t* X1,
 		return 0;
 	}
 
-	if(vkk_compute_active(engine->compute) == 0)
+	if(nn_engine_computeActive(engine) == 0)
 	{
 		LOGE("invalid");
 		return 0;
@@ -1924,6 +2671,13 @@ int nn_tensor_computeMixOp(nn_tensor_t* X1,
 		.value  = value,
 	};
 
+	if(engine->cpu)
+	{
+		nn_tensor_cpuOp(NN_TENSOR_OP_MIX, X1, X2, Y,
+		                &idx);
+		return 1;
+	}
+
 	vkk_uniformSet_t* us0;
 	us0 = nn_engine_getTensorOpUs0(engine, X1, X2, Y, &idx);
 	if(us0 == NULL)
@@ -1938,13 +2692,14 @@ int nn_tensor_computeMixOp(nn_tensor_t* X1,
 
 	// dispatch(hazard, count, height, width, 1, 8, 8)
 	vkk_computePipeline_t* cp;
-	cp = engine->cp_tensor_computeMixOp;
+	cp = nn_engine_getPipeline(engine,
+	                           &engine->cp_tensor_computeMixOp);
 	if(nn_engine_computeBind(engine, cp) == 0)
 	{
 		return 0;
 	}
-	vkk_compute_bindUniformSets(engine->compute, 1,
-	                            us_array);
+	nn_engine_computeBindUniformSets(engine, 1,
+	                                 us_array);
 	nn_engine_computeDispatch(engine, hazard,
 	                          count, height, width,
 	                          1, 8, 8);
@@ -1974,7 +2729,7 @@ int nn_tensor_computeMulOp(nn_tensor_t* X,
 		return 0;
 	}
 
-	if(vkk_compute_active(engine->compute) == 0)
+	if(nn_engine_computeActive(engine) == 0)
 	{
 		LOGE("invalid");
 		return 0;
@@ -2019,6 +2774,13 @@ int nn_tensor_computeMulOp(nn_tensor_t* X,
 		.value  = value,
 	};
 
+	if(engine->cpu)
+	{
+		nn_tensor_cpuOp(NN_TENSOR_OP_MUL, X, NULL, NULL,
+		                &idx);
+		return 1;
+	}
+
 	vkk_uniformSet_t* us0;
 	us0 = nn_engine_getTensorOpUs0(engine, X, NULL, NULL, &idx);
 	if(us0 == NULL)
@@ -2033,13 +2795,14 @@ int nn_tensor_computeMulOp(nn_tensor_t* X,
 
 	// dispatch(hazard, count, height, width, 1, 8, 8)
 	vkk_computePipeline_t* cp;
-	cp = engine->cp_tensor_computeMulOp;
+	cp = nn_engine_getPipeline(engine,
+	                           &engine->cp_tensor_computeMulOp);
 	if(nn_engine_computeBind(engine, cp) == 0)
 	{
 		return 0;
 	}
-	vkk_compute_bindUniformSets(engine->compute, 1,
-	                            us_array);
+	nn_engine_computeBindUniformSets(engine, 1,
+	                                 us_array);
 	nn_engine_computeDispatch(engine, hazard,
 	                          count, height, width,
 	                          1, 8, 8);
@@ -2077,7 +2840,7 @@ int nn_tensor_computeScaleOp(nn_tensor_t* X,
 		return 0;
 	}
 
-	if(vkk_compute_active(engine->compute) == 0)
+	if(nn_engine_computeActive(engine) == 0)
 	{
 		LOGE("invalid");
 		return 0;
@@ -2135,6 +2898,13 @@ int nn_tensor_computeScaleOp(nn_tensor_t* X,
 		.value  = value,
 	};
 
+	if(engine->cpu)
+	{
+		nn_tensor_cpuOp(NN_TENSOR_OP_SCALE, X, NULL, Y,
+		                &idx);
+		return 1;
+	}
+
 	vkk_uniformSet_t* us0;
 	us0 = nn_engine_getTensorOpUs0(engine, X, NULL, Y, &idx);
 	if(us0 == NULL)
@@ -2149,13 +2919,14 @@ int nn_tensor_computeScaleOp(nn_tensor_t* X,
 
 	// dispatch(hazard, count, height, width, 1, 8, 8)
 	vkk_computePipeline_t* cp;
-	cp = engine->cp_tensor_computeScaleOp;
+	cp = nn_engine_getPipeline(engine,
+	                           &engine->cp_tensor_computeScaleOp);
 	if(nn_engine_computeBind(engine, cp) == 0)
 	{
 		return 0;
 	}
-	vkk_compute_bindUniformSets(engine->compute, 1,
-	                            us_array);
+	nn_engine_computeBindUniformSets(engine, 1,
+	                                 us_array);
 	nn_engine_computeDispatch(engine, hazard,
 	                          count, height, width,
 	                          1, 8, 8);
@@ -2200,7 +2971,7 @@ int nn_tensor_computeScaleAddOp(nn_tensor_t* X1,
 		return 0;
 	}
 
-	if(vkk_compute_active(engine->compute) == 0)
+	if(nn_engine_computeActive(engine) == 0)
 	{
 		LOGE("invalid");
 		return 0;
@@ -2271,6 +3042,13 @@ int nn_tensor_computeScaleAddOp(nn_tensor_t* X1,
 		.value  = value,
 	};
 
+	if(engine->cpu)
+	{
+		nn_tensor_cpuOp(NN_TENSOR_OP_SCALEADD, X1, X2, Y,
+		                &idx);
+		return 1;
+	}
+
 	vkk_uniformSet_t* us0;
 	us0 = nn_engine_getTensorOpUs0(engine, X1, X2, Y, &idx);
 	if(us0 == NULL)
@@ -2285,13 +3063,14 @@ int nn_tensor_computeScaleAddOp(nn_tensor_t* X1,
 
 	// dispatch(hazard, count, height, width, 1, 8, 8)
 	vkk_computePipeline_t* cp;
-	cp = engine->cp_tensor_computeScaleAddOp;
+	cp = nn_engine_getPipeline(engine,
+	                           &engine->cp_tensor_computeScaleAddOp);
 	if(nn_engine_computeBind(engine, cp) == 0)
 	{
 		return 0;
 	}
-	vkk_compute_bindUniformSets(engine->compute, 1,
-	                            us_array);
+	nn_engine_computeBindUniformSets(engine, 1,
+	                                 us_array);
 	nn_engine_computeDispatch(engine, hazard,
 	                          count, height, width,
 	                          1, 8, 8);
@@ -2314,7 +3093,7 @@ int nn_tensor_computeNormalize(nn_tensor_t* self,
 		return 0;
 	}
 
-	if(vkk_compute_active(engine->compute) == 0)
+	if(nn_engine_computeActive(engine) == 0)
 	{
 		LOGE("invalid");
 		return 0;
@@ -2325,6 +3104,12 @@ int nn_tensor_computeNormalize(nn_tensor_t* self,
 		return 0;
 	}
 
+	if(engine->cpu)
+	{
+		nn_tensor_cpuNormalize(self, norm);
+		return 1;
+	}
+
 	// sb100: u1
 	// sb101: v1
 	// sb102: u2 (optional)
@@ -2368,21 +3153,27 @@ int nn_tensor_computeNormalize(nn_tensor_t* self,
 	};
 
 	// dispatch(hazard, 1, 1, 1, 64, 1, 1)
-	vkk_computePipeline_t* cp = engine->cp_tensor_sn;
+	vkk_computePipeline_t* cp;
 	if(norm == NN_TENSOR_NORM_BSSN)
 	{
-		cp = engine->cp_tensor_bssn;
+		cp = nn_engine_getPipeline(engine,
+		                           &engine->cp_tensor_bssn);
+	}
+	else
+	{
+		cp = nn_engine_getPipeline(engine,
+		                           &engine->cp_tensor_sn);
 	}
 
 	if(nn_engine_computeBind(engine, cp) == 0)
 	{
 		return 0;
 	}
-	vkk_compute_updateUniformSetRefs(engine->compute,
-	                                 self->us1_norm, 5,
-	                                 ua1_array);
-	vkk_compute_bindUniformSets(engine->compute, 2,
-	                            us_array);
+	nn_engine_computeUpdateUniformSetRefs(engine,
+	                                      self->us1_norm, 5,
+	                                      ua1_array);
+	nn_engine_computeBindUniformSets(engine, 2,
+	                                 us_array);
 	nn_engine_computeDispatch(engine, hazard,
 	                          1, 1, 1, 64, 1, 1);
 
@@ -2405,7 +3196,7 @@ int nn_tensor_computeStats(nn_tensor_t* self,
 		return 0;
 	}
 
-	if(vkk_compute_active(engine->compute) == 0)
+	if(nn_engine_computeActive(engine) == 0)
 	{
 		LOGE("invalid");
 		return 0;
@@ -2420,6 +3211,12 @@ int nn_tensor_computeStats(nn_tensor_t* self,
 
 	nn_tensorStats_update(stats, count);
 
+	if(engine->cpu)
+	{
+		nn_tensor_cpuStats(self, count, stats);
+		return 1;
+	}
+
 	vkk_uniformSet_t* us_array[] =
 	{
 		self->us0,
@@ -2427,13 +3224,15 @@ int nn_tensor_computeStats(nn_tensor_t* self,
 	};
 
 	// dispatch(hazard, 1, 1, 1, 8, 8, 1)
-	vkk_computePipeline_t* cp = engine->cp_tensor_stats;
+	vkk_computePipeline_t* cp;
+	cp = nn_engine_getPipeline(engine,
+	                           &engine->cp_tensor_stats);
 	if(nn_engine_computeBind(engine, cp) == 0)
 	{
 		return 0;
 	}
-	vkk_compute_bindUniformSets(engine->compute, 2,
-	                            us_array);
+	nn_engine_computeBindUniformSets(engine, 2,
+	                                 us_array);
 	nn_engine_computeDispatch(engine, hazard,
 	                          1, 1, 1, 8, 8, 1);
 
@@ -36,10 +36,18 @@ typedef enum
 	NN_TENSOR_INIT_HE     = 2,
 } nn_tensorInit_e;
 
+// NONE is a placeholder which stores the dimensions but no
+// data (e.g. optimizer and gradient state of inference-only
+// layers) and compute bindings reference the Null tensor
+// COMPUTE_FP16 stores the data as packed FP16 pairs along
+// the depth (e.g. layer private activations) which may only
+// be accessed by the kernels of the owner (see nn_arch_fp16)
 typedef enum
 {
-	NN_TENSOR_MODE_IO      = 0,
-	NN_TENSOR_MODE_COMPUTE = 1,
+	NN_TENSOR_MODE_IO           = 0,
+	NN_TENSOR_MODE_COMPUTE      = 1,
+	NN_TENSOR_MODE_NONE         = 2,
+	NN_TENSOR_MODE_COMPUTE_FP16 = 3,
 } nn_tensorMode_e;
 
 // SN:   Spectral Normalization
@@ -85,11 +93,63 @@ nn_tensorOpUs0Data_t* nn_tensorOpUs0Data_new(nn_tensor_t* X1,
                                              nn_tensor_t* Y,
                                              nn_tensorOpUs0Idx_t* idx);
 void                  nn_tensorOpUs0Data_delete(nn_tensorOpUs0Data_t** _self);
-int                   nn_tensorOpUs0Data_update(nn_tensorOpUs0Data_t* self,
-                                                nn_tensor_t* X1,
-                                                nn_tensor_t* X2,
-                                                nn_tensor_t* Y,
-                                                nn_tensorOpUs0Idx_t* idx);
+
+// GEMM
+// C = op(A)*op(B) + bias where op(A) is dim(m,k), op(B) is
+// dim(k,n) and C is dim(m,n) in row-major order. The TRANS
+// flags select A as dim(k,m) and B as dim(n,k) and the BS
+// flags scale m or k by the batch size (e.g. conv rows).
+// The batch count selects independent GEMMs which are
+// packed contiguously in A, B and C (the bias is shared).
+// The FACT bits select an activation function (see
+// nn_factLayerFn_e) which is applied to C and the DFACT_A
+// bits select an activation whose derivative scales A on
+// load (see nn_tensorGemm_computeDfactA).
+#define NN_TENSOR_GEMM_FLAG_TRANS_A 0x01
+#define NN_TENSOR_GEMM_FLAG_TRANS_B 0x02
+#define NN_TENSOR_GEMM_FLAG_BIAS    0x04
+#define NN_TENSOR_GEMM_FLAG_BS_M    0x10
+#define NN_TENSOR_GEMM_FLAG_BS_K    0x20
+#define NN_TENSOR_GEMM_FLAG_FACT(fn) ((((int) (fn)) << 8) & 0xF00)
+#define NN_TENSOR_GEMM_FLAG_DFACT_A(fn) ((((int) (fn)) << 12) & 0xF000)
+
+typedef struct nn_tensorGemm_s
+{
+	nn_engine_t* engine;
+
+	uint32_t batch;
+	uint32_t m;
+	uint32_t n;
+	uint32_t k;
+	int      flags;
+
+	vkk_buffer_t*     sb001_param;
+	vkk_uniformSet_t* us0;
+} nn_tensorGemm_t;
+
+nn_tensorGemm_t* nn_tensorGemm_new(nn_engine_t* engine,
+                                   uint32_t batch,
+                                   uint32_t m,
+                                   uint32_t n,
+                                   uint32_t k,
+                                   int flags);
+void             nn_tensorGemm_delete(nn_tensorGemm_t** _self);
+int              nn_tensorGemm_compute(nn_tensorGemm_t* self,
+                                       vkk_hazard_e hazard,
+                                       uint32_t bs,
+                                       vkk_buffer_t* sb_bs,
+                                       vkk_buffer_t* A,
+                                       vkk_buffer_t* B,
+                                       vkk_buffer_t* bias,
+                                       vkk_buffer_t* C);
+int              nn_tensorGemm_computeDfactA(nn_tensorGemm_t* self,
+                                             vkk_hazard_e hazard,
+                                             uint32_t bs,
+                                             vkk_buffer_t* sb_bs,
+                                             vkk_buffer_t* A,
+                                             vkk_buffer_t* YA,
+                                             vkk_buffer_t* B,
+                                             vkk_buffer_t* C);
 
 typedef struct nn_tensor_s
 {
@@ -100,13 +160,18 @@ typedef struct nn_tensor_s
 	nn_dim_t dim;
 
 	// IO tensor (optional)
+	// compute tensors also store data in host memory when
+	// using the CPU backend
 	float* data;
 
 	// compute tensor (optional)
 	// sb_dim/sb_data index varies by use case
+	// sb_data is owned by another tensor for placeholders
+	// or when aliased by the memory planner (see nn_arch_plan)
 	vkk_buffer_t*     sb_dim;
 	vkk_buffer_t*     sb_data;
 	vkk_uniformSet_t* us0;
+	int               alias;
 
 	// spectral normalization (optional)
 	nn_tensorNorm_e   norm;
@@ -116,6 +181,13 @@ typedef struct nn_tensor_s
 	vkk_buffer_t*     sb103_data_v2;
 	vkk_buffer_t*     sb104_c;
 	vkk_uniformSet_t* us1_norm;
+
+	// spectral normalization for CPU backend (optional)
+	float* data_u1;
+	float* data_v1;
+	float* data_u2;
+	float* data_v2;
+	float  c;
 } nn_tensor_t;
 
 /*
@@ -0,0 +1,561 @@
+/*
+ * Copyright (c) 2023 Jeff Boody
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define LOG_TAG "nn"
+#include "../libcc/cc_log.h"
+#include "../libcc/cc_memory.h"
+#include "nn_cpu.h"
+#include "nn_engine.h"
+#include "nn_tensor.h"
+#include "nn_tensorQ8.h"
+
+typedef struct
+{
+	float    scale_x;
+	uint32_t stride;
+	uint32_t depth;
+	uint32_t groups;
+} nn_tensorQ8Param_t;
+
+/***********************************************************
+* private                                                  *
+***********************************************************/
+
+static nn_tensorQ8_t*
+nn_tensorQ8_alloc(nn_engine_t* engine, nn_dim_t* dimX,
+                  nn_dim_t* dim)
+{
+	ASSERT(engine);
+	ASSERT(dimX);
+	ASSERT(dim);
+
+	if((dim->depth == 0) ||
+	   (dimX->depth%dim->depth))
+	{
+		LOGE("invalid depth=%u:%u", dimX->depth, dim->depth);
+		return NULL;
+	}
+
+	nn_tensorQ8_t* self;
+	self = (nn_tensorQ8_t*) CALLOC(1, sizeof(nn_tensorQ8_t));
+	if(self == NULL)
+	{
+		LOGE("CALLOC failed");
+		return NULL;
+	}
+
+	self->engine = engine;
+	self->depth  = 4*((dim->depth + 3)/4);
+	self->stride = dim->height*dim->width*self->depth;
+	self->groups = dimX->depth/dim->depth;
+	nn_dim_copy(dimX, &self->dimX);
+	nn_dim_copy(dim, &self->dim);
+
+	self->scale_w = (float*) CALLOC(dim->count, sizeof(float));
+	if(self->scale_w == NULL)
+	{
+		LOGE("CALLOC failed");
+		goto fail_scale_w;
+	}
+
+	self->data = (int8_t*)
+	             CALLOC(dim->count, self->stride*sizeof(int8_t));
+	if(self->data == NULL)
+	{
+		LOGE("CALLOC failed");
+		goto fail_data;
+	}
+
+	// success
+	return self;
+
+	// failure
+	fail_data:
+		FREE(self->scale_w);
+	fail_scale_w:
+		FREE(self);
+	return NULL;
+}
+
+static int nn_tensorQ8_upload(nn_tensorQ8_t* self)
+{
+	ASSERT(self);
+
+	nn_engine_t* engine = self->engine;
+
+	// the CPU backend reads data directly
+	if(engine->cpu)
+	{
+		return 1;
+	}
+
+	vkk_updateMode_e um;
+	um = vkk_compute_updateMode(engine->compute);
+
+	uint32_t fc = self->dim.count;
+	self->sb200_Wq = vkk_buffer_new(engine->engine, um,
+	                                VKK_BUFFER_USAGE_STORAGE,
+	                                fc*self->stride*sizeof(int8_t),
+	                                self->data);
+	if(self->sb200_Wq == NULL)
+	{
+		return 0;
+	}
+
+	self->sb201_scale_w = vkk_buffer_new(engine->engine, um,
+	                                     VKK_BUFFER_USAGE_STORAGE,
+	                                     fc*sizeof(float),
+	                                     self->scale_w);
+	if(self->sb201_scale_w == NULL)
+	{
+		goto fail_sb201_scale_w;
+	}
+
+	nn_tensorQ8Param_t param =
+	{
+		.scale_x = self->scale_x,
+		.stride  = self->stride,
+		.depth   = self->depth,
+		.groups  = self->groups,
+	};
+
+	self->sb202_param = vkk_buffer_new(engine->engine, um,
+	                                   VKK_BUFFER_USAGE_STORAGE,
+	                                   sizeof(nn_tensorQ8Param_t),
+	                                   &param);
+	if(self->sb202_param == NULL)
+	{
+		goto fail_sb202_param;
+	}
+
+	// Xq is requantized by each forward pass
+	nn_dim_t* dimX = &self->dimX;
+	size_t    size = dimX->count*dimX->height*dimX->width*
+	                 self->groups*self->depth;
+	self->sb203_Xq = vkk_buffer_new(engine->engine, um,
+	                                VKK_BUFFER_USAGE_STORAGE,
+	                                size, NULL);
+	if(self->sb203_Xq == NULL)
+	{
+		goto fail_sb203_Xq;
+	}
+
+	self->us2 = vkk_uniformSet_new(engine->engine, 2, 0, NULL,
+	                               engine->usf2_tensor_q8);
+	if(self->us2 == NULL)
+	{
+		goto fail_us2;
+	}
+
+	// sb200: Wq
+	// sb201: scale_w
+	// sb202: param (scale_x,stride,depth,groups)
+	// sb203: Xq
+	vkk_uniformAttachment_t ua2_array[] =
+	{
+		{
+			.binding = 0,
+			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
+			.buffer  = self->sb200_Wq,
+		},
+		{
+			.binding = 1,
+			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
+			.buffer  = self->sb201_scale_w,
+		},
+		{
+			.binding = 2,
+			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
+			.buffer  = self->sb202_param,
+		},
+		{
+			.binding = 3,
+			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
+			.buffer  = self->sb203_Xq,
+		},
+	};
+
+	nn_engine_computeUpdateUniformSetRefs(engine,
+	                                      self->us2, 4,
+	                                      ua2_array);
+
+	// success
+	return 1;
+
+	// failure
+	fail_us2:
+		vkk_buffer_delete(&self->sb203_Xq);
+	fail_sb203_Xq:
+		vkk_buffer_delete(&self->sb202_param);
+	fail_sb202_param:
+		vkk_buffer_delete(&self->sb201_scale_w);
+	fail_sb201_scale_w:
+		vkk_buffer_delete(&self->sb200_Wq);
+	return 0;
+}
+
+static int
+nn_tensorQ8_importArray(cc_jsmnVal_t* val, uint32_t count,
+                        float* data_f, int8_t* data_q)
+{
+	ASSERT(val);
+
+	if(val->type != CC_JSMN_TYPE_ARRAY)
+	{
+		LOGE("invalid type=%i", val->type);
+		return 0;
+	}
+
+	uint32_t       i;
+	cc_listIter_t* iter = cc_list_head(val->array->list);
+	for(i = 0; i < count; ++i)
+	{
+		if(iter == NULL)
+		{
+			LOGE("invalid");
+			return 0;
+		}
+
+		cc_jsmnVal_t* elem;
+		elem = (cc_jsmnVal_t*) cc_list_peekIter(iter);
+		if(elem->type != CC_JSMN_TYPE_PRIMITIVE)
+		{
+			LOGE("invalid");
+			return 0;
+		}
+
+		if(data_f)
+		{
+			data_f[i] = strtof(elem->data, NULL);
+		}
+		else
+		{
+			data_q[i] = (int8_t) strtol(elem->data, NULL, 0);
+		}
+
+		iter = cc_list_next(iter);
+	}
+
+	return 1;
+}
+
+/***********************************************************
+* public                                                   *
+***********************************************************/
+
+nn_tensorQ8_t*
+nn_tensorQ8_new(nn_engine_t* engine, nn_dim_t* dimX,
+                nn_tensor_t* W, float xmax)
+{
+	ASSERT(engine);
+	ASSERT(dimX);
+	ASSERT(W);
+
+	if(xmax <= 0.0f)
+	{
+		LOGE("invalid xmax=%f", xmax);
+		return NULL;
+	}
+
+	nn_dim_t* dim = nn_tensor_dim(W);
+
+	nn_tensorQ8_t* self = nn_tensorQ8_alloc(engine, dimX, dim);
+	if(self == NULL)
+	{
+		return NULL;
+	}
+
+	nn_tensor_t* W_io;
+	W_io = nn_tensor_new(engine, dim, NN_TENSOR_INIT_ZERO,
+	                     NN_TENSOR_MODE_IO);
+	if(W_io == NULL)
+	{
+		goto fail_W_io;
+	}
+
+	if(nn_tensor_copy(W, W_io, 0, 0, dim->count) == 0)
+	{
+		goto fail_copy;
+	}
+
+	// symmetric per-channel scales
+	uint32_t n  = dim->height*dim->width*dim->depth;
+	uint32_t fw = dim->width;
+	uint32_t wd = dim->depth;
+	uint32_t f;
+	uint32_t i;
+	uint32_t j;
+	float*   w;
+	float    wmax;
+	for(f = 0; f < dim->count; ++f)
+	{
+		w    = &W_io->data[f*n];
+		wmax = 0.0f;
+		for(i = 0; i < n; ++i)
+		{
+			wmax = fmaxf(wmax, fabsf(w[i]));
+		}
+
+		// an empty filter quantizes to zero
+		self->scale_w[f] = (wmax > 0.0f) ? wmax/127.0f : 1.0f;
+		for(i = 0; i < dim->height; ++i)
+		{
+			for(j = 0; j < fw; ++j)
+			{
+				nn_cpu_quantize(self->scale_w[f],
+				                &w[(i*fw + j)*wd],
+				                nn_tensorQ8_tap(self, f, i, j),
+				                wd);
+			}
+		}
+	}
+	self->scale_x = xmax/127.0f;
+
+	if(nn_tensorQ8_upload(self) == 0)
+	{
+		goto fail_upload;
+	}
+
+	nn_tensor_delete(&W_io);
+
+	// success
+	return self;
+
+	// failure
+	fail_upload:
+	fail_copy:
+		nn_tensor_delete(&W_io);
+	fail_W_io:
+		nn_tensorQ8_delete(&self);
+	return NULL;
+}
+
+void nn_tensorQ8_delete(nn_tensorQ8_t** _self)
+{
+	ASSERT(_self);
+
+	nn_tensorQ8_t* self = *_self;
+	if(self)
+	{
+		vkk_uniformSet_delete(&self->us2);
+		vkk_buffer_delete(&self->sb203_Xq);
+		vkk_buffer_delete(&self->sb202_param);
+		vkk_buffer_delete(&self->sb201_scale_w);
+		vkk_buffer_delete(&self->sb200_Wq);
+		FREE(self->data);
+		FREE(self->scale_w);
+		FREE(self);
+		*_self = NULL;
+	}
+}
+
+nn_tensorQ8_t*
+nn_tensorQ8_import(nn_engine_t* engine, nn_dim_t* dimX,
+                   nn_dim_t* dim, cc_jsmnVal_t* val)
+{
+	ASSERT(engine);
+	ASSERT(dimX);
+	ASSERT(dim);
+	ASSERT(val);
+
+	if(val->type != CC_JSMN_TYPE_OBJECT)
+	{
+		LOGE("invalid");
+		return NULL;
+	}
+
+	cc_jsmnVal_t* val_scale_x = NULL;
+	cc_jsmnVal_t* val_scale_w = NULL;
+	cc_jsmnVal_t* val_Wq      = NULL;
+
+	cc_listIter_t* iter = cc_list_head(val->obj->list);
+	while(iter)
+	{
+		cc_jsmnKeyval_t* kv;
+		kv = (cc_jsmnKeyval_t*) cc_list_peekIter(iter);
+
+		if(kv->val->type == CC_JSMN_TYPE_PRIMITIVE)
+		{
+			if(strcmp(kv->key, "scale_x") == 0)
+			{
+				val_scale_x = kv->val;
+			}
+		}
+		else if(kv->val->type == CC_JSMN_TYPE_ARRAY)
+		{
+			if(strcmp(kv->key, "scale_w") == 0)
+			{
+				val_scale_w = kv->val;
+			}
+			else if(strcmp(kv->key, "Wq") == 0)
+			{
+				val_Wq = kv->val;
+			}
+		}
+
+		iter = cc_list_next(iter);
+	}
+
+	// check for required parameters
+	if((val_scale_x == NULL) ||
+	   (val_scale_w == NULL) ||
+	   (val_Wq      == NULL))
+	{
+		LOGE("invalid");
+		return NULL;
+	}
+
+	nn_tensorQ8_t* self = nn_tensorQ8_alloc(engine, dimX, dim);
+	if(self == NULL)
+	{
+		return NULL;
+	}
+
+	self->scale_x = strtof(val_scale_x->data, NULL);
+	if(nn_tensorQ8_importArray(val_scale_w, dim->count,
+	                           self->scale_w, NULL) == 0)
+	{
+		goto fail_import;
+	}
+
+	// Wq is exported without the tap padding
+	uint32_t n  = dim->height*dim->width*dim->depth;
+	uint32_t fw = dim->width;
+	uint32_t wd = dim->depth;
+	int8_t*  tmp;
+	tmp = (int8_t*) CALLOC(dim->count, n*sizeof(int8_t));
+	if(tmp == NULL)
+	{
+		LOGE("CALLOC failed");
+		goto fail_import;
+	}
+
+	if(nn_tensorQ8_importArray(val_Wq, dim->count*n,
+	                           NULL, tmp) == 0)
+	{
+		goto fail_tmp;
+	}
+
+	uint32_t f;
+	uint32_t i;
+	uint32_t j;
+	for(f = 0; f < dim->count; ++f)
+	{
+		for(i = 0; i < dim->height; ++i)
+		{
+			for(j = 0; j < fw; ++j)
+			{
+				memcpy(nn_tensorQ8_tap(self, f, i, j),
+				       &tmp[f*n + (i*fw + j)*wd],
+				       wd*sizeof(int8_t));
+			}
+		}
+	}
+	FREE(tmp);
+
+	if(nn_tensorQ8_upload(self) == 0)
+	{
+		goto fail_import;
+	}
+
+	// success
+	return self;
+
+	// failure
+	fail_tmp:
+		FREE(tmp);
+	fail_import:
+		nn_tensorQ8_delete(&self);
+	return NULL;
+}
+
+int nn_tensorQ8_export(nn_tensorQ8_t* self,
+                       cc_jsmnStream_t* stream)
+{
+	ASSERT(self);
+	ASSERT(stream);
+
+	nn_dim_t* dim = &self->dim;
+
+	int ret = 1;
+	ret &= cc_jsmnStream_beginObject(stream);
+	ret &= cc_jsmnStream_key(stream, "%s", "scale_x");
+	ret &= cc_jsmnStream_float(stream, self->scale_x);
+	ret &= cc_jsmnStream_key(stream, "%s", "scale_w");
+	ret &= cc_jsmnStream_beginArray(stream);
+
+	uint32_t f;
+	for(f = 0; f < dim->count; ++f)
+	{
+		ret &= cc_jsmnStream_float(stream, self->scale_w[f]);
+	}
+	ret &= cc_jsmnStream_end(stream);
+
+	ret &= cc_jsmnStream_key(stream, "%s", "Wq");
+	ret &= cc_jsmnStream_beginArray(stream);
+
+	uint32_t i;
+	uint32_t j;
+	uint32_t k;
+	int8_t*  q;
+	for(f = 0; f < dim->count; ++f)
+	{
+		for(i = 0; i < dim->height; ++i)
+		{
+			for(j = 0; j < dim->width; ++j)
+			{
+				q = nn_tensorQ8_tap(self, f, i, j);
+				for(k = 0; k < dim->depth; ++k)
+				{
+					ret &= cc_jsmnStream_int(stream, (int) q[k]);
+				}
+			}
+		}
+	}
+	ret &= cc_jsmnStream_end(stream);
+	ret &= cc_jsmnStream_end(stream);
+
+	return ret;
+}
+
+int8_t* nn_tensorQ8_row(nn_tensorQ8_t* self, uint32_t n)
+{
+	ASSERT(self);
+
+	return &self->data[n*self->stride];
+}
+
+int8_t* nn_tensorQ8_tap(nn_tensorQ8_t* self, uint32_t n,
+                        uint32_t i, uint32_t j)
+{
+	ASSERT(self);
+
+	nn_dim_t* dim = &self->dim;
+
+	return &self->data[n*self->stride +
+	                   (i*dim->width + j)*self->depth];
+}
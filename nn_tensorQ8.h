@@ -0,0 +1,85 @@
+/*
+ * Copyright (c) 2023 Jeff Boody
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#ifndef nn_tensorQ8_H
+#define nn_tensorQ8_H
+
+#include "../libcc/jsmn/cc_jsmnStream.h"
+#include "../libcc/jsmn/cc_jsmnWrapper.h"
+#include "../libvkk/vkk.h"
+#include "nn.h"
+#include "nn_dim.h"
+
+// int8 weights with per-channel scales
+// W(n,i,j,k) ~= scale_w[n]*Wq(n,i,j,k)
+// X          ~= scale_x*Xq
+// Wq and Xq are in the range [-127, 127] where Xq is
+// quantized from the FP32 input once per forward pass
+// (see nn_tensorQ8_quantizeX.comp) and the dot product
+// Wq*Xq is accumulated in 32-bit integers
+typedef struct nn_tensorQ8_s
+{
+	nn_engine_t* engine;
+
+	// each filter tap is padded to a multiple of 4 bytes
+	// so that the shaders accumulate packed uints and the
+	// Xq rows are packed to match per tap and group
+	nn_dim_t dimX;   // dim(bs,xh,xw,xd)
+	nn_dim_t dim;    // dim(fc,fh,fw,wd)
+	uint32_t depth;  // bytes per tap
+	uint32_t stride; // bytes per row
+	uint32_t groups; // xd/wd
+	float    scale_x;
+	float*   scale_w; // dim(fc)
+	int8_t*  data;    // dim(fc,stride)
+
+	// sb200: Wq
+	// sb201: scale_w
+	// sb202: param (scale_x,stride,depth,groups)
+	// sb203: Xq
+	vkk_buffer_t*     sb200_Wq;
+	vkk_buffer_t*     sb201_scale_w;
+	vkk_buffer_t*     sb202_param;
+	vkk_buffer_t*     sb203_Xq;
+	vkk_uniformSet_t* us2;
+} nn_tensorQ8_t;
+
+// quantize W given the calibrated max(|X|)
+nn_tensorQ8_t* nn_tensorQ8_new(nn_engine_t* engine,
+                               nn_dim_t* dimX,
+                               nn_tensor_t* W,
+                               float xmax);
+void           nn_tensorQ8_delete(nn_tensorQ8_t** _self);
+nn_tensorQ8_t* nn_tensorQ8_import(nn_engine_t* engine,
+                                  nn_dim_t* dimX,
+                                  nn_dim_t* dim,
+                                  cc_jsmnVal_t* val);
+int            nn_tensorQ8_export(nn_tensorQ8_t* self,
+                                  cc_jsmnStream_t* stream);
+int8_t*        nn_tensorQ8_row(nn_tensorQ8_t* self,
+                               uint32_t n);
+int8_t*        nn_tensorQ8_tap(nn_tensorQ8_t* self,
+                               uint32_t n, uint32_t i,
+                               uint32_t j);
+
+#endif
@@ -65,6 +65,12 @@ nn_tensorStats_t* nn_tensorStats_new(nn_engine_t* engine)
 
 	self->engine = engine;
 
+	// the CPU backend writes data directly
+	if(engine->cpu)
+	{
+		return self;
+	}
+
 	vkk_updateMode_e um;
 	um = vkk_compute_updateMode(engine->compute);
 
@@ -95,9 +101,9 @@ nn_tensorStats_t* nn_tensorStats_new(nn_engine_t* engine)
 		},
 	};
 
-	vkk_compute_updateUniformSetRefs(engine->compute,
-	                                 self->us1, 1,
-	                                 ua1_array);
+	nn_engine_computeUpdateUniformSetRefs(engine,
+	                                      self->us1, 1,
+	                                      ua1_array);
 
 	// success
 	return self;
@@ -130,6 +136,11 @@ void nn_tensorStats_update(nn_tensorStats_t* self,
 	ASSERT(self);
 
 	self->data.count = count;
+	if(self->engine->cpu)
+	{
+		return;
+	}
+
 	vkk_buffer_writeStorage(self->sb100_stats, 0,
 	                        sizeof(nn_tensorStatsData_t),
 	                        &self->data);
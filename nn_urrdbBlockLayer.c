@@ -135,6 +135,66 @@ nn_urrdbBlockLayer_postFn(nn_layer_t* base,
 	nn_layer_post(&self->coder1->base, flags, bs);
 }
 
+static int
+nn_urrdbBlockLayer_freezeFn(nn_layer_t* base)
+{
+	ASSERT(base);
+
+	nn_urrdbBlockLayer_t* self;
+	self = (nn_urrdbBlockLayer_t*) base;
+
+	if(nn_layer_freeze(&self->coder0->base) == 0)
+	{
+		return 0;
+	}
+
+	cc_listIter_t* iter = cc_list_head(self->nodes);
+	while(iter)
+	{
+		nn_layer_t* node;
+		node = (nn_layer_t*) cc_list_peekIter(iter);
+
+		if(nn_layer_freeze(node) == 0)
+		{
+			return 0;
+		}
+
+		iter = cc_list_next(iter);
+	}
+
+	return nn_layer_freeze(&self->coder1->base);
+}
+
+static int
+nn_urrdbBlockLayer_quantizeFn(nn_layer_t* base)
+{
+	ASSERT(base);
+
+	nn_urrdbBlockLayer_t* self;
+	self = (nn_urrdbBlockLayer_t*) base;
+
+	if(nn_layer_quantize(&self->coder0->base) == 0)
+	{
+		return 0;
+	}
+
+	cc_listIter_t* iter = cc_list_head(self->nodes);
+	while(iter)
+	{
+		nn_layer_t* node;
+		node = (nn_layer_t*) cc_list_peekIter(iter);
+
+		if(nn_layer_quantize(node) == 0)
+		{
+			return 0;
+		}
+
+		iter = cc_list_next(iter);
+	}
+
+	return nn_layer_quantize(&self->coder1->base);
+}
+
 static nn_dim_t*
 nn_urrdbBlockLayer_dimXFn(nn_layer_t* base)
 {
@@ -224,6 +284,8 @@ nn_urrdbBlockLayer_new(nn_urrdbLayerInfo_t* info,
 		.post_fn       = nn_urrdbBlockLayer_postFn,
 		.dimX_fn       = nn_urrdbBlockLayer_dimXFn,
 		.dimY_fn       = nn_urrdbBlockLayer_dimYFn,
+		.freeze_fn     = nn_urrdbBlockLayer_freezeFn,
+		.quantize_fn   = nn_urrdbBlockLayer_quantizeFn,
 	};
 
 	nn_urrdbBlockLayer_t* self;
@@ -383,6 +445,8 @@ nn_urrdbBlockLayer_import(nn_arch_t* arch, cc_jsmnVal_t* val)
 		.post_fn       = nn_urrdbBlockLayer_postFn,
 		.dimX_fn       = nn_urrdbBlockLayer_dimXFn,
 		.dimY_fn       = nn_urrdbBlockLayer_dimYFn,
+		.freeze_fn     = nn_urrdbBlockLayer_freezeFn,
+		.quantize_fn   = nn_urrdbBlockLayer_quantizeFn,
 	};
 
 	nn_urrdbBlockLayer_t* self;
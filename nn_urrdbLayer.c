@@ -149,6 +149,68 @@ nn_urrdbLayer_postFn(nn_layer_t* base,
 	nn_layer_post(&self->coder2->base, flags, bs);
 }
 
+static int
+nn_urrdbLayer_freezeFn(nn_layer_t* base)
+{
+	ASSERT(base);
+
+	nn_urrdbLayer_t* self;
+	self = (nn_urrdbLayer_t*) base;
+
+	if(nn_layer_freeze(&self->coder0->base) == 0)
+	{
+		return 0;
+	}
+
+	cc_listIter_t* iter = cc_list_head(self->blocks);
+	while(iter)
+	{
+		nn_layer_t* block;
+		block = (nn_layer_t*) cc_list_peekIter(iter);
+
+		if(nn_layer_freeze(block) == 0)
+		{
+			return 0;
+		}
+
+		iter = cc_list_next(iter);
+	}
+
+	return nn_layer_freeze(&self->coder1->base) &&
+	       nn_layer_freeze(&self->coder2->base);
+}
+
+static int
+nn_urrdbLayer_quantizeFn(nn_layer_t* base)
+{
+	ASSERT(base);
+
+	nn_urrdbLayer_t* self;
+	self = (nn_urrdbLayer_t*) base;
+
+	if(nn_layer_quantize(&self->coder0->base) == 0)
+	{
+		return 0;
+	}
+
+	cc_listIter_t* iter = cc_list_head(self->blocks);
+	while(iter)
+	{
+		nn_layer_t* block;
+		block = (nn_layer_t*) cc_list_peekIter(iter);
+
+		if(nn_layer_quantize(block) == 0)
+		{
+			return 0;
+		}
+
+		iter = cc_list_next(iter);
+	}
+
+	return nn_layer_quantize(&self->coder1->base) &&
+	       nn_layer_quantize(&self->coder2->base);
+}
+
 static nn_dim_t*
 nn_urrdbLayer_dimXFn(nn_layer_t* base)
 {
@@ -234,6 +296,8 @@ nn_urrdbLayer_new(nn_urrdbLayerInfo_t* info)
 		.post_fn       = nn_urrdbLayer_postFn,
 		.dimX_fn       = nn_urrdbLayer_dimXFn,
 		.dimY_fn       = nn_urrdbLayer_dimYFn,
+		.freeze_fn     = nn_urrdbLayer_freezeFn,
+		.quantize_fn   = nn_urrdbLayer_quantizeFn,
 	};
 
 	nn_urrdbLayer_t* self;
@@ -419,6 +483,8 @@ nn_urrdbLayer_import(nn_arch_t* arch, cc_jsmnVal_t* val)
 		.post_fn       = nn_urrdbLayer_postFn,
 		.dimX_fn       = nn_urrdbLayer_dimXFn,
 		.dimY_fn       = nn_urrdbLayer_dimYFn,
+		.freeze_fn     = nn_urrdbLayer_freezeFn,
+		.quantize_fn   = nn_urrdbLayer_quantizeFn,
 	};
 
 	nn_urrdbLayer_t* self;
@@ -93,6 +93,30 @@ nn_urrdbNodeLayer_postFn(nn_layer_t* base,
 	nn_layer_post(&self->coder1->base, flags, bs);
 }
 
+static int
+nn_urrdbNodeLayer_freezeFn(nn_layer_t* base)
+{
+	ASSERT(base);
+
+	nn_urrdbNodeLayer_t* self;
+	self = (nn_urrdbNodeLayer_t*) base;
+
+	return nn_layer_freeze(&self->coder0->base) &&
+	       nn_layer_freeze(&self->coder1->base);
+}
+
+static int
+nn_urrdbNodeLayer_quantizeFn(nn_layer_t* base)
+{
+	ASSERT(base);
+
+	nn_urrdbNodeLayer_t* self;
+	self = (nn_urrdbNodeLayer_t*) base;
+
+	return nn_layer_quantize(&self->coder0->base) &&
+	       nn_layer_quantize(&self->coder1->base);
+}
+
 static nn_dim_t*
 nn_urrdbNodeLayer_dimXFn(nn_layer_t* base)
 {
@@ -132,6 +156,8 @@ nn_urrdbNodeLayer_new(nn_urrdbLayerInfo_t* info,
 		.post_fn       = nn_urrdbNodeLayer_postFn,
 		.dimX_fn       = nn_urrdbNodeLayer_dimXFn,
 		.dimY_fn       = nn_urrdbNodeLayer_dimYFn,
+		.freeze_fn     = nn_urrdbNodeLayer_freezeFn,
+		.quantize_fn   = nn_urrdbNodeLayer_quantizeFn,
 	};
 
 	nn_urrdbNodeLayer_t* self;
@@ -253,6 +279,8 @@ nn_urrdbNodeLayer_import(nn_arch_t* arch,
 		.post_fn       = nn_urrdbNodeLayer_postFn,
 		.dimX_fn       = nn_urrdbNodeLayer_dimXFn,
 		.dimY_fn       = nn_urrdbNodeLayer_dimYFn,
+		.freeze_fn     = nn_urrdbNodeLayer_freezeFn,
+		.quantize_fn   = nn_urrdbNodeLayer_quantizeFn,
 	};
 
 	nn_urrdbNodeLayer_t* self;
@@ -29,8 +29,11 @@
 #include "../libcc/cc_log.h"
 #include "../libcc/cc_memory.h"
 #include "nn_arch.h"
+#include "nn_batchNormLayer.h"
+#include "nn_cpu.h"
 #include "nn_engine.h"
 #include "nn_layer.h"
+#include "nn_tensorQ8.h"
 #include "nn_tensorStats.h"
 #include "nn_tensor.h"
 #include "nn_weightLayer.h"
@@ -42,8 +45,74 @@
 typedef struct
 {
 	uint32_t disable_bias;
+	uint32_t fact_fn;
 } nn_weightLayerParam_t;
 
+// tiled GEMM selection
+// the GEMM computes 64x64 blocks so the direct kernels are
+// faster for narrow layers and small batches
+#define NN_WEIGHT_LAYER_GEMM_MIN_BS 16
+#define NN_WEIGHT_LAYER_GEMM_MIN_NC 32
+#define NN_WEIGHT_LAYER_GEMM_MIN_XD 32
+
+static int
+nn_weightLayer_useGemm(nn_dim_t* dimX, nn_dim_t* dimW,
+                       int flags)
+{
+	ASSERT(dimX);
+	ASSERT(dimW);
+
+	if((flags & NN_WEIGHT_LAYER_FLAG_DISABLE_GEMM) ||
+	   (dimX->count < NN_WEIGHT_LAYER_GEMM_MIN_BS) ||
+	   (dimW->count < NN_WEIGHT_LAYER_GEMM_MIN_NC) ||
+	   (dimW->depth < NN_WEIGHT_LAYER_GEMM_MIN_XD))
+	{
+		return 0;
+	}
+
+	return 1;
+}
+
+static int
+nn_weightLayer_gemmFlagsY(nn_weightLayer_t* self)
+{
+	ASSERT(self);
+
+	// Y = X*W^T + B
+	int flags = NN_TENSOR_GEMM_FLAG_TRANS_B |
+	            NN_TENSOR_GEMM_FLAG_BS_M    |
+	            NN_TENSOR_GEMM_FLAG_FACT(self->fact_fn);
+	if((self->flags & NN_WEIGHT_LAYER_FLAG_DISABLE_BIAS) == 0)
+	{
+		flags |= NN_TENSOR_GEMM_FLAG_BIAS;
+	}
+
+	return flags;
+}
+
+static int
+nn_weightLayer_gemmFlags_dL_dX(nn_weightLayer_t* self)
+{
+	ASSERT(self);
+
+	// dL_dX = dL_dY*W
+	// dL_dY is scaled by dY_dZ on load
+	return NN_TENSOR_GEMM_FLAG_BS_M |
+	       NN_TENSOR_GEMM_FLAG_DFACT_A(self->fact_fn);
+}
+
+static int
+nn_weightLayer_gemmFlags_dL_dW(nn_weightLayer_t* self)
+{
+	ASSERT(self);
+
+	// dL_dW = dL_dY^T*X
+	// dL_dY is scaled by dY_dZ on load
+	return NN_TENSOR_GEMM_FLAG_TRANS_A |
+	       NN_TENSOR_GEMM_FLAG_BS_K    |
+	       NN_TENSOR_GEMM_FLAG_DFACT_A(self->fact_fn);
+}
+
 static nn_tensor_t*
 nn_weightLayer_computeFpFn(nn_layer_t* base,
                            int flags, uint32_t bs,
@@ -103,27 +172,89 @@ nn_weightLayer_computeFpFn(nn_layer_t* base,
 		},
 	};
 
-	vkk_compute_updateUniformSetRefs(engine->compute,
-	                                 self->us1_fp, 3,
-	                                 ua1_array);
+	nn_engine_computeUpdateUniformSetRefs(engine,
+	                                      self->us1_fp, 3,
+	                                      ua1_array);
 
 	vkk_uniformSet_t* us_array[] =
 	{
 		self->us0,
 		self->us1_fp,
+		NULL,
 	};
 
-	// nn_weightLayer_forwardPass
-	// dispatch(RAW, bs, nc, 1, 8, 8, 1)
-	vkk_computePipeline_t* cp;
-	cp = engine->cp_weight_forwardPass;
-	if(nn_engine_computeBind(engine, cp) == 0)
+	if(self->gemm_Y && (self->q8 == NULL))
 	{
-		return NULL;
+		// Y = X*W^T + B
+		vkk_buffer_t* sb_B = NULL;
+		if((self->flags & NN_WEIGHT_LAYER_FLAG_DISABLE_BIAS) == 0)
+		{
+			sb_B = self->B->sb_data;
+		}
+
+		if(nn_tensorGemm_compute(self->gemm_Y, VKK_HAZARD_RAW,
+		                         bs, arch->sb100_bs, X->sb_data,
+		                         self->W->sb_data, sb_B,
+		                         self->Y->sb_data) == 0)
+		{
+			return NULL;
+		}
+	}
+	else
+	{
+		// requantize X once for all nodes
+		// nn_tensorQ8_quantizeX
+		// dispatch(RAW, bs, depth/4, 1, 64, 1, 1)
+		vkk_computePipeline_t* cp;
+		uint32_t               us_count = 2;
+		if(self->q8)
+		{
+			us_array[2] = self->q8->us2;
+			us_count    = 3;
+
+			cp = nn_engine_getPipeline(engine,
+			                           &engine->cp_weight_forwardPassQ8X);
+			if(nn_engine_computeBind(engine, cp) == 0)
+			{
+				return NULL;
+			}
+			nn_engine_computeBindUniformSets(engine, 3, us_array);
+			nn_engine_computeDispatch(engine, VKK_HAZARD_RAW,
+			                          bs, self->q8->depth/4, 1,
+			                          64, 1, 1);
+		}
+
+		// nn_weightLayer_forwardPass
+		// nn_weightLayer_forwardPassQ8
+		// dispatch(RAW, bs, nc, 1, 8, 8, 1)
+		if(self->q8)
+		{
+			cp = nn_engine_getPipeline(engine,
+			                           &engine->cp_weight_forwardPassQ8);
+		}
+		else
+		{
+			cp = nn_engine_getPipeline(engine,
+			                           &engine->cp_weight_forwardPass);
+		}
+		if(nn_engine_computeBind(engine, cp) == 0)
+		{
+			return NULL;
+		}
+		nn_engine_computeBindUniformSets(engine, us_count, us_array);
+		nn_engine_computeDispatch(engine, VKK_HAZARD_RAW,
+		                          bs, nc, 1, 8, 8, 1);
+	}
+
+	// optionally calibrate the int8 input range
+	if(flags & NN_ARCH_FLAG_FP_CALIBRATE)
+	{
+		if(nn_tensor_computeStats(X, VKK_HAZARD_RAW, bs,
+		                          self->stats_X) == 0)
+		{
+			return NULL;
+		}
 	}
-	vkk_compute_bindUniformSets(engine->compute, 2, us_array);
-	nn_engine_computeDispatch(engine, VKK_HAZARD_RAW,
-	                          bs, nc, 1, 8, 8, 1);
 
 	// optionally compute stats
 	if(flags & NN_ARCH_FLAG_FP_STATS)
@@ -141,6 +272,92 @@ nn_weightLayer_computeFpFn(nn_layer_t* base,
 	return self->Y;
 }
 
+static nn_tensor_t*
+nn_weightLayer_computeBpFused(nn_weightLayer_t* self,
+                              int flags, nn_tensor_t* dL_dY)
+{
+	ASSERT(self);
+	ASSERT(dL_dY);
+
+	nn_arch_t*   arch   = self->base.arch;
+	nn_engine_t* engine = arch->engine;
+
+	nn_dim_t* dimW = nn_tensor_dim(self->W);
+	uint32_t  xd   = dimW->depth;
+	uint32_t  nc   = dimW->count;
+
+	// dL_dW is not stored so the parameter update may not
+	// be skipped
+	if(flags & NN_ARCH_FLAG_BP_NOP)
+	{
+		return self->dL_dX;
+	}
+
+	vkk_uniformSet_t* us_array[] =
+	{
+		self->us0,
+		self->us1_bp,
+	};
+
+	// nn_weightLayer_backprop_dL_dWAdam
+	// WAR hazard on W handled by RAW
+	// dispatch(RAW, nc, xd, 1, 8, 8, 1)
+	vkk_computePipeline_t* cp;
+	cp = nn_engine_getPipeline(engine,
+	                           &engine->cp_weight_backprop_dL_dWAdam);
+	if(nn_engine_computeBind(engine, cp) == 0)
+	{
+		return NULL;
+	}
+	nn_engine_computeBindUniformSets(engine, 2, us_array);
+	vkk_buffer_t* read_W[] =
+	{
+		dL_dY->sb_data,
+		self->Y->sb_data,
+		self->X->sb_data,
+	};
+	vkk_buffer_t* write_W[] =
+	{
+		self->W->sb_data,
+		self->MW->sb_data,
+		self->VW->sb_data,
+	};
+	nn_engine_computeAccess(engine, 3, read_W,
+	                        3, write_W);
+	nn_engine_computeDispatch(engine, VKK_HAZARD_RAW,
+	                          nc, xd, 1, 8, 8, 1);
+
+	// nn_weightLayer_backprop_dL_dBAdam
+	// dispatch(RAW, nc, 1, 1, 64, 1, 1)
+	if((self->flags & NN_WEIGHT_LAYER_FLAG_DISABLE_BIAS) == 0)
+	{
+		cp = nn_engine_getPipeline(engine,
+		                           &engine->cp_weight_backprop_dL_dBAdam);
+		if(nn_engine_computeBind(engine, cp) == 0)
+		{
+			return NULL;
+		}
+		nn_engine_computeBindUniformSets(engine, 2, us_array);
+		vkk_buffer_t* read_B[] =
+		{
+			dL_dY->sb_data,
+			self->Y->sb_data,
+		};
+		vkk_buffer_t* write_B[] =
+		{
+			self->B->sb_data,
+			self->MB->sb_data,
+			self->VB->sb_data,
+		};
+		nn_engine_computeAccess(engine, 2, read_B,
+		                        3, write_B);
+		nn_engine_computeDispatch(engine, VKK_HAZARD_RAW,
+		                          nc, 1, 1, 64, 1, 1);
+	}
+
+	return self->dL_dX;
+}
+
 static nn_tensor_t*
 nn_weightLayer_computeBpFn(nn_layer_t* base,
                            int flags, uint32_t bs,
@@ -185,9 +402,9 @@ nn_weightLayer_computeBpFn(nn_layer_t* base,
 		},
 	};
 
-	vkk_compute_updateUniformSetRefs(engine->compute,
-	                                 self->us1_bp, 4,
-	                                 ua1_array);
+	nn_engine_computeUpdateUniformSetRefs(engine,
+	                                      self->us1_bp, 4,
+	                                      ua1_array);
 
 	vkk_uniformSet_t* us_array[] =
 	{
@@ -195,17 +412,49 @@ nn_weightLayer_computeBpFn(nn_layer_t* base,
 		self->us1_bp,
 	};
 
-	// nn_weightLayer_backprop_dL_dX
-	// dispatch(RAW, bs, xd, 1, 8, 8, 1)
+	// dL_dY is scaled by dY_dZ on load for the fused
+	// activation (see NN_TENSOR_GEMM_FLAG_DFACT_A)
 	vkk_computePipeline_t* cp;
-	cp = engine->cp_weight_backprop_dL_dX;
-	if(nn_engine_computeBind(engine, cp) == 0)
+	if(self->gemm_dL_dX)
 	{
-		return NULL;
+		// dL_dX = dL_dY*W
+		if(nn_tensorGemm_computeDfactA(self->gemm_dL_dX,
+		                               VKK_HAZARD_RAW, bs,
+		                               arch->sb100_bs,
+		                               dL_dY->sb_data,
+		                               self->Y->sb_data,
+		                               self->W->sb_data,
+		                               self->dL_dX->sb_data) == 0)
+		{
+			return NULL;
+		}
+	}
+	else
+	{
+		// nn_weightLayer_backprop_dL_dX
+		// dispatch(RAW, bs, xd, 1, 8, 8, 1)
+		cp = nn_engine_getPipeline(engine,
+		                           &engine->cp_weight_backprop_dL_dX);
+		if(nn_engine_computeBind(engine, cp) == 0)
+		{
+			return NULL;
+		}
+		nn_engine_computeBindUniformSets(engine, 2, us_array);
+		vkk_buffer_t* read_dL_dX[] =
+		{
+			dL_dY->sb_data,
+			self->Y->sb_data,
+			self->W->sb_data,
+		};
+		vkk_buffer_t* write_dL_dX[] =
+		{
+			self->dL_dX->sb_data,
+		};
+		nn_engine_computeAccess(engine, 3, read_dL_dX,
+		                        1, write_dL_dX);
+		nn_engine_computeDispatch(engine, VKK_HAZARD_RAW,
+		                          bs, xd, 1, 8, 8, 1);
 	}
-	vkk_compute_bindUniformSets(engine->compute, 2, us_array);
-	nn_engine_computeDispatch(engine, VKK_HAZARD_RAW,
-	                          bs, xd, 1, 8, 8, 1);
 
 	// optionally compute stats
 	if(flags & NN_ARCH_FLAG_BP_STATS)
@@ -217,109 +466,801 @@ nn_weightLayer_computeBpFn(nn_layer_t* base,
 		}
 	}
 
-	// nn_weightLayer_backprop_dL_dW
-	// dispatch(RAW, nc, xd, 1, 8, 8, 1)
-	cp = engine->cp_weight_backprop_dL_dW;
-	if(nn_engine_computeBind(engine, cp) == 0)
-	{
-		return NULL;
-	}
-	nn_engine_computeDispatch(engine, VKK_HAZARD_RAW,
-	                          nc, xd, 1, 8, 8, 1);
+	if(self->fused)
+	{
+		return nn_weightLayer_computeBpFused(self, flags, dL_dY);
+	}
+
+	if(self->gemm_dL_dW)
+	{
+		// dL_dW = dL_dY^T*X
+		if(nn_tensorGemm_computeDfactA(self->gemm_dL_dW,
+		                               VKK_HAZARD_RAW, bs,
+		                               arch->sb100_bs,
+		                               dL_dY->sb_data,
+		                               self->Y->sb_data,
+		                               self->X->sb_data,
+		                               self->dL_dW->sb_data) == 0)
+		{
+			return NULL;
+		}
+	}
+	else
+	{
+		// nn_weightLayer_backprop_dL_dW
+		// dispatch(RAW, nc, xd, 1, 8, 8, 1)
+		cp = nn_engine_getPipeline(engine,
+		                           &engine->cp_weight_backprop_dL_dW);
+		if(nn_engine_computeBind(engine, cp) == 0)
+		{
+			return NULL;
+		}
+		nn_engine_computeBindUniformSets(engine, 2, us_array);
+		vkk_buffer_t* read_dL_dW[] =
+		{
+			dL_dY->sb_data,
+			self->Y->sb_data,
+			self->X->sb_data,
+		};
+		vkk_buffer_t* write_dL_dW[] =
+		{
+			self->dL_dW->sb_data,
+		};
+		nn_engine_computeAccess(engine, 3, read_dL_dW,
+		                        1, write_dL_dW);
+		nn_engine_computeDispatch(engine, VKK_HAZARD_RAW,
+		                          nc, xd, 1, 8, 8, 1);
+	}
+
+	// nn_weightLayer_backprop_dL_dB
+	// RAW hazard handled by nn_weightLayer_backprop_dL_dX
+	// dispatch(RAW, nc, 1, 1, 64, 1, 1)
+	if((self->flags & NN_WEIGHT_LAYER_FLAG_DISABLE_BIAS) == 0)
+	{
+		cp = nn_engine_getPipeline(engine,
+		                           &engine->cp_weight_backprop_dL_dB);
+		if(nn_engine_computeBind(engine, cp) == 0)
+		{
+			return NULL;
+		}
+		nn_engine_computeBindUniformSets(engine, 2, us_array);
+		vkk_buffer_t* read_dL_dB[] =
+		{
+			dL_dY->sb_data,
+			self->Y->sb_data,
+		};
+		vkk_buffer_t* write_dL_dB[] =
+		{
+			self->dL_dB->sb_data,
+		};
+		nn_engine_computeAccess(engine, 2, read_dL_dB,
+		                        1, write_dL_dB);
+		nn_engine_computeDispatch(engine, VKK_HAZARD_RAW,
+		                          nc, 1, 1, 64, 1, 1);
+	}
+
+	// optionally skip parameter update
+	if(flags & NN_ARCH_FLAG_BP_NOP)
+	{
+		return self->dL_dX;
+	}
+
+	// nn_weightLayer_backpropUpdateW
+	// dispatch(RAW, nc, xd, 1, 8, 8, 1)
+	cp = nn_engine_getPipeline(engine,
+	                           &engine->cp_weight_backpropUpdateW);
+	if(nn_engine_computeBind(engine, cp) == 0)
+	{
+		return NULL;
+	}
+	nn_engine_computeBindUniformSets(engine, 2, us_array);
+	vkk_buffer_t* read_W[] =
+	{
+		self->dL_dW->sb_data,
+	};
+	vkk_buffer_t* write_W[] =
+	{
+		self->W->sb_data,
+		self->MW->sb_data,
+		self->VW->sb_data,
+	};
+	nn_engine_computeAccess(engine, 1, read_W,
+	                        3, write_W);
+	nn_engine_computeDispatch(engine, VKK_HAZARD_RAW,
+	                          nc, xd, 1, 8, 8, 1);
+
+	// nn_weightLayer_backpropUpdateB
+	// dispatch(RAW, nc, 1, 1, 64, 1, 1)
+	if((self->flags & NN_WEIGHT_LAYER_FLAG_DISABLE_BIAS) == 0)
+	{
+		cp = nn_engine_getPipeline(engine,
+		                           &engine->cp_weight_backpropUpdateB);
+		if(nn_engine_computeBind(engine, cp) == 0)
+		{
+			return NULL;
+		}
+		vkk_buffer_t* read_B[] =
+		{
+			self->dL_dB->sb_data,
+		};
+		vkk_buffer_t* write_B[] =
+		{
+			self->B->sb_data,
+			self->MB->sb_data,
+			self->VB->sb_data,
+		};
+		nn_engine_computeAccess(engine, 1, read_B,
+		                        3, write_B);
+		nn_engine_computeDispatch(engine, VKK_HAZARD_RAW,
+		                          nc, 1, 1, 64, 1, 1);
+	}
+
+	return self->dL_dX;
+}
+
+typedef struct
+{
+	nn_weightLayer_t* self;
+	nn_tensor_t*      X;
+	nn_tensor_t*      dL_dY;
+	uint32_t          bs;
+} nn_weightLayerTask_t;
+
+static void
+nn_weightLayer_fpCpuTask(void* priv, uint32_t idx)
+{
+	ASSERT(priv);
+
+	nn_weightLayerTask_t* task = (nn_weightLayerTask_t*) priv;
+	nn_weightLayer_t*     self = task->self;
+
+	nn_dim_t* dimW = nn_tensor_dim(self->W);
+	uint32_t  nc   = dimW->count;
+	uint32_t  xd   = dimW->depth;
+	float*    X    = &task->X->data[idx*xd];
+	float*    Y    = &self->Y->data[idx*nc];
+
+	// dispatch(bs)
+	uint32_t n;
+	float    y;
+	for(n = 0; n < nc; ++n)
+	{
+		y = 0.0f;
+		if((self->flags & NN_WEIGHT_LAYER_FLAG_DISABLE_BIAS) == 0)
+		{
+			y = self->B->data[n];
+		}
+
+		y   += nn_cpu_dot(&self->W->data[n*xd], X, xd);
+		Y[n] = nn_factLayer_fact(self->fact_fn, y);
+	}
+}
+
+static void
+nn_weightLayer_fpQ8CpuTask(void* priv, uint32_t idx)
+{
+	ASSERT(priv);
+
+	nn_weightLayerTask_t* task = (nn_weightLayerTask_t*) priv;
+	nn_weightLayer_t*     self = task->self;
+	nn_tensorQ8_t*        q8   = self->q8;
+
+	nn_dim_t* dimW = nn_tensor_dim(self->W);
+	uint32_t  nc   = dimW->count;
+	uint32_t  xd   = dimW->depth;
+	int8_t*   Xq   = &self->q8_X[idx*xd];
+	float*    Y    = &self->Y->data[idx*nc];
+
+	// dispatch(bs)
+	uint32_t n;
+	int32_t  acc;
+	float    y;
+	for(n = 0; n < nc; ++n)
+	{
+		// dequantize
+		acc = nn_cpu_dotQ8(nn_tensorQ8_row(q8, n), Xq, xd);
+		y   = ((float) acc)*q8->scale_x*q8->scale_w[n];
+		if((self->flags & NN_WEIGHT_LAYER_FLAG_DISABLE_BIAS) == 0)
+		{
+			y += self->B->data[n];
+		}
+
+		Y[n] = nn_factLayer_fact(self->fact_fn, y);
+	}
+}
+
+static void
+nn_weightLayer_bpFactCpuTask(void* priv, uint32_t idx)
+{
+	ASSERT(priv);
+
+	nn_weightLayerTask_t* task = (nn_weightLayerTask_t*) priv;
+	nn_weightLayer_t*     self = task->self;
+
+	nn_dim_t* dimW  = nn_tensor_dim(self->W);
+	uint32_t  nc    = dimW->count;
+	float*    Y     = &self->Y->data[idx*nc];
+	float*    dL_dY = &task->dL_dY->data[idx*nc];
+
+	// dispatch(bs)
+	// dL_dY replaced by dL_dY*dY_dZ
+	uint32_t n;
+	for(n = 0; n < nc; ++n)
+	{
+		dL_dY[n] *= nn_factLayer_dfactY(self->fact_fn, Y[n]);
+	}
+}
+
+static void
+nn_weightLayer_bp_dL_dXCpuTask(void* priv, uint32_t idx)
+{
+	ASSERT(priv);
+
+	nn_weightLayerTask_t* task = (nn_weightLayerTask_t*) priv;
+	nn_weightLayer_t*     self = task->self;
+
+	nn_dim_t* dimW  = nn_tensor_dim(self->W);
+	uint32_t  nc    = dimW->count;
+	uint32_t  xd    = dimW->depth;
+	float*    dL_dY = &task->dL_dY->data[idx*nc];
+	float*    dL_dX = &self->dL_dX->data[idx*xd];
+
+	// dispatch(bs)
+	memset(dL_dX, 0, xd*sizeof(float));
+
+	uint32_t n;
+	for(n = 0; n < nc; ++n)
+	{
+		nn_cpu_axpy(dL_dY[n], &self->W->data[n*xd], dL_dX, xd);
+	}
+}
+
+static void
+nn_weightLayer_bp_dL_dWCpuTask(void* priv, uint32_t idx)
+{
+	ASSERT(priv);
+
+	nn_weightLayerTask_t* task = (nn_weightLayerTask_t*) priv;
+	nn_weightLayer_t*     self = task->self;
+
+	nn_dim_t* dimW  = nn_tensor_dim(self->W);
+	uint32_t  nc    = dimW->count;
+	uint32_t  xd    = dimW->depth;
+	float*    dL_dY = task->dL_dY->data;
+	float*    dL_dW = &self->dL_dW->data[idx*xd];
+
+	// dispatch(nc)
+	uint32_t n = idx;
+	memset(dL_dW, 0, xd*sizeof(float));
+
+	uint32_t m;
+	float    dl_db = 0.0f;
+	for(m = 0; m < task->bs; ++m)
+	{
+		nn_cpu_axpy(dL_dY[m*nc + n], &self->X->data[m*xd],
+		            dL_dW, xd);
+		dl_db += dL_dY[m*nc + n];
+	}
+
+	if((self->flags & NN_WEIGHT_LAYER_FLAG_DISABLE_BIAS) == 0)
+	{
+		self->dL_dB->data[n] = dl_db;
+	}
+}
+
+static void
+nn_weightLayer_bpUpdateCpuTask(void* priv, uint32_t idx)
+{
+	ASSERT(priv);
+
+	nn_weightLayerTask_t* task = (nn_weightLayerTask_t*) priv;
+	nn_weightLayer_t*     self = task->self;
+	nn_archState_t*       state;
+	state = &self->base.arch->state;
+
+	nn_dim_t* dimW = nn_tensor_dim(self->W);
+	uint32_t  xd   = dimW->depth;
+
+	// dispatch(nc)
+	uint32_t n = idx;
+
+	nn_cpu_adam(state, &self->W->data[n*xd],
+	            &self->MW->data[n*xd], &self->VW->data[n*xd],
+	            &self->dL_dW->data[n*xd], xd);
+
+	if((self->flags & NN_WEIGHT_LAYER_FLAG_DISABLE_BIAS) == 0)
+	{
+		nn_cpu_adam(state, &self->B->data[n],
+		            &self->MB->data[n], &self->VB->data[n],
+		            &self->dL_dB->data[n], 1);
+	}
+}
+
+static nn_tensor_t*
+nn_weightLayer_computeFpCpuFn(nn_layer_t* base,
+                              int flags, uint32_t bs,
+                              nn_tensor_t* X)
+{
+	ASSERT(base);
+	ASSERT(X);
+
+	nn_weightLayer_t* self   = (nn_weightLayer_t*) base;
+	nn_arch_t*        arch   = base->arch;
+	nn_engine_t*      engine = arch->engine;
+
+	// optionally perform Spectral Normalization
+	if(self->flags & NN_WEIGHT_LAYER_FLAG_NORM_SN)
+	{
+		if(nn_tensor_computeNormalize(self->W,
+		                              VKK_HAZARD_RAW,
+		                              NN_TENSOR_NORM_SN,
+		                              1.0f) == 0)
+		{
+			return NULL;
+		}
+	}
+	else if(self->flags & NN_WEIGHT_LAYER_FLAG_NORM_BSSN)
+	{
+		if(nn_tensor_computeNormalize(self->W,
+		                              VKK_HAZARD_RAW,
+		                              NN_TENSOR_NORM_BSSN,
+		                              1.2f) == 0)
+		{
+			return NULL;
+		}
+	}
+
+	// requantize the input once for all nodes
+	nn_cpuTask_fn fp_fn = nn_weightLayer_fpCpuTask;
+	if(self->q8)
+	{
+		nn_cpu_quantize(self->q8->scale_x, X->data, self->q8_X,
+		                bs*nn_dim_strideElements(nn_tensor_dim(X)));
+		fp_fn = nn_weightLayer_fpQ8CpuTask;
+	}
+
+	nn_weightLayerTask_t task =
+	{
+		.self = self,
+		.X    = X,
+		.bs   = bs,
+	};
+	nn_cpu_run(engine->cpu, fp_fn, &task, bs);
+
+	// optionally calibrate the int8 input range
+	if(flags & NN_ARCH_FLAG_FP_CALIBRATE)
+	{
+		if(nn_tensor_computeStats(X, VKK_HAZARD_RAW, bs,
+		                          self->stats_X) == 0)
+		{
+			return NULL;
+		}
+	}
+
+	// optionally compute stats
+	if(flags & NN_ARCH_FLAG_FP_STATS)
+	{
+		if(nn_tensor_computeStats(self->Y, VKK_HAZARD_RAW, bs,
+		                          self->stats_Y) == 0)
+		{
+			return NULL;
+		}
+	}
+
+	// store reference
+	self->X = X;
+
+	return self->Y;
+}
+
+static nn_tensor_t*
+nn_weightLayer_computeBpCpuFn(nn_layer_t* base,
+                              int flags, uint32_t bs,
+                              nn_tensor_t* dL_dY)
+{
+	ASSERT(base);
+	ASSERT(dL_dY); // dim(bs,1,1,nc)
+
+	nn_weightLayer_t* self   = (nn_weightLayer_t*) base;
+	nn_arch_t*        arch   = base->arch;
+	nn_engine_t*      engine = arch->engine;
+
+	nn_dim_t* dimW = nn_tensor_dim(self->W);
+	uint32_t  nc   = dimW->count;
+
+	nn_weightLayerTask_t task =
+	{
+		.self  = self,
+		.X     = self->X,
+		.dL_dY = dL_dY,
+		.bs    = bs,
+	};
+
+	if(self->fact_fn != NN_FACT_LAYER_FN_LINEAR)
+	{
+		nn_cpu_run(engine->cpu, nn_weightLayer_bpFactCpuTask,
+		           &task, bs);
+	}
+
+	nn_cpu_run(engine->cpu, nn_weightLayer_bp_dL_dXCpuTask,
+	           &task, bs);
+
+	// optionally compute stats
+	if(flags & NN_ARCH_FLAG_BP_STATS)
+	{
+		if(nn_tensor_computeStats(self->dL_dX, VKK_HAZARD_RAW, bs,
+		                          self->stats_dL_dX) == 0)
+		{
+			return NULL;
+		}
+	}
+
+	// dL_dB is computed with dL_dW
+	nn_cpu_run(engine->cpu, nn_weightLayer_bp_dL_dWCpuTask,
+	           &task, nc);
+
+	// optionally skip parameter update
+	if(flags & NN_ARCH_FLAG_BP_NOP)
+	{
+		return self->dL_dX;
+	}
+
+	nn_cpu_run(engine->cpu, nn_weightLayer_bpUpdateCpuTask,
+	           &task, nc);
+
+	return self->dL_dX;
+}
+
+static void
+nn_weightLayer_postFn(nn_layer_t* base,
+                      int flags, uint32_t bs)
+{
+	ASSERT(base);
+
+	nn_weightLayer_t* self = (nn_weightLayer_t*) base;
+
+	if(flags & NN_ARCH_FLAG_FP_CALIBRATE)
+	{
+		float xmin = nn_tensorStats_min(self->stats_X);
+		float xmax = nn_tensorStats_max(self->stats_X);
+		self->q8_xmax = fmaxf(self->q8_xmax, fmaxf(-xmin, xmax));
+	}
+
+	if(flags & NN_ARCH_FLAG_FP_STATS)
+	{
+		LOGI("Y min=%f, max=%f, mean=%f, stddev=%f, norm=%f",
+		     nn_tensorStats_min(self->stats_Y),
+		     nn_tensorStats_max(self->stats_Y),
+		     nn_tensorStats_mean(self->stats_Y),
+		     nn_tensorStats_stddev(self->stats_Y),
+		     nn_tensorStats_norm(self->stats_Y));
+	}
+
+	if(flags & NN_ARCH_FLAG_BP_STATS)
+	{
+		LOGI("dL_dX min=%f, max=%f, mean=%f, stddev=%f, norm=%f",
+		     nn_tensorStats_min(self->stats_dL_dX),
+		     nn_tensorStats_max(self->stats_dL_dX),
+		     nn_tensorStats_mean(self->stats_dL_dX),
+		     nn_tensorStats_stddev(self->stats_dL_dX),
+		     nn_tensorStats_norm(self->stats_dL_dX));
+	}
+}
+
+static int
+nn_weightLayer_bakeNorm(nn_weightLayer_t* self)
+{
+	ASSERT(self);
+
+	nn_arch_t*   arch   = self->base.arch;
+	nn_engine_t* engine = arch->engine;
+
+	// normalize the weights once and disable the per-pass
+	// normalization
+	nn_tensorNorm_e norm = NN_TENSOR_NORM_NONE;
+	float           c    = 1.0f;
+	if(self->flags & NN_WEIGHT_LAYER_FLAG_NORM_SN)
+	{
+		norm = NN_TENSOR_NORM_SN;
+	}
+	else if(self->flags & NN_WEIGHT_LAYER_FLAG_NORM_BSSN)
+	{
+		norm = NN_TENSOR_NORM_BSSN;
+		c    = 1.2f;
+	}
+
+	if(norm == NN_TENSOR_NORM_NONE)
+	{
+		return 1;
+	}
+
+	if(nn_engine_computeBegin(engine) == 0)
+	{
+		return 0;
+	}
+
+	if(nn_tensor_computeNormalize(self->W,
+	                              VKK_HAZARD_RAW,
+	                              norm, c) == 0)
+	{
+		nn_engine_computeEnd(engine);
+		return 0;
+	}
+	nn_engine_computeEnd(engine);
+
+	self->flags &= ~(NN_WEIGHT_LAYER_FLAG_NORM_SN |
+	                 NN_WEIGHT_LAYER_FLAG_NORM_BSSN);
+
+	return 1;
+}
+
+static int
+nn_weightLayer_setQ8(nn_weightLayer_t* self, nn_tensorQ8_t* q8)
+{
+	ASSERT(self);
+	ASSERT(q8);
+
+	nn_arch_t*   arch   = self->base.arch;
+	nn_engine_t* engine = arch->engine;
+
+	// the CPU backend quantizes X prior to the dot products
+	if(engine->cpu)
+	{
+		nn_dim_t* dimX = nn_tensor_dim(self->dL_dX);
+		self->q8_X = (int8_t*)
+		             CALLOC(nn_dim_sizeElements(dimX),
+		                    sizeof(int8_t));
+		if(self->q8_X == NULL)
+		{
+			LOGE("CALLOC failed");
+			return 0;
+		}
+	}
+
+	self->q8 = q8;
+
+	return 1;
+}
+
+static int
+nn_weightLayer_quantizeFn(nn_layer_t* base)
+{
+	ASSERT(base);
+
+	nn_weightLayer_t* self   = (nn_weightLayer_t*) base;
+	nn_arch_t*        arch   = base->arch;
+	nn_engine_t*      engine = arch->engine;
+
+	if(self->q8)
+	{
+		return 1;
+	}
+
+	if(nn_weightLayer_bakeNorm(self) == 0)
+	{
+		return 0;
+	}
+
+	nn_tensorQ8_t* q8;
+	q8 = nn_tensorQ8_new(engine, nn_tensor_dim(self->dL_dX),
+	                     self->W, self->q8_xmax);
+	if(q8 == NULL)
+	{
+		return 0;
+	}
+
+	if(nn_weightLayer_setQ8(self, q8) == 0)
+	{
+		nn_tensorQ8_delete(&q8);
+		return 0;
+	}
+
+	return 1;
+}
+
+static nn_dim_t*
+nn_weightLayer_dimXFn(nn_layer_t* base)
+{
+	ASSERT(base);
+
+	nn_weightLayer_t* self = (nn_weightLayer_t*) base;
+
+	return nn_tensor_dim(self->dL_dX);
+}
+
+static nn_dim_t*
+nn_weightLayer_dimYFn(nn_layer_t* base)
+{
+	ASSERT(base);
+
+	nn_weightLayer_t* self = (nn_weightLayer_t*) base;
+
+	return nn_tensor_dim(self->Y);
+}
+
+static void
+nn_weightLayer_updateUs0(nn_weightLayer_t* self)
+{
+	ASSERT(self);
+
+	nn_engine_t* engine = self->base.arch->engine;
+
+	// sb000: dimX
+	// sb001: dimW
+	// sb002: W
+	// sb003: B
+	// sb004: dimY
+	// sb005: Y
+	// sb006: MW
+	// sb007: VW
+	// sb008: MB
+	// sb009: VB
+	// sb010: dL_dW
+	// sb011: dL_dB
+	// sb012: dL_dX
+	// sb013: param (disable_bias)
+	vkk_uniformAttachment_t ua0_array[] =
+	{
+		{
+			.binding = 0,
+			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
+			.buffer  = self->dL_dX->sb_dim,
+		},
+		{
+			.binding = 1,
+			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
+			.buffer  = self->W->sb_dim,
+		},
+		{
+			.binding = 2,
+			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
+			.buffer  = self->W->sb_data,
+		},
+		{
+			.binding = 3,
+			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
+			.buffer  = self->B->sb_data,
+		},
+		{
+			.binding = 4,
+			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
+			.buffer  = self->Y->sb_dim,
+		},
+		{
+			.binding = 5,
+			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
+			.buffer  = self->Y->sb_data,
+		},
+		{
+			.binding = 6,
+			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
+			.buffer  = self->MW->sb_data,
+		},
+		{
+			.binding = 7,
+			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
+			.buffer  = self->VW->sb_data,
+		},
+		{
+			.binding = 8,
+			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
+			.buffer  = self->MB->sb_data,
+		},
+		{
+			.binding = 9,
+			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
+			.buffer  = self->VB->sb_data,
+		},
+		{
+			.binding = 10,
+			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
+			.buffer  = self->dL_dW->sb_data,
+		},
+		{
+			.binding = 11,
+			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
+			.buffer  = self->dL_dB->sb_data,
+		},
+		{
+			.binding = 12,
+			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
+			.buffer  = self->dL_dX->sb_data,
+		},
+		{
+			.binding = 13,
+			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
+			.buffer  = self->sb013_param,
+		},
+	};
+
+	nn_engine_computeUpdateUniformSetRefs(engine,
+	                                      self->us0, 14,
+	                                      ua0_array);
+}
 
-	// nn_weightLayer_backprop_dL_dB
-	// RAW hazard handled by nn_weightLayer_backprop_dL_dX
-	// dispatch(RAW, nc, 1, 1, 64, 1, 1)
-	if((self->flags & NN_WEIGHT_LAYER_FLAG_DISABLE_BIAS) == 0)
-	{
-		cp = engine->cp_weight_backprop_dL_dB;
-		if(nn_engine_computeBind(engine, cp) == 0)
-		{
-			return NULL;
-		}
-		nn_engine_computeDispatch(engine, VKK_HAZARD_RAW,
-		                          nc, 1, 1, 64, 1, 1);
-	}
+static int
+nn_weightLayer_updateParam(nn_weightLayer_t* self)
+{
+	ASSERT(self);
 
-	// optionally skip parameter update
-	if(flags & NN_ARCH_FLAG_BP_NOP)
+	nn_engine_t* engine = self->base.arch->engine;
+
+	// the CPU backend does not require uniform sets
+	if(engine->cpu)
 	{
-		return self->dL_dX;
+		return 1;
 	}
 
-	// nn_weightLayer_backpropUpdateW
-	// dispatch(RAW, nc, xd, 1, 8, 8, 1)
-	cp = engine->cp_weight_backpropUpdateW;
-	if(nn_engine_computeBind(engine, cp) == 0)
+	nn_weightLayerParam_t param =
 	{
-		return NULL;
+		.disable_bias = (self->flags & NN_WEIGHT_LAYER_FLAG_DISABLE_BIAS) ? 1 : 0,
+		.fact_fn      = (uint32_t) self->fact_fn,
+	};
+	vkk_buffer_t* sb013_param;
+	sb013_param = vkk_buffer_new(engine->engine,
+	                             VKK_UPDATE_MODE_STATIC,
+	                             VKK_BUFFER_USAGE_STORAGE,
+	                             sizeof(nn_weightLayerParam_t),
+	                             &param);
+	if(sb013_param == NULL)
+	{
+		return 0;
 	}
-	nn_engine_computeDispatch(engine, VKK_HAZARD_RAW,
-	                          nc, xd, 1, 8, 8, 1);
 
-	// nn_weightLayer_backpropUpdateB
-	// dispatch(RAW, nc, 1, 1, 64, 1, 1)
-	if((self->flags & NN_WEIGHT_LAYER_FLAG_DISABLE_BIAS) == 0)
+	if(self->gemm_Y)
 	{
-		cp = engine->cp_weight_backpropUpdateB;
-		if(nn_engine_computeBind(engine, cp) == 0)
+		nn_dim_t* dimW = nn_tensor_dim(self->W);
+
+		nn_tensorGemm_t* gemm_Y;
+		gemm_Y = nn_tensorGemm_new(engine, 1, 1, dimW->count,
+		                           dimW->depth,
+		                           nn_weightLayer_gemmFlagsY(self));
+		if(gemm_Y == NULL)
 		{
-			return NULL;
+			vkk_buffer_delete(&sb013_param);
+			return 0;
 		}
-		nn_engine_computeDispatch(engine, VKK_HAZARD_RAW,
-		                          nc, 1, 1, 64, 1, 1);
-	}
-
-	return self->dL_dX;
-}
 
-static void
-nn_weightLayer_postFn(nn_layer_t* base,
-                      int flags, uint32_t bs)
-{
-	ASSERT(base);
-
-	nn_weightLayer_t* self = (nn_weightLayer_t*) base;
-
-	if(flags & NN_ARCH_FLAG_FP_STATS)
-	{
-		LOGI("Y min=%f, max=%f, mean=%f, stddev=%f, norm=%f",
-		     nn_tensorStats_min(self->stats_Y),
-		     nn_tensorStats_max(self->stats_Y),
-		     nn_tensorStats_mean(self->stats_Y),
-		     nn_tensorStats_stddev(self->stats_Y),
-		     nn_tensorStats_norm(self->stats_Y));
+		nn_tensorGemm_delete(&self->gemm_Y);
+		self->gemm_Y = gemm_Y;
 	}
 
-	if(flags & NN_ARCH_FLAG_BP_STATS)
+	if(self->gemm_dL_dX)
 	{
-		LOGI("dL_dX min=%f, max=%f, mean=%f, stddev=%f, norm=%f",
-		     nn_tensorStats_min(self->stats_dL_dX),
-		     nn_tensorStats_max(self->stats_dL_dX),
-		     nn_tensorStats_mean(self->stats_dL_dX),
-		     nn_tensorStats_stddev(self->stats_dL_dX),
-		     nn_tensorStats_norm(self->stats_dL_dX));
-	}
-}
-
-static nn_dim_t*
-nn_weightLayer_dimXFn(nn_layer_t* base)
-{
-	ASSERT(base);
-
-	nn_weightLayer_t* self = (nn_weightLayer_t*) base;
+		nn_dim_t* dimW = nn_tensor_dim(self->W);
+		uint32_t  xd   = dimW->depth;
+		uint32_t  nc   = dimW->count;
+
+		nn_tensorGemm_t* gemm_dL_dX;
+		gemm_dL_dX = nn_tensorGemm_new(engine, 1, 1, xd, nc,
+		                               nn_weightLayer_gemmFlags_dL_dX(self));
+		if(gemm_dL_dX == NULL)
+		{
+			vkk_buffer_delete(&sb013_param);
+			return 0;
+		}
 
-	return nn_tensor_dim(self->dL_dX);
-}
+		nn_tensorGemm_t* gemm_dL_dW;
+		gemm_dL_dW = nn_tensorGemm_new(engine, 1, nc, xd, 1,
+		                               nn_weightLayer_gemmFlags_dL_dW(self));
+		if(gemm_dL_dW == NULL)
+		{
+			nn_tensorGemm_delete(&gemm_dL_dX);
+			vkk_buffer_delete(&sb013_param);
+			return 0;
+		}
 
-static nn_dim_t*
-nn_weightLayer_dimYFn(nn_layer_t* base)
-{
-	ASSERT(base);
+		nn_tensorGemm_delete(&self->gemm_dL_dX);
+		nn_tensorGemm_delete(&self->gemm_dL_dW);
+		self->gemm_dL_dX = gemm_dL_dX;
+		self->gemm_dL_dW = gemm_dL_dW;
+	}
 
-	nn_weightLayer_t* self = (nn_weightLayer_t*) base;
+	vkk_buffer_delete(&self->sb013_param);
+	self->sb013_param = sb013_param;
+	nn_weightLayer_updateUs0(self);
 
-	return nn_tensor_dim(self->Y);
+	return 1;
 }
 
 /***********************************************************
@@ -352,8 +1293,15 @@ nn_weightLayer_new(nn_arch_t* arch, nn_dim_t* dimX,
 		.post_fn       = nn_weightLayer_postFn,
 		.dimX_fn       = nn_weightLayer_dimXFn,
 		.dimY_fn       = nn_weightLayer_dimYFn,
+		.quantize_fn   = nn_weightLayer_quantizeFn,
 	};
 
+	if(engine->cpu)
+	{
+		info.compute_fp_fn = nn_weightLayer_computeFpCpuFn;
+		info.compute_bp_fn = nn_weightLayer_computeBpCpuFn;
+	}
+
 	nn_weightLayer_t* self;
 	self = (nn_weightLayer_t*)
 	       nn_layer_new(sizeof(nn_weightLayer_t), &info);
@@ -416,9 +1364,12 @@ nn_weightLayer_new(nn_arch_t* arch, nn_dim_t* dimX,
 		goto fail_Y;
 	}
 
+	// optimizer and gradient state
+	nn_tensorMode_e mode = nn_arch_trainMode(arch);
+
 	self->MW = nn_tensor_new(engine, dimW,
 	                         NN_TENSOR_INIT_ZERO,
-	                         NN_TENSOR_MODE_COMPUTE);
+	                         mode);
 	if(self->MW == NULL)
 	{
 		goto fail_MW;
@@ -426,7 +1377,7 @@ nn_weightLayer_new(nn_arch_t* arch, nn_dim_t* dimX,
 
 	self->VW = nn_tensor_new(engine, dimW,
 	                         NN_TENSOR_INIT_ZERO,
-	                         NN_TENSOR_MODE_COMPUTE);
+	                         mode);
 	if(self->VW == NULL)
 	{
 		goto fail_VW;
@@ -434,7 +1385,7 @@ nn_weightLayer_new(nn_arch_t* arch, nn_dim_t* dimX,
 
 	self->MB = nn_tensor_new(engine, &dimB,
 	                         NN_TENSOR_INIT_ZERO,
-	                         NN_TENSOR_MODE_COMPUTE);
+	                         mode);
 	if(self->MB == NULL)
 	{
 		goto fail_MB;
@@ -442,15 +1393,24 @@ nn_weightLayer_new(nn_arch_t* arch, nn_dim_t* dimX,
 
 	self->VB = nn_tensor_new(engine, &dimB,
 	                         NN_TENSOR_INIT_ZERO,
-	                         NN_TENSOR_MODE_COMPUTE);
+	                         mode);
 	if(self->VB == NULL)
 	{
 		goto fail_VB;
 	}
 
+	// the fused kernels are only used by the direct path
+	nn_tensorMode_e mode_dL_dW = mode;
+	if((engine->cpu == NULL) &&
+	   (nn_weightLayer_useGemm(dimX, dimW, flags) == 0))
+	{
+		self->fused = 1;
+		mode_dL_dW  = NN_TENSOR_MODE_NONE;
+	}
+
 	self->dL_dW = nn_tensor_new(engine, dimW,
 	                            NN_TENSOR_INIT_ZERO,
-	                            NN_TENSOR_MODE_COMPUTE);
+	                            mode_dL_dW);
 	if(self->dL_dW == NULL)
 	{
 		goto fail_dL_dW;
@@ -458,7 +1418,7 @@ nn_weightLayer_new(nn_arch_t* arch, nn_dim_t* dimX,
 
 	self->dL_dB = nn_tensor_new(engine, &dimB,
 	                            NN_TENSOR_INIT_ZERO,
-	                            NN_TENSOR_MODE_COMPUTE);
+	                            mode_dL_dW);
 	if(self->dL_dB == NULL)
 	{
 		goto fail_dL_dB;
@@ -466,12 +1426,18 @@ nn_weightLayer_new(nn_arch_t* arch, nn_dim_t* dimX,
 
 	self->dL_dX = nn_tensor_new(engine, dimX,
 	                            NN_TENSOR_INIT_ZERO,
-	                            NN_TENSOR_MODE_COMPUTE);
+	                            mode);
 	if(self->dL_dX == NULL)
 	{
 		goto fail_dL_dX;
 	}
 
+	self->stats_X = nn_tensorStats_new(engine);
+	if(self->stats_X == NULL)
+	{
+		goto fail_stats_X;
+	}
+
 	self->stats_Y = nn_tensorStats_new(engine);
 	if(self->stats_Y == NULL)
 	{
@@ -484,9 +1450,16 @@ nn_weightLayer_new(nn_arch_t* arch, nn_dim_t* dimX,
 		goto fail_stats_dL_dX;
 	}
 
+	// the CPU backend does not require uniform sets
+	if(engine->cpu)
+	{
+		return self;
+	}
+
 	nn_weightLayerParam_t param =
 	{
 		.disable_bias = (self->flags & NN_WEIGHT_LAYER_FLAG_DISABLE_BIAS) ? 1 : 0,
+		.fact_fn      = (uint32_t) self->fact_fn,
 	};
 	self->sb013_param = vkk_buffer_new(engine->engine,
 	                                   VKK_UPDATE_MODE_STATIC,
@@ -519,102 +1492,55 @@ nn_weightLayer_new(nn_arch_t* arch, nn_dim_t* dimX,
 		goto fail_us1_bp;
 	}
 
-	// sb000: dimX
-	// sb001: dimW
-	// sb002: W
-	// sb003: B
-	// sb004: dimY
-	// sb005: Y
-	// sb006: MW
-	// sb007: VW
-	// sb008: MB
-	// sb009: VB
-	// sb010: dL_dW
-	// sb011: dL_dB
-	// sb012: dL_dX
-	// sb013: param (disable_bias)
-	vkk_uniformAttachment_t ua0_array[] =
+	nn_weightLayer_updateUs0(self);
+
+	// optionally use the tiled GEMM
+	if(nn_weightLayer_useGemm(dimX, dimW, flags) == 0)
 	{
-		{
-			.binding = 0,
-			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
-			.buffer  = self->dL_dX->sb_dim,
-		},
-		{
-			.binding = 1,
-			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
-			.buffer  = self->W->sb_dim,
-		},
-		{
-			.binding = 2,
-			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
-			.buffer  = self->W->sb_data,
-		},
-		{
-			.binding = 3,
-			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
-			.buffer  = self->B->sb_data,
-		},
-		{
-			.binding = 4,
-			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
-			.buffer  = self->Y->sb_dim,
-		},
-		{
-			.binding = 5,
-			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
-			.buffer  = self->Y->sb_data,
-		},
-		{
-			.binding = 6,
-			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
-			.buffer  = self->MW->sb_data,
-		},
-		{
-			.binding = 7,
-			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
-			.buffer  = self->VW->sb_data,
-		},
-		{
-			.binding = 8,
-			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
-			.buffer  = self->MB->sb_data,
-		},
-		{
-			.binding = 9,
-			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
-			.buffer  = self->VB->sb_data,
-		},
-		{
-			.binding = 10,
-			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
-			.buffer  = self->dL_dW->sb_data,
-		},
-		{
-			.binding = 11,
-			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
-			.buffer  = self->dL_dB->sb_data,
-		},
-		{
-			.binding = 12,
-			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
-			.buffer  = self->dL_dX->sb_data,
-		},
-		{
-			.binding = 13,
-			.type    = VKK_UNIFORM_TYPE_STORAGE_REF,
-			.buffer  = self->sb013_param,
-		},
-	};
+		return self;
+	}
+
+	uint32_t xd = dimW->depth;
+
+	self->gemm_Y = nn_tensorGemm_new(engine, 1, 1, nc, xd,
+	                                 nn_weightLayer_gemmFlagsY(self));
+	if(self->gemm_Y == NULL)
+	{
+		goto fail_gemm_Y;
+	}
+
+	// the backprop GEMMs are not required for inference
+	if(arch->inference)
+	{
+		return self;
+	}
+
+	// dL_dX = dL_dY*W
+	self->gemm_dL_dX = nn_tensorGemm_new(engine, 1, 1, xd, nc,
+	                                     nn_weightLayer_gemmFlags_dL_dX(self));
+	if(self->gemm_dL_dX == NULL)
+	{
+		goto fail_gemm_dL_dX;
+	}
 
-	vkk_compute_updateUniformSetRefs(engine->compute,
-	                                 self->us0, 14,
-	                                 ua0_array);
+	// dL_dW = dL_dY^T*X
+	self->gemm_dL_dW = nn_tensorGemm_new(engine, 1, nc, xd, 1,
+	                                     nn_weightLayer_gemmFlags_dL_dW(self));
+	if(self->gemm_dL_dW == NULL)
+	{
+		goto fail_gemm_dL_dW;
+	}
 
 	// success
 	return self;
 
 	// failure
+	fail_gemm_dL_dW:
+		nn_tensorGemm_delete(&self->gemm_dL_dX);
+	fail_gemm_dL_dX:
+		nn_tensorGemm_delete(&self->gemm_Y);
+	fail_gemm_Y:
+		vkk_uniformSet_delete(&self->us1_bp);
 	fail_us1_bp:
 		vkk_uniformSet_delete(&self->us1_fp);
 	fail_us1_fp:
@@ -626,6 +1552,8 @@ nn_weightLayer_new(nn_arch_t* arch, nn_dim_t* dimX,
 	fail_stats_dL_dX:
 		nn_tensorStats_delete(&self->stats_Y);
 	fail_stats_Y:
+		nn_tensorStats_delete(&self->stats_X);
+	fail_stats_X:
 		nn_tensor_delete(&self->dL_dX);
 	fail_dL_dX:
 		nn_tensor_delete(&self->dL_dB);
@@ -657,12 +1585,18 @@ void nn_weightLayer_delete(nn_weightLayer_t** _self)
 	nn_weightLayer_t* self = *_self;
 	if(self)
 	{
+		nn_tensorGemm_delete(&self->gemm_dL_dW);
+		nn_tensorGemm_delete(&self->gemm_dL_dX);
+		nn_tensorGemm_delete(&self->gemm_Y);
 		vkk_uniformSet_delete(&self->us1_bp);
 		vkk_uniformSet_delete(&self->us1_fp);
 		vkk_uniformSet_delete(&self->us0);
 		vkk_buffer_delete(&self->sb013_param);
+		FREE(self->q8_X);
+		nn_tensorQ8_delete(&self->q8);
 		nn_tensorStats_delete(&self->stats_dL_dX);
 		nn_tensorStats_delete(&self->stats_Y);
+		nn_tensorStats_delete(&self->stats_X);
 		nn_tensor_delete(&self->dL_dX);
 		nn_tensor_delete(&self->dL_dB);
 		nn_tensor_delete(&self->dL_dW);
@@ -698,6 +1632,7 @@ nn_weightLayer_import(nn_arch_t* arch, cc_jsmnVal_t* val)
 	cc_jsmnVal_t* val_VW    = NULL;
 	cc_jsmnVal_t* val_MB    = NULL;
 	cc_jsmnVal_t* val_VB    = NULL;
+	cc_jsmnVal_t* val_Q8    = NULL;
 
 	cc_listIter_t* iter = cc_list_head(val->obj->list);
 	while(iter)
@@ -746,6 +1681,10 @@ nn_weightLayer_import(nn_arch_t* arch, cc_jsmnVal_t* val)
 			{
 				val_VB = kv->val;
 			}
+			else if(strcmp(kv->key, "Q8") == 0)
+			{
+				val_Q8 = kv->val;
+			}
 		}
 
 		iter = cc_list_next(iter);
@@ -755,12 +1694,26 @@ nn_weightLayer_import(nn_arch_t* arch, cc_jsmnVal_t* val)
 	if((val_dimX  == NULL) ||
 	   (val_dimW  == NULL) ||
 	   (val_flags == NULL) ||
-	   (val_W     == NULL) ||
-	   (val_B     == NULL) ||
-	   (val_MW    == NULL) ||
-	   (val_VW    == NULL) ||
-	   (val_MB    == NULL) ||
-	   (val_VB    == NULL))
+	   (val_B     == NULL))
+	{
+		LOGE("invalid");
+		return NULL;
+	}
+
+	// quantized layers are inference-only
+	if(val_Q8)
+	{
+		if(nn_arch_trainMode(arch) != NN_TENSOR_MODE_NONE)
+		{
+			LOGE("invalid");
+			return NULL;
+		}
+	}
+	else if((val_W  == NULL) ||
+	        (val_MW == NULL) ||
+	        (val_VW == NULL) ||
+	        (val_MB == NULL) ||
+	        (val_VB == NULL))
 	{
 		LOGE("invalid");
 		return NULL;
@@ -783,12 +1736,34 @@ nn_weightLayer_import(nn_arch_t* arch, cc_jsmnVal_t* val)
 		return NULL;
 	}
 
-	if((nn_tensor_import(self->W,  val_W)  == 0) ||
-	   (nn_tensor_import(self->B,  val_B)  == 0) ||
-	   (nn_tensor_import(self->MW, val_MW) == 0) ||
-	   (nn_tensor_import(self->VW, val_VW) == 0) ||
-	   (nn_tensor_import(self->MB, val_MB) == 0) ||
-	   (nn_tensor_import(self->VB, val_VB) == 0))
+	if(val_Q8)
+	{
+		if(nn_tensor_import(self->B, val_B) == 0)
+		{
+			goto fail_tensor;
+		}
+
+		nn_tensorQ8_t* q8;
+		q8 = nn_tensorQ8_import(arch->engine,
+		                        nn_tensor_dim(self->dL_dX),
+		                        &dimW, val_Q8);
+		if(q8 == NULL)
+		{
+			goto fail_tensor;
+		}
+
+		if(nn_weightLayer_setQ8(self, q8) == 0)
+		{
+			nn_tensorQ8_delete(&q8);
+			goto fail_tensor;
+		}
+	}
+	else if((nn_tensor_import(self->W,  val_W)  == 0) ||
+	        (nn_tensor_import(self->B,  val_B)  == 0) ||
+	        (nn_tensor_import(self->MW, val_MW) == 0) ||
+	        (nn_tensor_import(self->VW, val_VW) == 0) ||
+	        (nn_tensor_import(self->MB, val_MB) == 0) ||
+	        (nn_tensor_import(self->VB, val_VB) == 0))
 	{
 		goto fail_tensor;
 	}
@@ -819,19 +1794,67 @@ int nn_weightLayer_export(nn_weightLayer_t* self,
 	ret &= nn_dim_export(dimW, stream);
 	ret &= cc_jsmnStream_key(stream, "%s", "flags");
 	ret &= cc_jsmnStream_int(stream, self->flags);
-	ret &= cc_jsmnStream_key(stream, "%s", "W");
-	ret &= nn_tensor_export(self->W, stream);
-	ret &= cc_jsmnStream_key(stream, "%s", "B");
-	ret &= nn_tensor_export(self->B, stream);
-	ret &= cc_jsmnStream_key(stream, "%s", "MW");
-	ret &= nn_tensor_export(self->MW, stream);
-	ret &= cc_jsmnStream_key(stream, "%s", "VW");
-	ret &= nn_tensor_export(self->VW, stream);
-	ret &= cc_jsmnStream_key(stream, "%s", "MB");
-	ret &= nn_tensor_export(self->MB, stream);
-	ret &= cc_jsmnStream_key(stream, "%s", "VB");
-	ret &= nn_tensor_export(self->VB, stream);
+	if(self->q8)
+	{
+		ret &= cc_jsmnStream_key(stream, "%s", "Q8");
+		ret &= nn_tensorQ8_export(self->q8, stream);
+		ret &= cc_jsmnStream_key(stream, "%s", "B");
+		ret &= nn_tensor_export(self->B, stream);
+	}
+	else
+	{
+		ret &= cc_jsmnStream_key(stream, "%s", "W");
+		ret &= nn_tensor_export(self->W, stream);
+		ret &= cc_jsmnStream_key(stream, "%s", "B");
+		ret &= nn_tensor_export(self->B, stream);
+		ret &= cc_jsmnStream_key(stream, "%s", "MW");
+		ret &= nn_tensor_export(self->MW, stream);
+		ret &= cc_jsmnStream_key(stream, "%s", "VW");
+		ret &= nn_tensor_export(self->VW, stream);
+		ret &= cc_jsmnStream_key(stream, "%s", "MB");
+		ret &= nn_tensor_export(self->MB, stream);
+		ret &= cc_jsmnStream_key(stream, "%s", "VB");
+		ret &= nn_tensor_export(self->VB, stream);
+	}
 	ret &= cc_jsmnStream_end(stream);
 
 	return ret;
 }
+
+int nn_weightLayer_foldBatchNorm(nn_weightLayer_t* self,
+                                 nn_batchNormLayer_t* bn)
+{
+	ASSERT(self);
+	ASSERT(bn);
+
+	// bake the normalized weights before folding
+	if(nn_weightLayer_bakeNorm(self) == 0)
+	{
+		return 0;
+	}
+
+	if(nn_batchNormLayer_fold(bn, self->W, self->B) == 0)
+	{
+		return 0;
+	}
+
+	if((self->flags & NN_WEIGHT_LAYER_FLAG_DISABLE_BIAS) == 0)
+	{
+		return 1;
+	}
+
+	// the folded bias is required
+	self->flags &= ~NN_WEIGHT_LAYER_FLAG_DISABLE_BIAS;
+
+	return nn_weightLayer_updateParam(self);
+}
+
+int nn_weightLayer_fuseFact(nn_weightLayer_t* self,
+                            nn_factLayerFn_e fact_fn)
+{
+	ASSERT(self);
+
+	self->fact_fn = fact_fn;
+
+	return nn_weightLayer_updateParam(self);
+}
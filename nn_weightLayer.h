@@ -27,12 +27,14 @@
 #include "../libcc/jsmn/cc_jsmnStream.h"
 #include "../libcc/jsmn/cc_jsmnWrapper.h"
 #include "../libvkk/vkk.h"
+#include "nn_factLayer.h"
 #include "nn_layer.h"
 
 // XAVIER is default
 #define NN_WEIGHT_LAYER_FLAG_XAVIER       0x0001
 #define NN_WEIGHT_LAYER_FLAG_HE           0x0002
 #define NN_WEIGHT_LAYER_FLAG_DISABLE_BIAS 0x0010
+#define NN_WEIGHT_LAYER_FLAG_DISABLE_GEMM 0x0020
 #define NN_WEIGHT_LAYER_FLAG_NORM_SN      0x0100
 #define NN_WEIGHT_LAYER_FLAG_NORM_BSSN    0x0200
 
@@ -42,6 +44,10 @@ typedef struct nn_weightLayer_s
 
 	int flags;
 
+	// fused activation (optional)
+	// see nn_convLayer_fuseFact
+	nn_factLayerFn_e fact_fn;
+
 	// weights, bias, output
 	//           bs; // batch size
 	//           nc; // node count
@@ -63,19 +69,36 @@ typedef struct nn_weightLayer_s
 	// dY_dW; // X : dim(bs,1,1,xd)
 
 	// backprop gradients
+	// fused Adam update (see nn_convLayer)
 	//           dL_dY; // dim(bs,1,1,nc)
+	int          fused;
 	nn_tensor_t* dL_dW; // dim(nc,1,1,xd)
 	nn_tensor_t* dL_dB; // dim(nc,1,1,1)
 	nn_tensor_t* dL_dX; // dim(bs,1,1,xd)
 
 	// stats
+	nn_tensorStats_t* stats_X;
 	nn_tensorStats_t* stats_Y;
 	nn_tensorStats_t* stats_dL_dX;
 
+	// int8 inference (optional)
+	// see nn_convLayer
+	float          q8_xmax;
+	nn_tensorQ8_t* q8;
+	int8_t*        q8_X; // dim(bs,1,1,xd)
+
 	vkk_buffer_t*     sb013_param;
 	vkk_uniformSet_t* us0;
 	vkk_uniformSet_t* us1_fp;
 	vkk_uniformSet_t* us1_bp;
+
+	// tiled GEMM (optional)
+	// selected automatically by layer shape unless
+	// DISABLE_GEMM is set (e.g. to benchmark the direct
+	// kernels)
+	nn_tensorGemm_t* gemm_Y;
+	nn_tensorGemm_t* gemm_dL_dX;
+	nn_tensorGemm_t* gemm_dL_dW;
 } nn_weightLayer_t;
 
 nn_weightLayer_t* nn_weightLayer_new(nn_arch_t* arch,
@@ -88,4 +111,14 @@ nn_weightLayer_t* nn_weightLayer_import(nn_arch_t* arch,
 int               nn_weightLayer_export(nn_weightLayer_t* self,
                                         cc_jsmnStream_t* stream);
 
+// fold a batch normalization layer that directly follows
+// the weight layer into W and B (see nn_arch_freeze)
+int               nn_weightLayer_foldBatchNorm(nn_weightLayer_t* self,
+                                               nn_batchNormLayer_t* bn);
+
+// fuse an activation function that directly follows the
+// weight layer
+int               nn_weightLayer_fuseFact(nn_weightLayer_t* self,
+                                          nn_factLayerFn_e fact_fn);
+
 #endif
@@ -1,25 +1,54 @@
 cd nn/shaders
-glslangValidator -V nn_batchNormLayer_forwardPassXmeanTrain.comp -o nn_batchNormLayer_forwardPassXmeanTrain_comp.spv
-glslangValidator -V nn_batchNormLayer_forwardPassXvarTrain.comp -o nn_batchNormLayer_forwardPassXvarTrain_comp.spv
-glslangValidator -V nn_batchNormLayer_forwardPassXmeanCompute.comp -o nn_batchNormLayer_forwardPassXmeanCompute_comp.spv
-glslangValidator -V nn_batchNormLayer_forwardPassXvarCompute.comp -o nn_batchNormLayer_forwardPassXvarCompute_comp.spv
+glslangValidator -V -DNN_BN_TRAIN nn_batchNormLayer_forwardPassXstats.comp -o nn_batchNormLayer_forwardPassXstatsTrain_comp.spv
+glslangValidator -V nn_batchNormLayer_forwardPassXstats.comp -o nn_batchNormLayer_forwardPassXstatsCompute_comp.spv
 glslangValidator -V nn_batchNormLayer_forwardPassXhat.comp -o nn_batchNormLayer_forwardPassXhat_comp.spv
-glslangValidator -V nn_batchNormLayer_forwardPassY.comp -o nn_batchNormLayer_forwardPassY_comp.spv
 glslangValidator -V nn_batchNormLayer_backprop_dL_dX.comp -o nn_batchNormLayer_backprop_dL_dX_comp.spv
 glslangValidator -V nn_batchNormLayer_backprop_dL_dXhat.comp -o nn_batchNormLayer_backprop_dL_dXhat_comp.spv
 glslangValidator -V nn_batchNormLayer_backpropSum.comp -o nn_batchNormLayer_backpropSum_comp.spv
 glslangValidator -V nn_batchNormLayer_backpropSumNOP.comp -o nn_batchNormLayer_backpropSumNOP_comp.spv
+glslangValidator -V -DNN_FP16 nn_batchNormLayer_forwardPassXhat.comp -o nn_batchNormLayer_forwardPassXhatF16_comp.spv
+glslangValidator -V -DNN_FP16 nn_batchNormLayer_backprop_dL_dX.comp -o nn_batchNormLayer_backprop_dL_dXF16_comp.spv
+glslangValidator -V -DNN_FP16 nn_batchNormLayer_backprop_dL_dXhat.comp -o nn_batchNormLayer_backprop_dL_dXhatF16_comp.spv
+glslangValidator -V -DNN_FP16 nn_batchNormLayer_backpropSum.comp -o nn_batchNormLayer_backpropSumF16_comp.spv
+glslangValidator -V -DNN_FP16 nn_batchNormLayer_backpropSumNOP.comp -o nn_batchNormLayer_backpropSumNOPF16_comp.spv
 glslangValidator -V nn_convLayer_forwardPassClamp.comp -o nn_convLayer_forwardPassClamp_comp.spv
 glslangValidator -V nn_convLayer_forwardPassPad.comp -o nn_convLayer_forwardPassPad_comp.spv
+glslangValidator -V nn_convLayer_forwardPassTileClamp.comp -o nn_convLayer_forwardPassTileClamp_comp.spv
+glslangValidator -V nn_convLayer_forwardPassTilePad.comp -o nn_convLayer_forwardPassTilePad_comp.spv
 glslangValidator -V nn_convLayer_forwardPassTClamp.comp -o nn_convLayer_forwardPassTClamp_comp.spv
 glslangValidator -V nn_convLayer_forwardPassTPad.comp -o nn_convLayer_forwardPassTPad_comp.spv
+glslangValidator -V nn_convLayer_forwardPassQ8Clamp.comp -o nn_convLayer_forwardPassQ8Clamp_comp.spv
+glslangValidator -V nn_convLayer_forwardPassQ8Pad.comp -o nn_convLayer_forwardPassQ8Pad_comp.spv
 glslangValidator -V nn_convLayer_backprop_dL_dX.comp -o nn_convLayer_backprop_dL_dX_comp.spv
 glslangValidator -V nn_convLayer_backprop_dL_dW.comp -o nn_convLayer_backprop_dL_dW_comp.spv
+glslangValidator -V -DNN_FUSED_ADAM nn_convLayer_backprop_dL_dW.comp -o nn_convLayer_backprop_dL_dWAdam_comp.spv
 glslangValidator -V nn_convLayer_backprop_dL_dB.comp -o nn_convLayer_backprop_dL_dB_comp.spv
+glslangValidator -V -DNN_FUSED_ADAM nn_convLayer_backprop_dL_dB.comp -o nn_convLayer_backprop_dL_dBAdam_comp.spv
 glslangValidator -V nn_convLayer_backpropT_dL_dX.comp -o nn_convLayer_backpropT_dL_dX_comp.spv
 glslangValidator -V nn_convLayer_backpropT_dL_dW.comp -o nn_convLayer_backpropT_dL_dW_comp.spv
+glslangValidator -V -DNN_FUSED_ADAM nn_convLayer_backpropT_dL_dW.comp -o nn_convLayer_backpropT_dL_dWAdam_comp.spv
 glslangValidator -V nn_convLayer_backpropUpdateW.comp -o nn_convLayer_backpropUpdateW_comp.spv
 glslangValidator -V nn_convLayer_backpropUpdateB.comp -o nn_convLayer_backpropUpdateB_comp.spv
+glslangValidator -V nn_convLayer_backpropSplit_dL_dW.comp -o nn_convLayer_backpropSplit_dL_dW_comp.spv
+glslangValidator -V nn_convLayer_backpropTSplit_dL_dW.comp -o nn_convLayer_backpropTSplit_dL_dW_comp.spv
+glslangValidator -V nn_convLayer_backpropSplit_dL_dB.comp -o nn_convLayer_backpropSplit_dL_dB_comp.spv
+glslangValidator -V nn_convLayer_backpropReduce_dL_dW.comp -o nn_convLayer_backpropReduce_dL_dW_comp.spv
+glslangValidator -V -DNN_FUSED_ADAM nn_convLayer_backpropReduce_dL_dW.comp -o nn_convLayer_backpropReduce_dL_dWAdam_comp.spv
+glslangValidator -V nn_convLayer_backpropReduce_dL_dB.comp -o nn_convLayer_backpropReduce_dL_dB_comp.spv
+glslangValidator -V -DNN_FUSED_ADAM nn_convLayer_backpropReduce_dL_dB.comp -o nn_convLayer_backpropReduce_dL_dBAdam_comp.spv
+glslangValidator -V nn_convLayer_im2colClamp.comp -o nn_convLayer_im2colClamp_comp.spv
+glslangValidator -V nn_convLayer_im2colPad.comp -o nn_convLayer_im2colPad_comp.spv
+glslangValidator -V nn_convLayer_im2colTClamp.comp -o nn_convLayer_im2colTClamp_comp.spv
+glslangValidator -V nn_convLayer_im2colTPad.comp -o nn_convLayer_im2colTPad_comp.spv
+glslangValidator -V nn_convLayer_col2im.comp -o nn_convLayer_col2im_comp.spv
+glslangValidator -V nn_convLayer_col2imT.comp -o nn_convLayer_col2imT_comp.spv
+glslangValidator -V nn_convLayer_winogradW.comp -o nn_convLayer_winogradW_comp.spv
+glslangValidator -V nn_convLayer_winogradWT.comp -o nn_convLayer_winogradWT_comp.spv
+glslangValidator -V nn_convLayer_winogradXClamp.comp -o nn_convLayer_winogradXClamp_comp.spv
+glslangValidator -V nn_convLayer_winogradXPad.comp -o nn_convLayer_winogradXPad_comp.spv
+glslangValidator -V nn_convLayer_winogradY.comp -o nn_convLayer_winogradY_comp.spv
+glslangValidator -V nn_convLayer_winograd_dL_dY.comp -o nn_convLayer_winograd_dL_dY_comp.spv
+glslangValidator -V nn_convLayer_winograd_dL_dX.comp -o nn_convLayer_winograd_dL_dX_comp.spv
 glslangValidator -V nn_factLayer_forwardPassLinear.comp -o nn_factLayer_forwardPassLinear_comp.spv
 glslangValidator -V nn_factLayer_forwardPassLogistic.comp -o nn_factLayer_forwardPassLogistic_comp.spv
 glslangValidator -V nn_factLayer_forwardPassReLU.comp -o nn_factLayer_forwardPassReLU_comp.spv
@@ -34,6 +63,12 @@ glslangValidator -V nn_factLayer_backpropPReLU.comp -o nn_factLayer_backpropPReL
 glslangValidator -V nn_factLayer_backpropLReLU.comp -o nn_factLayer_backpropLReLU_comp.spv
 glslangValidator -V nn_factLayer_backpropTanh.comp -o nn_factLayer_backpropTanh_comp.spv
 glslangValidator -V nn_factLayer_backpropSink.comp -o nn_factLayer_backpropSink_comp.spv
+glslangValidator -V nn_groupNormLayer_forwardPassXstats.comp -o nn_groupNormLayer_forwardPassXstats_comp.spv
+glslangValidator -V nn_groupNormLayer_forwardPassXhat.comp -o nn_groupNormLayer_forwardPassXhat_comp.spv
+glslangValidator -V nn_groupNormLayer_backpropSum.comp -o nn_groupNormLayer_backpropSum_comp.spv
+glslangValidator -V nn_groupNormLayer_backpropSumGB.comp -o nn_groupNormLayer_backpropSumGB_comp.spv
+glslangValidator -V nn_groupNormLayer_backprop_dL_dX.comp -o nn_groupNormLayer_backprop_dL_dX_comp.spv
+glslangValidator -V nn_groupNormLayer_backpropUpdate.comp -o nn_groupNormLayer_backpropUpdate_comp.spv
 glslangValidator -V nn_lanczosLayer_forwardPassT.comp -o nn_lanczosLayer_forwardPassT_comp.spv
 glslangValidator -V nn_lanczosLayer_forwardPassY.comp -o nn_lanczosLayer_forwardPassY_comp.spv
 glslangValidator -V nn_lanczosLayer_backprop_dL_dT.comp -o nn_lanczosLayer_backprop_dL_dT_comp.spv
@@ -53,12 +88,17 @@ glslangValidator -V nn_tensor_computeMixOp.comp -o nn_tensor_computeMixOp_comp.s
 glslangValidator -V nn_tensor_computeMulOp.comp -o nn_tensor_computeMulOp_comp.spv
 glslangValidator -V nn_tensor_computeScaleOp.comp -o nn_tensor_computeScaleOp_comp.spv
 glslangValidator -V nn_tensor_computeScaleAddOp.comp -o nn_tensor_computeScaleAddOp_comp.spv
+glslangValidator -V nn_tensor_gemm.comp -o nn_tensor_gemm_comp.spv
+glslangValidator -V nn_tensorQ8_quantizeX.comp -o nn_tensorQ8_quantizeX_comp.spv
 glslangValidator -V nn_weightLayer_forwardPass.comp -o nn_weightLayer_forwardPass_comp.spv
+glslangValidator -V nn_weightLayer_forwardPassQ8.comp -o nn_weightLayer_forwardPassQ8_comp.spv
 glslangValidator -V nn_weightLayer_backpropUpdateW.comp -o nn_weightLayer_backpropUpdateW_comp.spv
 glslangValidator -V nn_weightLayer_backpropUpdateB.comp -o nn_weightLayer_backpropUpdateB_comp.spv
 glslangValidator -V nn_weightLayer_backprop_dL_dX.comp -o nn_weightLayer_backprop_dL_dX_comp.spv
 glslangValidator -V nn_weightLayer_backprop_dL_dW.comp -o nn_weightLayer_backprop_dL_dW_comp.spv
+glslangValidator -V -DNN_FUSED_ADAM nn_weightLayer_backprop_dL_dW.comp -o nn_weightLayer_backprop_dL_dWAdam_comp.spv
 glslangValidator -V nn_weightLayer_backprop_dL_dB.comp -o nn_weightLayer_backprop_dL_dB_comp.spv
+glslangValidator -V -DNN_FUSED_ADAM nn_weightLayer_backprop_dL_dB.comp -o nn_weightLayer_backprop_dL_dBAdam_comp.spv
 glslangValidator -V nn_loss_dL_dY_mse.comp -o nn_loss_dL_dY_mse_comp.spv
 glslangValidator -V nn_loss_dL_dY_mae.comp -o nn_loss_dL_dY_mae_comp.spv
 glslangValidator -V nn_loss_dL_dY_bce.comp -o nn_loss_dL_dY_bce_comp.spv
@@ -68,27 +108,56 @@ glslangValidator -V nn_loss_bce.comp -o nn_loss_bce_comp.spv
 cd ../..
 
 # shaders
-bfs $1 blobSet nn/shaders/nn_batchNormLayer_forwardPassXmeanTrain_comp.spv
-bfs $1 blobSet nn/shaders/nn_batchNormLayer_forwardPassXvarTrain_comp.spv
-bfs $1 blobSet nn/shaders/nn_batchNormLayer_forwardPassXmeanCompute_comp.spv
-bfs $1 blobSet nn/shaders/nn_batchNormLayer_forwardPassXvarCompute_comp.spv
+bfs $1 blobSet nn/shaders/nn_batchNormLayer_forwardPassXstatsTrain_comp.spv
+bfs $1 blobSet nn/shaders/nn_batchNormLayer_forwardPassXstatsCompute_comp.spv
 bfs $1 blobSet nn/shaders/nn_batchNormLayer_forwardPassXhat_comp.spv
-bfs $1 blobSet nn/shaders/nn_batchNormLayer_forwardPassY_comp.spv
 bfs $1 blobSet nn/shaders/nn_batchNormLayer_backprop_dL_dX_comp.spv
 bfs $1 blobSet nn/shaders/nn_batchNormLayer_backprop_dL_dXhat_comp.spv
 bfs $1 blobSet nn/shaders/nn_batchNormLayer_backpropSum_comp.spv
 bfs $1 blobSet nn/shaders/nn_batchNormLayer_backpropSumNOP_comp.spv
+bfs $1 blobSet nn/shaders/nn_batchNormLayer_forwardPassXhatF16_comp.spv
+bfs $1 blobSet nn/shaders/nn_batchNormLayer_backprop_dL_dXF16_comp.spv
+bfs $1 blobSet nn/shaders/nn_batchNormLayer_backprop_dL_dXhatF16_comp.spv
+bfs $1 blobSet nn/shaders/nn_batchNormLayer_backpropSumF16_comp.spv
+bfs $1 blobSet nn/shaders/nn_batchNormLayer_backpropSumNOPF16_comp.spv
 bfs $1 blobSet nn/shaders/nn_convLayer_forwardPassClamp_comp.spv
 bfs $1 blobSet nn/shaders/nn_convLayer_forwardPassPad_comp.spv
+bfs $1 blobSet nn/shaders/nn_convLayer_forwardPassTileClamp_comp.spv
+bfs $1 blobSet nn/shaders/nn_convLayer_forwardPassTilePad_comp.spv
 bfs $1 blobSet nn/shaders/nn_convLayer_forwardPassTClamp_comp.spv
 bfs $1 blobSet nn/shaders/nn_convLayer_forwardPassTPad_comp.spv
+bfs $1 blobSet nn/shaders/nn_convLayer_forwardPassQ8Clamp_comp.spv
+bfs $1 blobSet nn/shaders/nn_convLayer_forwardPassQ8Pad_comp.spv
 bfs $1 blobSet nn/shaders/nn_convLayer_backprop_dL_dX_comp.spv
 bfs $1 blobSet nn/shaders/nn_convLayer_backprop_dL_dW_comp.spv
+bfs $1 blobSet nn/shaders/nn_convLayer_backprop_dL_dWAdam_comp.spv
 bfs $1 blobSet nn/shaders/nn_convLayer_backprop_dL_dB_comp.spv
+bfs $1 blobSet nn/shaders/nn_convLayer_backprop_dL_dBAdam_comp.spv
 bfs $1 blobSet nn/shaders/nn_convLayer_backpropT_dL_dX_comp.spv
 bfs $1 blobSet nn/shaders/nn_convLayer_backpropT_dL_dW_comp.spv
+bfs $1 blobSet nn/shaders/nn_convLayer_backpropT_dL_dWAdam_comp.spv
 bfs $1 blobSet nn/shaders/nn_convLayer_backpropUpdateW_comp.spv
 bfs $1 blobSet nn/shaders/nn_convLayer_backpropUpdateB_comp.spv
+bfs $1 blobSet nn/shaders/nn_convLayer_backpropSplit_dL_dW_comp.spv
+bfs $1 blobSet nn/shaders/nn_convLayer_backpropTSplit_dL_dW_comp.spv
+bfs $1 blobSet nn/shaders/nn_convLayer_backpropSplit_dL_dB_comp.spv
+bfs $1 blobSet nn/shaders/nn_convLayer_backpropReduce_dL_dW_comp.spv
+bfs $1 blobSet nn/shaders/nn_convLayer_backpropReduce_dL_dWAdam_comp.spv
+bfs $1 blobSet nn/shaders/nn_convLayer_backpropReduce_dL_dB_comp.spv
+bfs $1 blobSet nn/shaders/nn_convLayer_backpropReduce_dL_dBAdam_comp.spv
+bfs $1 blobSet nn/shaders/nn_convLayer_im2colClamp_comp.spv
+bfs $1 blobSet nn/shaders/nn_convLayer_im2colPad_comp.spv
+bfs $1 blobSet nn/shaders/nn_convLayer_im2colTClamp_comp.spv
+bfs $1 blobSet nn/shaders/nn_convLayer_im2colTPad_comp.spv
+bfs $1 blobSet nn/shaders/nn_convLayer_col2im_comp.spv
+bfs $1 blobSet nn/shaders/nn_convLayer_col2imT_comp.spv
+bfs $1 blobSet nn/shaders/nn_convLayer_winogradW_comp.spv
+bfs $1 blobSet nn/shaders/nn_convLayer_winogradWT_comp.spv
+bfs $1 blobSet nn/shaders/nn_convLayer_winogradXClamp_comp.spv
+bfs $1 blobSet nn/shaders/nn_convLayer_winogradXPad_comp.spv
+bfs $1 blobSet nn/shaders/nn_convLayer_winogradY_comp.spv
+bfs $1 blobSet nn/shaders/nn_convLayer_winograd_dL_dY_comp.spv
+bfs $1 blobSet nn/shaders/nn_convLayer_winograd_dL_dX_comp.spv
 bfs $1 blobSet nn/shaders/nn_factLayer_forwardPassLinear_comp.spv
 bfs $1 blobSet nn/shaders/nn_factLayer_forwardPassLogistic_comp.spv
 bfs $1 blobSet nn/shaders/nn_factLayer_forwardPassReLU_comp.spv
@@ -103,6 +172,12 @@ bfs $1 blobSet nn/shaders/nn_factLayer_backpropPReLU_comp.spv
 bfs $1 blobSet nn/shaders/nn_factLayer_backpropLReLU_comp.spv
 bfs $1 blobSet nn/shaders/nn_factLayer_backpropTanh_comp.spv
 bfs $1 blobSet nn/shaders/nn_factLayer_backpropSink_comp.spv
+bfs $1 blobSet nn/shaders/nn_groupNormLayer_forwardPassXstats_comp.spv
+bfs $1 blobSet nn/shaders/nn_groupNormLayer_forwardPassXhat_comp.spv
+bfs $1 blobSet nn/shaders/nn_groupNormLayer_backpropSum_comp.spv
+bfs $1 blobSet nn/shaders/nn_groupNormLayer_backpropSumGB_comp.spv
+bfs $1 blobSet nn/shaders/nn_groupNormLayer_backprop_dL_dX_comp.spv
+bfs $1 blobSet nn/shaders/nn_groupNormLayer_backpropUpdate_comp.spv
 bfs $1 blobSet nn/shaders/nn_lanczosLayer_forwardPassT_comp.spv
 bfs $1 blobSet nn/shaders/nn_lanczosLayer_forwardPassY_comp.spv
 bfs $1 blobSet nn/shaders/nn_lanczosLayer_backprop_dL_dT_comp.spv
@@ -122,12 +197,17 @@ bfs $1 blobSet nn/shaders/nn_tensor_computeMixOp_comp.spv
 bfs $1 blobSet nn/shaders/nn_tensor_computeMulOp_comp.spv
 bfs $1 blobSet nn/shaders/nn_tensor_computeScaleOp_comp.spv
 bfs $1 blobSet nn/shaders/nn_tensor_computeScaleAddOp_comp.spv
+bfs $1 blobSet nn/shaders/nn_tensor_gemm_comp.spv
+bfs $1 blobSet nn/shaders/nn_tensorQ8_quantizeX_comp.spv
 bfs $1 blobSet nn/shaders/nn_weightLayer_forwardPass_comp.spv
+bfs $1 blobSet nn/shaders/nn_weightLayer_forwardPassQ8_comp.spv
 bfs $1 blobSet nn/shaders/nn_weightLayer_backpropUpdateW_comp.spv
 bfs $1 blobSet nn/shaders/nn_weightLayer_backpropUpdateB_comp.spv
 bfs $1 blobSet nn/shaders/nn_weightLayer_backprop_dL_dX_comp.spv
 bfs $1 blobSet nn/shaders/nn_weightLayer_backprop_dL_dW_comp.spv
+bfs $1 blobSet nn/shaders/nn_weightLayer_backprop_dL_dWAdam_comp.spv
 bfs $1 blobSet nn/shaders/nn_weightLayer_backprop_dL_dB_comp.spv
+bfs $1 blobSet nn/shaders/nn_weightLayer_backprop_dL_dBAdam_comp.spv
 bfs $1 blobSet nn/shaders/nn_loss_dL_dY_mse_comp.spv
 bfs $1 blobSet nn/shaders/nn_loss_dL_dY_mae_comp.spv
 bfs $1 blobSet nn/shaders/nn_loss_dL_dY_bce_comp.spv
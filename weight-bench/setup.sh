@@ -0,0 +1,8 @@
+ln -s ../../jsmn
+ln -s ../../libbfs
+ln -s ../../libcc
+ln -s ../../libnn
+ln -s ../../libsqlite3
+ln -s ../../libvkk
+ln -s ../../pcg-c-basic
+ln -s ../../texgz
@@ -0,0 +1,464 @@
+/*
+ * Copyright (c) 2023 Jeff Boody
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a
+ * copy of this software and associated documentation files (the "Software"),
+ * to deal in the Software without restriction, including without limitation
+ * the rights to use, copy, modify, merge, publish, distribute, sublicense,
+ * and/or sell copies of the Software, and to permit persons to whom the
+ * Software is furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included
+ * in all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ *
+ */
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#define LOG_TAG "weight-bench"
+#include "libcc/rng/cc_rngNormal.h"
+#include "libcc/cc_log.h"
+#include "libcc/cc_memory.h"
+#include "libcc/cc_timestamp.h"
+#include "libnn/nn_arch.h"
+#include "libnn/nn_dim.h"
+#include "libnn/nn_engine.h"
+#include "libnn/nn_tensor.h"
+#include "libnn/nn_weightLayer.h"
+#include "libvkk/vkk_platform.h"
+
+// compares the tiled GEMM kernels with the direct kernels
+// for the weight layer across a range of shapes
+
+#define WEIGHT_BENCH_COUNT 100
+
+typedef struct
+{
+	uint32_t bs;
+	uint32_t xd;
+	uint32_t nc;
+} weight_bench_shape_t;
+
+typedef struct
+{
+	nn_arch_t*        arch;
+	nn_weightLayer_t* layer;
+} weight_bench_t;
+
+/***********************************************************
+* private                                                  *
+***********************************************************/
+
+static int
+weight_bench_new(weight_bench_t* self,
+                 nn_engine_t* engine,
+                 nn_dim_t* dimX, nn_dim_t* dimW,
+                 int flags)
+{
+	ASSERT(self);
+	ASSERT(engine);
+	ASSERT(dimX);
+	ASSERT(dimW);
+
+	nn_archState_t arch_state =
+	{
+		.adam_alpha  = 0.0001f,
+		.adam_beta1  = 0.9f,
+		.adam_beta2  = 0.999f,
+		.adam_beta1t = 1.0f,
+		.adam_beta2t = 1.0f,
+		.bn_momentum = 0.99f,
+	};
+
+	self->arch = nn_arch_new(engine, 0, &arch_state);
+	if(self->arch == NULL)
+	{
+		return 0;
+	}
+
+	self->layer = nn_weightLayer_new(self->arch, dimX, dimW,
+	                                 flags);
+	if(self->layer == NULL)
+	{
+		goto fail_layer;
+	}
+
+	if(nn_arch_attachLayer(self->arch,
+	                       (nn_layer_t*) self->layer) == 0)
+	{
+		goto fail_attach;
+	}
+
+	// success
+	return 1;
+
+	// failure
+	fail_attach:
+		nn_weightLayer_delete(&self->layer);
+	fail_layer:
+		nn_arch_delete(&self->arch);
+	return 0;
+}
+
+static void weight_bench_delete(weight_bench_t* self)
+{
+	ASSERT(self);
+
+	nn_weightLayer_delete(&self->layer);
+	nn_arch_delete(&self->arch);
+}
+
+static int
+weight_bench_step(weight_bench_t* self, int flags,
+                  uint32_t bs, nn_tensor_t* X,
+                  nn_tensor_t* dL_dY)
+{
+	ASSERT(self);
+	ASSERT(X);
+	ASSERT(dL_dY);
+
+	if((nn_arch_forwardPass(self->arch, 0, bs, X) == NULL) ||
+	   (nn_arch_backprop(self->arch, flags,
+	                     bs, dL_dY) == NULL))
+	{
+		return 0;
+	}
+
+	return 1;
+}
+
+static double
+weight_bench_run(weight_bench_t* self, uint32_t bs,
+                 nn_tensor_t* X, nn_tensor_t* dL_dY)
+{
+	ASSERT(self);
+	ASSERT(X);
+	ASSERT(dL_dY);
+
+	// warm up the pipelines
+	// the parameter update is included in the timing since
+	// the direct kernels fuse dL_dW with the Adam update
+	if(weight_bench_step(self, 0, bs, X, dL_dY) == 0)
+	{
+		return -1.0;
+	}
+
+	double   t0 = cc_timestamp();
+	uint32_t i;
+	for(i = 0; i < WEIGHT_BENCH_COUNT; ++i)
+	{
+		if(weight_bench_step(self, 0, bs, X, dL_dY) == 0)
+		{
+			return -1.0;
+		}
+	}
+
+	return 1000.0*(cc_timestamp() - t0)/WEIGHT_BENCH_COUNT;
+}
+
+static float
+weight_bench_diff(nn_tensor_t* A, nn_tensor_t* B,
+                  nn_tensor_t* io)
+{
+	ASSERT(A);
+	ASSERT(B);
+	ASSERT(io);
+
+	nn_dim_t* dim = nn_tensor_dim(io);
+
+	float*   a;
+	uint32_t size = dim->count*dim->depth;
+	a = (float*) CALLOC(size, sizeof(float));
+	if(a == NULL)
+	{
+		LOGE("CALLOC failed");
+		return -1.0f;
+	}
+
+	if(nn_tensor_copy(A, io, 0, 0, dim->count) == 0)
+	{
+		FREE(a);
+		return -1.0f;
+	}
+
+	uint32_t m;
+	uint32_t k;
+	for(m = 0; m < dim->count; ++m)
+	{
+		for(k = 0; k < dim->depth; ++k)
+		{
+			a[m*dim->depth + k] = nn_tensor_ioGet(io, m, 0, 0, k);
+		}
+	}
+
+	if(nn_tensor_copy(B, io, 0, 0, dim->count) == 0)
+	{
+		FREE(a);
+		return -1.0f;
+	}
+
+	float d;
+	float diff = 0.0f;
+	for(m = 0; m < dim->count; ++m)
+	{
+		for(k = 0; k < dim->depth; ++k)
+		{
+			d = fabsf(a[m*dim->depth + k] -
+			          nn_tensor_ioGet(io, m, 0, 0, k));
+			if(d > diff)
+			{
+				diff = d;
+			}
+		}
+	}
+	FREE(a);
+
+	return diff;
+}
+
+static int
+weight_bench_shape(nn_engine_t* engine,
+                   weight_bench_shape_t* shape,
+                   cc_rngNormal_t* rng)
+{
+	ASSERT(engine);
+	ASSERT(shape);
+	ASSERT(rng);
+
+	uint32_t bs = shape->bs;
+
+	nn_dim_t dimX =
+	{
+		.count  = bs,
+		.height = 1,
+		.width  = 1,
+		.depth  = shape->xd,
+	};
+
+	nn_dim_t dimW =
+	{
+		.count  = shape->nc,
+		.height = 1,
+		.width  = 1,
+		.depth  = shape->xd,
+	};
+
+	nn_dim_t dimY =
+	{
+		.count  = bs,
+		.height = 1,
+		.width  = 1,
+		.depth  = shape->nc,
+	};
+
+	weight_bench_t gemm;
+	if(weight_bench_new(&gemm, engine, &dimX, &dimW,
+	                    NN_WEIGHT_LAYER_FLAG_XAVIER) == 0)
+	{
+		return 0;
+	}
+
+	weight_bench_t direct;
+	if(weight_bench_new(&direct, engine, &dimX, &dimW,
+	                    NN_WEIGHT_LAYER_FLAG_XAVIER |
+	                    NN_WEIGHT_LAYER_FLAG_DISABLE_GEMM) == 0)
+	{
+		goto fail_direct;
+	}
+
+	nn_tensor_t* Xio;
+	Xio = nn_tensor_new(engine, &dimX,
+	                    NN_TENSOR_INIT_ZERO,
+	                    NN_TENSOR_MODE_IO);
+	if(Xio == NULL)
+	{
+		goto fail_Xio;
+	}
+
+	nn_tensor_t* X;
+	X = nn_tensor_new(engine, &dimX,
+	                  NN_TENSOR_INIT_ZERO,
+	                  NN_TENSOR_MODE_COMPUTE);
+	if(X == NULL)
+	{
+		goto fail_X;
+	}
+
+	nn_tensor_t* Yio;
+	Yio = nn_tensor_new(engine, &dimY,
+	                    NN_TENSOR_INIT_ZERO,
+	                    NN_TENSOR_MODE_IO);
+	if(Yio == NULL)
+	{
+		goto fail_Yio;
+	}
+
+	nn_tensor_t* dL_dY;
+	dL_dY = nn_tensor_new(engine, &dimY,
+	                      NN_TENSOR_INIT_ZERO,
+	                      NN_TENSOR_MODE_COMPUTE);
+	if(dL_dY == NULL)
+	{
+		goto fail_dL_dY;
+	}
+
+	// fill X and dL_dY and share W
+	uint32_t m;
+	uint32_t k;
+	for(m = 0; m < bs; ++m)
+	{
+		for(k = 0; k < shape->xd; ++k)
+		{
+			nn_tensor_ioSet(Xio, m, 0, 0, k,
+			                cc_rngNormal_rand1F(rng));
+		}
+
+		for(k = 0; k < shape->nc; ++k)
+		{
+			nn_tensor_ioSet(Yio, m, 0, 0, k,
+			                cc_rngNormal_rand1F(rng));
+		}
+	}
+
+	if((nn_tensor_copy(Xio, X, 0, 0, bs)     == 0) ||
+	   (nn_tensor_copy(Yio, dL_dY, 0, 0, bs) == 0) ||
+	   (nn_tensor_copy(gemm.layer->W, direct.layer->W,
+	                   0, 0, shape->nc) == 0))
+	{
+		goto fail_run;
+	}
+
+	double ms_gemm   = weight_bench_run(&gemm, bs, X, dL_dY);
+	double ms_direct = weight_bench_run(&direct, bs, X, dL_dY);
+	if((ms_gemm < 0.0) || (ms_direct < 0.0))
+	{
+		goto fail_run;
+	}
+
+	// share W again and compare the outputs of a pass
+	// which skips the parameter update
+	if((nn_tensor_copy(gemm.layer->W, direct.layer->W,
+	                   0, 0, shape->nc) == 0) ||
+	   (nn_tensor_copy(gemm.layer->B, direct.layer->B,
+	                   0, 0, shape->nc) == 0) ||
+	   (weight_bench_step(&gemm, NN_ARCH_FLAG_BP_NOP,
+	                      bs, X, dL_dY) == 0) ||
+	   (weight_bench_step(&direct, NN_ARCH_FLAG_BP_NOP,
+	                      bs, X, dL_dY) == 0))
+	{
+		goto fail_run;
+	}
+
+	float diff_Y = weight_bench_diff(gemm.layer->Y,
+	                                 direct.layer->Y, Yio);
+	float diff_dL_dX = weight_bench_diff(gemm.layer->dL_dX,
+	                                     direct.layer->dL_dX,
+	                                     Xio);
+
+	LOGI("bs=%u, xd=%u, nc=%u, gemm=%s, direct=%0.3lf ms, gemm=%0.3lf ms, speedup=%0.2lf, diff_Y=%f, diff_dL_dX=%f",
+	     bs, shape->xd, shape->nc,
+	     gemm.layer->gemm_Y ? "yes" : "no",
+	     ms_direct, ms_gemm, ms_direct/ms_gemm,
+	     diff_Y, diff_dL_dX);
+
+	nn_tensor_delete(&dL_dY);
+	nn_tensor_delete(&Yio);
+	nn_tensor_delete(&X);
+	nn_tensor_delete(&Xio);
+	weight_bench_delete(&direct);
+	weight_bench_delete(&gemm);
+
+	// success
+	return 1;
+
+	// failure
+	fail_run:
+		nn_tensor_delete(&dL_dY);
+	fail_dL_dY:
+		nn_tensor_delete(&Yio);
+	fail_Yio:
+		nn_tensor_delete(&X);
+	fail_X:
+		nn_tensor_delete(&Xio);
+	fail_Xio:
+		weight_bench_delete(&direct);
+	fail_direct:
+		weight_bench_delete(&gemm);
+	return 0;
+}
+
+/***********************************************************
+* callbacks                                                *
+***********************************************************/
+
+static int
+weight_bench_onMain(vkk_engine_t* ve, int argc, char** argv)
+{
+	ASSERT(ve);
+
+	// includes the dense heads of the discriminators and
+	// shapes below the GEMM selection thresholds
+	weight_bench_shape_t shapes[] =
+	{
+		{ .bs = 8,   .xd = 64,   .nc = 64,   },
+		{ .bs = 32,  .xd = 64,   .nc = 1,    },
+		{ .bs = 32,  .xd = 128,  .nc = 128,  },
+		{ .bs = 32,  .xd = 784,  .nc = 256,  },
+		{ .bs = 64,  .xd = 1024, .nc = 1024, },
+		{ .bs = 128, .xd = 256,  .nc = 10,   },
+		{ .bs = 128, .xd = 512,  .nc = 512,  },
+		{ .bs = 256, .xd = 2048, .nc = 512,  },
+	};
+
+	nn_engine_t* engine = nn_engine_new(ve);
+	if(engine == NULL)
+	{
+		return EXIT_FAILURE;
+	}
+
+	cc_rngNormal_t rng;
+	cc_rngNormal_init(&rng, 0.0f, 1.0f);
+
+	uint32_t i;
+	uint32_t count = sizeof(shapes)/sizeof(weight_bench_shape_t);
+	for(i = 0; i < count; ++i)
+	{
+		if(weight_bench_shape(engine, &shapes[i], &rng) == 0)
+		{
+			goto fail_shape;
+		}
+	}
+
+	nn_engine_delete(&engine);
+
+	// success
+	return EXIT_SUCCESS;
+
+	// failure
+	fail_shape:
+		nn_engine_delete(&engine);
+	return EXIT_FAILURE;
+}
+
+vkk_platformInfo_t VKK_PLATFORM_INFO =
+{
+	.app_name    = "weight-bench",
+	.app_version =
+	{
+		.major = 1,
+		.minor = 0,
+		.patch = 0,
+	},
+	.app_dir = "weight-bench",
+	.onMain  = weight_bench_onMain,
+};